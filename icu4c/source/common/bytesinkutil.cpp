@@ -14,6 +14,7 @@
 #include "charstr.h"
 #include "cmemory.h"
 #include "uassert.h"
+#include "ustr_imp.h"
 
 U_NAMESPACE_BEGIN
 
@@ -121,6 +122,64 @@ ByteSinkUtil::appendUnchanged(const uint8_t *s, const uint8_t *limit,
     return TRUE;
 }
 
+int32_t
+ByteSinkUtil::applyChangesInPlace(char *s, int32_t length, int32_t capacity,
+                                  const Edits &edits, const CharString &changes,
+                                  int32_t *pFirstChange, UErrorCode &errorCode) {
+    if (U_FAILURE(errorCode)) { return 0; }
+    int32_t newLength = length + edits.lengthDelta();
+    Edits::Iterator ei = edits.getCoarseChangesIterator();
+    if (pFirstChange != nullptr) {
+        *pFirstChange = ei.next(errorCode) ? ei.sourceIndex() : length;
+    }
+    if (!edits.hasChanges()) {
+        return u_terminateChars(s, capacity, length, &errorCode);
+    }
+    if (newLength > capacity) {
+        errorCode = U_BUFFER_OVERFLOW_ERROR;
+        return newLength;
+    }
+    // Move the unchanged spans. The ones that move left are moved front to back,
+    // the ones that move right back to front, so that none overwrites
+    // another one that has not been moved yet.
+    // The replacement text is copied last because it may overwrite
+    // the old positions of unchanged spans.
+    MaybeStackArray<int32_t, 48> rightward;
+    int32_t rightwardLength = 0;
+    ei = edits.getCoarseIterator();
+    while (ei.next(errorCode)) {
+        if (ei.hasChange()) {
+            if (ei.replacementIndex() + ei.newLength() > changes.length()) {
+                // CharStringByteSink ignores allocation failures.
+                errorCode = U_MEMORY_ALLOCATION_ERROR;
+                return 0;
+            }
+        } else if (ei.destinationIndex() < ei.sourceIndex()) {
+            uprv_memmove(s + ei.destinationIndex(), s + ei.sourceIndex(), ei.oldLength());
+        } else if (ei.destinationIndex() > ei.sourceIndex()) {
+            if (rightwardLength == rightward.getCapacity() &&
+                    rightward.resize(2 * rightwardLength, rightwardLength) == nullptr) {
+                errorCode = U_MEMORY_ALLOCATION_ERROR;
+                return 0;
+            }
+            rightward[rightwardLength++] = ei.sourceIndex();
+            rightward[rightwardLength++] = ei.destinationIndex();
+            rightward[rightwardLength++] = ei.oldLength();
+        }
+    }
+    while (rightwardLength > 0) {
+        rightwardLength -= 3;
+        uprv_memmove(s + rightward[rightwardLength + 1], s + rightward[rightwardLength],
+                     rightward[rightwardLength + 2]);
+    }
+    ei = edits.getCoarseChangesIterator();
+    while (ei.next(errorCode)) {
+        uprv_memcpy(s + ei.destinationIndex(), changes.data() + ei.replacementIndex(),
+                    ei.newLength());
+    }
+    return u_terminateChars(s, capacity, newLength, &errorCode);
+}
+
 CharStringByteSink::CharStringByteSink(CharString* dest) : dest_(*dest) {
 }
 
@@ -54,6 +54,19 @@ class U_COMMON_API ByteSinkUtil {
                                  ByteSink &sink, uint32_t options, Edits *edits,
                                  UErrorCode &errorCode);
 
+    /**
+     * Rewrites s[0..length[ according to the edits, taking the replacement text
+     * from changes, which was written with U_OMIT_UNCHANGED_TEXT.
+     * Sets *pFirstChange (if not nullptr) to the source index of the first change,
+     * or to length if there is none.
+     * If the result does not fit into capacity, then s is not modified
+     * and U_BUFFER_OVERFLOW_ERROR is set.
+     * @return the length of the result
+     */
+    static int32_t applyChangesInPlace(char *s, int32_t length, int32_t capacity,
+                                       const Edits &edits, const CharString &changes,
+                                       int32_t *pFirstChange, UErrorCode &errorCode);
+
 private:
     static void appendNonEmptyUnchanged(const uint8_t *s, int32_t length,
                                         ByteSink &sink, uint32_t options, Edits *edits);
@@ -0,0 +1,210 @@
+// © 2016 and later: Unicode, Inc. and others.
+// License & terms of use: http://www.unicode.org/copyright.html
+/*
+*******************************************************************************
+*   file name:  keynorm.cpp
+*   encoding:   UTF-8
+*   tab size:   8 (not used)
+*   indentation:4
+*
+*   Search-key mapping with NFKC_Casefold: ASCII runs via a table,
+*   the rest of the text via the normalizer, segment by segment.
+*/
+
+#include "unicode/utypes.h"
+
+#if !UCONFIG_NO_NORMALIZATION
+
+#include "unicode/keynorm.h"
+#include "bytesinkutil.h"
+#include "charstr.h"
+#include "cmemory.h"
+
+U_NAMESPACE_BEGIN
+
+namespace {
+
+const uint8_t kRemoved = 0xff;
+
+}  // namespace
+
+UOBJECT_DEFINE_RTTI_IMPLEMENTATION(SearchKeyNormalizer)
+
+SearchKeyNormalizer::SearchKeyNormalizer(UErrorCode &errorCode) : norm2(nullptr) {
+    init(nullptr, nullptr, errorCode);
+}
+
+SearchKeyNormalizer::SearchKeyNormalizer(const UnicodeSet *excluded, const UnicodeSet *removed,
+                                         UErrorCode &errorCode) : norm2(nullptr) {
+    init(excluded, removed, errorCode);
+}
+
+SearchKeyNormalizer::~SearchKeyNormalizer() {}
+
+void
+SearchKeyNormalizer::init(const UnicodeSet *excluded, const UnicodeSet *removed,
+                          UErrorCode &errorCode) {
+    uprv_memset(asciiMap, 0, sizeof(asciiMap));
+    const Normalizer2 *nfkc_cf = Normalizer2::getNFKCCasefoldInstance(errorCode);
+    if (U_FAILURE(errorCode)) {
+        return;
+    }
+    norm2 = nfkc_cf;
+    if (excluded != nullptr && !excluded->isEmpty()) {
+        filterSet.adoptInsteadAndCheckErrorCode(new UnicodeSet(*excluded), errorCode);
+        if (U_FAILURE(errorCode)) {
+            return;
+        }
+        filterSet->complement().freeze();
+        filtered.adoptInsteadAndCheckErrorCode(new FilteredNormalizer2(*nfkc_cf, *filterSet),
+                                               errorCode);
+        if (U_FAILURE(errorCode)) {
+            return;
+        }
+        norm2 = filtered.getAlias();
+    }
+    if (removed != nullptr && !removed->isEmpty()) {
+        removedSet.adoptInsteadAndCheckErrorCode(new UnicodeSet(*removed), errorCode);
+        if (U_FAILURE(errorCode)) {
+            return;
+        }
+        removedSet->freeze();
+    }
+    // NFKC_Casefold maps each ASCII character to itself or to one other ASCII character.
+    UnicodeString mapped;
+    for (UChar32 c = 0; c < 0x80; ++c) {
+        norm2->normalize(UnicodeString(c), mapped, errorCode);
+        if (U_FAILURE(errorCode)) {
+            return;
+        }
+        if (mapped.length() != 1 || mapped.charAt(0) >= 0x80) {
+            errorCode = U_INTERNAL_PROGRAM_ERROR;
+            return;
+        }
+        UChar32 m = mapped.charAt(0);
+        asciiMap[c] = removedSet.isValid() && removedSet->contains(m) ?
+            kRemoved : static_cast<uint8_t>(m);
+    }
+}
+
+void
+SearchKeyNormalizer::appendRemaining(const char *s, int32_t length, ByteSink &sink) const {
+    // Write the spans that are not in the removal set.
+    while (length > 0) {
+        int32_t keep = removedSet->spanUTF8(s, length, USET_SPAN_NOT_CONTAINED);
+        if (keep > 0) {
+            sink.Append(s, keep);
+            s += keep;
+            length -= keep;
+        }
+        int32_t skip = removedSet->spanUTF8(s, length, USET_SPAN_CONTAINED);
+        s += skip;
+        length -= skip;
+    }
+}
+
+UnicodeString &
+SearchKeyNormalizer::normalize(const UnicodeString &src, UnicodeString &dest,
+                               UErrorCode &errorCode) const {
+    if (U_FAILURE(errorCode)) {
+        dest.setToBogus();
+        return dest;
+    }
+    if (norm2 == nullptr) {
+        errorCode = U_INVALID_STATE_ERROR;
+        dest.setToBogus();
+        return dest;
+    }
+    norm2->normalize(src, dest, errorCode);
+    if (U_FAILURE(errorCode) || removedSet.isNull()) {
+        return dest;
+    }
+    // Remove in place: Copy the kept spans over the removed ones.
+    int32_t length = dest.length();
+    char16_t *p = dest.getBuffer(-1);
+    if (p == nullptr) {
+        errorCode = U_MEMORY_ALLOCATION_ERROR;
+        return dest;
+    }
+    int32_t i = 0, j = 0;
+    while (i < length) {
+        int32_t keep = removedSet->span(p + i, length - i, USET_SPAN_NOT_CONTAINED);
+        if (keep > 0) {
+            if (j != i) {
+                uprv_memmove(p + j, p + i, keep * U_SIZEOF_UCHAR);
+            }
+            i += keep;
+            j += keep;
+        }
+        i += removedSet->span(p + i, length - i, USET_SPAN_CONTAINED);
+    }
+    dest.releaseBuffer(j);
+    return dest;
+}
+
+void
+SearchKeyNormalizer::normalizeUTF8(StringPiece src, ByteSink &sink, UErrorCode &errorCode) const {
+    if (U_FAILURE(errorCode)) {
+        return;
+    }
+    if (norm2 == nullptr) {
+        errorCode = U_INVALID_STATE_ERROR;
+        return;
+    }
+    const uint8_t *s = reinterpret_cast<const uint8_t *>(src.data());
+    const uint8_t *limit = s + src.length();
+    CharString segmentKey;
+    while (s < limit) {
+        // Map an ASCII run via the table, except for an ASCII character
+        // before a non-ASCII one, which might combine with it.
+        const uint8_t *asciiLimit = s;
+        while (asciiLimit < limit && *asciiLimit < 0x80) {
+            ++asciiLimit;
+        }
+        const uint8_t *segmentStart = asciiLimit;
+        if (asciiLimit < limit && asciiLimit > s) {
+            --segmentStart;
+        }
+        while (s < segmentStart) {
+            char scratch[256];
+            int32_t capacity;
+            char *buffer = sink.GetAppendBuffer(
+                1, static_cast<int32_t>(segmentStart - s), scratch, UPRV_LENGTHOF(scratch), &capacity);
+            int32_t length = 0;
+            for (; s < segmentStart && length < capacity; ++s) {
+                uint8_t b = asciiMap[*s];
+                if (b != kRemoved) {
+                    buffer[length++] = static_cast<char>(b);
+                }
+            }
+            sink.Append(buffer, length);
+        }
+        if (s == limit) {
+            break;
+        }
+        // The rest of the segment ends before the next ASCII character,
+        // where NFKC_Casefold always has a normalization boundary.
+        const uint8_t *segmentLimit = asciiLimit;
+        while (segmentLimit < limit && *segmentLimit >= 0x80) {
+            ++segmentLimit;
+        }
+        StringPiece segment(reinterpret_cast<const char *>(s), static_cast<int32_t>(segmentLimit - s));
+        if (removedSet.isNull()) {
+            norm2->normalizeUTF8(0, segment, sink, nullptr, errorCode);
+        } else {
+            segmentKey.clear();
+            CharStringByteSink segmentSink(&segmentKey);
+            norm2->normalizeUTF8(0, segment, segmentSink, nullptr, errorCode);
+            appendRemaining(segmentKey.data(), segmentKey.length(), sink);
+        }
+        if (U_FAILURE(errorCode)) {
+            return;
+        }
+        s = segmentLimit;
+    }
+    sink.Flush();
+}
+
+U_NAMESPACE_END
+
+#endif  // !UCONFIG_NO_NORMALIZATION
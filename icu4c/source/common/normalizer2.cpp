@@ -25,12 +25,16 @@
 #include "unicode/stringoptions.h"
 #include "unicode/unistr.h"
 #include "unicode/unorm.h"
+#include "unicode/utf8.h"
+#include "bytesinkutil.h"
+#include "charstr.h"
 #include "cstring.h"
 #include "mutex.h"
 #include "norm2allmodes.h"
 #include "normalizer2impl.h"
 #include "uassert.h"
 #include "ucln_cmn.h"
+#include "ustr_imp.h"
 
 using icu::Normalizer2Impl;
 
@@ -60,6 +64,63 @@ Normalizer2::normalizeUTF8(uint32_t /*options*/, StringPiece src, ByteSink &sink
     normalize(src16, errorCode).toUTF8(sink);
 }
 
+int32_t
+Normalizer2::normalizeUTF8InPlace(char *s, int32_t length, int32_t capacity,
+                                  int32_t *pFirstChange, UErrorCode &errorCode) const {
+    if (U_FAILURE(errorCode)) {
+        return 0;
+    }
+    if (s == nullptr ? (length != 0 || capacity != 0) : length < -1) {
+        errorCode = U_ILLEGAL_ARGUMENT_ERROR;
+        return 0;
+    }
+    if (length < 0) {
+        length = static_cast<int32_t>(uprv_strlen(s));
+    }
+    if (capacity < length) {
+        errorCode = U_ILLEGAL_ARGUMENT_ERROR;
+        return 0;
+    }
+    CharString changes;
+    CharStringByteSink sink(&changes);
+    Edits edits;
+    normalizeUTF8(U_OMIT_UNCHANGED_TEXT, StringPiece(s, length), sink, &edits, errorCode);
+    if (errorCode != U_UNSUPPORTED_ERROR) {
+        return ByteSinkUtil::applyChangesInPlace(s, length, capacity, edits, changes,
+                                                 pFirstChange, errorCode);
+    }
+    // This normalizer does not record edits: Normalize completely and compare.
+    errorCode = U_ZERO_ERROR;
+    CharString result;
+    CharStringByteSink resultSink(&result);
+    normalizeUTF8(0, StringPiece(s, length), resultSink, nullptr, errorCode);
+    if (U_FAILURE(errorCode)) {
+        return 0;
+    }
+    int32_t newLength = result.length();
+    int32_t firstChange = 0;
+    while (firstChange < length && firstChange < newLength &&
+            s[firstChange] == result[firstChange]) {
+        ++firstChange;
+    }
+    // Report the start of the code point that changes.
+    if (firstChange < length || firstChange < newLength) {
+        while (firstChange > 0 &&
+                U8_IS_TRAIL(firstChange < length ? s[firstChange] : result[firstChange])) {
+            --firstChange;
+        }
+    }
+    if (pFirstChange != nullptr) {
+        *pFirstChange = firstChange;
+    }
+    if (newLength > capacity) {
+        errorCode = U_BUFFER_OVERFLOW_ERROR;
+        return newLength;
+    }
+    uprv_memcpy(s + firstChange, result.data() + firstChange, newLength - firstChange);
+    return u_terminateChars(s, capacity, newLength, &errorCode);
+}
+
 UBool
 Normalizer2::getRawDecomposition(UChar32, UnicodeString &) const {
     return FALSE;
@@ -40,6 +40,7 @@
 #include "uassert.h"
 #include "ucptrie_impl.h"
 #include "uset_imp.h"
+#include "ustr_simd.h"
 #include "uvector.h"
 
 U_NAMESPACE_BEGIN
@@ -62,6 +63,29 @@ inline uint8_t leadByteForCP(UChar32 c) {
     }
 }
 
+/**
+ * Returns the end of the run of code units below minCP that starts at src.
+ * Used in the fast paths after the first such code unit,
+ * to skip the rest of a run of low, normalization-inert text in blocks.
+ * Single low code units between higher characters (like spaces in Hangul text)
+ * are common, so the block scan starts only if the next unit is also low.
+ */
+const UChar *spanBelow(const UChar *src, const UChar *limit, UChar32 minCP) {
+    if (src != limit && *src < minCP) {
+        ++src;
+        src += uprv_spanUCharsBelow(src, (int32_t)(limit - src), (UChar)minCP);
+    }
+    return src;
+}
+
+const uint8_t *spanBelow(const uint8_t *src, const uint8_t *limit, uint8_t minLead) {
+    if (src != limit && *src < minLead) {
+        ++src;
+        src += uprv_spanBytesBelow(src, (int32_t)(limit - src), minLead);
+    }
+    return src;
+}
+
 /**
  * Returns the code point from one single well-formed UTF-8 byte sequence
  * between cpStart and cpLimit.
@@ -606,9 +630,9 @@ Normalizer2Impl::decompose(const UChar *src, const UChar *limit,
     for(;;) {
         // count code units below the minimum or with irrelevant data for the quick check
         for(prevSrc=src; src!=limit;) {
-            if( (c=*src)<minNoCP ||
-                isMostDecompYesAndZeroCC(norm16=UCPTRIE_FAST_BMP_GET(normTrie, UCPTRIE_16, c))
-            ) {
+            if((c=*src)<minNoCP) {
+                src=spanBelow(src+1, limit, minNoCP);
+            } else if(isMostDecompYesAndZeroCC(norm16=UCPTRIE_FAST_BMP_GET(normTrie, UCPTRIE_16, c))) {
                 ++src;
             } else if(!U16_IS_LEAD(c)) {
                 break;
@@ -762,7 +786,7 @@ Normalizer2Impl::decomposeUTF8(uint32_t options,
                 return src;
             }
             if (*src < minNoLead) {
-                ++src;
+                src = spanBelow(src + 1, limit, minNoLead);
             } else {
                 prevSrc = src;
                 UCPTRIE_FAST_U8_NEXT(normTrie, UCPTRIE_16, src, limit, norm16);
@@ -1473,9 +1497,9 @@ Normalizer2Impl::compose(const UChar *src, const UChar *limit,
                 }
                 return TRUE;
             }
-            if( (c=*src)<minNoMaybeCP ||
-                isCompYesAndZeroCC(norm16=UCPTRIE_FAST_BMP_GET(normTrie, UCPTRIE_16, c))
-            ) {
+            if((c=*src)<minNoMaybeCP) {
+                src=spanBelow(src+1, limit, minNoMaybeCP);
+            } else if(isCompYesAndZeroCC(norm16=UCPTRIE_FAST_BMP_GET(normTrie, UCPTRIE_16, c))) {
                 ++src;
             } else {
                 prevSrc = src++;
@@ -1734,9 +1758,9 @@ Normalizer2Impl::composeQuickCheck(const UChar *src, const UChar *limit,
             if(src==limit) {
                 return src;
             }
-            if( (c=*src)<minNoMaybeCP ||
-                isCompYesAndZeroCC(norm16=UCPTRIE_FAST_BMP_GET(normTrie, UCPTRIE_16, c))
-            ) {
+            if((c=*src)<minNoMaybeCP) {
+                src=spanBelow(src+1, limit, minNoMaybeCP);
+            } else if(isCompYesAndZeroCC(norm16=UCPTRIE_FAST_BMP_GET(normTrie, UCPTRIE_16, c))) {
                 ++src;
             } else {
                 prevSrc = src++;
@@ -1886,7 +1910,7 @@ Normalizer2Impl::composeUTF8(uint32_t options, UBool onlyContiguous,
                 return TRUE;
             }
             if (*src < minNoMaybeLead) {
-                ++src;
+                src = spanBelow(src + 1, limit, minNoMaybeLead);
             } else {
                 prevSrc = src;
                 UCPTRIE_FAST_U8_NEXT(normTrie, UCPTRIE_16, src, limit, norm16);
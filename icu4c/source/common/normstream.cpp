@@ -0,0 +1,442 @@
+// © 2016 and later: Unicode, Inc. and others.
+// License & terms of use: http://www.unicode.org/copyright.html
+/*
+*******************************************************************************
+*   file name:  normstream.cpp
+*   encoding:   UTF-8
+*   tab size:   8 (not used)
+*   indentation:4
+*
+*   Incremental normalization of chunked text, split at the normalizer's
+*   hasBoundaryBefore() positions so that only the unstable tail is held back,
+*   and parallel normalization of large texts split at the same kind of positions,
+*   with the segments normalized by tasks on a caller-supplied runner.
+*/
+
+#include "unicode/utypes.h"
+
+#if !UCONFIG_NO_NORMALIZATION
+
+#include "unicode/normstream.h"
+#include "unicode/stringoptions.h"
+#include "unicode/ustring.h"
+#include "unicode/utf16.h"
+#include "unicode/utf8.h"
+#include "bytesinkutil.h"
+#include "charstr.h"
+#include "cmemory.h"
+#include "utask_imp.h"
+
+U_NAMESPACE_BEGIN
+
+UOBJECT_DEFINE_RTTI_IMPLEMENTATION(StreamingNormalizer2)
+
+StreamingNormalizer2::StreamingNormalizer2(const Normalizer2 &n2)
+        : norm2(n2), pending8(nullptr), pending8Length(0), pending8Capacity(0) {}
+
+StreamingNormalizer2::~StreamingNormalizer2() {
+    uprv_free(pending8);
+}
+
+void
+StreamingNormalizer2::reset() {
+    pending16.remove();
+    pending8Length = 0;
+}
+
+int32_t
+StreamingNormalizer2::getPendingLength() const {
+    return pending16.length() + pending8Length;
+}
+
+// A code point that is split across chunks, or might be, is never a boundary.
+// Unpaired surrogates and ill-formed UTF-8 otherwise are, because they are inert.
+
+UBool
+StreamingNormalizer2::hasBoundaryAt(const char16_t *s, int32_t i, int32_t length) const {
+    UChar32 c;
+    U16_NEXT(s, i, length, c);
+    if (U16_IS_LEAD(c) && i == length) {
+        return FALSE;  // the trail surrogate may be in the next chunk
+    }
+    return norm2.hasBoundaryBefore(c);
+}
+
+UBool
+StreamingNormalizer2::hasBoundaryAt(const uint8_t *s, int32_t i, int32_t length) const {
+    UChar32 c;
+    U8_NEXT(s, i, length, c);
+    if (c < 0) {
+        return i < length;  // at the end, the sequence may continue in the next chunk
+    }
+    return norm2.hasBoundaryBefore(c);
+}
+
+void
+StreamingNormalizer2::normalizeAndAppend(const UnicodeString &src, Appendable &dest,
+                                         UErrorCode &errorCode) {
+    norm2.normalize(src, normalized16, errorCode);
+    if (U_SUCCESS(errorCode)) {
+        dest.appendString(normalized16.getBuffer(), normalized16.length());
+    }
+}
+
+void
+StreamingNormalizer2::append(const char16_t *s, int32_t length, Appendable &dest,
+                             UErrorCode &errorCode) {
+    if (U_FAILURE(errorCode)) {
+        return;
+    }
+    if (s == nullptr ? length != 0 : length < -1) {
+        errorCode = U_ILLEGAL_ARGUMENT_ERROR;
+        return;
+    }
+    if (length < 0) {
+        length = u_strlen(s);
+    }
+    // A trail surrogate at the start of the chunk goes with a held-back lead surrogate.
+    int32_t first = 0;
+    if (length > 0 && U16_IS_TRAIL(s[0]) && !pending16.isEmpty() &&
+            U16_IS_LEAD(pending16.charAt(pending16.length() - 1))) {
+        first = 1;
+    }
+    while (first < length && !hasBoundaryAt(s, first, length)) {
+        U16_FWD_1(s, first, length);
+    }
+    if (first == length) {
+        // No boundary in this chunk: Hold all of it back.
+        if (!pending16.append(s, length).isBogus()) {
+            return;
+        }
+        errorCode = U_MEMORY_ALLOCATION_ERROR;
+        return;
+    }
+    // The text before the first boundary completes the held-back text.
+    if (!pending16.isEmpty() || first > 0) {
+        if (pending16.append(s, first).isBogus()) {
+            errorCode = U_MEMORY_ALLOCATION_ERROR;
+            return;
+        }
+        normalizeAndAppend(pending16, dest, errorCode);
+        pending16.remove();
+    }
+    // Normalize up to the last boundary directly from the chunk.
+    int32_t last = length;
+    do {
+        U16_BACK_1(s, first, last);
+    } while (last > first && !hasBoundaryAt(s, last, length));
+    if (last > first) {
+        normalizeAndAppend(UnicodeString(FALSE, s + first, last - first), dest, errorCode);
+    }
+    if (pending16.setTo(s + last, length - last).isBogus()) {
+        errorCode = U_MEMORY_ALLOCATION_ERROR;
+    }
+}
+
+void
+StreamingNormalizer2::finish(Appendable &dest, UErrorCode &errorCode) {
+    if (U_FAILURE(errorCode)) {
+        return;
+    }
+    if (!pending16.isEmpty()) {
+        normalizeAndAppend(pending16, dest, errorCode);
+    }
+    reset();
+}
+
+UBool
+StreamingNormalizer2::appendPending8(const char *s, int32_t length, UErrorCode &errorCode) {
+    if (length > pending8Capacity - pending8Length) {
+        int32_t newCapacity = 2 * pending8Capacity;
+        if (newCapacity < pending8Length + length) {
+            newCapacity = pending8Length + length;
+        }
+        if (newCapacity < 64) {
+            newCapacity = 64;
+        }
+        char *newPending = static_cast<char *>(uprv_realloc(pending8, newCapacity));
+        if (newPending == nullptr) {
+            errorCode = U_MEMORY_ALLOCATION_ERROR;
+            return FALSE;
+        }
+        pending8 = newPending;
+        pending8Capacity = newCapacity;
+    }
+    if (length > 0) {
+        uprv_memcpy(pending8 + pending8Length, s, length);
+        pending8Length += length;
+    }
+    return TRUE;
+}
+
+void
+StreamingNormalizer2::appendUTF8(uint32_t options, StringPiece src, ByteSink &sink,
+                                 Edits *edits, UErrorCode &errorCode) {
+    if (U_FAILURE(errorCode)) {
+        return;
+    }
+    options |= U_EDITS_NO_RESET;
+    const uint8_t *s = reinterpret_cast<const uint8_t *>(src.data());
+    int32_t length = src.length();
+    // Trail bytes at the start of the chunk go with the held-back text,
+    // which may end with an incomplete sequence.
+    int32_t first = 0;
+    if (pending8Length > 0) {
+        while (first < length && first < 3 && U8_IS_TRAIL(s[first])) {
+            ++first;
+        }
+    }
+    while (first < length && !hasBoundaryAt(s, first, length)) {
+        U8_FWD_1(s, first, length);
+    }
+    if (first == length) {
+        // No boundary in this chunk: Hold all of it back.
+        appendPending8(src.data(), length, errorCode);
+        return;
+    }
+    // The text before the first boundary completes the held-back text.
+    if (pending8Length > 0) {
+        if (!appendPending8(src.data(), first, errorCode)) {
+            return;
+        }
+        norm2.normalizeUTF8(options, StringPiece(pending8, pending8Length), sink, edits, errorCode);
+        pending8Length = 0;
+    } else if (first > 0) {
+        norm2.normalizeUTF8(options, StringPiece(src.data(), first), sink, edits, errorCode);
+    }
+    // Normalize up to the last boundary directly from the chunk.
+    int32_t last = length;
+    do {
+        U8_BACK_1(s, first, last);
+    } while (last > first && !hasBoundaryAt(s, last, length));
+    if (last > first) {
+        norm2.normalizeUTF8(options, StringPiece(src.data() + first, last - first),
+                            sink, edits, errorCode);
+    }
+    appendPending8(src.data() + last, length - last, errorCode);
+}
+
+void
+StreamingNormalizer2::finishUTF8(uint32_t options, ByteSink &sink, Edits *edits,
+                                 UErrorCode &errorCode) {
+    if (U_FAILURE(errorCode)) {
+        return;
+    }
+    if (pending8Length > 0) {
+        norm2.normalizeUTF8(options | U_EDITS_NO_RESET, StringPiece(pending8, pending8Length),
+                            sink, edits, errorCode);
+    }
+    reset();
+}
+
+namespace {
+
+/** Upper limit for the number of segments per call. */
+const int32_t kMaxSegments = 64;
+
+/** One piece of the text, normalized independently. */
+struct NormSegment : public UMemory {
+    NormSegment() : start(0), limit(0), errorCode(U_ZERO_ERROR) {}
+
+    int32_t start;
+    int32_t limit;
+    CharString dest8;
+    UnicodeString dest16;
+    Edits edits;
+    UErrorCode errorCode;
+};
+
+// Returns the first index at or after i where the text has a boundary
+// before a well-formed code point, or length if there is none.
+// A split point can only be at the start of a code point as seen when
+// iterating from the start of the text, so trail units are skipped first.
+
+int32_t nextBoundary(const Normalizer2 &norm2, const char16_t *s, int32_t i, int32_t length) {
+    if (i < length && U16_IS_TRAIL(s[i]) && U16_IS_LEAD(s[i - 1])) {
+        ++i;
+    }
+    while (i < length) {
+        int32_t start = i;
+        UChar32 c;
+        U16_NEXT(s, i, length, c);
+        if (!U_IS_SURROGATE(c) && norm2.hasBoundaryBefore(c)) {
+            return start;
+        }
+    }
+    return length;
+}
+
+int32_t nextBoundary(const Normalizer2 &norm2, const uint8_t *s, int32_t i, int32_t length) {
+    while (i < length && U8_IS_TRAIL(s[i])) {
+        ++i;
+    }
+    while (i < length) {
+        int32_t start = i;
+        UChar32 c;
+        U8_NEXT(s, i, length, c);
+        if (c >= 0 && norm2.hasBoundaryBefore(c)) {
+            return start;
+        }
+    }
+    return length;
+}
+
+/**
+ * Splits the text into up to count segments of roughly equal lengths.
+ * @return the actual number of segments
+ */
+template<typename Unit>
+int32_t splitText(const Normalizer2 &norm2, const Unit *s, int32_t length,
+                  NormSegment *segments, int32_t count) {
+    int32_t segmentCount = 0;
+    int32_t start = 0;
+    for (int32_t k = 1; k <= count && start < length; ++k) {
+        int32_t limit = length;
+        if (k < count) {
+            int32_t target = static_cast<int32_t>(static_cast<int64_t>(length) * k / count);
+            if (target <= start) {
+                continue;  // The previous segment already extends beyond this target.
+            }
+            limit = nextBoundary(norm2, s, target, length);
+        }
+        segments[segmentCount].start = start;
+        segments[segmentCount].limit = limit;
+        ++segmentCount;
+        start = limit;
+    }
+    return segmentCount;
+}
+
+}  // namespace
+
+UOBJECT_DEFINE_RTTI_IMPLEMENTATION(ParallelNormalizer2)
+
+ParallelNormalizer2::ParallelNormalizer2(const Normalizer2 &n2, int32_t count,
+                                         UTaskRunner r, const void *rContext)
+        : norm2(n2), maxSegments(count), runner(r), runnerContext(rContext),
+          minSegmentLength(32768) {
+    if (maxSegments < 1) {
+        maxSegments = 1;
+    } else if (maxSegments > kMaxSegments) {
+        maxSegments = kMaxSegments;
+    }
+}
+
+ParallelNormalizer2::~ParallelNormalizer2() {}
+
+int32_t
+ParallelNormalizer2::countSegments(int32_t length) const {
+    if (runner == nullptr) {
+        return 1;
+    }
+    int32_t count = length / minSegmentLength;
+    return count < maxSegments ? count : maxSegments;
+}
+
+UnicodeString &
+ParallelNormalizer2::normalize(const UnicodeString &src, UnicodeString &dest,
+                               UErrorCode &errorCode) const {
+    if (U_FAILURE(errorCode)) {
+        dest.setToBogus();
+        return dest;
+    }
+    int32_t count = countSegments(src.length());
+    if (count <= 1) {
+        return norm2.normalize(src, dest, errorCode);
+    }
+    const char16_t *s = src.getBuffer();
+    if (s == nullptr || &dest == &src) {
+        errorCode = U_ILLEGAL_ARGUMENT_ERROR;
+        dest.setToBogus();
+        return dest;
+    }
+    LocalArray<NormSegment> segments(new NormSegment[count]);
+    if (segments.isNull()) {
+        errorCode = U_MEMORY_ALLOCATION_ERROR;
+        dest.setToBogus();
+        return dest;
+    }
+    count = splitText(norm2, s, src.length(), segments.getAlias(), count);
+    const Normalizer2 &n2 = norm2;
+    NormSegment *segmentsArray = segments.getAlias();
+    auto work = [&n2, s, segmentsArray](int32_t i) {
+        NormSegment &segment = segmentsArray[i];
+        n2.normalize(UnicodeString(FALSE, s + segment.start, segment.limit - segment.start),
+                     segment.dest16, segment.errorCode);
+    };
+    uprv_runTasks(runner, runnerContext, count, work);
+    dest.remove();
+    for (int32_t i = 0; i < count; ++i) {
+        const NormSegment &segment = segments[i];
+        if (U_FAILURE(segment.errorCode)) {
+            errorCode = segment.errorCode;
+            dest.setToBogus();
+            return dest;
+        }
+        dest.append(segment.dest16);
+    }
+    if (dest.isBogus()) {
+        errorCode = U_MEMORY_ALLOCATION_ERROR;
+    }
+    return dest;
+}
+
+void
+ParallelNormalizer2::normalizeUTF8(uint32_t options, StringPiece src, ByteSink &sink,
+                                   Edits *edits, UErrorCode &errorCode) const {
+    if (U_FAILURE(errorCode)) {
+        return;
+    }
+    int32_t count = countSegments(src.length());
+    if (count <= 1) {
+        norm2.normalizeUTF8(options, src, sink, edits, errorCode);
+        return;
+    }
+    LocalArray<NormSegment> segments(new NormSegment[count]);
+    if (segments.isNull()) {
+        errorCode = U_MEMORY_ALLOCATION_ERROR;
+        return;
+    }
+    const uint8_t *s = reinterpret_cast<const uint8_t *>(src.data());
+    count = splitText(norm2, s, src.length(), segments.getAlias(), count);
+    const Normalizer2 &n2 = norm2;
+    const char *p = src.data();
+    uint32_t segmentOptions = options & ~U_EDITS_NO_RESET;
+    UBool withEdits = edits != nullptr;
+    NormSegment *segmentsArray = segments.getAlias();
+    auto work = [&n2, p, segmentOptions, withEdits, segmentsArray](int32_t i) {
+        NormSegment &segment = segmentsArray[i];
+        CharStringByteSink segmentSink(&segment.dest8);
+        n2.normalizeUTF8(segmentOptions, StringPiece(p + segment.start, segment.limit - segment.start),
+                         segmentSink, withEdits ? &segment.edits : nullptr, segment.errorCode);
+    };
+    uprv_runTasks(runner, runnerContext, count, work);
+    if (edits != nullptr && (options & U_EDITS_NO_RESET) == 0) {
+        edits->reset();
+    }
+    for (int32_t i = 0; i < count; ++i) {
+        NormSegment &segment = segments[i];
+        if (U_FAILURE(segment.errorCode)) {
+            errorCode = segment.errorCode;
+            return;
+        }
+        sink.Append(segment.dest8.data(), segment.dest8.length());
+        if (edits != nullptr) {
+            for (Edits::Iterator ei = segment.edits.getFineIterator(); ei.next(errorCode);) {
+                if (ei.hasChange()) {
+                    edits->addReplace(ei.oldLength(), ei.newLength());
+                } else {
+                    edits->addUnchanged(ei.oldLength());
+                }
+            }
+            if (edits->copyErrorTo(errorCode)) {
+                return;
+            }
+        }
+    }
+    sink.Flush();
+}
+
+U_NAMESPACE_END
+
+#endif  // !UCONFIG_NO_NORMALIZATION
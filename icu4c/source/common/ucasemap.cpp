@@ -36,6 +36,7 @@
 #include "unicode/utf8.h"
 #include "unicode/utf16.h"
 #include "bytesinkutil.h"
+#include "charstr.h"
 #include "cmemory.h"
 #include "cstring.h"
 #include "uassert.h"
@@ -950,4 +951,34 @@ int32_t CaseMap::utf8Fold(
         ucasemap_internalUTF8Fold, edits, errorCode);
 }
 
+int32_t CaseMap::utf8FoldInPlace(
+        uint32_t options,
+        char *s, int32_t length, int32_t capacity,
+        int32_t *pFirstChange, UErrorCode &errorCode) {
+    if (U_FAILURE(errorCode)) {
+        return 0;
+    }
+    if (s == nullptr ? (length != 0 || capacity != 0) : length < -1) {
+        errorCode = U_ILLEGAL_ARGUMENT_ERROR;
+        return 0;
+    }
+    if (length < 0) {
+        length = (int32_t)uprv_strlen(s);
+    }
+    if (capacity < length) {
+        errorCode = U_ILLEGAL_ARGUMENT_ERROR;
+        return 0;
+    }
+    CharString changes;
+    CharStringByteSink sink(&changes);
+    Edits edits;
+    options = (options & ~U_EDITS_NO_RESET) | U_OMIT_UNCHANGED_TEXT;
+    ucasemap_mapUTF8(
+        UCASE_LOC_ROOT, options, UCASEMAP_BREAK_ITERATOR_NULL
+        s, length,
+        ucasemap_internalUTF8Fold, sink, &edits, errorCode);
+    return ByteSinkUtil::applyChangesInPlace(s, length, capacity, edits, changes,
+                                             pFirstChange, errorCode);
+}
+
 U_NAMESPACE_END
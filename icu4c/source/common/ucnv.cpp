@@ -33,6 +33,7 @@
 #include "unicode/uset.h"
 #include "unicode/utf.h"
 #include "unicode/utf16.h"
+#include "charstr.h"
 #include "putilimp.h"
 #include "cmemory.h"
 #include "cstring.h"
@@ -2131,7 +2132,7 @@ ucnv_convertEx(UConverter *targetCnv, UConverter *sourceCnv,
         }
     }
 
-    /* Is direct-UTF-8 conversion available? */
+    /* Is direct-UTF-8 or direct MBCS-to-MBCS conversion available? */
     if( sourceCnv->sharedData->staticData->conversionType==UCNV_UTF8 &&
         targetCnv->sharedData->impl->fromUTF8!=NULL
     ) {
@@ -2140,6 +2141,11 @@ ucnv_convertEx(UConverter *targetCnv, UConverter *sourceCnv,
                sourceCnv->sharedData->impl->toUTF8!=NULL
     ) {
         convert=sourceCnv->sharedData->impl->toUTF8;
+#if !UCONFIG_NO_LEGACY_CONVERSION
+    } else if(ucnv_MBCSCanConvertDirect(targetCnv, sourceCnv)) {
+        /* direct conversion between table-based codepages */
+        convert=ucnv_MBCSToMBCS;
+#endif
     } else {
         convert=NULL;
     }
@@ -2514,6 +2520,296 @@ ucnv_convert(const char *toConverterName, const char *fromConverterName,
     return targetLength;
 }
 
+/* parallel conversion ------------------------------------------------------ */
+
+/*
+ * Do not split the input into chunks shorter than this,
+ * to keep the per-chunk overhead (cloning, buffer allocation, copying) small.
+ */
+#define MIN_PARALLEL_CHUNK_LENGTH 0x10000
+
+/* How the input or output of a converter can be split for parallel conversion. */
+enum {
+    CNV_SPLIT_NONE,
+    CNV_SPLIT_UTF8,
+    CNV_SPLIT_UTF16BE,
+    CNV_SPLIT_UTF16LE,
+    CNV_SPLIT_UTF32BE,
+    CNV_SPLIT_UTF32LE,
+    CNV_SPLIT_BYTES,
+    CNV_SPLIT_MBCS
+};
+
+static int32_t
+getSplitKind(const UConverter *cnv) {
+    switch(ucnv_getType(cnv)) {
+    case UCNV_UTF8:
+        return CNV_SPLIT_UTF8;
+    case UCNV_UTF16_BigEndian:
+        /* version 1 writes a BOM */
+        return UCNV_GET_VERSION(cnv)==0 ? CNV_SPLIT_UTF16BE : CNV_SPLIT_NONE;
+    case UCNV_UTF16_LittleEndian:
+        return UCNV_GET_VERSION(cnv)==0 ? CNV_SPLIT_UTF16LE : CNV_SPLIT_NONE;
+    case UCNV_UTF32_BigEndian:
+        return CNV_SPLIT_UTF32BE;
+    case UCNV_UTF32_LittleEndian:
+        return CNV_SPLIT_UTF32LE;
+    case UCNV_LATIN_1:
+    case UCNV_US_ASCII:
+        return CNV_SPLIT_BYTES;
+#if !UCONFIG_NO_LEGACY_CONVERSION
+    case UCNV_SBCS:
+    case UCNV_DBCS:
+    case UCNV_MBCS:
+        /* ucnv_getType() returns UCNV_EBCDIC_STATEFUL for SI/SO tables */
+        return CNV_SPLIT_MBCS;
+#endif
+    default:
+        return CNV_SPLIT_NONE;
+    }
+}
+
+static int32_t
+getSplitUnitSize(int32_t kind) {
+    switch(kind) {
+    case CNV_SPLIT_UTF16BE:
+    case CNV_SPLIT_UTF16LE:
+        return 2;
+    case CNV_SPLIT_UTF32BE:
+    case CNV_SPLIT_UTF32LE:
+        return 4;
+    default:
+        return 1;
+    }
+}
+
+/*
+ * Can conversion restart at p, in the initial states of both converters,
+ * with the same results as continuing through p?
+ * p must be at a code unit boundary of the source charset.
+ */
+static UBool
+isSplitPoint(const UConverter *sourceCnv, int32_t sourceKind,
+             const UConverter *targetCnv, int32_t targetKind,
+             const uint8_t *p, const uint8_t *limit) {
+    UChar32 c;
+    switch(sourceKind) {
+    case CNV_SPLIT_UTF8: {
+        int32_t i=0;
+        if(U8_IS_TRAIL(*p)) {
+            return FALSE;
+        }
+        U8_NEXT(p, i, limit-p, c);
+        break;
+    }
+    case CNV_SPLIT_UTF16BE:
+        c=((UChar32)p[0]<<8)|p[1];
+        break;
+    case CNV_SPLIT_UTF16LE:
+        c=((UChar32)p[1]<<8)|p[0];
+        break;
+    case CNV_SPLIT_UTF32BE:
+        c=(UChar32)(((uint32_t)p[0]<<24)|((uint32_t)p[1]<<16)|((uint32_t)p[2]<<8)|p[3]);
+        break;
+    case CNV_SPLIT_UTF32LE:
+        c=(UChar32)(((uint32_t)p[3]<<24)|((uint32_t)p[2]<<16)|((uint32_t)p[1]<<8)|p[0]);
+        break;
+    case CNV_SPLIT_BYTES:
+        c=*p;
+        break;
+#if !UCONFIG_NO_LEGACY_CONVERSION
+    case CNV_SPLIT_MBCS: {
+        UChar u;
+        if(!ucnv_MBCSIsResyncByte(sourceCnv, *p, &u)) {
+            return FALSE;
+        }
+        c=u;
+        break;
+    }
+#endif
+    default:
+        return FALSE;
+    }
+    /* do not split before an ill-formed sequence or a trail surrogate */
+    if((uint32_t)c>0x10ffff || U_IS_TRAIL(c) || (sourceKind>=CNV_SPLIT_UTF32BE && U_IS_SURROGATE(c))) {
+        return FALSE;
+    }
+#if !UCONFIG_NO_LEGACY_CONVERSION
+    if(targetKind==CNV_SPLIT_MBCS &&
+            ucnv_extIsFromUContinuation(targetCnv->sharedData->mbcs.extIndexes,
+                                        c<=0xffff ? (UChar)c : U16_LEAD(c))) {
+        return FALSE;
+    }
+#else
+    (void)targetCnv;
+    (void)targetKind;
+#endif
+    return TRUE;
+}
+
+namespace {
+
+struct ConvertChunk : public icu::UMemory {
+    ConvertChunk() : source(NULL), sourceLimit(NULL), errorCode(U_ZERO_ERROR) {}
+
+    const char *source, *sourceLimit;
+    icu::CharString output;
+    UErrorCode errorCode;
+};
+
+struct ParallelConversion {
+    UConverter *targetCnv, *sourceCnv;
+    ConvertChunk *chunks;
+};
+
+}  // namespace
+
+U_CDECL_BEGIN
+
+static void U_CALLCONV
+convertChunk(void *context, int32_t index) {
+    ParallelConversion *conv=static_cast<ParallelConversion *>(context);
+    ConvertChunk &chunk=conv->chunks[index];
+    UErrorCode &errorCode=chunk.errorCode;
+    UConverter *targetClone=ucnv_safeClone(conv->targetCnv, NULL, NULL, &errorCode);
+    UConverter *sourceClone=ucnv_safeClone(conv->sourceCnv, NULL, NULL, &errorCode);
+    if(U_SUCCESS(errorCode)) {
+        UChar pivotBuffer[CHUNK_SIZE];
+        UChar *pivot=pivotBuffer, *pivot2=pivotBuffer;
+        const char *source=chunk.source;
+        int32_t sourceLength=(int32_t)(chunk.sourceLimit-source);
+        int32_t desiredCapacity=sourceLength<=0x3fffffff ? sourceLength*2 : 0x7fffffff;
+        do {
+            int32_t capacity;
+            errorCode=U_ZERO_ERROR;
+            char *buffer=chunk.output.getAppendBuffer(CHUNK_SIZE, desiredCapacity, capacity, errorCode);
+            if(U_FAILURE(errorCode)) {
+                break;
+            }
+            char *target=buffer;
+            ucnv_convertEx(targetClone, sourceClone,
+                           &target, buffer+capacity,
+                           &source, chunk.sourceLimit,
+                           pivotBuffer, &pivot, &pivot2, pivotBuffer+CHUNK_SIZE,
+                           FALSE, TRUE, &errorCode);
+            UErrorCode appendErrorCode=U_ZERO_ERROR;
+            chunk.output.append(buffer, (int32_t)(target-buffer), appendErrorCode);
+            if(U_FAILURE(appendErrorCode)) {
+                errorCode=appendErrorCode;
+                break;
+            }
+        } while(errorCode==U_BUFFER_OVERFLOW_ERROR);
+    }
+    ucnv_close(sourceClone);
+    ucnv_close(targetClone);
+}
+
+U_CDECL_END
+
+U_CAPI int32_t U_EXPORT2
+ucnv_convertParallel(UConverter *targetCnv, UConverter *sourceCnv,
+                     char *target, int32_t targetCapacity,
+                     const char *source, int32_t sourceLength,
+                     int32_t maxChunks,
+                     UTaskRunner runner, const void *runnerContext,
+                     UErrorCode *pErrorCode) {
+    if(pErrorCode==NULL || U_FAILURE(*pErrorCode)) {
+        return 0;
+    }
+
+    if( targetCnv==NULL || sourceCnv==NULL ||
+        source==NULL || sourceLength<-1 ||
+        targetCapacity<0 || (targetCapacity>0 && target==NULL)
+    ) {
+        *pErrorCode=U_ILLEGAL_ARGUMENT_ERROR;
+        return 0;
+    }
+
+    if(sourceLength<0) {
+        sourceLength=(int32_t)uprv_strlen(source);
+    }
+    ucnv_resetToUnicode(sourceCnv);
+    ucnv_resetFromUnicode(targetCnv);
+
+    /* find the chunk boundaries */
+    int32_t sourceKind=CNV_SPLIT_NONE, targetKind=CNV_SPLIT_NONE;
+    int32_t chunkCount=1;
+    if(runner!=NULL && maxChunks>1 && sourceLength>=2*MIN_PARALLEL_CHUNK_LENGTH) {
+        sourceKind=getSplitKind(sourceCnv);
+        targetKind=getSplitKind(targetCnv);
+        if(sourceKind!=CNV_SPLIT_NONE && targetKind!=CNV_SPLIT_NONE) {
+            chunkCount=sourceLength/MIN_PARALLEL_CHUNK_LENGTH;
+            if(chunkCount>maxChunks) {
+                chunkCount=maxChunks;
+            }
+        }
+    }
+    if(chunkCount<=1) {
+        return ucnv_internalConvert(targetCnv, sourceCnv,
+                                    target, targetCapacity,
+                                    source, sourceLength,
+                                    pErrorCode);
+    }
+
+    icu::LocalArray<ConvertChunk> chunks(new ConvertChunk[chunkCount], *pErrorCode);
+    if(U_FAILURE(*pErrorCode)) {
+        return 0;
+    }
+    const uint8_t *s=(const uint8_t *)source;
+    const uint8_t *sourceLimit=s+sourceLength;
+    int32_t unitSize=getSplitUnitSize(sourceKind);
+    int32_t count=0;
+    const uint8_t *chunkStart=s;
+    for(int32_t i=1; i<chunkCount; ++i) {
+        /* look for a split point between the nominal boundaries i and i+1 */
+        int32_t nominal=(int32_t)(((int64_t)sourceLength*i)/chunkCount);
+        int32_t nextNominal=(int32_t)(((int64_t)sourceLength*(i+1))/chunkCount);
+        const uint8_t *p=s+(nominal-nominal%unitSize);
+        const uint8_t *limit=s+(nextNominal-nextNominal%unitSize);
+        if(p<=chunkStart) {
+            p=chunkStart+unitSize;
+        }
+        while(p<limit && !isSplitPoint(sourceCnv, sourceKind, targetCnv, targetKind, p, sourceLimit)) {
+            p+=unitSize;
+        }
+        if(p<limit) {
+            chunks[count].source=(const char *)chunkStart;
+            chunks[count++].sourceLimit=(const char *)p;
+            chunkStart=p;
+        }
+    }
+    chunks[count].source=(const char *)chunkStart;
+    chunks[count++].sourceLimit=(const char *)sourceLimit;
+
+    /* convert the chunks */
+    ParallelConversion conv={ targetCnv, sourceCnv, chunks.getAlias() };
+    runner(runnerContext, convertChunk, &conv, count);
+
+    /* concatenate the outputs */
+    int32_t targetLength=0;
+    for(int32_t i=0; i<count; ++i) {
+        const ConvertChunk &chunk=chunks[i];
+        if(U_FAILURE(chunk.errorCode)) {
+            *pErrorCode=chunk.errorCode;
+            return 0;
+        }
+        int32_t length=chunk.output.length();
+        if(length>(0x7fffffff-targetLength)) {
+            *pErrorCode=U_INDEX_OUTOFBOUNDS_ERROR;
+            return 0;
+        }
+        if(targetLength<targetCapacity) {
+            int32_t copyLength=targetCapacity-targetLength;
+            if(copyLength>length) {
+                copyLength=length;
+            }
+            uprv_memcpy(target+targetLength, chunk.output.data(), copyLength);
+        }
+        targetLength+=length;
+    }
+    return u_terminateChars(target, targetCapacity, targetLength, pErrorCode);
+}
+
 /* @internal */
 static int32_t
 ucnv_convertAlgorithmic(UBool convertToAlgorithmic,
@@ -39,12 +39,16 @@
 #include "ucnv_ext.h"
 #include "ucnv_cnv.h"
 #include "ucnv_imp.h"
-#include "uhash.h"
 #include "umutex.h"
 #include "cstring.h"
 #include "cmemory.h"
 #include "ucln_cmn.h"
 #include "ustr_cnv.h"
+#include "ustr_imp.h"
+
+#include <atomic>
+#include <functional>
+#include <thread>
 
 
 #if 0
@@ -192,11 +196,46 @@ static struct {
 };
 
 
-/*initializes some global variables */
-static UHashtable *SHARED_DATA_HASHTABLE = NULL;
+/*
+ * Cache of shared data for data-based converters, keyed by canonical name.
+ *
+ * Open addressing with linear probing in a table that is allocated once.
+ * A slot is claimed for one name and keeps it until ucnv_cleanup(),
+ * so that lookups can probe the table without a lock.
+ * The data pointer of a slot is set and cleared while holding cnvCacheMutex.
+ *
+ * The references to cached shared data are counted atomically in its slot,
+ * not in UConverterSharedData.referenceCounter (which must stay a plain integer
+ * for C code that includes ucnv_bld.h). Acquiring a reference is
+ * an atomic increment of the slot count; if it was not negative then
+ * the slot data cannot be deleted until the reference is released.
+ * ucnv_flushCache() deletes the data only after swapping a zero count
+ * for UCNV_SLOT_FLUSHING, which makes concurrent lookups back off.
+ * Shared data that is not cached (from a package, or without a free slot)
+ * is still counted in its referenceCounter under cnvCacheMutex.
+ */
+#define UCNV_SLOT_FLUSHING ((int32_t)0xc0000000)
+
+namespace {
+
+struct SharedDataSlot : public icu::UMemory {
+    SharedDataSlot() : refs(0), data(nullptr), isClaimed(FALSE) {
+        name[0] = 0;
+    }
+
+    std::atomic<int32_t> refs;
+    std::atomic<UConverterSharedData *> data;
+    std::atomic<UBool> isClaimed;
+    char name[UCNV_MAX_CONVERTER_NAME_LENGTH];
+};
+
+}  // namespace
+
+static std::atomic<SharedDataSlot *> gSharedDataSlots(nullptr);
+static int32_t gSharedDataSlotCount = 0;
 static icu::UMutex cnvCacheMutex;
-/*  Note:  the global mutex is used for      */
-/*         reference count updates.          */
+/*  Note:  the global mutex is used for modifying the cache  */
+/*         and for reference count updates of uncached data. */
 
 static const char **gAvailableConverters = NULL;
 static uint16_t gAvailableConverterCount = 0;
@@ -243,9 +282,20 @@ ucnv_flushAvailableConverterCache() {
 /*                Not supported API.                                          */
 static UBool U_CALLCONV ucnv_cleanup(void) {
     ucnv_flushCache();
-    if (SHARED_DATA_HASHTABLE != NULL && uhash_count(SHARED_DATA_HASHTABLE) == 0) {
-        uhash_close(SHARED_DATA_HASHTABLE);
-        SHARED_DATA_HASHTABLE = NULL;
+    SharedDataSlot *slots = gSharedDataSlots.load();
+    if (slots != NULL) {
+        UBool isEmpty = TRUE;
+        for (int32_t i = 0; i < gSharedDataSlotCount; ++i) {
+            if (slots[i].data.load() != NULL) {
+                isEmpty = FALSE;
+                break;
+            }
+        }
+        if (isEmpty) {
+            gSharedDataSlots.store(NULL);
+            gSharedDataSlotCount = 0;
+            delete[] slots;
+        }
     }
 
     /* Isn't called from flushCache because other threads may have preexisting references to the table. */
@@ -258,7 +308,7 @@ static UBool U_CALLCONV ucnv_cleanup(void) {
     gDefaultAlgorithmicSharedData = NULL;
 #endif
 
-    return (SHARED_DATA_HASHTABLE == NULL);
+    return (gSharedDataSlots.load() == NULL);
 }
 
 U_CAPI void U_EXPORT2
@@ -426,74 +476,121 @@ getAlgorithmicTypeFromName(const char *realName)
 */
 #define UCNV_CACHE_LOAD_FACTOR 2
 
-/* Puts the shared data in the static hashtable SHARED_DATA_HASHTABLE */
-/*   Will always be called with the cnvCacheMutex already being held   */
-/*     by the calling function.                                       */
-/* Stores the shared data in the SHARED_DATA_HASHTABLE
- * @param data The shared data
+/*
+ * Finds the cache slot for a converter name, or NULL if there is none.
+ * Lock-free: Claimed slots never change their names.
  */
-static void
-ucnv_shareConverterData(UConverterSharedData * data)
-{
-    UErrorCode err = U_ZERO_ERROR;
-    /*Lazy evaluates the Hashtable itself */
-    /*void *sanity = NULL;*/
-
-    if (SHARED_DATA_HASHTABLE == NULL)
-    {
-        SHARED_DATA_HASHTABLE = uhash_openSize(uhash_hashChars, uhash_compareChars, NULL,
-                            ucnv_io_countKnownConverters(&err)*UCNV_CACHE_LOAD_FACTOR,
-                            &err);
-        ucnv_enableCleanup();
-
-        if (U_FAILURE(err))
-            return;
+static SharedDataSlot *
+ucnv_findSharedDataSlot(const char *name) {
+    SharedDataSlot *slots = gSharedDataSlots.load(std::memory_order_acquire);
+    if (slots == NULL) {
+        return NULL;
     }
-
-    /* ### check to see if the element is not already there! */
-
-    /*
-    sanity =   ucnv_getSharedConverterData (data->staticData->name);
-    if(sanity != NULL)
-    {
-    UCNV_DEBUG_LOG("put:overwrite!",data->staticData->name,sanity);
+    int32_t count = gSharedDataSlotCount;
+    int32_t i = (int32_t)((uint32_t)ustr_hashCharsN(name, (int32_t)uprv_strlen(name)) % (uint32_t)count);
+    for (int32_t probes = 0; probes < count; ++probes) {
+        SharedDataSlot &slot = slots[i];
+        if (!slot.isClaimed.load(std::memory_order_acquire)) {
+            break;
+        }
+        if (uprv_strcmp(slot.name, name) == 0) {
+            return &slot;
+        }
+        if (++i == count) {
+            i = 0;
+        }
     }
-    UCNV_DEBUG_LOG("put:chk",data->staticData->name,sanity);
-    */
-
-    /* Mark it shared */
-    data->sharedDataCached = TRUE;
-
-    uhash_put(SHARED_DATA_HASHTABLE,
-            (void*) data->staticData->name, /* Okay to cast away const as long as
-            keyDeleter == NULL */
-            data,
-            &err);
-    UCNV_DEBUG_LOG("put", data->staticData->name,data);
+    return NULL;
+}
 
+/*
+ * Acquires a reference to the shared data in a cache slot.
+ * Returns NULL if the slot is empty or being flushed.
+ * Lock-free and wait-free.
+ */
+static UConverterSharedData *
+ucnv_acquireSlotData(SharedDataSlot *slot) {
+    if (slot->refs.fetch_add(1) >= 0) {
+        UConverterSharedData *data = slot->data.load(std::memory_order_acquire);
+        if (data != NULL) {
+            return data;
+        }
+    }
+    slot->refs.fetch_sub(1);
+    return NULL;
 }
 
-/*  Look up a converter name in the shared data cache.                    */
-/*    cnvCacheMutex must be held by the caller to protect the hash table. */
-/* gets the shared data from the SHARED_DATA_HASHTABLE (might return NULL if it isn't there)
- * @param name The name of the shared data
- * @return the shared data from the SHARED_DATA_HASHTABLE
+/*
+ * Looks up a converter name in the shared data cache and
+ * acquires a reference to the shared data if it is there.
+ * Lock-free: Does not need cnvCacheMutex.
  */
 static UConverterSharedData *
 ucnv_getSharedConverterData(const char *name)
 {
-    /*special case when no Table has yet been created we return NULL */
-    if (SHARED_DATA_HASHTABLE == NULL)
-    {
-        return NULL;
+    SharedDataSlot *slot = ucnv_findSharedDataSlot(name);
+    UConverterSharedData *rc = slot != NULL ? ucnv_acquireSlotData(slot) : NULL;
+    UCNV_DEBUG_LOG("get",name,rc);
+    return rc;
+}
+
+/* Puts the shared data into the cache, if possible.                  */
+/*   Will always be called with the cnvCacheMutex already being held  */
+/*     by the calling function.                                       */
+/* Moves the caller's reference from data->referenceCounter into the
+ * cache slot. Leaves the data uncached if it cannot be looked up
+ * by its own name or if the cache is full.
+ * @param data The shared data
+ * @param name The canonical converter name used for lookups
+ */
+static void
+ucnv_shareConverterData(UConverterSharedData * data, const char *name)
+{
+    UErrorCode err = U_ZERO_ERROR;
+
+    if (uprv_strcmp(name, data->staticData->name) != 0 ||
+            uprv_strlen(name) >= UCNV_MAX_CONVERTER_NAME_LENGTH) {
+        return;
     }
-    else
+
+    /*Lazy evaluates the table itself */
+    SharedDataSlot *slots = gSharedDataSlots.load();
+    if (slots == NULL)
     {
-        UConverterSharedData *rc;
+        int32_t count = ucnv_io_countKnownConverters(&err)*UCNV_CACHE_LOAD_FACTOR;
+        if (count < 32) {
+            count = 32;
+        }
+        slots = new SharedDataSlot[count];
+        if (slots == NULL) {
+            return;
+        }
+        ucnv_enableCleanup();
+        gSharedDataSlotCount = count;
+        gSharedDataSlots.store(slots, std::memory_order_release);
+    }
 
-        rc = (UConverterSharedData*)uhash_get(SHARED_DATA_HASHTABLE, name);
-        UCNV_DEBUG_LOG("get",name,rc);
-        return rc;
+    int32_t count = gSharedDataSlotCount;
+    int32_t i = (int32_t)((uint32_t)ustr_hashCharsN(name, (int32_t)uprv_strlen(name)) % (uint32_t)count);
+    for (int32_t probes = 0; probes < count; ++probes) {
+        SharedDataSlot &slot = slots[i];
+        if (!slot.isClaimed.load()) {
+            uprv_strcpy(slot.name, name);
+            slot.isClaimed.store(TRUE, std::memory_order_release);
+        } else if (uprv_strcmp(slot.name, name) != 0) {
+            if (++i == count) {
+                i = 0;
+            }
+            continue;
+        }
+        /* The caller looked up this name, so the slot is empty. */
+        U_ASSERT(slot.data.load() == NULL);
+        data->referenceCounter = 0;
+        data->sharedDataCached = TRUE;
+        slot.refs.fetch_add(1);
+        slot.data.store(data, std::memory_order_release);
+        UCNV_DEBUG_LOG("put", data->staticData->name,data);
+        return;
     }
 }
 
@@ -552,31 +649,39 @@ ucnv_load(UConverterLoadArgs *pArgs, UErrorCode *err) {
         return createConverterFromFile(pArgs, err);
     }
 
+    /* If the data for this converter is already in the cache,  */
+    /* then one more client now holds a reference to it.          */
     mySharedConverterData = ucnv_getSharedConverterData(pArgs->name);
-    if (mySharedConverterData == NULL)
+    if (mySharedConverterData != NULL) {
+        return mySharedConverterData;
+    }
+
+    /*Not cached, we need to stream it in from file */
+    mySharedConverterData = createConverterFromFile(pArgs, err);
+    if (U_FAILURE (*err) || (mySharedConverterData == NULL))
     {
-        /*Not cached, we need to stream it in from file */
-        mySharedConverterData = createConverterFromFile(pArgs, err);
-        if (U_FAILURE (*err) || (mySharedConverterData == NULL))
-        {
-            return NULL;
-        }
-        else if (!pArgs->onlyTestIsLoadable)
-        {
-            /* share it with other library clients */
-            ucnv_shareConverterData(mySharedConverterData);
-        }
+        return NULL;
     }
-    else
+    else if (!pArgs->onlyTestIsLoadable)
     {
-        /* The data for this converter was already in the cache.            */
-        /* Update the reference counter on the shared data: one more client */
-        mySharedConverterData->referenceCounter++;
+        /* share it with other library clients */
+        ucnv_shareConverterData(mySharedConverterData, pArgs->name);
     }
 
     return mySharedConverterData;
 }
 
+/**
+ * Release a reference to cached shared data. Lock-free.
+ * The data stays cached until ucnv_flushCache().
+ */
+static void
+ucnv_releaseCachedSharedData(UConverterSharedData *sharedData) {
+    SharedDataSlot *slot = ucnv_findSharedDataSlot(sharedData->staticData->name);
+    U_ASSERT(slot != NULL && slot->data.load() == sharedData);
+    slot->refs.fetch_sub(1);
+}
+
 /**
  * Unload a non-algorithmic converter.
  * It must be sharedData->isReferenceCounted
@@ -585,6 +690,10 @@ ucnv_load(UConverterLoadArgs *pArgs, UErrorCode *err) {
 U_CAPI void
 ucnv_unload(UConverterSharedData *sharedData) {
     if(sharedData != NULL) {
+        if (sharedData->sharedDataCached) {
+            ucnv_releaseCachedSharedData(sharedData);
+            return;
+        }
         if (sharedData->referenceCounter > 0) {
             sharedData->referenceCounter--;
         }
@@ -599,6 +708,11 @@ U_CFUNC void
 ucnv_unloadSharedDataIfReady(UConverterSharedData *sharedData)
 {
     if(sharedData != NULL && sharedData->isReferenceCounted) {
+        /* The caller's reference keeps cached data cached. */
+        if (sharedData->sharedDataCached) {
+            ucnv_releaseCachedSharedData(sharedData);
+            return;
+        }
         umtx_lock(&cnvCacheMutex);
         ucnv_unload(sharedData);
         umtx_unlock(&cnvCacheMutex);
@@ -609,6 +723,13 @@ U_CFUNC void
 ucnv_incrementRefCount(UConverterSharedData *sharedData)
 {
     if(sharedData != NULL && sharedData->isReferenceCounted) {
+        /* The caller's reference keeps cached data cached. */
+        if (sharedData->sharedDataCached) {
+            SharedDataSlot *slot = ucnv_findSharedDataSlot(sharedData->staticData->name);
+            U_ASSERT(slot != NULL && slot->data.load() == sharedData);
+            slot->refs.fetch_add(1);
+            return;
+        }
         umtx_lock(&cnvCacheMutex);
         sharedData->referenceCounter++;
         umtx_unlock(&cnvCacheMutex);
@@ -805,19 +926,23 @@ ucnv_loadSharedData(const char *converterName,
     if (mySharedConverterData == NULL)
     {
         /* it is a data-based converter, get its shared data.               */
-        /* Hold the cnvCacheMutex through the whole process of checking the */
+        /* Try the cache without locking; if the data is not there,         */
+        /* hold the cnvCacheMutex through the whole process of checking the */
         /*   converter data cache, and adding new entries to the cache      */
         /*   to prevent other threads from modifying the cache during the   */
         /*   process.                                                       */
         pArgs->nestedLoads=1;
         pArgs->pkg=NULL;
 
-        umtx_lock(&cnvCacheMutex);
-        mySharedConverterData = ucnv_load(pArgs, err);
-        umtx_unlock(&cnvCacheMutex);
-        if (U_FAILURE (*err) || (mySharedConverterData == NULL))
-        {
-            return NULL;
+        mySharedConverterData = ucnv_getSharedConverterData(pArgs->name);
+        if (mySharedConverterData == NULL) {
+            umtx_lock(&cnvCacheMutex);
+            mySharedConverterData = ucnv_load(pArgs, err);
+            umtx_unlock(&cnvCacheMutex);
+            if (U_FAILURE (*err) || (mySharedConverterData == NULL))
+            {
+                return NULL;
+            }
         }
     }
 
@@ -1025,41 +1150,257 @@ ucnv_createConverterFromSharedData(UConverter *myUConverter,
     return myUConverter;
 }
 
+/* converter pool ----------------------------------------------------------- */
+
+/*
+ * Converters handed back with ucnv_returnToPool() are kept in a fixed number
+ * of shards, each with its own mutex. Each thread always uses the shard
+ * selected by a hash of its thread ID, without thread-local storage, so that
+ * threads mostly use different mutexes, and none contend for cnvCacheMutex
+ * on a pool hit.
+ * The pool is constant-initialized like UMutex, without static construction.
+ *
+ * Buckets are keyed by the canonical converter name pointer from the alias table.
+ * Each bucket also records the shared data and ucnv_getName() of the converters
+ * it holds, so that a returned converter is only put into a bucket for
+ * the very same converter configuration.
+ *
+ * Pooled converters hold references to their shared data;
+ * ucnv_flushCache() closes them before it looks for unused shared data.
+ */
+
+#define UCNV_POOL_SHARD_COUNT 16
+#define UCNV_POOL_BUCKET_COUNT 8
+#define UCNV_POOL_BUCKET_CAPACITY 8
+
+namespace {
+
+struct ConverterPoolBucket {
+    constexpr ConverterPoolBucket() :
+            aliasName(NULL), sharedData(NULL), cnvName(), count(0), converters() {}
+
+    const char *aliasName;  /* canonical name from ucnv_io_getConverterName() */
+    const UConverterSharedData *sharedData;
+    char cnvName[UCNV_MAX_CONVERTER_NAME_LENGTH];
+    int32_t count;
+    UConverter *converters[UCNV_POOL_BUCKET_CAPACITY];
+};
+
+struct ConverterPoolShard {
+    UMUTEX_CONSTEXPR ConverterPoolShard() :
+            hits(0), misses(0), bucketCount(0), buckets() {}
+
+    icu::UMutex mutex;
+    int64_t hits;
+    int64_t misses;
+    int32_t bucketCount;
+    ConverterPoolBucket buckets[UCNV_POOL_BUCKET_COUNT];
+};
+
+ConverterPoolShard gConverterPool[UCNV_POOL_SHARD_COUNT];
+
+// A thread always maps to the same shard, so that it returns converters where it gets them.
+ConverterPoolShard &
+getPoolShard() {
+    uint64_t id = (uint64_t)std::hash<std::thread::id>()(std::this_thread::get_id());
+    // Thread IDs are often aligned addresses; the multiplication mixes their higher bits down.
+    uint32_t h = (uint32_t)((id * 0x9e3779b97f4a7c15ULL) >> 32);
+    return gConverterPool[h % UCNV_POOL_SHARD_COUNT];
+}
+
+ConverterPoolBucket *
+findPoolBucket(ConverterPoolShard &shard, const char *aliasName) {
+    for (int32_t i = 0; i < shard.bucketCount; ++i) {
+        if (shard.buckets[i].aliasName == aliasName) {
+            return shard.buckets + i;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Is the converter in the state that ucnv_open() returns it in,
+ * apart from the conversion state which ucnv_reset() takes care of?
+ */
+UBool
+isPoolable(const UConverter *cnv) {
+    const UConverterStaticData *staticData = cnv->sharedData->staticData;
+    return
+        !cnv->isCopyLocal &&
+        cnv->fromCharErrorBehaviour == UCNV_TO_U_DEFAULT_CALLBACK &&
+        cnv->fromUCharErrorBehaviour == UCNV_FROM_U_DEFAULT_CALLBACK &&
+        cnv->toUContext == NULL && cnv->fromUContext == NULL &&
+        !cnv->useFallback &&
+        cnv->subChars == (const uint8_t *)cnv->subUChars &&
+        cnv->subCharLen == staticData->subCharLen &&
+        cnv->subChar1 == staticData->subChar1 &&
+        uprv_memcmp(cnv->subChars, staticData->subChar, cnv->subCharLen) == 0;
+}
+
+/* Closes all pooled converters. Must not be called with cnvCacheMutex held. */
+void
+flushConverterPool() {
+    UConverter *toClose[UCNV_POOL_BUCKET_COUNT * UCNV_POOL_BUCKET_CAPACITY];
+    for (int32_t s = 0; s < UCNV_POOL_SHARD_COUNT; ++s) {
+        ConverterPoolShard &shard = gConverterPool[s];
+        int32_t closeCount = 0;
+        {
+            icu::Mutex lock(&shard.mutex);
+            for (int32_t i = 0; i < shard.bucketCount; ++i) {
+                ConverterPoolBucket &bucket = shard.buckets[i];
+                for (int32_t j = 0; j < bucket.count; ++j) {
+                    toClose[closeCount++] = bucket.converters[j];
+                }
+            }
+            shard.bucketCount = 0;
+        }
+        /* ucnv_close() locks cnvCacheMutex; do not hold the shard mutex meanwhile. */
+        for (int32_t i = 0; i < closeCount; ++i) {
+            ucnv_close(toClose[i]);
+        }
+    }
+}
+
+}  // namespace
+
+U_CAPI UConverter * U_EXPORT2
+ucnv_openPooled(const char *name, UErrorCode *err) {
+    if (U_FAILURE(*err)) {
+        return NULL;
+    }
+    ConverterPoolShard &shard = getPoolShard();
+    const char *aliasName = NULL;
+    if (name != NULL && *name != 0 && uprv_strchr(name, UCNV_OPTION_SEP_CHAR) == NULL) {
+        UBool containsOption = FALSE;
+        UErrorCode localErr = U_ZERO_ERROR;
+        aliasName = ucnv_io_getConverterName(name, &containsOption, &localErr);
+        if (U_FAILURE(localErr)) {
+            aliasName = NULL;
+        }
+    }
+    if (aliasName != NULL) {
+        icu::Mutex lock(&shard.mutex);
+        ConverterPoolBucket *bucket = findPoolBucket(shard, aliasName);
+        if (bucket != NULL && bucket->count > 0) {
+            ++shard.hits;
+            return bucket->converters[--bucket->count];
+        }
+    }
+
+    /* Pool miss, or not a poolable name. */
+    UConverter *cnv = ucnv_open(name, err);
+    const char *cnvName = NULL;
+    if (U_SUCCESS(*err) && aliasName != NULL) {
+        UErrorCode localErr = U_ZERO_ERROR;
+        cnvName = ucnv_getName(cnv, &localErr);
+        if (U_FAILURE(localErr) || uprv_strlen(cnvName) >= UCNV_MAX_CONVERTER_NAME_LENGTH) {
+            cnvName = NULL;
+        }
+    }
+    icu::Mutex lock(&shard.mutex);
+    ++shard.misses;
+    if (cnvName != NULL && findPoolBucket(shard, aliasName) == NULL) {
+        /* Add a bucket, or recycle an empty one, so that ucnv_returnToPool() can keep cnv. */
+        ConverterPoolBucket *bucket = NULL;
+        if (shard.bucketCount < UCNV_POOL_BUCKET_COUNT) {
+            bucket = shard.buckets + shard.bucketCount++;
+        } else {
+            for (int32_t i = 0; i < UCNV_POOL_BUCKET_COUNT; ++i) {
+                if (shard.buckets[i].count == 0) {
+                    bucket = shard.buckets + i;
+                    break;
+                }
+            }
+        }
+        if (bucket != NULL) {
+            bucket->aliasName = aliasName;
+            bucket->sharedData = cnv->sharedData;
+            uprv_strcpy(bucket->cnvName, cnvName);
+            bucket->count = 0;
+        }
+    }
+    return cnv;
+}
+
+U_CAPI void U_EXPORT2
+ucnv_returnToPool(UConverter *cnv) {
+    if (cnv == NULL) {
+        return;
+    }
+    if (isPoolable(cnv)) {
+        UErrorCode errorCode = U_ZERO_ERROR;
+        const char *cnvName = ucnv_getName(cnv, &errorCode);
+        if (U_SUCCESS(errorCode)) {
+            /* No callbacks to notify: isPoolable() requires the default ones. */
+            ucnv_reset(cnv);
+            ConverterPoolShard &shard = getPoolShard();
+            icu::Mutex lock(&shard.mutex);
+            for (int32_t i = 0; i < shard.bucketCount; ++i) {
+                ConverterPoolBucket &bucket = shard.buckets[i];
+                if (bucket.sharedData == cnv->sharedData &&
+                        uprv_strcmp(bucket.cnvName, cnvName) == 0) {
+                    if (bucket.count < UCNV_POOL_BUCKET_CAPACITY) {
+                        bucket.converters[bucket.count++] = cnv;
+                        return;
+                    }
+                    break;
+                }
+            }
+        }
+    }
+    ucnv_close(cnv);
+}
+
+U_CAPI void U_EXPORT2
+ucnv_getPoolStatistics(int64_t *pHits, int64_t *pMisses) {
+    int64_t hits = 0, misses = 0;
+    for (int32_t s = 0; s < UCNV_POOL_SHARD_COUNT; ++s) {
+        ConverterPoolShard &shard = gConverterPool[s];
+        icu::Mutex lock(&shard.mutex);
+        hits += shard.hits;
+        misses += shard.misses;
+    }
+    if (pHits != NULL) {
+        *pHits = hits;
+    }
+    if (pMisses != NULL) {
+        *pMisses = misses;
+    }
+}
+
 /*Frees all shared immutable objects that aren't referred to (reference count = 0)
  */
 U_CAPI int32_t U_EXPORT2
 ucnv_flushCache ()
 {
     UConverterSharedData *mySharedData = NULL;
-    int32_t pos;
+    SharedDataSlot *slots;
     int32_t tableDeletedNum = 0;
-    const UHashElement *e;
-    /*UErrorCode status = U_ILLEGAL_ARGUMENT_ERROR;*/
-    int32_t i, remaining;
+    int32_t i, j, remaining;
 
     UTRACE_ENTRY_OC(UTRACE_UCNV_FLUSH_CACHE);
 
     /* Close the default converter without creating a new one so that everything will be flushed. */
     u_flushDefaultConverter();
+    /* Release the references that pooled converters hold on their shared data. */
+    flushConverterPool();
 
     /*if shared data hasn't even been lazy evaluated yet
     * return 0
     */
-    if (SHARED_DATA_HASHTABLE == NULL) {
+    slots = gSharedDataSlots.load();
+    if (slots == NULL) {
         UTRACE_EXIT_VALUE((int32_t)0);
         return 0;
     }
 
-    /*creates an enumeration to iterate through every element in the
-    * table
-    *
+    /*
     * Synchronization:  holding cnvCacheMutex will prevent any other thread from
-    *                   accessing or modifying the hash table during the iteration.
-    *                   The reference count of an entry may be decremented by
-    *                   ucnv_close while the iteration is in process, but this is
-    *                   benign.  It can't be incremented (in ucnv_createConverter())
-    *                   because the sequence of looking up in the cache + incrementing
-    *                   is protected by cnvCacheMutex.
+    *                   adding or removing cache entries during the iteration.
+    *                   Lock-free lookups may change the reference count of an
+    *                   entry at any time, but the compare-and-swap from 0 to
+    *                   UCNV_SLOT_FLUSHING succeeds only if there is no reference,
+    *                   and makes lookups back off until the entry is removed.
     */
     umtx_lock(&cnvCacheMutex);
     /*
@@ -1071,18 +1412,23 @@ ucnv_flushCache ()
     i = 0;
     do {
         remaining = 0;
-        pos = UHASH_FIRST;
-        while ((e = uhash_nextElement (SHARED_DATA_HASHTABLE, &pos)) != NULL)
+        for (j = 0; j < gSharedDataSlotCount; ++j)
         {
-            mySharedData = (UConverterSharedData *) e->value.pointer;
+            SharedDataSlot &slot = slots[j];
+            mySharedData = slot.data.load();
+            if (mySharedData == NULL) {
+                continue;
+            }
             /*deletes only if reference counter == 0 */
-            if (mySharedData->referenceCounter == 0)
+            int32_t expected = 0;
+            if (slot.refs.compare_exchange_strong(expected, UCNV_SLOT_FLUSHING))
             {
                 tableDeletedNum++;
 
                 UCNV_DEBUG_LOG("del",mySharedData->staticData->name,mySharedData);
 
-                uhash_removeElement(SHARED_DATA_HASHTABLE, e);
+                slot.data.store(NULL);
+                slot.refs.fetch_sub(UCNV_SLOT_FLUSHING);
                 mySharedData->sharedDataCached = FALSE;
                 ucnv_deleteSharedConverterData (mySharedData);
             } else {
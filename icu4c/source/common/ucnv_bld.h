@@ -238,6 +238,10 @@ struct UConverter {
 
     /* new fields for ICU 4.0 */
     UConverterCallbackReason toUCallbackReason; /* (*fromCharErrorBehaviour) reason, set when error is detected */
+
+    /* new fields for ICU 69 */
+    const void *directTable;                /* last direct MBCS-to-MBCS table used from this converter */
+    int32_t directTableGeneration;          /* validates directTable, see ucnvmbcs.cpp */
 };
 
 U_CDECL_END /* end of UConverter */
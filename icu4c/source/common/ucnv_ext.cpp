@@ -329,6 +329,36 @@ ucnv_extInitialMatchToU(UConverter *cnv, const int32_t *cx,
     }
 }
 
+/*
+ * Used by ucnv_convertParallel() to find chunk boundaries.
+ * Tests the toUTable sections for all but the initial input byte.
+ */
+U_CFUNC UBool
+ucnv_extIsToUContinuation(const int32_t *cx, uint8_t b) {
+    const uint32_t *toUTable;
+    int32_t i, limit, count;
+
+    if(cx==NULL) {
+        return FALSE;
+    }
+    toUTable=UCNV_EXT_ARRAY(cx, UCNV_EXT_TO_U_INDEX, uint32_t);
+    limit=cx[UCNV_EXT_TO_U_LENGTH];
+    if(limit<=0) {
+        return FALSE;
+    }
+    /* skip the initial section */
+    for(i=1+(int32_t)UCNV_EXT_TO_U_GET_BYTE(toUTable[0]); i<limit; i+=1+count) {
+        int32_t j;
+        count=(int32_t)UCNV_EXT_TO_U_GET_BYTE(toUTable[i]);
+        for(j=1; j<=count && (i+j)<limit; ++j) {
+            if(UCNV_EXT_TO_U_GET_BYTE(toUTable[i+j])==b) {
+                return TRUE;
+            }
+        }
+    }
+    return FALSE;
+}
+
 U_CFUNC UChar32
 ucnv_extSimpleMatchToU(const int32_t *cx,
                        const char *source, int32_t length,
@@ -805,6 +835,33 @@ ucnv_extInitialMatchFromU(UConverter *cnv, const int32_t *cx,
     }
 }
 
+/*
+ * Used by ucnv_convertParallel() to find chunk boundaries.
+ * Conservative: Tests all sections of the fromUTable except for the default UChar
+ * in each section's first entry.
+ */
+U_CFUNC UBool
+ucnv_extIsFromUContinuation(const int32_t *cx, UChar c) {
+    const UChar *fromUTableUChars;
+    int32_t i, limit, count;
+
+    if(cx==NULL) {
+        return FALSE;
+    }
+    fromUTableUChars=UCNV_EXT_ARRAY(cx, UCNV_EXT_FROM_U_UCHARS_INDEX, UChar);
+    limit=cx[UCNV_EXT_FROM_U_LENGTH];
+    for(i=0; i<limit; i+=1+count) {
+        int32_t j;
+        count=fromUTableUChars[i];
+        for(j=1; j<=count && (i+j)<limit; ++j) {
+            if(fromUTableUChars[i+j]==c) {
+                return TRUE;
+            }
+        }
+    }
+    return FALSE;
+}
+
 /*
  * Used by ISO 2022 implementation.
  * @return number of bytes in *pValue; negative number if fallback; 0 for no mapping
@@ -363,6 +363,13 @@ ucnv_extSimpleMatchToU(const int32_t *cx,
                        const char *source, int32_t length,
                        UBool useFallback);
 
+/*
+ * Returns TRUE if byte b can continue a multi-byte toUnicode extension match,
+ * that is, if it occurs at a non-initial position of any mapping input.
+ */
+U_CFUNC UBool
+ucnv_extIsToUContinuation(const int32_t *cx, uint8_t b);
+
 U_CFUNC void
 ucnv_extContinueMatchToU(UConverter *cnv,
                          UConverterToUnicodeArgs *pArgs, int32_t srcIndex,
@@ -378,6 +385,13 @@ ucnv_extInitialMatchFromU(UConverter *cnv, const int32_t *cx,
                           UBool flush,
                           UErrorCode *pErrorCode);
 
+/*
+ * Returns TRUE if c can continue a multi-character fromUnicode extension match,
+ * that is, if it may occur at a non-initial position of a mapping input.
+ */
+U_CFUNC UBool
+ucnv_extIsFromUContinuation(const int32_t *cx, UChar c);
+
 U_CFUNC int32_t
 ucnv_extSimpleMatchFromU(const int32_t *cx,
                          UChar32 cp, uint32_t *pValue,
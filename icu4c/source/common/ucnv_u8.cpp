@@ -33,6 +33,7 @@
 #include "ucnv_cnv.h"
 #include "cmemory.h"
 #include "ustr_imp.h"
+#include "ustr_simd.h"
 
 /* Prototypes --------------------------------------------------------------- */
 
@@ -61,6 +62,155 @@ static UBool hasCESU8Data(const UConverter *cnv)
     return (UBool)(cnv->sharedData == &_CESU8Data);
 #endif
 }
+/*
+ * Bulk conversion of well-formed UTF-8 without converter state.
+ * Converts complete, valid sequences from the source while they fit into the target,
+ * copying ASCII runs in blocks. Stops before any ill-formed or truncated sequence
+ * and before a character that might not fit, leaving those to the stateful loop.
+ * Only for UTF-8, not for CESU-8.
+ * offsets can be NULL; otherwise offsetNum is the source index of *source.
+ */
+static void
+bulkToUnicodeFromUTF8(const uint8_t *&source, const uint8_t *sourceLimit,
+                      UChar *&target, const UChar *targetLimit,
+                      int32_t *&offsets, int32_t &offsetNum) {
+    const uint8_t *src = source;
+    UChar *dest = target;
+    int32_t *destOffsets = offsets;
+    int32_t srcIndex = offsetNum;
+    for (;;) {
+        int32_t srcLength = (int32_t)(sourceLimit - src);
+        int32_t destCapacity = (int32_t)(targetLimit - dest);
+        if (srcLength == 0 || destCapacity == 0) {
+            break;
+        }
+        uint8_t b = *src;
+        if (U8_IS_SINGLE(b)) {
+            int32_t n = uprv_copyASCIIToUChars(dest, src, srcLength < destCapacity ? srcLength : destCapacity);
+            src += n;
+            dest += n;
+            if (destOffsets != NULL) {
+                for (int32_t limit = srcIndex + n; srcIndex < limit;) {
+                    *destOffsets++ = srcIndex++;
+                }
+            }
+            continue;
+        }
+        uint8_t t1, t2, t3;
+        UChar32 c;
+        int32_t length;
+        if (0xe0 <= b && b < 0xf0) {
+            if (srcLength >= 3 && U8_IS_VALID_LEAD3_AND_T1(b, src[1]) &&
+                    (t2 = (uint8_t)(src[2] - 0x80)) <= 0x3f) {
+                c = ((b & 0xf) << 12) | ((src[1] & 0x3f) << 6) | t2;
+                length = 3;
+            } else {
+                break;
+            }
+        } else if (0xc2 <= b && b < 0xe0) {
+            if (srcLength >= 2 && (t1 = (uint8_t)(src[1] - 0x80)) <= 0x3f) {
+                c = ((b & 0x1f) << 6) | t1;
+                length = 2;
+            } else {
+                break;
+            }
+        } else if (0xf0 <= b && b <= 0xf4) {
+            if (destCapacity >= 2 && srcLength >= 4 && U8_IS_VALID_LEAD4_AND_T1(b, src[1]) &&
+                    (t2 = (uint8_t)(src[2] - 0x80)) <= 0x3f &&
+                    (t3 = (uint8_t)(src[3] - 0x80)) <= 0x3f) {
+                c = ((b & 7) << 18) | ((src[1] & 0x3f) << 12) | (t2 << 6) | t3;
+                length = 4;
+            } else {
+                break;
+            }
+        } else {
+            break;
+        }
+        src += length;
+        if (c <= MAXIMUM_UCS2) {
+            *dest++ = (UChar)c;
+            if (destOffsets != NULL) {
+                *destOffsets++ = srcIndex;
+            }
+        } else {
+            *dest++ = U16_LEAD(c);
+            *dest++ = U16_TRAIL(c);
+            if (destOffsets != NULL) {
+                *destOffsets++ = srcIndex;
+                *destOffsets++ = srcIndex;
+            }
+        }
+        srcIndex += length;
+    }
+    source = src;
+    target = dest;
+    offsets = destOffsets;
+    offsetNum = srcIndex;
+}
+
+/*
+ * Bulk conversion of well-formed UTF-16 to UTF-8 without converter state.
+ * Converts code points while there is room for their longest encoding,
+ * copying ASCII runs in blocks. Stops before an unpaired surrogate,
+ * a lead surrogate at the end of the source, and for CESU-8 before any surrogate,
+ * leaving those to the stateful loop.
+ * offsets can be NULL; otherwise offsetNum is the source index of *source.
+ */
+static void
+bulkFromUnicodeToUTF8(const UChar *&source, const UChar *sourceLimit,
+                      uint8_t *&target, const uint8_t *targetLimit,
+                      int32_t *&offsets, int32_t &offsetNum, UBool isNotCESU8) {
+    const UChar *src = source;
+    uint8_t *dest = target;
+    int32_t *destOffsets = offsets;
+    int32_t srcIndex = offsetNum;
+    for (;;) {
+        int32_t srcLength = (int32_t)(sourceLimit - src);
+        int32_t destCapacity = (int32_t)(targetLimit - dest);
+        if (srcLength == 0 || destCapacity == 0) {
+            break;
+        }
+        UChar32 c = *src;
+        if (c < 0x80) {
+            int32_t n = uprv_copyASCIIFromUChars(dest, src, srcLength < destCapacity ? srcLength : destCapacity);
+            src += n;
+            dest += n;
+            if (destOffsets != NULL) {
+                for (int32_t limit = srcIndex + n; srcIndex < limit;) {
+                    *destOffsets++ = srcIndex++;
+                }
+            }
+            continue;
+        }
+        if (destCapacity < 4) {
+            break;
+        }
+        int32_t length = 1;
+        if (U16_IS_SURROGATE(c)) {
+            if (isNotCESU8 && U16_IS_SURROGATE_LEAD(c) && srcLength >= 2 && U16_IS_TRAIL(src[1])) {
+                c = U16_GET_SUPPLEMENTARY(c, src[1]);
+                length = 2;
+            } else {
+                break;
+            }
+        }
+        src += length;
+        int32_t destLength = 0;
+        U8_APPEND_UNSAFE(dest, destLength, c);
+        if (destOffsets != NULL) {
+            for (int32_t j = 0; j < destLength; ++j) {
+                *destOffsets++ = srcIndex;
+            }
+        }
+        dest += destLength;
+        srcIndex += length;
+    }
+    source = src;
+    target = dest;
+    offsets = destOffsets;
+    offsetNum = srcIndex;
+}
+
 U_CDECL_BEGIN
 static void  U_CALLCONV ucnv_toUnicode_UTF8 (UConverterToUnicodeArgs * args,
                                   UErrorCode * err)
@@ -74,6 +224,8 @@ static void  U_CALLCONV ucnv_toUnicode_UTF8 (UConverterToUnicodeArgs * args,
     UBool isCESU8 = hasCESU8Data(cnv);
     uint32_t ch, ch2 = 0;
     int32_t i, inBytes;
+    int32_t *noOffsets = NULL;
+    int32_t offsetNum = 0;
 
     /* Restore size of current sequence */
     if (cnv->toULength > 0 && myTarget < targetLimit)
@@ -90,6 +242,14 @@ static void  U_CALLCONV ucnv_toUnicode_UTF8 (UConverterToUnicodeArgs * args,
 
     while (mySource < sourceLimit && myTarget < targetLimit)
     {
+        if (!isCESU8)
+        {
+            bulkToUnicodeFromUTF8(mySource, sourceLimit, myTarget, targetLimit, noOffsets, offsetNum);
+            if (mySource >= sourceLimit || myTarget >= targetLimit)
+            {
+                break;
+            }
+        }
         ch = *(mySource++);
         if (U8_IS_SINGLE(ch))        /* Simple case */
         {
@@ -202,11 +362,21 @@ static void  U_CALLCONV ucnv_toUnicode_UTF8_OFFSETS_LOGIC (UConverterToUnicodeAr
 
         ch = cnv->toUnicodeStatus;/*Stores the previously calculated ch from a previous call*/
         cnv->toUnicodeStatus = 0;
+        /* The character started in a previous buffer; only inBytes-i of its bytes are in this one. */
+        offsetNum = -i;
         goto morebytes;
     }
 
     while (mySource < sourceLimit && myTarget < targetLimit)
     {
+        if (!isCESU8)
+        {
+            bulkToUnicodeFromUTF8(mySource, sourceLimit, myTarget, targetLimit, myOffsets, offsetNum);
+            if (mySource >= sourceLimit || myTarget >= targetLimit)
+            {
+                break;
+            }
+        }
         ch = *(mySource++);
         if (U8_IS_SINGLE(ch))        /* Simple case */
         {
@@ -246,6 +416,8 @@ static void  U_CALLCONV ucnv_toUnicode_UTF8_OFFSETS_LOGIC (UConverterToUnicodeAr
             // In CESU-8, only surrogates, not supplementary code points, are encoded directly.
             if (i == inBytes && (!isCESU8 || i <= 3))
             {
+                int32_t charOffset = offsetNum >= 0 ? offsetNum : -1;
+
                 /* Remove the accumulated high bits */
                 ch -= offsetsFromUTF8[inBytes];
 
@@ -254,18 +426,18 @@ static void  U_CALLCONV ucnv_toUnicode_UTF8_OFFSETS_LOGIC (UConverterToUnicodeAr
                 {
                     /* fits in 16 bits */
                     *(myTarget++) = (UChar) ch;
-                    *(myOffsets++) = offsetNum;
+                    *(myOffsets++) = charOffset;
                 }
                 else
                 {
                     /* write out the surrogates */
                     *(myTarget++) = U16_LEAD(ch);
-                    *(myOffsets++) = offsetNum;
+                    *(myOffsets++) = charOffset;
                     ch = U16_TRAIL(ch);
                     if (myTarget < targetLimit)
                     {
                         *(myTarget++) = (UChar)ch;
-                        *(myOffsets++) = offsetNum;
+                        *(myOffsets++) = charOffset;
                     }
                     else
                     {
@@ -310,6 +482,8 @@ U_CFUNC void  U_CALLCONV ucnv_fromUnicode_UTF8 (UConverterFromUnicodeArgs * args
     uint8_t tempBuf[4];
     int32_t indexToWrite;
     UBool isNotCESU8 = !hasCESU8Data(cnv);
+    int32_t *noOffsets = NULL;
+    int32_t offsetNum = 0;
 
     if (cnv->fromUChar32 && myTarget < targetLimit)
     {
@@ -320,6 +494,11 @@ U_CFUNC void  U_CALLCONV ucnv_fromUnicode_UTF8 (UConverterFromUnicodeArgs * args
 
     while (mySource < sourceLimit && myTarget < targetLimit)
     {
+        bulkFromUnicodeToUTF8(mySource, sourceLimit, myTarget, targetLimit, noOffsets, offsetNum, isNotCESU8);
+        if (mySource >= sourceLimit || myTarget >= targetLimit)
+        {
+            break;
+        }
         ch = *(mySource++);
 
         if (ch < 0x80)        /* Single byte */
@@ -440,6 +619,11 @@ U_CFUNC void  U_CALLCONV ucnv_fromUnicode_UTF8_OFFSETS_LOGIC (UConverterFromUnic
 
     while (mySource < sourceLimit && myTarget < targetLimit)
     {
+        bulkFromUnicodeToUTF8(mySource, sourceLimit, myTarget, targetLimit, myOffsets, offsetNum, isNotCESU8);
+        if (mySource >= sourceLimit || myTarget >= targetLimit)
+        {
+            break;
+        }
         ch = *(mySource++);
 
         if (ch < 0x80)        /* Single byte */
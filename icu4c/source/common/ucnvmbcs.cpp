@@ -58,8 +58,10 @@
 #include "ucnv_cnv.h"
 #include "cmemory.h"
 #include "cstring.h"
+#include "mutex.h"
 #include "umutex.h"
 #include "ustr_imp.h"
+#include "ustr_simd.h"
 
 /* control optimizations according to the platform */
 #define MBCS_UNROLL_SINGLE_TO_BMP 1
@@ -406,6 +408,48 @@ static const char* U_CALLCONV
 ucnv_MBCSGetName(const UConverter *cnv);
 U_CDECL_END
 
+U_CFUNC UBool
+ucnv_MBCSIsResyncByte(const UConverter *cnv, uint8_t b, UChar *pc) {
+    const UConverterMBCSTable *mbcsTable=&cnv->sharedData->mbcs;
+    const int32_t (*stateTable)[256];
+    int32_t entry, state;
+
+    if( (mbcsTable->outputType&0xff)==MBCS_OUTPUT_2_SISO ||
+        mbcsTable->outputType==MBCS_OUTPUT_DBCS_ONLY
+    ) {
+        return FALSE;
+    }
+    if((cnv->options&UCNV_OPTION_SWAP_LFNL)!=0) {
+        stateTable=(const int32_t (*)[256])mbcsTable->swapLFNLStateTable;
+    } else {
+        stateTable=mbcsTable->stateTable;
+    }
+
+    /* b must be a directly-mapped single byte in the initial state */
+    entry=stateTable[0][b];
+    if( MBCS_ENTRY_IS_TRANSITION(entry) ||
+        MBCS_ENTRY_FINAL_STATE(entry)!=0 ||
+        MBCS_ENTRY_FINAL_ACTION(entry)!=MBCS_STATE_VALID_DIRECT_16
+    ) {
+        return FALSE;
+    }
+    /* b must be illegal in all other states */
+    for(state=1; state<mbcsTable->countStates; ++state) {
+        entry=stateTable[state][b];
+        if( MBCS_ENTRY_IS_TRANSITION(entry) ||
+            MBCS_ENTRY_FINAL_ACTION(entry)!=MBCS_STATE_ILLEGAL
+        ) {
+            return FALSE;
+        }
+    }
+    /* b must not continue an extension mapping */
+    if(ucnv_extIsToUContinuation(mbcsTable->extIndexes, b)) {
+        return FALSE;
+    }
+    *pc=(UChar)MBCS_ENTRY_FINAL_VALUE_16(stateTable[0][b]);
+    return TRUE;
+}
+
 static void U_CALLCONV
 ucnv_MBCSWriteSub(UConverterFromUnicodeArgs *pArgs,
               int32_t offsetIndex,
@@ -420,6 +464,9 @@ ucnv_SBCSFromUTF8(UConverterFromUnicodeArgs *pFromUArgs,
                   UConverterToUnicodeArgs *pToUArgs,
                   UErrorCode *pErrorCode);
 
+static void
+ucnv_MBCSRemoveDirectTables(const UConverterSharedData *sharedData);
+
 static void U_CALLCONV
 ucnv_MBCSGetUnicodeSet(const UConverter *cnv,
                    const USetAdder *sa,
@@ -431,6 +478,11 @@ ucnv_DBCSFromUTF8(UConverterFromUnicodeArgs *pFromUArgs,
                   UConverterToUnicodeArgs *pToUArgs,
                   UErrorCode *pErrorCode);
 
+static void U_CALLCONV
+ucnv_MBCSToUTF8(UConverterFromUnicodeArgs *pFromUArgs,
+                UConverterToUnicodeArgs *pToUArgs,
+                UErrorCode *pErrorCode);
+
 static const UConverterImpl _SBCSUTF8Impl={
     UCNV_MBCS,
 
@@ -453,7 +505,7 @@ static const UConverterImpl _SBCSUTF8Impl={
     NULL,
     ucnv_MBCSGetUnicodeSet,
 
-    NULL,
+    ucnv_MBCSToUTF8,
     ucnv_SBCSFromUTF8
 };
 
@@ -479,7 +531,7 @@ static const UConverterImpl _DBCSUTF8Impl={
     NULL,
     ucnv_MBCSGetUnicodeSet,
 
-    NULL,
+    ucnv_MBCSToUTF8,
     ucnv_DBCSFromUTF8
 };
 
@@ -1892,6 +1944,7 @@ ucnv_MBCSUnload(UConverterSharedData *sharedData) {
     if(mbcsTable->reconstitutedData!=NULL) {
         uprv_free(mbcsTable->reconstitutedData);
     }
+    ucnv_MBCSRemoveDirectTables(sharedData);
 }
 
 static void U_CALLCONV
@@ -5622,6 +5675,501 @@ ucnv_DBCSFromUTF8(UConverterFromUnicodeArgs *pFromUArgs,
     pFromUArgs->target=(char *)target;
 }
 
+/* MBCS-to-UTF-8 conversion functions ------------------------------------- */
+
+/*
+ * Returns the code point for the character starting with the byte that yielded
+ * the initial-state entry, reading further bytes and advancing s past them.
+ * Returns -1 for unassigned, illegal and truncated sequences and for state changes.
+ */
+static UChar32
+getNextCodePointForUTF8(UConverter *cnv, const int32_t (*stateTable)[256], int32_t entry,
+                        const uint8_t *&s, const uint8_t *sourceLimit) {
+    const uint16_t *unicodeCodeUnits=cnv->sharedData->mbcs.unicodeCodeUnits;
+    uint32_t offset=0;
+    UChar32 c;
+    while(MBCS_ENTRY_IS_TRANSITION(entry)) {
+        offset+=MBCS_ENTRY_TRANSITION_OFFSET(entry);
+        if(s==sourceLimit) {
+            return -1; /* truncated */
+        }
+        entry=stateTable[MBCS_ENTRY_TRANSITION_STATE(entry)][*s++];
+    }
+    if(MBCS_ENTRY_FINAL_STATE(entry)!=0) {
+        return -1;
+    }
+    switch(MBCS_ENTRY_FINAL_ACTION(entry)) {
+    case MBCS_STATE_VALID_DIRECT_16:
+    case MBCS_STATE_FALLBACK_DIRECT_16:
+        c=MBCS_ENTRY_FINAL_VALUE_16(entry);
+        break;
+    case MBCS_STATE_VALID_DIRECT_20:
+    case MBCS_STATE_FALLBACK_DIRECT_20:
+        c=0x10000+MBCS_ENTRY_FINAL_VALUE(entry);
+        break;
+    case MBCS_STATE_VALID_16:
+        offset+=MBCS_ENTRY_FINAL_VALUE_16(entry);
+        c=unicodeCodeUnits[offset];
+        if(c==0xfffe) {
+            c=(UChar32)ucnv_MBCSGetFallback(&cnv->sharedData->mbcs, offset);
+        }
+        if(c>=0xfffe) {
+            c=-1; /* unassigned or illegal */
+        }
+        break;
+    case MBCS_STATE_VALID_16_PAIR:
+        offset+=MBCS_ENTRY_FINAL_VALUE_16(entry);
+        c=unicodeCodeUnits[offset++];
+        if(c<0xd800) {
+            /* BMP code point below 0xd800 */
+        } else if(c<=0xdfff) {
+            /* roundtrip or fallback supplementary code point */
+            c=U16_GET_SUPPLEMENTARY(c&0xdbff, unicodeCodeUnits[offset]);
+        } else if((c&0xfffe)==0xe000) {
+            /* roundtrip or fallback BMP code point above 0xd800 */
+            c=unicodeCodeUnits[offset];
+        } else {
+            c=-1;
+        }
+        break;
+    default:
+        c=-1;
+        break;
+    }
+    return c;
+}
+
+/*
+ * Writes UTF-8 directly from the toUnicode state table, for stateless codepages
+ * (the SBCS and DBCS/MBCS_OUTPUT_2 tables with the utf8Friendly implementations).
+ * Uses toUnicode fallbacks like ucnv_MBCSToUnicodeWithOffsets().
+ * Unassigned and illegal sequences (including extension mappings),
+ * truncated input, and partial UTF-8 output at the end of the target
+ * are handled by pivoting.
+ */
+static void U_CALLCONV
+ucnv_MBCSToUTF8(UConverterFromUnicodeArgs *pFromUArgs,
+                UConverterToUnicodeArgs *pToUArgs,
+                UErrorCode *pErrorCode) {
+    UConverter *cnv=pToUArgs->converter;
+    const uint8_t *source=(const uint8_t *)pToUArgs->source;
+    const uint8_t *sourceLimit=(const uint8_t *)pToUArgs->sourceLimit;
+    uint8_t *target=(uint8_t *)pFromUArgs->target;
+    const uint8_t *targetLimit=(const uint8_t *)pFromUArgs->targetLimit;
+
+    const int32_t (*stateTable)[256];
+    const uint16_t *unicodeCodeUnits=cnv->sharedData->mbcs.unicodeCodeUnits;
+
+    /* pivot to continue a partial character on either side */
+    if( cnv->toULength>0 || (uint8_t)cnv->mode!=0 || cnv->sharedData->mbcs.dbcsOnlyState!=0 ||
+        pFromUArgs->converter->fromUChar32!=0
+    ) {
+        *pErrorCode=U_USING_DEFAULT_WARNING;
+        return;
+    }
+    if((cnv->options&UCNV_OPTION_SWAP_LFNL)!=0) {
+        stateTable=(const int32_t (*)[256])cnv->sharedData->mbcs.swapLFNLStateTable;
+    } else {
+        stateTable=cnv->sharedData->mbcs.stateTable;
+    }
+
+    /* copy runs of ASCII bytes if they all map to U+0000..U+007F */
+    UBool asciiIdentity=
+        cnv->sharedData->mbcs.asciiRoundtrips==0xffffffff &&
+        stateTable==cnv->sharedData->mbcs.stateTable;
+
+    /*
+     * For long SBCS input, precompute up to three UTF-8 bytes for each
+     * directly-mapped non-ASCII byte, with the length in the fourth byte
+     * (0 for bytes handled otherwise).
+     * Output is written with one 4-byte copy while there is enough room.
+     */
+    if(cnv->sharedData->mbcs.countStates==1 && (sourceLimit-source)>=1024) {
+        uint8_t utf8Bytes[256][4];
+        int32_t b;
+        for(b=0; b<=0xff; ++b) {
+            int32_t entry=stateTable[0][b];
+            UChar32 c=MBCS_ENTRY_FINAL_VALUE_16(entry);
+            int32_t length=0;
+            if( MBCS_ENTRY_FINAL_IS_VALID_DIRECT_16(entry) &&
+                !(c<=0x7f && asciiIdentity) && !U_IS_SURROGATE(c)
+            ) {
+                U8_APPEND_UNSAFE(utf8Bytes[b], length, c);
+            }
+            utf8Bytes[b][3]=(uint8_t)length;
+        }
+        while(source<sourceLimit && (targetLimit-target)>=4) {
+            const uint8_t *bytes=utf8Bytes[*source];
+            if(bytes[3]!=0) {
+                uprv_memcpy(target, bytes, 4);
+                target+=bytes[3];
+                ++source;
+            } else if(asciiIdentity && *source<=0x7f) {
+                int32_t length=(int32_t)(sourceLimit-source);
+                if(length>(targetLimit-target)) {
+                    length=(int32_t)(targetLimit-target);
+                }
+                length=uprv_asciiSpan(source, length);
+                uprv_memcpy(target, source, length);
+                source+=length;
+                target+=length;
+            } else {
+                break;  /* handled by the general loop */
+            }
+        }
+    }
+
+    while(source<sourceLimit) {
+        if(target>=targetLimit) {
+            /* target is full */
+            *pErrorCode=U_BUFFER_OVERFLOW_ERROR;
+            break;
+        }
+
+        const uint8_t *s=source;
+        int32_t entry=stateTable[0][*s++], entry2;
+        UChar32 c;
+        if(MBCS_ENTRY_FINAL_IS_VALID_DIRECT_16(entry)) {
+            c=MBCS_ENTRY_FINAL_VALUE_16(entry);
+            if(c<=0x7f) {
+                if(asciiIdentity) {
+                    int32_t length=(int32_t)(sourceLimit-source);
+                    if(length>(targetLimit-target)) {
+                        length=(int32_t)(targetLimit-target);
+                    }
+                    length=uprv_asciiSpan(source, length);
+                    uprv_memcpy(target, source, length);
+                    source+=length;
+                    target+=length;
+                } else {
+                    *target++=(uint8_t)c;
+                    source=s;
+                }
+                continue;
+            }
+        } else if(
+            MBCS_ENTRY_IS_TRANSITION(entry) && s<sourceLimit &&
+            (entry2=stateTable[MBCS_ENTRY_TRANSITION_STATE(entry)][*s],
+             MBCS_ENTRY_IS_FINAL(entry2)) &&
+            MBCS_ENTRY_FINAL_STATE(entry2)==0 &&
+            MBCS_ENTRY_FINAL_ACTION(entry2)==MBCS_STATE_VALID_16 &&
+            (c=unicodeCodeUnits[MBCS_ENTRY_TRANSITION_OFFSET(entry)+MBCS_ENTRY_FINAL_VALUE_16(entry2)])<0xfffe
+        ) {
+            /* common two-byte BMP mapping */
+            ++s;
+        } else {
+            c=getNextCodePointForUTF8(cnv, stateTable, entry, s, sourceLimit);
+        }
+        if(c<0 || U_IS_SURROGATE(c)) {
+            /* unassigned, illegal, or not a complete character */
+            *pErrorCode=U_USING_DEFAULT_WARNING;
+            break;
+        }
+
+        /* write the UTF-8 bytes */
+        int32_t length=U8_LENGTH(c);
+        if(length<=(targetLimit-target)) {
+            int32_t i=0;
+            U8_APPEND_UNSAFE(target, i, c);
+            target+=length;
+        } else {
+            /* pivot so that the rest of the character goes into the overflow buffer */
+            *pErrorCode=U_USING_DEFAULT_WARNING;
+            break;
+        }
+        source=s;
+    }
+
+    /* write back the updated pointers */
+    pToUArgs->source=(const char *)source;
+    pFromUArgs->target=(char *)target;
+}
+
+/* MBCS-to-MBCS conversion functions --------------------------------------- */
+
+/*
+ * Direct conversion between two table-based MBCS converters uses a table
+ * of the target bytes for every one- and two-byte source sequence
+ * that has a roundtrip mapping to a BMP code point in the source table,
+ * which in turn has a roundtrip mapping in the target base table.
+ * Everything else (fallbacks, extension mappings, longer sequences,
+ * supplementary code points, errors) falls back to pivoting.
+ *
+ * The tables are built on first use and cached per pair of shared data objects.
+ * A table is removed when either of its shared data objects is unloaded;
+ * the table itself does not hold references, which avoids keeping
+ * each other's converter data alive.
+ *
+ * The source converter remembers the last table it used, so that conversion
+ * calls normally do not need the global mutex. The remembered pointer is
+ * only used while gMBCSDirectGeneration is unchanged, that is, while no table
+ * has been removed since. A table that is in use cannot be removed because
+ * both the source and target converters hold references to their shared data.
+ */
+struct MBCSDirectTable {
+    MBCSDirectTable *next;
+    const UConverterSharedData *source;
+    const UConverterSharedData *target;
+    /*
+     * Indexed by a single byte or by (lead<<8)|trail.
+     * Value (length<<16)|bytes with length 1 or 2, or 0 if not direct.
+     */
+    uint32_t results[0x10000];
+};
+
+static MBCSDirectTable *gMBCSDirectTables=NULL;
+static icu::UMutex gMBCSDirectMutex;
+/* incremented when tables are removed; starts at 1 so that 0 in a new converter never matches */
+static icu::u_atomic_int32_t gMBCSDirectGeneration(1);
+
+static void
+ucnv_MBCSRemoveDirectTables(const UConverterSharedData *sharedData) {
+    icu::Mutex lock(&gMBCSDirectMutex);
+    MBCSDirectTable **pNext=&gMBCSDirectTables;
+    MBCSDirectTable *table;
+    while((table=*pNext)!=NULL) {
+        if(table->source==sharedData || table->target==sharedData) {
+            *pNext=table->next;
+            icu::umtx_atomic_inc(&gMBCSDirectGeneration);
+            uprv_free(table);
+        } else {
+            pNext=&table->next;
+        }
+    }
+}
+
+/*
+ * Returns the roundtrip base-table mapping of c as (length<<16)|bytes
+ * for one or two target bytes, or 0.
+ * Same lookup as in ucnv_MBCSFromUChar32() but without fallbacks and extensions.
+ */
+static uint32_t
+getDirectFromU(const UConverterMBCSTable *mbcs, UChar c) {
+    const uint16_t *table=mbcs->fromUnicodeTable;
+    uint32_t stage2Entry, value;
+
+    if(mbcs->outputType==MBCS_OUTPUT_1) {
+        value=MBCS_SINGLE_RESULT_FROM_U(table, (const uint16_t *)mbcs->fromUnicodeBytes, c);
+        return value>=0xc00 ? 0x10000|(value&0xff) : 0;
+    }
+    stage2Entry=MBCS_STAGE_2_FROM_U(table, c);
+    if(!MBCS_FROM_U_IS_ROUNDTRIP(stage2Entry, c)) {
+        return 0;
+    }
+    switch(mbcs->outputType) {
+    case MBCS_OUTPUT_2:
+        value=MBCS_VALUE_2_FROM_STAGE_2(mbcs->fromUnicodeBytes, stage2Entry, c);
+        break;
+    case MBCS_OUTPUT_3_EUC:
+        value=MBCS_VALUE_2_FROM_STAGE_2(mbcs->fromUnicodeBytes, stage2Entry, c);
+        if(value>0xff && ((value&0x8000)==0 || (value&0x80)==0)) {
+            return 0; /* three-byte EUC sequence */
+        }
+        break;
+    case MBCS_OUTPUT_4:
+        value=MBCS_VALUE_4_FROM_STAGE_2(mbcs->fromUnicodeBytes, stage2Entry, c);
+        if(value>0xffff) {
+            return 0;
+        }
+        break;
+    default:
+        return 0;
+    }
+    return value<=0xff ? 0x10000|value : 0x20000|value;
+}
+
+/* Returns the roundtrip BMP code point for a final toUnicode entry, or 0xffff. */
+static UChar
+getDirectToU(const UConverterMBCSTable *mbcs, int32_t entry, uint32_t offset) {
+    UChar c;
+    if(MBCS_ENTRY_FINAL_STATE(entry)!=0) {
+        return 0xffff;
+    }
+    switch(MBCS_ENTRY_FINAL_ACTION(entry)) {
+    case MBCS_STATE_VALID_DIRECT_16:
+        c=(UChar)MBCS_ENTRY_FINAL_VALUE_16(entry);
+        break;
+    case MBCS_STATE_VALID_16:
+        c=mbcs->unicodeCodeUnits[offset+MBCS_ENTRY_FINAL_VALUE_16(entry)];
+        break;
+    default:
+        return 0xffff;
+    }
+    /* 0xfffe=unassigned or fallback, 0xffff=illegal */
+    return U16_IS_SURROGATE(c) ? 0xffff : c;
+}
+
+static MBCSDirectTable *
+buildDirectTable(const UConverterSharedData *source, const UConverterSharedData *target) {
+    const UConverterMBCSTable *srcMBCS=&source->mbcs;
+    const int32_t (*stateTable)[256]=srcMBCS->stateTable;
+    MBCSDirectTable *table;
+    int32_t entry, entry2;
+    int32_t b, t;
+    UChar c;
+
+    if(MBCS_ENTRY_IS_TRANSITION(stateTable[0][0])) {
+        return NULL; /* single bytes and (lead<<8)|trail would overlap */
+    }
+    table=(MBCSDirectTable *)uprv_malloc(sizeof(MBCSDirectTable));
+    if(table==NULL) {
+        return NULL;
+    }
+    uprv_memset(table->results, 0, sizeof(table->results));
+    table->source=source;
+    table->target=target;
+    for(b=0; b<=0xff; ++b) {
+        entry=stateTable[0][b];
+        if(MBCS_ENTRY_IS_FINAL(entry)) {
+            c=getDirectToU(srcMBCS, entry, 0);
+            if(c<0xfffe) {
+                table->results[b]=getDirectFromU(&target->mbcs, c);
+            }
+        } else {
+            const int32_t *trailRow=stateTable[MBCS_ENTRY_TRANSITION_STATE(entry)];
+            uint32_t offset=MBCS_ENTRY_TRANSITION_OFFSET(entry);
+            for(t=0; t<=0xff; ++t) {
+                entry2=trailRow[t];
+                if(MBCS_ENTRY_IS_FINAL(entry2)) {
+                    c=getDirectToU(srcMBCS, entry2, offset);
+                    if(c<0xfffe) {
+                        table->results[(b<<8)|t]=getDirectFromU(&target->mbcs, c);
+                    }
+                }
+            }
+        }
+    }
+    return table;
+}
+
+static const MBCSDirectTable *
+getDirectTable(const UConverterSharedData *source, const UConverterSharedData *target) {
+    MBCSDirectTable *table;
+    {
+        icu::Mutex lock(&gMBCSDirectMutex);
+        for(table=gMBCSDirectTables; table!=NULL; table=table->next) {
+            if(table->source==source && table->target==target) {
+                return table;
+            }
+        }
+    }
+    /* Build outside of the lock; another thread might race to build the same table. */
+    MBCSDirectTable *newTable=buildDirectTable(source, target);
+    if(newTable==NULL) {
+        return NULL;
+    }
+    icu::Mutex lock(&gMBCSDirectMutex);
+    for(table=gMBCSDirectTables; table!=NULL; table=table->next) {
+        if(table->source==source && table->target==target) {
+            uprv_free(newTable);
+            return table;
+        }
+    }
+    newTable->next=gMBCSDirectTables;
+    gMBCSDirectTables=newTable;
+    return newTable;
+}
+
+/* Returns the direct table for cnv and target, remembered in cnv if still valid. */
+static const MBCSDirectTable *
+getConverterDirectTable(UConverter *cnv, const UConverterSharedData *target) {
+    int32_t generation=icu::umtx_loadAcquire(gMBCSDirectGeneration);
+    const MBCSDirectTable *table=(const MBCSDirectTable *)cnv->directTable;
+    if(table!=NULL && cnv->directTableGeneration==generation && table->target==target) {
+        return table;
+    }
+    table=getDirectTable(cnv->sharedData, target);
+    cnv->directTable=table;
+    cnv->directTableGeneration=generation;
+    return table;
+}
+
+U_CFUNC UBool
+ucnv_MBCSCanConvertDirect(const UConverter *targetCnv, const UConverter *sourceCnv) {
+    const UConverterSharedData *source=sourceCnv->sharedData;
+    const UConverterSharedData *target=targetCnv->sharedData;
+    if(source->impl->type!=UCNV_MBCS || target->impl->type!=UCNV_MBCS) {
+        return FALSE;
+    }
+    if(((sourceCnv->options|targetCnv->options)&UCNV_OPTION_SWAP_LFNL)!=0) {
+        return FALSE;
+    }
+    /* stateless source: no SI/SO, and a toUnicode state table (not extension-only) */
+    uint8_t outputType=source->mbcs.outputType;
+    if( outputType==MBCS_OUTPUT_2_SISO || outputType==MBCS_OUTPUT_DBCS_ONLY ||
+        outputType==MBCS_OUTPUT_EXT_ONLY || source->mbcs.countStates==0
+    ) {
+        return FALSE;
+    }
+    outputType=target->mbcs.outputType;
+    return outputType==MBCS_OUTPUT_1 || outputType==MBCS_OUTPUT_2 ||
+           outputType==MBCS_OUTPUT_3_EUC || outputType==MBCS_OUTPUT_4;
+}
+
+U_CFUNC void U_CALLCONV
+ucnv_MBCSToMBCS(UConverterFromUnicodeArgs *pFromUArgs,
+                UConverterToUnicodeArgs *pToUArgs,
+                UErrorCode *pErrorCode) {
+    UConverter *cnv=pToUArgs->converter;
+    const uint8_t *source=(const uint8_t *)pToUArgs->source;
+    const uint8_t *sourceLimit=(const uint8_t *)pToUArgs->sourceLimit;
+    uint8_t *target=(uint8_t *)pFromUArgs->target;
+    const uint8_t *targetLimit=(const uint8_t *)pFromUArgs->targetLimit;
+
+    /* pivot for a partial character on either side */
+    const MBCSDirectTable *table;
+    if( cnv->toULength>0 || pFromUArgs->converter->fromUChar32!=0 ||
+        (table=getConverterDirectTable(cnv, pFromUArgs->converter->sharedData))==NULL
+    ) {
+        *pErrorCode=U_USING_DEFAULT_WARNING;
+        return;
+    }
+    const int32_t *stateZero=cnv->sharedData->mbcs.stateTable[0];
+    const uint32_t *results=table->results;
+
+    while(source<sourceLimit) {
+        if(target>=targetLimit) {
+            /* target is full */
+            *pErrorCode=U_BUFFER_OVERFLOW_ERROR;
+            break;
+        }
+        uint8_t b=*source;
+        uint32_t value;
+        int32_t length;
+        if(MBCS_ENTRY_IS_FINAL(stateZero[b])) {
+            value=results[b];
+            length=1;
+        } else if((sourceLimit-source)>=2) {
+            value=results[((uint32_t)b<<8)|source[1]];
+            length=2;
+        } else {
+            value=0; /* truncated sequence at the end of the input */
+            length=0;
+        }
+        if(value==0) {
+            /* not direct: pivot for error handling and for non-trivial mappings */
+            *pErrorCode=U_USING_DEFAULT_WARNING;
+            break;
+        }
+        if(value<0x20000) {
+            *target++=(uint8_t)value;
+        } else if((targetLimit-target)>=2) {
+            target[0]=(uint8_t)(value>>8);
+            target[1]=(uint8_t)value;
+            target+=2;
+        } else {
+            /* pivot so that the second byte goes into the overflow buffer */
+            *pErrorCode=U_USING_DEFAULT_WARNING;
+            break;
+        }
+        source+=length;
+    }
+
+    /* write back the updated pointers */
+    pToUArgs->source=(const char *)source;
+    pFromUArgs->target=(char *)target;
+}
+
 /* miscellaneous ------------------------------------------------------------ */
 
 static void U_CALLCONV
@@ -522,6 +522,38 @@ ucnv_MBCSSingleSimpleGetNextUChar(UConverterSharedData *sharedData,
 U_CFUNC UBool
 ucnv_MBCSIsLeadByte(UConverterSharedData *sharedData, char byte);
 
+/**
+ * Internal function for ucnv_convertParallel():
+ * Returns TRUE if toUnicode conversion can restart in the initial state
+ * before byte b with the same results as continuing through it.
+ * That is the case if b is a directly-mapped single byte in the initial state,
+ * illegal in all other states, and does not continue any extension mapping.
+ * Returns FALSE for SI/SO-stateful tables.
+ * If TRUE, then *pc is set to the code point for b.
+ */
+U_CFUNC UBool
+ucnv_MBCSIsResyncByte(const UConverter *cnv, uint8_t b, UChar *pc);
+
+/**
+ * Internal function for ucnv_convertEx():
+ * Returns TRUE if ucnv_MBCSToMBCS() can be used for converting
+ * from sourceCnv to targetCnv without pivoting through UTF-16.
+ */
+U_CFUNC UBool
+ucnv_MBCSCanConvertDirect(const UConverter *targetCnv, const UConverter *sourceCnv);
+
+/**
+ * Direct conversion between two stateless MBCS converters,
+ * with the UConverterConvert signature of the UTF-8 conversion functions.
+ * Converts characters that have roundtrip mappings in both base tables
+ * and returns with U_USING_DEFAULT_WARNING for anything else,
+ * which is then handled by pivoting.
+ */
+U_CFUNC void U_CALLCONV
+ucnv_MBCSToMBCS(UConverterFromUnicodeArgs *pFromUArgs,
+                UConverterToUnicodeArgs *pToUArgs,
+                UErrorCode *pErrorCode);
+
 /** This is a macro version of _MBCSIsLeadByte(). */
 #define _MBCS_IS_LEAD_BYTE(sharedData, byte) \
     (UBool)MBCS_ENTRY_IS_TRANSITION((sharedData)->mbcs.stateTable[0][(uint8_t)(byte)])
@@ -37,6 +37,8 @@
 #include "unicode/ucnv.h"
 #include "unicode/ustring.h"
 #include "unicode/uchriter.h"
+#include "unicode/ucptrie.h"
+#include "unicode/umutablecptrie.h"
 #include "utrie2.h"
 #include "propsvec.h"
 #include "uassert.h"
@@ -49,7 +51,9 @@
 U_NAMESPACE_USE
 
 struct UConverterSelector {
-  UTrie2 *trie;              // 16 bit trie containing offsets into pv
+  UTrie2 *trie;              // 16 bit trie containing offsets into pv, for serialization
+  UCPTrie *cpTrie;           // the same data, used for selection
+  int32_t asciiPvIndex;      // offset into pv shared by all of ASCII, or -1 if they differ
   uint32_t* pv;              // table of bits!
   int32_t pvCount;
   char** encodings;          // which encodings did user ask to use?
@@ -145,6 +149,53 @@ static void generateSelectorData(UConverterSelector* result,
   result->ownPv = TRUE;
 }
 
+struct CopyTrieContext {
+  UMutableCPTrie *trie;
+  UErrorCode status;
+};
+
+U_CDECL_BEGIN
+static UBool U_CALLCONV
+copyTrieRange(const void *context, UChar32 start, UChar32 end, uint32_t value) {
+  CopyTrieContext *ctx = static_cast<CopyTrieContext *>(const_cast<void *>(context));
+  umutablecptrie_setRange(ctx->trie, start, end, value, &ctx->status);
+  return U_SUCCESS(ctx->status);
+}
+U_CDECL_END
+
+// Build the UCPTrie used for selection from the UTrie2,
+// which remains the serialized form.
+static void buildSelectionTrie(UConverterSelector* sel, UErrorCode* status) {
+  if (U_FAILURE(*status)) {
+    return;
+  }
+  LocalUMutableCPTriePointer mutableTrie(
+    umutablecptrie_open(sel->trie->initialValue, sel->trie->errorValue, status));
+  if (U_FAILURE(*status)) {
+    return;
+  }
+  CopyTrieContext context = { mutableTrie.getAlias(), U_ZERO_ERROR };
+  utrie2_enum(sel->trie, NULL, copyTrieRange, &context);
+  if (U_FAILURE(context.status)) {
+    *status = context.status;
+    return;
+  }
+  sel->cpTrie = umutablecptrie_buildImmutable(mutableTrie.getAlias(), UCPTRIE_TYPE_FAST,
+                                              UCPTRIE_VALUE_BITS_16, status);
+  if (U_FAILURE(*status)) {
+    return;
+  }
+  // Most selectors map all of ASCII to the same bit vector,
+  // which allows skipping over runs of ASCII without lookups.
+  sel->asciiPvIndex = UCPTRIE_ASCII_GET(sel->cpTrie, UCPTRIE_16, 0);
+  for (UChar32 c = 1; c < 0x80; ++c) {
+    if (UCPTRIE_ASCII_GET(sel->cpTrie, UCPTRIE_16, c) != sel->asciiPvIndex) {
+      sel->asciiPvIndex = -1;
+      break;
+    }
+  }
+}
+
 /* open a selector. If converterListSize is 0, build for all converters.
    If excludedCodePoints is NULL, don't exclude any codepoints */
 U_CAPI UConverterSelector* U_EXPORT2
@@ -217,6 +268,7 @@ ucnvsel_open(const char* const*  converterList, int32_t converterListSize,
   UPropsVectors *upvec = upvec_open((converterListSize+31)/32, status);
   generateSelectorData(newSelector.getAlias(), upvec, excludedCodePoints, whichSet, status);
   upvec_close(upvec);
+  buildSelectionTrie(newSelector.getAlias(), status);
 
   if (U_FAILURE(*status)) {
     return NULL;
@@ -239,6 +291,7 @@ ucnvsel_close(UConverterSelector *sel) {
     uprv_free(sel->pv);
   }
   utrie2_close(sel->trie);
+  ucptrie_close(sel->cpTrie);
   uprv_free(sel->swapped);
   uprv_free(sel);
 }
@@ -585,6 +638,11 @@ ucnvsel_openFromSerialized(const void* buffer, int32_t length, UErrorCode* statu
   }
   p += sel->encodingStrLength;
 
+  buildSelectionTrie(sel, status);
+  if (U_FAILURE(*status)) {
+    ucnvsel_close(sel);
+    return NULL;
+  }
   return sel;
 }
 
@@ -738,6 +796,87 @@ static UEnumeration *selectForMask(const UConverterSelector* sel,
   return en.orphan();
 }
 
+// internal fn to compute the mask for a UTF-16 string
+static void selectMaskForString(const UConverterSelector* sel,
+                                const UChar *s, int32_t length,
+                                uint32_t *mask, int32_t columns) {
+  uprv_memset(mask, ~0, columns * 4);
+  if (s == NULL) {
+    return;
+  }
+  if (length < 0) {
+    length = u_strlen(s);
+  }
+  const UChar *limit = s + length;
+  const UCPTrie *trie = sel->cpTrie;
+  int32_t prevPvIndex = -1;
+  while (s != limit) {
+    uint16_t pvIndex;
+    if (sel->asciiPvIndex >= 0 && *s < 0x80) {
+      // skip the whole ASCII run
+      do {
+        ++s;
+      } while (s != limit && *s < 0x80);
+      pvIndex = static_cast<uint16_t>(sel->asciiPvIndex);
+    } else {
+      UChar32 c;
+      UCPTRIE_FAST_U16_NEXT(trie, UCPTRIE_16, s, limit, c, pvIndex);
+      if (U_IS_SURROGATE(c)) {
+        // Unpaired surrogate: Not the error value.
+        // As with UTRIE2_U16_NEXT16(), a lead surrogate gets the UTrie2 value
+        // for the lead code unit, and a trail surrogate the one for its code point.
+        if (U16_IS_LEAD(c)) {
+          pvIndex = UTRIE2_GET16_FROM_U16_SINGLE_LEAD(sel->trie, c);
+        } else {
+          pvIndex = static_cast<uint16_t>(ucptrie_get(trie, c));
+        }
+      }
+    }
+    // consecutive characters often share a bit vector
+    if (pvIndex != prevPvIndex) {
+      if (intersectMasks(mask, sel->pv+pvIndex, columns)) {
+        break;
+      }
+      prevPvIndex = pvIndex;
+    }
+  }
+}
+
+// internal fn to compute the mask for a UTF-8 string
+static void selectMaskForUTF8(const UConverterSelector* sel,
+                              const char *s, int32_t length,
+                              uint32_t *mask, int32_t columns) {
+  uprv_memset(mask, ~0, columns * 4);
+  if (s == NULL) {
+    return;
+  }
+  if (length < 0) {
+    length = (int32_t)uprv_strlen(s);
+  }
+  const char *limit = s + length;
+  const UCPTrie *trie = sel->cpTrie;
+  int32_t prevPvIndex = -1;
+  while (s != limit) {
+    uint16_t pvIndex;
+    if (sel->asciiPvIndex >= 0 && U8_IS_SINGLE(*s)) {
+      // skip the whole ASCII run
+      do {
+        ++s;
+      } while (s != limit && U8_IS_SINGLE(*s));
+      pvIndex = static_cast<uint16_t>(sel->asciiPvIndex);
+    } else {
+      UCPTRIE_FAST_U8_NEXT(trie, UCPTRIE_16, s, limit, pvIndex);
+    }
+    // consecutive characters often share a bit vector
+    if (pvIndex != prevPvIndex) {
+      if (intersectMasks(mask, sel->pv+pvIndex, columns)) {
+        break;
+      }
+      prevPvIndex = pvIndex;
+    }
+  }
+}
+
 /* check a string against the selector - UTF16 version */
 U_CAPI UEnumeration * U_EXPORT2
 ucnvsel_selectForString(const UConverterSelector* sel,
@@ -758,25 +897,7 @@ ucnvsel_selectForString(const UConverterSelector* sel,
     *status = U_MEMORY_ALLOCATION_ERROR;
     return NULL;
   }
-  uprv_memset(mask, ~0, columns *4);
-
-  if(s!=NULL) {
-    const UChar *limit;
-    if (length >= 0) {
-      limit = s + length;
-    } else {
-      limit = NULL;
-    }
-    
-    while (limit == NULL ? *s != 0 : s != limit) {
-      UChar32 c;
-      uint16_t pvIndex;
-      UTRIE2_U16_NEXT16(sel->trie, s, limit, c, pvIndex);
-      if (intersectMasks(mask, sel->pv+pvIndex, columns)) {
-        break;
-      }
-    }
-  }
+  selectMaskForString(sel, s, length, mask, columns);
   return selectForMask(sel, mask, status);
 }
 
@@ -800,24 +921,106 @@ ucnvsel_selectForUTF8(const UConverterSelector* sel,
     *status = U_MEMORY_ALLOCATION_ERROR;
     return NULL;
   }
-  uprv_memset(mask, ~0, columns *4);
+  selectMaskForUTF8(sel, s, length, mask, columns);
+  return selectForMask(sel, mask, status);
+}
 
-  if (length < 0) {
-    length = (int32_t)uprv_strlen(s);
+U_CAPI int32_t U_EXPORT2
+ucnvsel_countEncodings(const UConverterSelector* sel, UErrorCode *status) {
+  if (U_FAILURE(*status)) {
+    return 0;
   }
+  if (sel == NULL) {
+    *status = U_ILLEGAL_ARGUMENT_ERROR;
+    return 0;
+  }
+  return sel->encodingsCount;
+}
 
-  if(s!=NULL) {
-    const char *limit = s + length;
-    
-    while (s != limit) {
-      uint16_t pvIndex;
-      UTRIE2_U8_NEXT16(sel->trie, s, limit, pvIndex);
-      if (intersectMasks(mask, sel->pv+pvIndex, columns)) {
-        break;
-      }
+U_CAPI const char * U_EXPORT2
+ucnvsel_getEncodingName(const UConverterSelector* sel, int32_t index, UErrorCode *status) {
+  if (U_FAILURE(*status)) {
+    return NULL;
+  }
+  if (sel == NULL) {
+    *status = U_ILLEGAL_ARGUMENT_ERROR;
+    return NULL;
+  }
+  if (index < 0 || sel->encodingsCount <= index) {
+    *status = U_INDEX_OUTOFBOUNDS_ERROR;
+    return NULL;
+  }
+  return sel->encodings[index];
+}
+
+// internal fn to check the batch arguments
+// returns the number of columns per mask, or 0 if the masks are not to be written
+static int32_t checkBatchArgs(const UConverterSelector* sel,
+                              const void *strings, int32_t count,
+                              uint32_t *masks, int32_t masksCapacity,
+                              int32_t &masksLength, UErrorCode *status) {
+  masksLength = 0;
+  if (U_FAILURE(*status)) {
+    return 0;
+  }
+  if (sel == NULL || count < 0 || (strings == NULL && count != 0) ||
+      masksCapacity < 0 || (masks == NULL && masksCapacity != 0)) {
+    *status = U_ILLEGAL_ARGUMENT_ERROR;
+    return 0;
+  }
+  int32_t columns = (sel->encodingsCount+31)/32;
+  if (columns > 0 && count > INT32_MAX / columns) {
+    *status = U_INDEX_OUTOFBOUNDS_ERROR;
+    return 0;
+  }
+  masksLength = count * columns;
+  if (masksLength > masksCapacity) {
+    *status = U_BUFFER_OVERFLOW_ERROR;
+    return 0;
+  }
+  return columns;
+}
+
+/* check an array of strings against the selector - UTF16 version */
+U_CAPI int32_t U_EXPORT2
+ucnvsel_selectForStrings(const UConverterSelector* sel,
+                         const UChar *const *strings, const int32_t *lengths, int32_t count,
+                         uint32_t *masks, int32_t masksCapacity, UErrorCode *status) {
+  int32_t masksLength;
+  int32_t columns = checkBatchArgs(sel, strings, count, masks, masksCapacity, masksLength, status);
+  if (columns == 0) {
+    return masksLength;
+  }
+  for (int32_t i = 0; i < count; ++i, masks += columns) {
+    int32_t length = lengths != NULL ? lengths[i] : -1;
+    if (strings[i] == NULL && length != 0) {
+      *status = U_ILLEGAL_ARGUMENT_ERROR;
+      return 0;
     }
+    selectMaskForString(sel, strings[i], length, masks, columns);
   }
-  return selectForMask(sel, mask, status);
+  return masksLength;
+}
+
+/* check an array of strings against the selector - UTF8 version */
+U_CAPI int32_t U_EXPORT2
+ucnvsel_selectForUTF8Strings(const UConverterSelector* sel,
+                             const char *const *strings, const int32_t *lengths, int32_t count,
+                             uint32_t *masks, int32_t masksCapacity, UErrorCode *status) {
+  int32_t masksLength;
+  int32_t columns = checkBatchArgs(sel, strings, count, masks, masksCapacity, masksLength, status);
+  if (columns == 0) {
+    return masksLength;
+  }
+  for (int32_t i = 0; i < count; ++i, masks += columns) {
+    int32_t length = lengths != NULL ? lengths[i] : -1;
+    if (strings[i] == NULL && length != 0) {
+      *status = U_ILLEGAL_ARGUMENT_ERROR;
+      return 0;
+    }
+    selectMaskForUTF8(sel, strings[i], length, masks, columns);
+  }
+  return masksLength;
 }
 
 #endif  // !UCONFIG_NO_CONVERSION
@@ -484,6 +484,36 @@ class U_COMMON_API CaseMap U_FINAL : public UMemory {
             char *dest, int32_t destCapacity, Edits *edits,
             UErrorCode &errorCode);
 
+#ifndef U_HIDE_DRAFT_API
+    /**
+     * Case-folds a UTF-8 string in place.
+     * Text that does not change is not copied at all,
+     * and otherwise only the changed parts are written into a separate buffer.
+     *
+     * If the folded string does not fit into the capacity,
+     * then the buffer is not modified, U_BUFFER_OVERFLOW_ERROR is set,
+     * and the folded length is returned. The caller can grow the buffer and try again;
+     * the text before *pFirstChange is already the start of the folded string.
+     *
+     * @param options   Options bit set, usually 0. See U_FOLD_CASE_DEFAULT, U_FOLD_CASE_EXCLUDE_SPECIAL_I.
+     * @param s         UTF-8 string to be case-folded in place.
+     *                  The result is NUL-terminated if there is room.
+     * @param length    Length of the string, or -1 if NUL-terminated.
+     * @param capacity  Size of the buffer (number of bytes); at least length.
+     * @param pFirstChange If not nullptr, receives the index of the first character
+     *                  that changes, or the length of the string if none changes.
+     * @param errorCode Reference to an in/out error code value
+     *                  which must not indicate a failure before the function call.
+     * @return the length of the case-folded string
+     *
+     * @draft ICU 69
+     */
+    static int32_t utf8FoldInPlace(
+            uint32_t options,
+            char *s, int32_t length, int32_t capacity,
+            int32_t *pFirstChange, UErrorCode &errorCode);
+#endif  // U_HIDE_DRAFT_API
+
 private:
     CaseMap() = delete;
     CaseMap(const CaseMap &other) = delete;
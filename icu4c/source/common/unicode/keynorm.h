@@ -0,0 +1,155 @@
+// © 2016 and later: Unicode, Inc. and others.
+// License & terms of use: http://www.unicode.org/copyright.html
+/*
+*******************************************************************************
+*   file name:  keynorm.h
+*   encoding:   UTF-8
+*   tab size:   8 (not used)
+*   indentation:4
+*/
+
+#ifndef __KEYNORM_H__
+#define __KEYNORM_H__
+
+/**
+ * \file
+ * \brief C++ API: Search-key normalization with NFKC_Casefold in a single pass.
+ */
+
+#include "unicode/utypes.h"
+
+#if U_SHOW_CPLUSPLUS_API
+
+#if !UCONFIG_NO_NORMALIZATION
+
+#include "unicode/bytestream.h"
+#include "unicode/localpointer.h"
+#include "unicode/normalizer2.h"
+#include "unicode/stringpiece.h"
+#include "unicode/uniset.h"
+#include "unicode/unistr.h"
+#include "unicode/uobject.h"
+
+U_NAMESPACE_BEGIN
+
+#ifndef U_HIDE_DRAFT_API
+
+/**
+ * Maps text to keys for matching and searching:
+ * NFKC_Casefold (which case-folds, applies NFKC, and removes Default_Ignorable_Code_Point
+ * characters) with optional exceptions and optional removal of further characters,
+ * all in one pass over the text.
+ *
+ * This replaces a chain of case folding, NFKC normalization, and removal of
+ * default ignorables (and of the removal set), without the intermediate strings.
+ * (NFKC_Casefold is closed under these operations, while the chain can leave
+ * rare sequences not fully folded or normalized.)
+ * ASCII text is mapped via a table, and only the rest of the text
+ * goes through the normalizer.
+ *
+ * The object is immutable and can be used by several threads at the same time.
+ *
+ * @draft ICU 69
+ */
+class U_COMMON_API SearchKeyNormalizer : public UObject {
+public:
+    /**
+     * Constructs a key normalizer for NFKC_Casefold without exceptions.
+     * @param errorCode Standard ICU error code. Its input value must
+     *                  pass the U_SUCCESS() test, or else the function returns
+     *                  immediately. Check for U_FAILURE() on output or use with
+     *                  function chaining. (See User Guide for details.)
+     * @draft ICU 69
+     */
+    explicit SearchKeyNormalizer(UErrorCode &errorCode);
+
+    /**
+     * Constructs a key normalizer for NFKC_Casefold with exceptions.
+     * @param excluded  if not nullptr, then these characters are not mapped
+     *                  but copied unchanged (as with a FilteredNormalizer2
+     *                  for the complement of this set); the set is copied
+     * @param removed   if not nullptr, then these characters are removed
+     *                  from the mapped text (for example, punctuation);
+     *                  the set is copied
+     * @param errorCode Standard ICU error code. Its input value must
+     *                  pass the U_SUCCESS() test, or else the function returns
+     *                  immediately. Check for U_FAILURE() on output or use with
+     *                  function chaining. (See User Guide for details.)
+     * @draft ICU 69
+     */
+    SearchKeyNormalizer(const UnicodeSet *excluded, const UnicodeSet *removed,
+                        UErrorCode &errorCode);
+
+    /**
+     * Destructor.
+     * @draft ICU 69
+     */
+    virtual ~SearchKeyNormalizer();
+
+    /**
+     * Writes the key for the source string to the destination string
+     * (replacing its contents).
+     * @param src source string
+     * @param dest destination string; its contents is replaced with the key
+     * @param errorCode Standard ICU error code. Its input value must
+     *                  pass the U_SUCCESS() test, or else the function returns
+     *                  immediately. Check for U_FAILURE() on output or use with
+     *                  function chaining. (See User Guide for details.)
+     * @return dest
+     * @draft ICU 69
+     */
+    UnicodeString &normalize(const UnicodeString &src, UnicodeString &dest,
+                             UErrorCode &errorCode) const;
+
+    /**
+     * Writes the key for a UTF-8 string to the sink.
+     * Ill-formed UTF-8 is treated as in Normalizer2::normalizeUTF8().
+     * @param src       Source UTF-8 string.
+     * @param sink      A ByteSink to which the UTF-8 key is written.
+     *                  sink.Flush() is called at the end.
+     * @param errorCode Standard ICU error code. Its input value must
+     *                  pass the U_SUCCESS() test, or else the function returns
+     *                  immediately. Check for U_FAILURE() on output or use with
+     *                  function chaining. (See User Guide for details.)
+     * @draft ICU 69
+     */
+    void normalizeUTF8(StringPiece src, ByteSink &sink, UErrorCode &errorCode) const;
+
+    /**
+     * ICU "poor man's RTTI", returns a UClassID for this class.
+     * @draft ICU 69
+     */
+    static UClassID U_EXPORT2 getStaticClassID();
+
+    /**
+     * ICU "poor man's RTTI", returns a UClassID for the actual class.
+     * @draft ICU 69
+     */
+    virtual UClassID getDynamicClassID() const;
+
+private:
+    SearchKeyNormalizer(const SearchKeyNormalizer &other) = delete;
+    SearchKeyNormalizer &operator=(const SearchKeyNormalizer &other) = delete;
+
+    void init(const UnicodeSet *excluded, const UnicodeSet *removed, UErrorCode &errorCode);
+    void appendRemaining(const char *s, int32_t length, ByteSink &sink) const;
+
+    /** NFKC_Casefold, or a FilteredNormalizer2 for it if there are excluded characters. */
+    const Normalizer2 *norm2;
+    LocalPointer<UnicodeSet> filterSet;
+    LocalPointer<FilteredNormalizer2> filtered;
+    /** Characters removed after mapping; nullptr if none. */
+    LocalPointer<UnicodeSet> removedSet;
+    /** ASCII code point to its key character, or 0xff if it is removed. */
+    uint8_t asciiMap[0x80];
+};
+
+#endif  // U_HIDE_DRAFT_API
+
+U_NAMESPACE_END
+
+#endif  // !UCONFIG_NO_NORMALIZATION
+
+#endif  // U_SHOW_CPLUSPLUS_API
+
+#endif  // __KEYNORM_H__
@@ -247,6 +247,36 @@ class U_COMMON_API Normalizer2 : public UObject {
     normalizeUTF8(uint32_t options, StringPiece src, ByteSink &sink,
                   Edits *edits, UErrorCode &errorCode) const;
 
+#ifndef U_HIDE_DRAFT_API
+    /**
+     * Normalizes a UTF-8 string in place.
+     * Text that is already normalized is not copied at all,
+     * and otherwise only the changed parts are written into a separate buffer.
+     *
+     * If the normalized string does not fit into the capacity,
+     * then the buffer is not modified, U_BUFFER_OVERFLOW_ERROR is set,
+     * and the normalized length is returned. The caller can grow the buffer and try again;
+     * the text before *pFirstChange is already the start of the normalized string.
+     *
+     * @param s         UTF-8 string to be normalized in place.
+     *                  The result is NUL-terminated if there is room.
+     * @param length    Length of the string, or -1 if NUL-terminated.
+     * @param capacity  Size of the buffer (number of bytes); at least length.
+     * @param pFirstChange If not nullptr, receives the index where the normalized string
+     *                  starts to differ from the original (the text before it is unchanged),
+     *                  or the length of the string if it is already normalized.
+     * @param errorCode Standard ICU error code. Its input value must
+     *                  pass the U_SUCCESS() test, or else the function returns
+     *                  immediately. Check for U_FAILURE() on output or use with
+     *                  function chaining. (See User Guide for details.)
+     * @return the length of the normalized string
+     * @draft ICU 69
+     */
+    int32_t
+    normalizeUTF8InPlace(char *s, int32_t length, int32_t capacity,
+                         int32_t *pFirstChange, UErrorCode &errorCode) const;
+#endif  // U_HIDE_DRAFT_API
+
     /**
      * Appends the normalized form of the second string to the first string
      * (merging them at the boundary) and returns the first string.
@@ -0,0 +1,319 @@
+// © 2016 and later: Unicode, Inc. and others.
+// License & terms of use: http://www.unicode.org/copyright.html
+/*
+*******************************************************************************
+*   file name:  normstream.h
+*   encoding:   UTF-8
+*   tab size:   8 (not used)
+*   indentation:4
+*/
+
+#ifndef __NORMSTREAM_H__
+#define __NORMSTREAM_H__
+
+/**
+ * \file
+ * \brief C++ API: Incremental and parallel normalization of large texts.
+ */
+
+#include "unicode/utypes.h"
+
+#if U_SHOW_CPLUSPLUS_API
+
+#if !UCONFIG_NO_NORMALIZATION
+
+#include "unicode/appendable.h"
+#include "unicode/bytestream.h"
+#include "unicode/edits.h"
+#include "unicode/normalizer2.h"
+#include "unicode/stringpiece.h"
+#include "unicode/uobject.h"
+#include "unicode/unistr.h"
+#include "unicode/utask.h"
+
+U_NAMESPACE_BEGIN
+
+#ifndef U_HIDE_DRAFT_API
+
+/**
+ * Normalizes a text stream that is passed in chunks of arbitrary lengths,
+ * without ever holding the whole text.
+ *
+ * Each chunk is normalized and written to the output up to the last position
+ * where the Normalizer2 has a boundary before the character (see
+ * Normalizer2::hasBoundaryBefore()). The rest of the chunk, and any code point
+ * that is split across chunks, is held back until a later chunk provides
+ * the next boundary, or until the stream is finished.
+ * Memory use is therefore proportional to the longest sequence of characters
+ * without boundaries (for example, a base character and its combining marks),
+ * not to the length of the text.
+ *
+ * The concatenation of the output for all chunks, including the output of
+ * finish(), is the same as the normalization of the concatenated input.
+ *
+ * One object normalizes either UTF-16 text (with append() and finish())
+ * or UTF-8 text (with appendUTF8() and finishUTF8()), not both at the same time.
+ * Call reset() before reusing it for a new stream.
+ *
+ * Not thread-safe; use one object per stream.
+ *
+ * @draft ICU 69
+ */
+class U_COMMON_API StreamingNormalizer2 : public UObject {
+public:
+    /**
+     * Constructs a streaming normalizer for the given Normalizer2.
+     * @param norm2 the normalizer; must stay valid for the lifetime of this object
+     *              (for example, one returned by Normalizer2::getNFCInstance())
+     * @draft ICU 69
+     */
+    explicit StreamingNormalizer2(const Normalizer2 &norm2);
+
+    /**
+     * Destructor.
+     * @draft ICU 69
+     */
+    virtual ~StreamingNormalizer2();
+
+    /**
+     * Discards any held-back text and starts a new stream.
+     * @draft ICU 69
+     */
+    void reset();
+
+    /**
+     * Normalizes the next chunk of UTF-16 text and appends as much of the
+     * result as is final to dest.
+     * A chunk may end in the middle of a surrogate pair.
+     * @param s next chunk of the text
+     * @param length length of the chunk, or -1 if NUL-terminated
+     * @param dest receives normalized text
+     * @param errorCode Standard ICU error code. Its input value must
+     *                  pass the U_SUCCESS() test, or else the function returns
+     *                  immediately. Check for U_FAILURE() on output or use with
+     *                  function chaining. (See User Guide for details.)
+     * @draft ICU 69
+     */
+    void append(const char16_t *s, int32_t length, Appendable &dest, UErrorCode &errorCode);
+
+    /**
+     * Normalizes and appends to dest whatever UTF-16 text was held back.
+     * Call this at the end of the stream.
+     * The object is then ready for a new stream.
+     * @param dest receives normalized text
+     * @param errorCode Standard ICU error code. Its input value must
+     *                  pass the U_SUCCESS() test, or else the function returns
+     *                  immediately. Check for U_FAILURE() on output or use with
+     *                  function chaining. (See User Guide for details.)
+     * @draft ICU 69
+     */
+    void finish(Appendable &dest, UErrorCode &errorCode);
+
+    /**
+     * Normalizes the next chunk of UTF-8 text and writes as much of the
+     * result as is final to the sink.
+     * A chunk may end in the middle of a UTF-8 sequence.
+     * Ill-formed UTF-8 is treated as in Normalizer2::normalizeUTF8().
+     * @param options   Options bit set, usually 0. See U_OMIT_UNCHANGED_TEXT.
+     *                  The normalizer adds U_EDITS_NO_RESET so that edits
+     *                  accumulate over the whole stream.
+     * @param src       next chunk of the text
+     * @param sink      receives normalized text
+     * @param edits     records edits for index mapping, working with styled text,
+     *                  and getting only changes (if any);
+     *                  offsets are relative to the start of the stream.
+     *                  The Edits contents are not reset by this function.
+     *                  Can be nullptr.
+     * @param errorCode Standard ICU error code. Its input value must
+     *                  pass the U_SUCCESS() test, or else the function returns
+     *                  immediately. Check for U_FAILURE() on output or use with
+     *                  function chaining. (See User Guide for details.)
+     * @draft ICU 69
+     */
+    void appendUTF8(uint32_t options, StringPiece src, ByteSink &sink,
+                    Edits *edits, UErrorCode &errorCode);
+
+    /**
+     * Normalizes and writes to the sink whatever UTF-8 text was held back.
+     * Call this at the end of the stream.
+     * The object is then ready for a new stream.
+     * @param options   Options bit set, usually 0. See U_OMIT_UNCHANGED_TEXT.
+     * @param sink      receives normalized text
+     * @param edits     records edits; see appendUTF8(). Can be nullptr.
+     * @param errorCode Standard ICU error code. Its input value must
+     *                  pass the U_SUCCESS() test, or else the function returns
+     *                  immediately. Check for U_FAILURE() on output or use with
+     *                  function chaining. (See User Guide for details.)
+     * @draft ICU 69
+     */
+    void finishUTF8(uint32_t options, ByteSink &sink, Edits *edits, UErrorCode &errorCode);
+
+    /**
+     * Returns the number of code units (UTF-16) or bytes (UTF-8)
+     * currently held back.
+     * @return the length of the held-back text
+     * @draft ICU 69
+     */
+    int32_t getPendingLength() const;
+
+    /**
+     * ICU "poor man's RTTI", returns a UClassID for this class.
+     * @draft ICU 69
+     */
+    static UClassID U_EXPORT2 getStaticClassID();
+
+    /**
+     * ICU "poor man's RTTI", returns a UClassID for the actual class.
+     * @draft ICU 69
+     */
+    virtual UClassID getDynamicClassID() const;
+
+private:
+    StreamingNormalizer2(const StreamingNormalizer2 &other) = delete;
+    StreamingNormalizer2 &operator=(const StreamingNormalizer2 &other) = delete;
+
+    UBool hasBoundaryAt(const char16_t *s, int32_t i, int32_t length) const;
+    UBool hasBoundaryAt(const uint8_t *s, int32_t i, int32_t length) const;
+    void normalizeAndAppend(const UnicodeString &src, Appendable &dest, UErrorCode &errorCode);
+    UBool appendPending8(const char *s, int32_t length, UErrorCode &errorCode);
+
+    const Normalizer2 &norm2;
+    /** Held-back UTF-16 text. */
+    UnicodeString pending16;
+    /** Reusable buffer for normalized UTF-16 text. */
+    UnicodeString normalized16;
+    /** Held-back UTF-8 text. */
+    char *pending8;
+    int32_t pending8Length;
+    int32_t pending8Capacity;
+};
+
+/**
+ * Normalizes a large text in parallel tasks.
+ *
+ * The text is split into up to the maximum number of segments,
+ * at positions where the Normalizer2 has a boundary before the character
+ * (see Normalizer2::hasBoundaryBefore()). The segments are normalized
+ * by independent tasks on a caller-supplied UTaskRunner, typically on the threads
+ * of a thread pool, and the results are concatenated, so the output
+ * (and the Edits, if requested) is the same as from the serial Normalizer2 function.
+ * ICU does not create threads itself.
+ *
+ * Texts shorter than twice the minimum segment length are normalized
+ * on the calling thread, and so is all text if the runner is nullptr.
+ *
+ * The object can be used by several threads at the same time
+ * if none of them calls setMinSegmentLength().
+ *
+ * @draft ICU 69
+ */
+class U_COMMON_API ParallelNormalizer2 : public UObject {
+public:
+    /**
+     * Constructs a parallel normalizer for the given Normalizer2.
+     * @param norm2 the normalizer; must stay valid for the lifetime of this object
+     *              (for example, one returned by Normalizer2::getNFCInstance())
+     * @param maxSegments maximum number of segments to be normalized in parallel,
+     *                    typically the number of available threads.
+     *                    Values below 1 are treated as 1, and at most 64 segments are used.
+     * @param runner caller-supplied function that runs the segment tasks; can be nullptr
+     * @param runnerContext passed into runner
+     * @draft ICU 69
+     */
+    ParallelNormalizer2(const Normalizer2 &norm2, int32_t maxSegments,
+                        UTaskRunner runner, const void *runnerContext);
+
+    /**
+     * Destructor.
+     * @draft ICU 69
+     */
+    virtual ~ParallelNormalizer2();
+
+    /**
+     * Returns the maximum number of segments normalized in parallel.
+     * @return the maximum segment count
+     * @draft ICU 69
+     */
+    int32_t getMaxSegments() const { return maxSegments; }
+
+    /**
+     * Sets the minimum number of code units (UTF-16) or bytes (UTF-8)
+     * that are normalized by one task. Segments may be longer
+     * because they are extended to the next boundary.
+     * The default is 32768.
+     * @param length minimum segment length; values below 1 are treated as 1
+     * @draft ICU 69
+     */
+    void setMinSegmentLength(int32_t length) { minSegmentLength = length > 0 ? length : 1; }
+
+    /**
+     * Writes the normalized form of the source string to the destination string
+     * (replacing its contents). Same as Normalizer2::normalize().
+     * @param src source string
+     * @param dest destination string; its contents is replaced with normalized src
+     * @param errorCode Standard ICU error code. Its input value must
+     *                  pass the U_SUCCESS() test, or else the function returns
+     *                  immediately. Check for U_FAILURE() on output or use with
+     *                  function chaining. (See User Guide for details.)
+     * @return dest
+     * @draft ICU 69
+     */
+    UnicodeString &normalize(const UnicodeString &src, UnicodeString &dest,
+                             UErrorCode &errorCode) const;
+
+    /**
+     * Normalizes a UTF-8 string and optionally records how source substrings
+     * relate to changed and unchanged result substrings.
+     * Same as Normalizer2::normalizeUTF8().
+     * @param options   Options bit set, usually 0. See U_OMIT_UNCHANGED_TEXT and U_EDITS_NO_RESET.
+     * @param src       Source UTF-8 string.
+     * @param sink      A ByteSink to which the normalized UTF-8 result string is written.
+     *                  sink.Flush() is called at the end.
+     * @param edits     Records edits for index mapping, working with styled text,
+     *                  and getting only changes (if any).
+     *                  The Edits contents is undefined if any error occurs.
+     *                  This function calls edits->reset() first unless
+     *                  options includes U_EDITS_NO_RESET. edits can be nullptr.
+     * @param errorCode Standard ICU error code. Its input value must
+     *                  pass the U_SUCCESS() test, or else the function returns
+     *                  immediately. Check for U_FAILURE() on output or use with
+     *                  function chaining. (See User Guide for details.)
+     * @draft ICU 69
+     */
+    void normalizeUTF8(uint32_t options, StringPiece src, ByteSink &sink,
+                       Edits *edits, UErrorCode &errorCode) const;
+
+    /**
+     * ICU "poor man's RTTI", returns a UClassID for this class.
+     * @draft ICU 69
+     */
+    static UClassID U_EXPORT2 getStaticClassID();
+
+    /**
+     * ICU "poor man's RTTI", returns a UClassID for the actual class.
+     * @draft ICU 69
+     */
+    virtual UClassID getDynamicClassID() const;
+
+private:
+    ParallelNormalizer2(const ParallelNormalizer2 &other) = delete;
+    ParallelNormalizer2 &operator=(const ParallelNormalizer2 &other) = delete;
+
+    int32_t countSegments(int32_t length) const;
+
+    const Normalizer2 &norm2;
+    int32_t maxSegments;
+    UTaskRunner runner;
+    const void *runnerContext;
+    int32_t minSegmentLength;
+};
+
+#endif  // U_HIDE_DRAFT_API
+
+U_NAMESPACE_END
+
+#endif  // !UCONFIG_NO_NORMALIZATION
+
+#endif  // U_SHOW_CPLUSPLUS_API
+
+#endif  // __NORMSTREAM_H__
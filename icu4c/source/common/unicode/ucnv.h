@@ -51,6 +51,7 @@
 
 #include "unicode/ucnv_err.h"
 #include "unicode/uenum.h"
+#include "unicode/utask.h"
 
 #if U_SHOW_CPLUSPLUS_API
 #include "unicode/localpointer.h"
@@ -1509,6 +1510,66 @@ ucnv_convertEx(UConverter *targetCnv, UConverter *sourceCnv,
                UBool reset, UBool flush,
                UErrorCode *pErrorCode);
 
+#ifndef U_HIDE_DRAFT_API
+/**
+ * Convert a complete string from one external charset to another,
+ * like ucnv_convert() but with converter objects,
+ * splitting large inputs into chunks which are converted concurrently.
+ *
+ * The input is split at character boundaries where conversion can restart
+ * in the initial state with the same results as continuing through it.
+ * This is possible for UTF-8, UTF-16BE/LE and UTF-32BE/LE,
+ * US-ASCII and ISO-8859-1, and for table-based SBCS/DBCS/MBCS charsets without SI/SO
+ * (MBCS input is split only before single bytes that cannot occur inside multi-byte
+ * sequences, such as ASCII controls and most ASCII characters in EUC or Shift-JIS).
+ * The same restrictions apply to the target charset.
+ * Otherwise, including for stateful charsets like ISO-2022, HZ and SCSU,
+ * for inputs that are too short to split, or if runner is NULL,
+ * the whole input is converted as a single chunk on the calling thread.
+ *
+ * Each chunk is converted with clones of the two converters,
+ * using their current callbacks. The callback context objects must therefore be
+ * safe for concurrent use. Chunks never split a well-formed character,
+ * but an incomplete sequence at the end of a chunk is reported to the
+ * toUnicode callback as truncated (U_TRUNCATED_CHAR_FOUND) rather than as illegal.
+ * Both converters are reset.
+ *
+ * The output of all chunks is concatenated into the target buffer.
+ * Preflighting and termination work like ucnv_convert():
+ * The function returns the complete output length, and sets U_BUFFER_OVERFLOW_ERROR
+ * if it does not fit into the target buffer.
+ * If any chunk fails, the error code of the first failed chunk is returned.
+ *
+ * @param targetCnv    Output converter, used to convert from the UTF-16 pivot
+ *                     to the target using ucnv_fromUnicode().
+ * @param sourceCnv    Input converter, used to convert from the source to
+ *                     the UTF-16 pivot using ucnv_toUnicode().
+ * @param target       Pointer to the output buffer.
+ * @param targetCapacity Capacity of the target, in bytes.
+ * @param source       Pointer to the input buffer.
+ * @param sourceLength Length of the input text, in bytes, or -1 for NUL-terminated input.
+ * @param maxChunks    Maximum number of chunks, typically the number of available threads.
+ * @param runner       Caller-supplied function that runs the chunk conversion tasks; can be NULL.
+ *                     ICU does not create threads itself.
+ * @param runnerContext Passed into runner.
+ * @param pErrorCode   ICU error code in/out parameter.
+ *                     Must fulfill U_SUCCESS before the function call.
+ * @return Length of the complete output text in bytes, even if it exceeds the targetCapacity
+ *         and a U_BUFFER_OVERFLOW_ERROR is set.
+ *
+ * @see ucnv_convertEx
+ * @see ucnv_convert
+ * @draft ICU 69
+ */
+U_CAPI int32_t U_EXPORT2
+ucnv_convertParallel(UConverter *targetCnv, UConverter *sourceCnv,
+                     char *target, int32_t targetCapacity,
+                     const char *source, int32_t sourceLength,
+                     int32_t maxChunks,
+                     UTaskRunner runner, const void *runnerContext,
+                     UErrorCode *pErrorCode);
+#endif  /* U_HIDE_DRAFT_API */
+
 /**
  * Convert from one external charset to another.
  * Internally, two converters are opened according to the name arguments,
@@ -1679,6 +1740,7 @@ ucnv_fromAlgorithmic(UConverter *cnv,
 
 /**
  * Frees up memory occupied by unused, cached converter shared data.
+ * Closes converters in the ucnv_openPooled() pool first.
  *
  * @return the number of cached converters successfully deleted
  * @see ucnv_close
@@ -1687,6 +1749,66 @@ ucnv_fromAlgorithmic(UConverter *cnv,
 U_CAPI int32_t U_EXPORT2
 ucnv_flushCache(void);
 
+#ifndef U_HIDE_DRAFT_API
+/**
+ * Opens a converter like ucnv_open(), but reuses a converter that was
+ * earlier handed back with ucnv_returnToPool() if one is available.
+ * A reused converter is in its reset state.
+ *
+ * The pool is meant for services that open and close converters by name
+ * for each request from many threads. A pool hit avoids the shared-data
+ * cache lookup under its global mutex and the heap allocation of ucnv_open().
+ * Pooled converters are kept in a number of shards, and each thread
+ * prefers its own shard, so that threads rarely wait for each other.
+ *
+ * Converter names are canonicalized via the alias table.
+ * Names with options (like "ibm-37,swaplfnl"), and NULL or empty names
+ * for the default converter, are not pooled: those converters
+ * are simply opened with ucnv_open().
+ *
+ * The converter must be released with ucnv_returnToPool() or ucnv_close().
+ *
+ * @param converterName name of the converter, see ucnv_open()
+ * @param err ICU error code in/out parameter
+ * @return the converter, or NULL if an error occurred
+ * @see ucnv_returnToPool
+ * @see ucnv_getPoolStatistics
+ * @draft ICU 69
+ */
+U_CAPI UConverter * U_EXPORT2
+ucnv_openPooled(const char *converterName, UErrorCode *err);
+
+/**
+ * Hands a converter back to the pool for reuse by ucnv_openPooled().
+ * The converter is reset and kept if it has the default callbacks,
+ * substitution and fallback settings and if there is room in the pool.
+ * Otherwise it is closed with ucnv_close(), which notifies any custom callbacks.
+ * Any converter, not only one from ucnv_openPooled(), can be passed in.
+ * The caller must not use the converter any more.
+ *
+ * ucnv_flushCache() closes all pooled converters first,
+ * so that their shared data can be released.
+ *
+ * @param cnv the converter, can be NULL
+ * @see ucnv_openPooled
+ * @draft ICU 69
+ */
+U_CAPI void U_EXPORT2
+ucnv_returnToPool(UConverter *cnv);
+
+/**
+ * Gets the cumulative number of ucnv_openPooled() calls that reused
+ * a pooled converter (hits) and that had to open a new one (misses).
+ *
+ * @param pHits receives the number of hits; can be NULL
+ * @param pMisses receives the number of misses; can be NULL
+ * @see ucnv_openPooled
+ * @draft ICU 69
+ */
+U_CAPI void U_EXPORT2
+ucnv_getPoolStatistics(int64_t *pHits, int64_t *pMisses);
+#endif  /* U_HIDE_DRAFT_API */
+
 /**
  * Returns the number of available converters, as per the alias file.
  *
@@ -187,6 +187,87 @@ U_CAPI UEnumeration * U_EXPORT2
 ucnvsel_selectForUTF8(const UConverterSelector* sel,
                       const char *s, int32_t length, UErrorCode *status);
 
+#ifndef U_HIDE_DRAFT_API
+/**
+ * Returns the number of encodings in the selector.
+ * Bit i of a mask written by ucnvsel_selectForStrings() or
+ * ucnvsel_selectForUTF8Strings() refers to encoding i.
+ *
+ * @param sel a selector
+ * @param status an in/out ICU UErrorCode
+ * @return the number of encodings, or 0 if an error occurred
+ *
+ * @draft ICU 69
+ */
+U_CAPI int32_t U_EXPORT2
+ucnvsel_countEncodings(const UConverterSelector* sel, UErrorCode *status);
+
+/**
+ * Returns the name of one of the selector's encodings, as
+ * supplied when building the selector.
+ *
+ * @param sel a selector
+ * @param index encoding index, 0..ucnvsel_countEncodings()-1
+ * @param status an in/out ICU UErrorCode
+ * @return the encoding name, owned by the selector,
+ *         or NULL if an error occurred
+ *
+ * @draft ICU 69
+ */
+U_CAPI const char * U_EXPORT2
+ucnvsel_getEncodingName(const UConverterSelector* sel, int32_t index, UErrorCode *status);
+
+/**
+ * Select converters for each of an array of UTF-16 strings,
+ * ignoring the excluded code points.
+ * This is equivalent to calling ucnvsel_selectForString() for each string
+ * but does not allocate memory: The result for each string is a bit mask
+ * of (ucnvsel_countEncodings()+31)/32 words, where bit (i&31) of word (i>>5)
+ * is set if encoding i can map all characters of the string.
+ * The masks for consecutive strings are stored consecutively.
+ *
+ * @param sel a selector
+ * @param strings array of UTF-16 strings
+ * @param lengths array of string lengths, each -1 if the string is NUL-terminated;
+ *                can be NULL if all strings are NUL-terminated
+ * @param count number of strings
+ * @param masks output buffer for the masks; can be NULL if masksCapacity==0
+ * @param masksCapacity number of uint32_t words available in masks
+ * @param status an in/out ICU UErrorCode;
+ *               set to U_BUFFER_OVERFLOW_ERROR if masksCapacity is too small
+ * @return the number of uint32_t words needed for all of the masks
+ *
+ * @draft ICU 69
+ */
+U_CAPI int32_t U_EXPORT2
+ucnvsel_selectForStrings(const UConverterSelector* sel,
+                         const UChar *const *strings, const int32_t *lengths, int32_t count,
+                         uint32_t *masks, int32_t masksCapacity, UErrorCode *status);
+
+/**
+ * Select converters for each of an array of UTF-8 strings,
+ * ignoring the excluded code points.
+ * See ucnvsel_selectForStrings() for the layout of the masks.
+ *
+ * @param sel a selector
+ * @param strings array of UTF-8 strings
+ * @param lengths array of string lengths, each -1 if the string is NUL-terminated;
+ *                can be NULL if all strings are NUL-terminated
+ * @param count number of strings
+ * @param masks output buffer for the masks; can be NULL if masksCapacity==0
+ * @param masksCapacity number of uint32_t words available in masks
+ * @param status an in/out ICU UErrorCode;
+ *               set to U_BUFFER_OVERFLOW_ERROR if masksCapacity is too small
+ * @return the number of uint32_t words needed for all of the masks
+ *
+ * @draft ICU 69
+ */
+U_CAPI int32_t U_EXPORT2
+ucnvsel_selectForUTF8Strings(const UConverterSelector* sel,
+                             const char *const *strings, const int32_t *lengths, int32_t count,
+                             uint32_t *masks, int32_t masksCapacity, UErrorCode *status);
+#endif  /* U_HIDE_DRAFT_API */
+
 #endif  /* !UCONFIG_NO_CONVERSION */
 
 #endif  /* __ICU_UCNV_SEL_H__ */
@@ -626,6 +626,7 @@
 #define ucnv_compareNames U_ICU_ENTRY_POINT_RENAME(ucnv_compareNames)
 #define ucnv_convert U_ICU_ENTRY_POINT_RENAME(ucnv_convert)
 #define ucnv_convertEx U_ICU_ENTRY_POINT_RENAME(ucnv_convertEx)
+#define ucnv_convertParallel U_ICU_ENTRY_POINT_RENAME(ucnv_convertParallel)
 #define ucnv_countAliases U_ICU_ENTRY_POINT_RENAME(ucnv_countAliases)
 #define ucnv_countAvailable U_ICU_ENTRY_POINT_RENAME(ucnv_countAvailable)
 #define ucnv_countStandards U_ICU_ENTRY_POINT_RENAME(ucnv_countStandards)
@@ -668,6 +669,7 @@
 #define ucnv_getNextUChar U_ICU_ENTRY_POINT_RENAME(ucnv_getNextUChar)
 #define ucnv_getNonSurrogateUnicodeSet U_ICU_ENTRY_POINT_RENAME(ucnv_getNonSurrogateUnicodeSet)
 #define ucnv_getPlatform U_ICU_ENTRY_POINT_RENAME(ucnv_getPlatform)
+#define ucnv_getPoolStatistics U_ICU_ENTRY_POINT_RENAME(ucnv_getPoolStatistics)
 #define ucnv_getStandard U_ICU_ENTRY_POINT_RENAME(ucnv_getStandard)
 #define ucnv_getStandardName U_ICU_ENTRY_POINT_RENAME(ucnv_getStandardName)
 #define ucnv_getStarters U_ICU_ENTRY_POINT_RENAME(ucnv_getStarters)
@@ -688,11 +690,13 @@
 #define ucnv_openAllNames U_ICU_ENTRY_POINT_RENAME(ucnv_openAllNames)
 #define ucnv_openCCSID U_ICU_ENTRY_POINT_RENAME(ucnv_openCCSID)
 #define ucnv_openPackage U_ICU_ENTRY_POINT_RENAME(ucnv_openPackage)
+#define ucnv_openPooled U_ICU_ENTRY_POINT_RENAME(ucnv_openPooled)
 #define ucnv_openStandardNames U_ICU_ENTRY_POINT_RENAME(ucnv_openStandardNames)
 #define ucnv_openU U_ICU_ENTRY_POINT_RENAME(ucnv_openU)
 #define ucnv_reset U_ICU_ENTRY_POINT_RENAME(ucnv_reset)
 #define ucnv_resetFromUnicode U_ICU_ENTRY_POINT_RENAME(ucnv_resetFromUnicode)
 #define ucnv_resetToUnicode U_ICU_ENTRY_POINT_RENAME(ucnv_resetToUnicode)
+#define ucnv_returnToPool U_ICU_ENTRY_POINT_RENAME(ucnv_returnToPool)
 #define ucnv_safeClone U_ICU_ENTRY_POINT_RENAME(ucnv_safeClone)
 #define ucnv_setDefaultName U_ICU_ENTRY_POINT_RENAME(ucnv_setDefaultName)
 #define ucnv_setFallback U_ICU_ENTRY_POINT_RENAME(ucnv_setFallback)
@@ -712,10 +716,14 @@
 #define ucnv_unloadSharedDataIfReady U_ICU_ENTRY_POINT_RENAME(ucnv_unloadSharedDataIfReady)
 #define ucnv_usesFallback U_ICU_ENTRY_POINT_RENAME(ucnv_usesFallback)
 #define ucnvsel_close U_ICU_ENTRY_POINT_RENAME(ucnvsel_close)
+#define ucnvsel_countEncodings U_ICU_ENTRY_POINT_RENAME(ucnvsel_countEncodings)
+#define ucnvsel_getEncodingName U_ICU_ENTRY_POINT_RENAME(ucnvsel_getEncodingName)
 #define ucnvsel_open U_ICU_ENTRY_POINT_RENAME(ucnvsel_open)
 #define ucnvsel_openFromSerialized U_ICU_ENTRY_POINT_RENAME(ucnvsel_openFromSerialized)
 #define ucnvsel_selectForString U_ICU_ENTRY_POINT_RENAME(ucnvsel_selectForString)
+#define ucnvsel_selectForStrings U_ICU_ENTRY_POINT_RENAME(ucnvsel_selectForStrings)
 #define ucnvsel_selectForUTF8 U_ICU_ENTRY_POINT_RENAME(ucnvsel_selectForUTF8)
+#define ucnvsel_selectForUTF8Strings U_ICU_ENTRY_POINT_RENAME(ucnvsel_selectForUTF8Strings)
 #define ucnvsel_serialize U_ICU_ENTRY_POINT_RENAME(ucnvsel_serialize)
 #define ucol_cloneBinary U_ICU_ENTRY_POINT_RENAME(ucol_cloneBinary)
 #define ucol_close U_ICU_ENTRY_POINT_RENAME(ucol_close)
@@ -744,6 +752,9 @@
 #define ucol_getRulesEx U_ICU_ENTRY_POINT_RENAME(ucol_getRulesEx)
 #define ucol_getShortDefinitionString U_ICU_ENTRY_POINT_RENAME(ucol_getShortDefinitionString)
 #define ucol_getSortKey U_ICU_ENTRY_POINT_RENAME(ucol_getSortKey)
+#define ucol_getSortKeyUTF8 U_ICU_ENTRY_POINT_RENAME(ucol_getSortKeyUTF8)
+#define ucol_getSortKeys U_ICU_ENTRY_POINT_RENAME(ucol_getSortKeys)
+#define ucol_getSortKeysUTF8 U_ICU_ENTRY_POINT_RENAME(ucol_getSortKeysUTF8)
 #define ucol_getStrength U_ICU_ENTRY_POINT_RENAME(ucol_getStrength)
 #define ucol_getTailoredSet U_ICU_ENTRY_POINT_RENAME(ucol_getTailoredSet)
 #define ucol_getUCAVersion U_ICU_ENTRY_POINT_RENAME(ucol_getUCAVersion)
@@ -756,6 +767,7 @@
 #define ucol_looksLikeCollationBinary U_ICU_ENTRY_POINT_RENAME(ucol_looksLikeCollationBinary)
 #define ucol_mergeSortkeys U_ICU_ENTRY_POINT_RENAME(ucol_mergeSortkeys)
 #define ucol_next U_ICU_ENTRY_POINT_RENAME(ucol_next)
+#define ucol_nextCEs U_ICU_ENTRY_POINT_RENAME(ucol_nextCEs)
 #define ucol_nextSortKeyPart U_ICU_ENTRY_POINT_RENAME(ucol_nextSortKeyPart)
 #define ucol_normalizeShortDefinitionString U_ICU_ENTRY_POINT_RENAME(ucol_normalizeShortDefinitionString)
 #define ucol_open U_ICU_ENTRY_POINT_RENAME(ucol_open)
@@ -778,6 +790,8 @@
 #define ucol_setStrength U_ICU_ENTRY_POINT_RENAME(ucol_setStrength)
 #define ucol_setText U_ICU_ENTRY_POINT_RENAME(ucol_setText)
 #define ucol_setVariableTop U_ICU_ENTRY_POINT_RENAME(ucol_setVariableTop)
+#define ucol_sortStrings U_ICU_ENTRY_POINT_RENAME(ucol_sortStrings)
+#define ucol_sortStringsUTF8 U_ICU_ENTRY_POINT_RENAME(ucol_sortStringsUTF8)
 #define ucol_strcoll U_ICU_ENTRY_POINT_RENAME(ucol_strcoll)
 #define ucol_strcollIter U_ICU_ENTRY_POINT_RENAME(ucol_strcollIter)
 #define ucol_strcollUTF8 U_ICU_ENTRY_POINT_RENAME(ucol_strcollUTF8)
@@ -798,6 +812,7 @@
 #define ucptrie_openFromBinary U_ICU_ENTRY_POINT_RENAME(ucptrie_openFromBinary)
 #define ucptrie_swap U_ICU_ENTRY_POINT_RENAME(ucptrie_swap)
 #define ucptrie_toBinary U_ICU_ENTRY_POINT_RENAME(ucptrie_toBinary)
+#define ucsdet_appendText U_ICU_ENTRY_POINT_RENAME(ucsdet_appendText)
 #define ucsdet_close U_ICU_ENTRY_POINT_RENAME(ucsdet_close)
 #define ucsdet_detect U_ICU_ENTRY_POINT_RENAME(ucsdet_detect)
 #define ucsdet_detectAll U_ICU_ENTRY_POINT_RENAME(ucsdet_detectAll)
@@ -812,6 +827,7 @@
 #define ucsdet_open U_ICU_ENTRY_POINT_RENAME(ucsdet_open)
 #define ucsdet_setDeclaredEncoding U_ICU_ENTRY_POINT_RENAME(ucsdet_setDeclaredEncoding)
 #define ucsdet_setDetectableCharset U_ICU_ENTRY_POINT_RENAME(ucsdet_setDetectableCharset)
+#define ucsdet_setStopConfidence U_ICU_ENTRY_POINT_RENAME(ucsdet_setStopConfidence)
 #define ucsdet_setText U_ICU_ENTRY_POINT_RENAME(ucsdet_setText)
 #define ucurr_countCurrencies U_ICU_ENTRY_POINT_RENAME(ucurr_countCurrencies)
 #define ucurr_forLocale U_ICU_ENTRY_POINT_RENAME(ucurr_forLocale)
@@ -1150,6 +1166,10 @@
 #define ultag_isUnicodeLocaleKey U_ICU_ENTRY_POINT_RENAME(ultag_isUnicodeLocaleKey)
 #define ultag_isUnicodeLocaleType U_ICU_ENTRY_POINT_RENAME(ultag_isUnicodeLocaleType)
 #define ultag_isVariantSubtags U_ICU_ENTRY_POINT_RENAME(ultag_isVariantSubtags)
+#define umsearch_close U_ICU_ENTRY_POINT_RENAME(umsearch_close)
+#define umsearch_next U_ICU_ENTRY_POINT_RENAME(umsearch_next)
+#define umsearch_open U_ICU_ENTRY_POINT_RENAME(umsearch_open)
+#define umsearch_setText U_ICU_ENTRY_POINT_RENAME(umsearch_setText)
 #define umsg_applyPattern U_ICU_ENTRY_POINT_RENAME(umsg_applyPattern)
 #define umsg_autoQuoteApostrophe U_ICU_ENTRY_POINT_RENAME(umsg_autoQuoteApostrophe)
 #define umsg_clone U_ICU_ENTRY_POINT_RENAME(umsg_clone)
@@ -1711,6 +1731,14 @@
 #define uset_spanBackUTF8 U_ICU_ENTRY_POINT_RENAME(uset_spanBackUTF8)
 #define uset_spanUTF8 U_ICU_ENTRY_POINT_RENAME(uset_spanUTF8)
 #define uset_toPattern U_ICU_ENTRY_POINT_RENAME(uset_toPattern)
+#define usortkeystore_build U_ICU_ENTRY_POINT_RENAME(usortkeystore_build)
+#define usortkeystore_close U_ICU_ENTRY_POINT_RENAME(usortkeystore_close)
+#define usortkeystore_getBoundRange U_ICU_ENTRY_POINT_RENAME(usortkeystore_getBoundRange)
+#define usortkeystore_getCount U_ICU_ENTRY_POINT_RENAME(usortkeystore_getCount)
+#define usortkeystore_getKey U_ICU_ENTRY_POINT_RENAME(usortkeystore_getKey)
+#define usortkeystore_lowerBound U_ICU_ENTRY_POINT_RENAME(usortkeystore_lowerBound)
+#define usortkeystore_openFromBinary U_ICU_ENTRY_POINT_RENAME(usortkeystore_openFromBinary)
+#define usortkeystore_upperBound U_ICU_ENTRY_POINT_RENAME(usortkeystore_upperBound)
 #define uspoof_areConfusable U_ICU_ENTRY_POINT_RENAME(uspoof_areConfusable)
 #define uspoof_areConfusableUTF8 U_ICU_ENTRY_POINT_RENAME(uspoof_areConfusableUTF8)
 #define uspoof_areConfusableUnicodeString U_ICU_ENTRY_POINT_RENAME(uspoof_areConfusableUnicodeString)
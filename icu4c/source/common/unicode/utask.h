@@ -0,0 +1,54 @@
+// © 2016 and later: Unicode, Inc. and others.
+// License & terms of use: http://www.unicode.org/copyright.html
+
+// utask.h
+
+#ifndef __UTASK_H__
+#define __UTASK_H__
+
+#include "unicode/utypes.h"
+
+/**
+ * \file
+ * \brief C API: Caller-supplied task runners.
+ *
+ * Some ICU functions can split a large input into independent tasks,
+ * for example ucnv_convertParallel(). ICU does not create threads itself.
+ * Instead, such functions take a UTaskRunner function from the caller,
+ * which typically runs the tasks on the threads of a thread pool.
+ * If the runner is NULL, then the functions do all of the work on the calling thread.
+ */
+
+#ifndef U_HIDE_DRAFT_API
+
+U_CDECL_BEGIN
+
+/**
+ * Function type for one of a set of independent tasks.
+ * @param taskContext the task context pointer that was passed into the UTaskRunner
+ * @param index the task index, 0..count-1
+ * @see UTaskRunner
+ * @draft ICU 69
+ */
+typedef void (U_CALLCONV *UTask)(void *taskContext, int32_t index);
+
+/**
+ * Caller-supplied function that runs a set of independent tasks,
+ * typically on the threads of a thread pool.
+ * It must call task(taskContext, i) exactly once for each i from 0 to count-1,
+ * in any order and on any threads, and return only after all of those calls have returned.
+ *
+ * @param runnerContext the runner context pointer that was passed into the ICU function
+ * @param task the function to be called count times
+ * @param taskContext to be passed into each task call
+ * @param count the number of tasks
+ * @draft ICU 69
+ */
+typedef void (U_CALLCONV *UTaskRunner)(const void *runnerContext,
+                                       UTask task, void *taskContext, int32_t count);
+
+U_CDECL_END
+
+#endif  /* U_HIDE_DRAFT_API */
+
+#endif  /* __UTASK_H__ */
@@ -0,0 +1,219 @@
+// © 2016 and later: Unicode, Inc. and others.
+// License & terms of use: http://www.unicode.org/copyright.html
+/*
+*******************************************************************************
+*   file name:  ustr_simd.h
+*   encoding:   UTF-8
+*   tab size:   8 (not used)
+*   indentation:4
+*
+* Block-at-a-time scanning and copying of code unit runs that need no
+* per-character processing: ASCII bytes, bytes or UChars below some threshold,
+* and UChars other than one that is searched for.
+*
+* The functions process 16 code units per step with SSE2 where it is part of
+* the compiler's baseline instruction set (all x86-64 targets), and otherwise
+* 8 bytes per step with plain 64-bit word operations.
+* There is no runtime CPU dispatch; wider vectors would require per-function
+* target attributes which ICU does not use.
+*
+* Each function stops at the first code unit that does not qualify,
+* so callers continue with their regular per-character code from there.
+*/
+
+#ifndef __USTR_SIMD_H__
+#define __USTR_SIMD_H__
+
+#include "unicode/utypes.h"
+#include "cmemory.h"
+#include "uassert.h"
+
+#ifndef U_STR_SIMD_SSE2
+#   if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || \
+            (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#       define U_STR_SIMD_SSE2 1
+#   else
+#       define U_STR_SIMD_SSE2 0
+#   endif
+#endif
+
+#if U_STR_SIMD_SSE2
+#   include <emmintrin.h>
+#endif
+
+/** Bit mask for the high bit of each byte in a 64-bit word. */
+#define U_STR_SIMD_HIGH_BITS ((uint64_t)0x8080808080808080ULL)
+
+/**
+ * Returns the length of the initial run of ASCII bytes (<0x80) in s.
+ * @param s byte string
+ * @param length number of bytes in s, must be >=0
+ * @return the number of leading ASCII bytes, 0..length
+ * @internal
+ */
+static inline int32_t
+uprv_asciiSpan(const uint8_t *s, int32_t length) {
+    int32_t i = 0;
+#if U_STR_SIMD_SSE2
+    while((length - i) >= 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(s + i));
+        if(_mm_movemask_epi8(v) != 0) { break; }
+        i += 16;
+    }
+#endif
+    while((length - i) >= 8) {
+        uint64_t w;
+        uprv_memcpy(&w, s + i, 8);
+        if((w & U_STR_SIMD_HIGH_BITS) != 0) { break; }
+        i += 8;
+    }
+    while(i < length && s[i] <= 0x7f) { ++i; }
+    return i;
+}
+
+/**
+ * Copies the initial run of ASCII bytes (<0x80) from src to dest,
+ * widening each byte to a UChar.
+ * @param dest UChar buffer with room for at least length units
+ * @param src byte string
+ * @param length maximum number of bytes to copy, must be >=0
+ * @return the number of bytes copied and UChars written, 0..length
+ * @internal
+ */
+static inline int32_t
+uprv_copyASCIIToUChars(UChar *dest, const uint8_t *src, int32_t length) {
+    int32_t i = 0;
+#if U_STR_SIMD_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    while((length - i) >= 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(src + i));
+        if(_mm_movemask_epi8(v) != 0) { break; }
+        _mm_storeu_si128((__m128i *)(dest + i), _mm_unpacklo_epi8(v, zero));
+        _mm_storeu_si128((__m128i *)(dest + i + 8), _mm_unpackhi_epi8(v, zero));
+        i += 16;
+    }
+#endif
+    while((length - i) >= 8) {
+        uint64_t w;
+        uprv_memcpy(&w, src + i, 8);
+        if((w & U_STR_SIMD_HIGH_BITS) != 0) { break; }
+        for(int32_t j = 0; j < 8; ++j) { dest[i + j] = src[i + j]; }
+        i += 8;
+    }
+    uint8_t b;
+    while(i < length && (b = src[i]) <= 0x7f) {
+        dest[i++] = b;
+    }
+    return i;
+}
+
+/**
+ * Copies the initial run of ASCII UChars (<0x80) from src to dest,
+ * narrowing each UChar to a byte.
+ * @param dest byte buffer with room for at least length bytes
+ * @param src UChar string
+ * @param length maximum number of UChars to copy, must be >=0
+ * @return the number of UChars copied and bytes written, 0..length
+ * @internal
+ */
+static inline int32_t
+uprv_copyASCIIFromUChars(uint8_t *dest, const UChar *src, int32_t length) {
+    int32_t i = 0;
+#if U_STR_SIMD_SSE2
+    const __m128i nonASCII = _mm_set1_epi16((short)0xff80);
+    const __m128i zero = _mm_setzero_si128();
+    while((length - i) >= 16) {
+        __m128i v0 = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i v1 = _mm_loadu_si128((const __m128i *)(src + i + 8));
+        __m128i high = _mm_and_si128(_mm_or_si128(v0, v1), nonASCII);
+        if(_mm_movemask_epi8(_mm_cmpeq_epi16(high, zero)) != 0xffff) { break; }
+        _mm_storeu_si128((__m128i *)(dest + i), _mm_packus_epi16(v0, v1));
+        i += 16;
+    }
+#endif
+    UChar c;
+    while(i < length && (c = src[i]) <= 0x7f) {
+        dest[i++] = (uint8_t)c;
+    }
+    return i;
+}
+
+/**
+ * Returns the length of the initial run of bytes in s that are all below limit.
+ * @param s byte string
+ * @param length number of bytes in s, must be >=0
+ * @param limit exclusive upper bound, 1..0xff
+ * @return the number of leading bytes that are <limit, 0..length
+ * @internal
+ */
+static inline int32_t
+uprv_spanBytesBelow(const uint8_t *s, int32_t length, uint8_t limit) {
+    U_ASSERT(limit > 0);
+    int32_t i = 0;
+#if U_STR_SIMD_SSE2
+    // Unsigned saturating subtraction yields 0 exactly for bytes <= limit-1.
+    const __m128i max = _mm_set1_epi8((char)(limit - 1));
+    const __m128i zero = _mm_setzero_si128();
+    while((length - i) >= 16) {
+        __m128i v = _mm_subs_epu8(_mm_loadu_si128((const __m128i *)(s + i)), max);
+        if(_mm_movemask_epi8(_mm_cmpeq_epi8(v, zero)) != 0xffff) { break; }
+        i += 16;
+    }
+#endif
+    while(i < length && s[i] < limit) { ++i; }
+    return i;
+}
+
+/**
+ * Returns the length of the initial run of UChars in s that are all below limit.
+ * @param s UChar string
+ * @param length number of UChars in s, must be >=0
+ * @param limit exclusive upper bound, 1..0xffff
+ * @return the number of leading UChars that are <limit, 0..length
+ * @internal
+ */
+static inline int32_t
+uprv_spanUCharsBelow(const UChar *s, int32_t length, UChar limit) {
+    U_ASSERT(limit > 0);
+    int32_t i = 0;
+#if U_STR_SIMD_SSE2
+    // Unsigned saturating subtraction yields 0 exactly for units <= limit-1.
+    const __m128i max = _mm_set1_epi16((short)(limit - 1));
+    const __m128i zero = _mm_setzero_si128();
+    while((length - i) >= 16) {
+        __m128i v0 = _mm_subs_epu16(_mm_loadu_si128((const __m128i *)(s + i)), max);
+        __m128i v1 = _mm_subs_epu16(_mm_loadu_si128((const __m128i *)(s + i + 8)), max);
+        if(_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_or_si128(v0, v1), zero)) != 0xffff) { break; }
+        i += 16;
+    }
+#endif
+    while(i < length && s[i] < limit) { ++i; }
+    return i;
+}
+
+/**
+ * Returns the length of the initial run of UChars in s that are not equal to c,
+ * which is the index of the first c if there is one.
+ * @param s UChar string
+ * @param length number of UChars in s, must be >=0
+ * @param c the code unit to look for
+ * @return the number of leading UChars that are !=c, 0..length
+ * @internal
+ */
+static inline int32_t
+uprv_spanUCharsNotEqual(const UChar *s, int32_t length, UChar c) {
+    int32_t i = 0;
+#if U_STR_SIMD_SSE2
+    const __m128i v = _mm_set1_epi16((short)c);
+    while((length - i) >= 16) {
+        __m128i eq0 = _mm_cmpeq_epi16(_mm_loadu_si128((const __m128i *)(s + i)), v);
+        __m128i eq1 = _mm_cmpeq_epi16(_mm_loadu_si128((const __m128i *)(s + i + 8)), v);
+        if(_mm_movemask_epi8(_mm_or_si128(eq0, eq1)) != 0) { break; }
+        i += 16;
+    }
+#endif
+    while(i < length && s[i] != c) { ++i; }
+    return i;
+}
+
+#endif
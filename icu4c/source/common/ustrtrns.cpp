@@ -34,6 +34,7 @@
 #include "cstring.h"
 #include "cmemory.h"
 #include "ustr_imp.h"
+#include "ustr_simd.h"
 #include "uassert.h"
 
 U_CAPI UChar* U_EXPORT2 
@@ -403,6 +404,12 @@ u_strFromUTF8WithSub(UChar *dest,
                 c = (uint8_t)src[i++];
                 if(U8_IS_SINGLE(c)) {
                     *pDest++=(UChar)c;
+                    // Copy the rest of an ASCII run in blocks.
+                    // Each byte takes one iteration's worth of src and dest.
+                    int32_t n = uprv_copyASCIIToUChars(pDest, (const uint8_t *)src + i, count - 1);
+                    pDest += n;
+                    i += n;
+                    count -= n;
                 } else {
                     uint8_t __t1, __t2;
                     if( /* handle U+0800..U+FFFF inline */
@@ -491,7 +498,9 @@ u_strFromUTF8WithSub(UChar *dest,
             // modified copy of U8_NEXT()
             c = (uint8_t)src[i++];
             if(U8_IS_SINGLE(c)) {
-                ++reqLength;
+                int32_t n = uprv_asciiSpan((const uint8_t *)src + i, srcLength - i);
+                i += n;
+                reqLength += 1 + n;
             } else {
                 uint8_t __t1, __t2;
                 if( /* handle U+0800..U+FFFF inline */
@@ -921,6 +930,12 @@ u_strToUTF8WithSub(char *dest,
                 ch=*pSrc++;
                 if(ch <= 0x7f) {
                     *pDest++ = (uint8_t)ch;
+                    // Copy the rest of an ASCII run in blocks.
+                    // Each UChar takes one iteration's worth of src and dest.
+                    int32_t n = uprv_copyASCIIFromUChars(pDest, pSrc, count - 1);
+                    pDest += n;
+                    pSrc += n;
+                    count -= n;
                 } else if(ch <= 0x7ff) {
                     *pDest++=(uint8_t)((ch>>6)|0xc0);
                     *pDest++=(uint8_t)((ch&0x3f)|0x80);
@@ -1019,7 +1034,9 @@ u_strToUTF8WithSub(char *dest,
         while(pSrc<pSrcLimit) {
             ch=*pSrc++;
             if(ch<=0x7f) {
-                ++reqLength;
+                int32_t n = uprv_spanUCharsBelow(pSrc, (int32_t)(pSrcLimit - pSrc), 0x80);
+                pSrc += n;
+                reqLength += 1 + n;
             } else if(ch<=0x7ff) {
                 reqLength+=2;
             } else if(!U16_IS_SURROGATE(ch)) {
@@ -0,0 +1,52 @@
+// © 2016 and later: Unicode, Inc. and others.
+// License & terms of use: http://www.unicode.org/copyright.html
+/*
+*******************************************************************************
+*   file name:  utask_imp.h
+*   encoding:   UTF-8
+*   tab size:   8 (not used)
+*   indentation:4
+*
+*   Internal helpers for running independent tasks
+*   with a caller-supplied UTaskRunner.
+*/
+
+#ifndef __UTASK_IMP_H__
+#define __UTASK_IMP_H__
+
+#include "unicode/utypes.h"
+#include "unicode/utask.h"
+
+#ifdef __cplusplus
+
+U_NAMESPACE_BEGIN
+
+/** UTask adapter that calls (*(Work *)context)(index). @internal */
+template<typename Work>
+void U_CALLCONV
+uprv_callTaskWork(void *context, int32_t index) {
+    (*static_cast<Work *>(context))(index);
+}
+
+/**
+ * Calls work(i) for i=0..count-1 via the runner.
+ * If the runner is NULL or there is only one task,
+ * then the calls are made in order on the calling thread.
+ * @internal
+ */
+template<typename Work>
+void uprv_runTasks(UTaskRunner runner, const void *runnerContext, int32_t count, Work &work) {
+    if (runner == nullptr || count <= 1) {
+        for (int32_t i = 0; i < count; ++i) {
+            work(i);
+        }
+    } else {
+        runner(runnerContext, uprv_callTaskWork<Work>, &work, count);
+    }
+}
+
+U_NAMESPACE_END
+
+#endif  // __cplusplus
+
+#endif  // __UTASK_IMP_H__
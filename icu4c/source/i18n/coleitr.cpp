@@ -137,6 +137,42 @@ int32_t CollationElementIterator::next(UErrorCode& status)
     return firstHalf;
 }
 
+int32_t CollationElementIterator::nextCEs(int64_t *ces, int32_t *offsets, int32_t capacity,
+                                          UErrorCode &status)
+{
+    if (U_FAILURE(status)) { return 0; }
+    if (capacity < 0 || (capacity > 0 && ces == NULL)) {
+        status = U_ILLEGAL_ARGUMENT_ERROR;
+        return 0;
+    }
+    if (dir_ < 0) {
+        // illegal change of direction
+        status = U_INVALID_STATE_ERROR;
+        return 0;
+    }
+    dir_ = 2;
+    otherHalf_ = 0;
+    // Same as next() but without splitting the CEs.
+    int32_t length = 0;
+    if (offsets == NULL) {
+        while (length < capacity) {
+            iter_->clearCEsIfNoneRemaining();
+            int64_t ce = iter_->nextCE(status);
+            if (ce == Collation::NO_CE) { break; }
+            ces[length++] = ce;
+        }
+    } else {
+        while (length < capacity) {
+            iter_->clearCEsIfNoneRemaining();
+            int64_t ce = iter_->nextCE(status);
+            if (ce == Collation::NO_CE) { break; }
+            ces[length] = ce;
+            offsets[length++] = iter_->getOffset();
+        }
+    }
+    return U_SUCCESS(status) ? length : 0;
+}
+
 UBool CollationElementIterator::operator!=(
                                   const CollationElementIterator& other) const
 {
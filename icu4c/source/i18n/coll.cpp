@@ -535,6 +535,35 @@ UCollationResult Collator::compareUTF8(const StringPiece &source,
     return compare(sIter, tIter, status);
 }
 
+void Collator::getSortKeyUTF8(StringPiece source, ByteSink &sink,
+                              UErrorCode &errorCode) const {
+    if(U_FAILURE(errorCode)) {
+        return;
+    }
+    UnicodeString s16 = UnicodeString::fromUTF8(source);
+    // Most keys fit into the sink's buffer or the scratch buffer, without preflighting.
+    char scratch[200];
+    int32_t capacity;
+    char *buffer = sink.GetAppendBuffer(1, UPRV_LENGTHOF(scratch),
+                                        scratch, UPRV_LENGTHOF(scratch), &capacity);
+    int32_t length = getSortKey(s16, reinterpret_cast<uint8_t *>(buffer), capacity);
+    if(length <= 0) {
+        // getSortKey() returns 0 only for an internal error.
+        errorCode = U_INTERNAL_PROGRAM_ERROR;
+        return;
+    }
+    MaybeStackArray<char, 1> key;
+    if(length > capacity) {
+        if((buffer = key.resize(length)) == NULL) {
+            errorCode = U_MEMORY_ALLOCATION_ERROR;
+            return;
+        }
+        getSortKey(s16, reinterpret_cast<uint8_t *>(buffer), length);
+    }
+    sink.Append(buffer, length);
+    sink.Flush();
+}
+
 UBool Collator::equals(const UnicodeString& source, 
                        const UnicodeString& target) const
 {
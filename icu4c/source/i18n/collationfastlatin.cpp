@@ -16,6 +16,7 @@
 #if !UCONFIG_NO_COLLATION
 
 #include "unicode/ucol.h"
+#include "unicode/uscript.h"
 #include "collationdata.h"
 #include "collationfastlatin.h"
 #include "collationsettings.h"
@@ -23,6 +24,74 @@
 
 U_NAMESPACE_BEGIN
 
+namespace {
+
+/**
+ * Character layout of the fast Latin table:
+ * U+0000..U+017F followed by U+2000..U+203F.
+ */
+struct LatinLayout {
+    static const int32_t PUNCT_INDEX = CollationFastLatin::LATIN_LIMIT;
+    static const int32_t NUM_CHARS = CollationFastLatin::NUM_FAST_CHARS;
+
+    /** Returns the index of c if it has a precomputed primary, otherwise -1. */
+    int32_t getPrimaryIndex(UChar32 c) const {
+        return c <= CollationFastLatin::LATIN_MAX ? c : -1;
+    }
+    UBool isBlockLead(UChar32 b) const {
+        return 0xc2 <= b && b <= CollationFastLatin::LATIN_MAX_UTF8_LEAD;
+    }
+    /** Returns the index of the two-byte sequence b, t in the Latin range. */
+    int32_t getBlockIndexUTF8(UChar32 b, uint8_t t) const {
+        return ((b - 0xc2) << 6) + t;  // 0080..017F
+    }
+};
+
+/**
+ * Character layout of a fast script table:
+ * U+0000..U+007F, the script block, and U+2000..U+203F.
+ */
+struct ScriptLayout {
+    ScriptLayout(const uint16_t *table)
+            : blockStart(table[(table[0] & 0xff) - 1]),
+              blockLead(0xc0 | (blockStart >> 6)) {}
+
+    static const int32_t PUNCT_INDEX = CollationFastLatin::SCRIPT_PRIMARIES_LENGTH;
+    static const int32_t NUM_CHARS = CollationFastLatin::NUM_FAST_SCRIPT_CHARS;
+
+    int32_t getPrimaryIndex(UChar32 c) const {
+        if(c <= 0x7f) { return c; }
+        c -= blockStart;
+        return (uint32_t)c < (uint32_t)CollationFastLatin::SCRIPT_BLOCK_LENGTH ? c + 0x80 : -1;
+    }
+    UBool isBlockLead(UChar32 b) const {
+        // The script block has two UTF-8 lead bytes.
+        return (uint32_t)(b - blockLead) <= 1;
+    }
+    int32_t getBlockIndexUTF8(UChar32 b, uint8_t t) const {
+        return ((b - blockLead) << 6) + t;  // blockStart..+7F -> 0080..00FF
+    }
+
+    UChar32 blockStart;
+    UChar32 blockLead;
+};
+
+}  // namespace
+
+UChar32
+CollationFastLatin::getScriptBlockStart(int32_t script) {
+    // Each block must start at a multiple of 0x40 and end before U+0800,
+    // so that its characters have two-byte UTF-8 sequences with two lead bytes.
+    switch(script) {
+    case USCRIPT_GREEK:
+        return 0x380;  // U+0386..U+03CE: modern Greek letters
+    case USCRIPT_CYRILLIC:
+        return 0x400;  // U+0400..U+045F: letters of most modern Cyrillic alphabets
+    default:
+        return -1;
+    }
+}
+
 int32_t
 CollationFastLatin::getOptions(const CollationData *data, const CollationSettings &settings,
                                uint16_t *primaries, int32_t capacity) {
@@ -30,7 +99,24 @@ CollationFastLatin::getOptions(const CollationData *data, const CollationSetting
     if(table == NULL) { return -1; }
     U_ASSERT(capacity == LATIN_LIMIT);
     if(capacity != LATIN_LIMIT) { return -1; }
+    return getOptions(data, table, USCRIPT_LATIN, settings, primaries, capacity);
+}
 
+int32_t
+CollationFastLatin::getScriptOptions(const CollationData *data, const uint16_t *table,
+                                     const CollationSettings &settings,
+                                     uint16_t *primaries, int32_t capacity) {
+    if(table == NULL) { return -1; }
+    U_ASSERT(capacity == SCRIPT_PRIMARIES_LENGTH);
+    if(capacity != SCRIPT_PRIMARIES_LENGTH) { return -1; }
+    int32_t script = table[(table[0] & 0xff) - 2];
+    return getOptions(data, table, script, settings, primaries, capacity);
+}
+
+int32_t
+CollationFastLatin::getOptions(const CollationData *data, const uint16_t *table, int32_t script,
+                               const CollationSettings &settings,
+                               uint16_t *primaries, int32_t length) {
     uint32_t miniVarTop;
     if((settings.options & CollationSettings::ALTERNATE_MASK) == 0) {
         // No mini primaries are variable, set a variableTop just below the
@@ -71,13 +157,15 @@ CollationFastLatin::getOptions(const CollationData *data, const CollationSetting
                 prevStart = start;
             }
         }
-        uint32_t latinStart = data->getFirstPrimaryForGroup(USCRIPT_LATIN);
-        latinStart = settings.reorder(latinStart);
-        if(latinStart < prevStart) {
+        // The Latin script for the fast Latin table,
+        // or the fast script which follows the special groups and the digits.
+        uint32_t scriptStart = data->getFirstPrimaryForGroup(script);
+        scriptStart = settings.reorder(scriptStart);
+        if(scriptStart < prevStart) {
             return -1;
         }
         if(afterDigitStart == 0) {
-            afterDigitStart = latinStart;
+            afterDigitStart = scriptStart;
         }
         if(!(beforeDigitStart < digitStart && digitStart < afterDigitStart)) {
             digitsAreReordered = TRUE;
@@ -85,7 +173,7 @@ CollationFastLatin::getOptions(const CollationData *data, const CollationSetting
     }
 
     table += (table[0] & 0xff);  // skip the header
-    for(UChar32 c = 0; c < LATIN_LIMIT; ++c) {
+    for(int32_t c = 0; c < length; ++c) {
         uint32_t p = table[c];
         if(p >= MIN_SHORT) {
             p &= SHORT_PRIMARY_MASK;
@@ -96,19 +184,59 @@ CollationFastLatin::getOptions(const CollationData *data, const CollationSetting
         }
         primaries[c] = (uint16_t)p;
     }
-    if(digitsAreReordered || (settings.options & CollationSettings::NUMERIC) != 0) {
+    int32_t options = settings.options;
+    if(digitsAreReordered || (options & CollationSettings::NUMERIC) != 0) {
         // Bail out for digits.
+        // The compare functions test the NUMERIC bit when they see a digit,
+        // so set it for reordered digits as well.
         for(UChar32 c = 0x30; c <= 0x39; ++c) { primaries[c] = 0; }
+        options |= CollationSettings::NUMERIC;
     }
 
     // Shift the miniVarTop above other options.
-    return ((int32_t)miniVarTop << 16) | settings.options;
+    return ((int32_t)miniVarTop << 16) | options;
 }
 
 int32_t
 CollationFastLatin::compareUTF16(const uint16_t *table, const uint16_t *primaries, int32_t options,
                                  const UChar *left, int32_t leftLength,
                                  const UChar *right, int32_t rightLength) {
+    return compareUTF16(table, LatinLayout(), primaries, options,
+                        left, leftLength, right, rightLength);
+}
+
+int32_t
+CollationFastLatin::compareScriptUTF16(const uint16_t *table, const uint16_t *primaries,
+                                       int32_t options,
+                                       const UChar *left, int32_t leftLength,
+                                       const UChar *right, int32_t rightLength) {
+    return compareUTF16(table, ScriptLayout(table), primaries, options,
+                        left, leftLength, right, rightLength);
+}
+
+int32_t
+CollationFastLatin::compareUTF8(const uint16_t *table, const uint16_t *primaries, int32_t options,
+                                const uint8_t *left, int32_t leftLength,
+                                const uint8_t *right, int32_t rightLength) {
+    return compareUTF8(table, LatinLayout(), primaries, options,
+                       left, leftLength, right, rightLength);
+}
+
+int32_t
+CollationFastLatin::compareScriptUTF8(const uint16_t *table, const uint16_t *primaries,
+                                      int32_t options,
+                                      const uint8_t *left, int32_t leftLength,
+                                      const uint8_t *right, int32_t rightLength) {
+    return compareUTF8(table, ScriptLayout(table), primaries, options,
+                       left, leftLength, right, rightLength);
+}
+
+template<typename Layout>
+int32_t
+CollationFastLatin::compareUTF16(const uint16_t *table, const Layout &layout,
+                                 const uint16_t *primaries, int32_t options,
+                                 const UChar *left, int32_t leftLength,
+                                 const UChar *right, int32_t rightLength) {
     // This is a modified copy of CollationCompare::compareUpToQuaternary(),
     // optimized for common Latin text.
     // Keep them in sync!
@@ -135,17 +263,18 @@ CollationFastLatin::compareUTF16(const uint16_t *table, const uint16_t *primarie
                 break;
             }
             UChar32 c = left[leftIndex++];
-            if(c <= LATIN_MAX) {
-                leftPair = primaries[c];
+            int32_t x = layout.getPrimaryIndex(c);
+            if(x >= 0) {
+                leftPair = primaries[x];
                 if(leftPair != 0) { break; }
                 if(c <= 0x39 && c >= 0x30 && (options & CollationSettings::NUMERIC) != 0) {
                     return BAIL_OUT_RESULT;
                 }
-                leftPair = table[c];
+                leftPair = table[x];
             } else if(PUNCT_START <= c && c < PUNCT_LIMIT) {
-                leftPair = table[c - PUNCT_START + LATIN_LIMIT];
+                leftPair = table[c - PUNCT_START + Layout::PUNCT_INDEX];
             } else {
-                leftPair = lookup(table, c);
+                leftPair = lookup<Layout>(table, c);
             }
             if(leftPair >= MIN_SHORT) {
                 leftPair &= SHORT_PRIMARY_MASK;
@@ -154,7 +283,7 @@ CollationFastLatin::compareUTF16(const uint16_t *table, const uint16_t *primarie
                 leftPair &= LONG_PRIMARY_MASK;
                 break;
             } else {
-                leftPair = nextPair(table, c, leftPair, left, NULL, leftIndex, leftLength);
+                leftPair = nextPair(table, layout, c, leftPair, left, NULL, leftIndex, leftLength);
                 if(leftPair == BAIL_OUT) { return BAIL_OUT_RESULT; }
                 leftPair = getPrimaries(variableTop, leftPair);
             }
@@ -166,17 +295,18 @@ CollationFastLatin::compareUTF16(const uint16_t *table, const uint16_t *primarie
                 break;
             }
             UChar32 c = right[rightIndex++];
-            if(c <= LATIN_MAX) {
-                rightPair = primaries[c];
+            int32_t x = layout.getPrimaryIndex(c);
+            if(x >= 0) {
+                rightPair = primaries[x];
                 if(rightPair != 0) { break; }
                 if(c <= 0x39 && c >= 0x30 && (options & CollationSettings::NUMERIC) != 0) {
                     return BAIL_OUT_RESULT;
                 }
-                rightPair = table[c];
+                rightPair = table[x];
             } else if(PUNCT_START <= c && c < PUNCT_LIMIT) {
-                rightPair = table[c - PUNCT_START + LATIN_LIMIT];
+                rightPair = table[c - PUNCT_START + Layout::PUNCT_INDEX];
             } else {
-                rightPair = lookup(table, c);
+                rightPair = lookup<Layout>(table, c);
             }
             if(rightPair >= MIN_SHORT) {
                 rightPair &= SHORT_PRIMARY_MASK;
@@ -185,7 +315,7 @@ CollationFastLatin::compareUTF16(const uint16_t *table, const uint16_t *primarie
                 rightPair &= LONG_PRIMARY_MASK;
                 break;
             } else {
-                rightPair = nextPair(table, c, rightPair, right, NULL, rightIndex, rightLength);
+                rightPair = nextPair(table, layout, c, rightPair, right, NULL, rightIndex, rightLength);
                 if(rightPair == BAIL_OUT) { return BAIL_OUT_RESULT; }
                 rightPair = getPrimaries(variableTop, rightPair);
             }
@@ -222,12 +352,13 @@ CollationFastLatin::compareUTF16(const uint16_t *table, const uint16_t *primarie
                     break;
                 }
                 UChar32 c = left[leftIndex++];
-                if(c <= LATIN_MAX) {
-                    leftPair = table[c];
+                int32_t x = layout.getPrimaryIndex(c);
+                if(x >= 0) {
+                    leftPair = table[x];
                 } else if(PUNCT_START <= c && c < PUNCT_LIMIT) {
-                    leftPair = table[c - PUNCT_START + LATIN_LIMIT];
+                    leftPair = table[c - PUNCT_START + Layout::PUNCT_INDEX];
                 } else {
-                    leftPair = lookup(table, c);
+                    leftPair = lookup<Layout>(table, c);
                 }
                 if(leftPair >= MIN_SHORT) {
                     leftPair = getSecondariesFromOneShortCE(leftPair);
@@ -236,7 +367,7 @@ CollationFastLatin::compareUTF16(const uint16_t *table, const uint16_t *primarie
                     leftPair = COMMON_SEC_PLUS_OFFSET;
                     break;
                 } else {
-                    leftPair = nextPair(table, c, leftPair, left, NULL, leftIndex, leftLength);
+                    leftPair = nextPair(table, layout, c, leftPair, left, NULL, leftIndex, leftLength);
                     leftPair = getSecondaries(variableTop, leftPair);
                 }
             }
@@ -247,12 +378,13 @@ CollationFastLatin::compareUTF16(const uint16_t *table, const uint16_t *primarie
                     break;
                 }
                 UChar32 c = right[rightIndex++];
-                if(c <= LATIN_MAX) {
-                    rightPair = table[c];
+                int32_t x = layout.getPrimaryIndex(c);
+                if(x >= 0) {
+                    rightPair = table[x];
                 } else if(PUNCT_START <= c && c < PUNCT_LIMIT) {
-                    rightPair = table[c - PUNCT_START + LATIN_LIMIT];
+                    rightPair = table[c - PUNCT_START + Layout::PUNCT_INDEX];
                 } else {
-                    rightPair = lookup(table, c);
+                    rightPair = lookup<Layout>(table, c);
                 }
                 if(rightPair >= MIN_SHORT) {
                     rightPair = getSecondariesFromOneShortCE(rightPair);
@@ -261,7 +393,7 @@ CollationFastLatin::compareUTF16(const uint16_t *table, const uint16_t *primarie
                     rightPair = COMMON_SEC_PLUS_OFFSET;
                     break;
                 } else {
-                    rightPair = nextPair(table, c, rightPair, right, NULL, rightIndex, rightLength);
+                    rightPair = nextPair(table, layout, c, rightPair, right, NULL, rightIndex, rightLength);
                     rightPair = getSecondaries(variableTop, rightPair);
                 }
             }
@@ -298,9 +430,10 @@ CollationFastLatin::compareUTF16(const uint16_t *table, const uint16_t *primarie
                     break;
                 }
                 UChar32 c = left[leftIndex++];
-                leftPair = (c <= LATIN_MAX) ? table[c] : lookup(table, c);
+                int32_t x = layout.getPrimaryIndex(c);
+                leftPair = (x >= 0) ? table[x] : lookup<Layout>(table, c);
                 if(leftPair < MIN_LONG) {
-                    leftPair = nextPair(table, c, leftPair, left, NULL, leftIndex, leftLength);
+                    leftPair = nextPair(table, layout, c, leftPair, left, NULL, leftIndex, leftLength);
                 }
                 leftPair = getCases(variableTop, strengthIsPrimary, leftPair);
             }
@@ -311,9 +444,10 @@ CollationFastLatin::compareUTF16(const uint16_t *table, const uint16_t *primarie
                     break;
                 }
                 UChar32 c = right[rightIndex++];
-                rightPair = (c <= LATIN_MAX) ? table[c] : lookup(table, c);
+                int32_t x = layout.getPrimaryIndex(c);
+                rightPair = (x >= 0) ? table[x] : lookup<Layout>(table, c);
                 if(rightPair < MIN_LONG) {
-                    rightPair = nextPair(table, c, rightPair, right, NULL, rightIndex, rightLength);
+                    rightPair = nextPair(table, layout, c, rightPair, right, NULL, rightIndex, rightLength);
                 }
                 rightPair = getCases(variableTop, strengthIsPrimary, rightPair);
             }
@@ -351,9 +485,10 @@ CollationFastLatin::compareUTF16(const uint16_t *table, const uint16_t *primarie
                 break;
             }
             UChar32 c = left[leftIndex++];
-            leftPair = (c <= LATIN_MAX) ? table[c] : lookup(table, c);
+            int32_t x = layout.getPrimaryIndex(c);
+            leftPair = (x >= 0) ? table[x] : lookup<Layout>(table, c);
             if(leftPair < MIN_LONG) {
-                leftPair = nextPair(table, c, leftPair, left, NULL, leftIndex, leftLength);
+                leftPair = nextPair(table, layout, c, leftPair, left, NULL, leftIndex, leftLength);
             }
             leftPair = getTertiaries(variableTop, withCaseBits, leftPair);
         }
@@ -364,9 +499,10 @@ CollationFastLatin::compareUTF16(const uint16_t *table, const uint16_t *primarie
                 break;
             }
             UChar32 c = right[rightIndex++];
-            rightPair = (c <= LATIN_MAX) ? table[c] : lookup(table, c);
+            int32_t x = layout.getPrimaryIndex(c);
+            rightPair = (x >= 0) ? table[x] : lookup<Layout>(table, c);
             if(rightPair < MIN_LONG) {
-                rightPair = nextPair(table, c, rightPair, right, NULL, rightIndex, rightLength);
+                rightPair = nextPair(table, layout, c, rightPair, right, NULL, rightIndex, rightLength);
             }
             rightPair = getTertiaries(variableTop, withCaseBits, rightPair);
         }
@@ -407,9 +543,10 @@ CollationFastLatin::compareUTF16(const uint16_t *table, const uint16_t *primarie
                 break;
             }
             UChar32 c = left[leftIndex++];
-            leftPair = (c <= LATIN_MAX) ? table[c] : lookup(table, c);
+            int32_t x = layout.getPrimaryIndex(c);
+            leftPair = (x >= 0) ? table[x] : lookup<Layout>(table, c);
             if(leftPair < MIN_LONG) {
-                leftPair = nextPair(table, c, leftPair, left, NULL, leftIndex, leftLength);
+                leftPair = nextPair(table, layout, c, leftPair, left, NULL, leftIndex, leftLength);
             }
             leftPair = getQuaternaries(variableTop, leftPair);
         }
@@ -420,9 +557,10 @@ CollationFastLatin::compareUTF16(const uint16_t *table, const uint16_t *primarie
                 break;
             }
             UChar32 c = right[rightIndex++];
-            rightPair = (c <= LATIN_MAX) ? table[c] : lookup(table, c);
+            int32_t x = layout.getPrimaryIndex(c);
+            rightPair = (x >= 0) ? table[x] : lookup<Layout>(table, c);
             if(rightPair < MIN_LONG) {
-                rightPair = nextPair(table, c, rightPair, right, NULL, rightIndex, rightLength);
+                rightPair = nextPair(table, layout, c, rightPair, right, NULL, rightIndex, rightLength);
             }
             rightPair = getQuaternaries(variableTop, rightPair);
         }
@@ -444,10 +582,12 @@ CollationFastLatin::compareUTF16(const uint16_t *table, const uint16_t *primarie
     return UCOL_EQUAL;
 }
 
+template<typename Layout>
 int32_t
-CollationFastLatin::compareUTF8(const uint16_t *table, const uint16_t *primaries, int32_t options,
-                                 const uint8_t *left, int32_t leftLength,
-                                 const uint8_t *right, int32_t rightLength) {
+CollationFastLatin::compareUTF8(const uint16_t *table, const Layout &layout,
+                                const uint16_t *primaries, int32_t options,
+                                const uint8_t *left, int32_t leftLength,
+                                const uint8_t *right, int32_t rightLength) {
     // Keep compareUTF16() and compareUTF8() in sync very closely!
 
     U_ASSERT((table[0] >> 8) == VERSION);
@@ -482,15 +622,15 @@ CollationFastLatin::compareUTF8(const uint16_t *table, const uint16_t *primaries
                     return BAIL_OUT_RESULT;
                 }
                 leftPair = table[c];
-            } else if(c <= LATIN_MAX_UTF8_LEAD && 0xc2 <= c && leftIndex != leftLength &&
+            } else if(layout.isBlockLead(c) && leftIndex != leftLength &&
                     0x80 <= (t = left[leftIndex]) && t <= 0xbf) {
                 ++leftIndex;
-                c = ((c - 0xc2) << 6) + t;
+                c = layout.getBlockIndexUTF8(c, t);
                 leftPair = primaries[c];
                 if(leftPair != 0) { break; }
                 leftPair = table[c];
             } else {
-                leftPair = lookupUTF8(table, c, left, leftIndex, leftLength);
+                leftPair = lookupUTF8<Layout>(table, c, left, leftIndex, leftLength);
             }
             if(leftPair >= MIN_SHORT) {
                 leftPair &= SHORT_PRIMARY_MASK;
@@ -499,7 +639,7 @@ CollationFastLatin::compareUTF8(const uint16_t *table, const uint16_t *primaries
                 leftPair &= LONG_PRIMARY_MASK;
                 break;
             } else {
-                leftPair = nextPair(table, c, leftPair, NULL, left, leftIndex, leftLength);
+                leftPair = nextPair(table, layout, c, leftPair, NULL, left, leftIndex, leftLength);
                 if(leftPair == BAIL_OUT) { return BAIL_OUT_RESULT; }
                 leftPair = getPrimaries(variableTop, leftPair);
             }
@@ -519,15 +659,15 @@ CollationFastLatin::compareUTF8(const uint16_t *table, const uint16_t *primaries
                     return BAIL_OUT_RESULT;
                 }
                 rightPair = table[c];
-            } else if(c <= LATIN_MAX_UTF8_LEAD && 0xc2 <= c && rightIndex != rightLength &&
+            } else if(layout.isBlockLead(c) && rightIndex != rightLength &&
                     0x80 <= (t = right[rightIndex]) && t <= 0xbf) {
                 ++rightIndex;
-                c = ((c - 0xc2) << 6) + t;
+                c = layout.getBlockIndexUTF8(c, t);
                 rightPair = primaries[c];
                 if(rightPair != 0) { break; }
                 rightPair = table[c];
             } else {
-                rightPair = lookupUTF8(table, c, right, rightIndex, rightLength);
+                rightPair = lookupUTF8<Layout>(table, c, right, rightIndex, rightLength);
             }
             if(rightPair >= MIN_SHORT) {
                 rightPair &= SHORT_PRIMARY_MASK;
@@ -536,7 +676,7 @@ CollationFastLatin::compareUTF8(const uint16_t *table, const uint16_t *primaries
                 rightPair &= LONG_PRIMARY_MASK;
                 break;
             } else {
-                rightPair = nextPair(table, c, rightPair, NULL, right, rightIndex, rightLength);
+                rightPair = nextPair(table, layout, c, rightPair, NULL, right, rightIndex, rightLength);
                 if(rightPair == BAIL_OUT) { return BAIL_OUT_RESULT; }
                 rightPair = getPrimaries(variableTop, rightPair);
             }
@@ -575,10 +715,10 @@ CollationFastLatin::compareUTF8(const uint16_t *table, const uint16_t *primaries
                 UChar32 c = left[leftIndex++];
                 if(c <= 0x7f) {
                     leftPair = table[c];
-                } else if(c <= LATIN_MAX_UTF8_LEAD) {
-                    leftPair = table[((c - 0xc2) << 6) + left[leftIndex++]];
+                } else if(c < 0xe0) {
+                    leftPair = table[layout.getBlockIndexUTF8(c, left[leftIndex++])];
                 } else {
-                    leftPair = lookupUTF8Unsafe(table, c, left, leftIndex);
+                    leftPair = lookupUTF8Unsafe(table, layout, c, left, leftIndex);
                 }
                 if(leftPair >= MIN_SHORT) {
                     leftPair = getSecondariesFromOneShortCE(leftPair);
@@ -587,7 +727,7 @@ CollationFastLatin::compareUTF8(const uint16_t *table, const uint16_t *primaries
                     leftPair = COMMON_SEC_PLUS_OFFSET;
                     break;
                 } else {
-                    leftPair = nextPair(table, c, leftPair, NULL, left, leftIndex, leftLength);
+                    leftPair = nextPair(table, layout, c, leftPair, NULL, left, leftIndex, leftLength);
                     leftPair = getSecondaries(variableTop, leftPair);
                 }
             }
@@ -600,10 +740,10 @@ CollationFastLatin::compareUTF8(const uint16_t *table, const uint16_t *primaries
                 UChar32 c = right[rightIndex++];
                 if(c <= 0x7f) {
                     rightPair = table[c];
-                } else if(c <= LATIN_MAX_UTF8_LEAD) {
-                    rightPair = table[((c - 0xc2) << 6) + right[rightIndex++]];
+                } else if(c < 0xe0) {
+                    rightPair = table[layout.getBlockIndexUTF8(c, right[rightIndex++])];
                 } else {
-                    rightPair = lookupUTF8Unsafe(table, c, right, rightIndex);
+                    rightPair = lookupUTF8Unsafe(table, layout, c, right, rightIndex);
                 }
                 if(rightPair >= MIN_SHORT) {
                     rightPair = getSecondariesFromOneShortCE(rightPair);
@@ -612,7 +752,7 @@ CollationFastLatin::compareUTF8(const uint16_t *table, const uint16_t *primaries
                     rightPair = COMMON_SEC_PLUS_OFFSET;
                     break;
                 } else {
-                    rightPair = nextPair(table, c, rightPair, NULL, right, rightIndex, rightLength);
+                    rightPair = nextPair(table, layout, c, rightPair, NULL, right, rightIndex, rightLength);
                     rightPair = getSecondaries(variableTop, rightPair);
                 }
             }
@@ -649,9 +789,9 @@ CollationFastLatin::compareUTF8(const uint16_t *table, const uint16_t *primaries
                     break;
                 }
                 UChar32 c = left[leftIndex++];
-                leftPair = (c <= 0x7f) ? table[c] : lookupUTF8Unsafe(table, c, left, leftIndex);
+                leftPair = (c <= 0x7f) ? table[c] : lookupUTF8Unsafe(table, layout, c, left, leftIndex);
                 if(leftPair < MIN_LONG) {
-                    leftPair = nextPair(table, c, leftPair, NULL, left, leftIndex, leftLength);
+                    leftPair = nextPair(table, layout, c, leftPair, NULL, left, leftIndex, leftLength);
                 }
                 leftPair = getCases(variableTop, strengthIsPrimary, leftPair);
             }
@@ -662,9 +802,9 @@ CollationFastLatin::compareUTF8(const uint16_t *table, const uint16_t *primaries
                     break;
                 }
                 UChar32 c = right[rightIndex++];
-                rightPair = (c <= 0x7f) ? table[c] : lookupUTF8Unsafe(table, c, right, rightIndex);
+                rightPair = (c <= 0x7f) ? table[c] : lookupUTF8Unsafe(table, layout, c, right, rightIndex);
                 if(rightPair < MIN_LONG) {
-                    rightPair = nextPair(table, c, rightPair, NULL, right, rightIndex, rightLength);
+                    rightPair = nextPair(table, layout, c, rightPair, NULL, right, rightIndex, rightLength);
                 }
                 rightPair = getCases(variableTop, strengthIsPrimary, rightPair);
             }
@@ -702,9 +842,9 @@ CollationFastLatin::compareUTF8(const uint16_t *table, const uint16_t *primaries
                 break;
             }
             UChar32 c = left[leftIndex++];
-            leftPair = (c <= 0x7f) ? table[c] : lookupUTF8Unsafe(table, c, left, leftIndex);
+            leftPair = (c <= 0x7f) ? table[c] : lookupUTF8Unsafe(table, layout, c, left, leftIndex);
             if(leftPair < MIN_LONG) {
-                leftPair = nextPair(table, c, leftPair, NULL, left, leftIndex, leftLength);
+                leftPair = nextPair(table, layout, c, leftPair, NULL, left, leftIndex, leftLength);
             }
             leftPair = getTertiaries(variableTop, withCaseBits, leftPair);
         }
@@ -715,9 +855,9 @@ CollationFastLatin::compareUTF8(const uint16_t *table, const uint16_t *primaries
                 break;
             }
             UChar32 c = right[rightIndex++];
-            rightPair = (c <= 0x7f) ? table[c] : lookupUTF8Unsafe(table, c, right, rightIndex);
+            rightPair = (c <= 0x7f) ? table[c] : lookupUTF8Unsafe(table, layout, c, right, rightIndex);
             if(rightPair < MIN_LONG) {
-                rightPair = nextPair(table, c, rightPair, NULL, right, rightIndex, rightLength);
+                rightPair = nextPair(table, layout, c, rightPair, NULL, right, rightIndex, rightLength);
             }
             rightPair = getTertiaries(variableTop, withCaseBits, rightPair);
         }
@@ -758,9 +898,9 @@ CollationFastLatin::compareUTF8(const uint16_t *table, const uint16_t *primaries
                 break;
             }
             UChar32 c = left[leftIndex++];
-            leftPair = (c <= 0x7f) ? table[c] : lookupUTF8Unsafe(table, c, left, leftIndex);
+            leftPair = (c <= 0x7f) ? table[c] : lookupUTF8Unsafe(table, layout, c, left, leftIndex);
             if(leftPair < MIN_LONG) {
-                leftPair = nextPair(table, c, leftPair, NULL, left, leftIndex, leftLength);
+                leftPair = nextPair(table, layout, c, leftPair, NULL, left, leftIndex, leftLength);
             }
             leftPair = getQuaternaries(variableTop, leftPair);
         }
@@ -771,9 +911,9 @@ CollationFastLatin::compareUTF8(const uint16_t *table, const uint16_t *primaries
                 break;
             }
             UChar32 c = right[rightIndex++];
-            rightPair = (c <= 0x7f) ? table[c] : lookupUTF8Unsafe(table, c, right, rightIndex);
+            rightPair = (c <= 0x7f) ? table[c] : lookupUTF8Unsafe(table, layout, c, right, rightIndex);
             if(rightPair < MIN_LONG) {
-                rightPair = nextPair(table, c, rightPair, NULL, right, rightIndex, rightLength);
+                rightPair = nextPair(table, layout, c, rightPair, NULL, right, rightIndex, rightLength);
             }
             rightPair = getQuaternaries(variableTop, rightPair);
         }
@@ -795,11 +935,12 @@ CollationFastLatin::compareUTF8(const uint16_t *table, const uint16_t *primaries
     return UCOL_EQUAL;
 }
 
+template<typename Layout>
 uint32_t
 CollationFastLatin::lookup(const uint16_t *table, UChar32 c) {
-    U_ASSERT(c > LATIN_MAX);
+    // The caller handled characters with precomputed primaries.
     if(PUNCT_START <= c && c < PUNCT_LIMIT) {
-        return table[c - PUNCT_START + LATIN_LIMIT];
+        return table[c - PUNCT_START + Layout::PUNCT_INDEX];
     } else if(c == 0xfffe) {
         return MERGE_WEIGHT;
     } else if(c == 0xffff) {
@@ -809,10 +950,11 @@ CollationFastLatin::lookup(const uint16_t *table, UChar32 c) {
     }
 }
 
+template<typename Layout>
 uint32_t
 CollationFastLatin::lookupUTF8(const uint16_t *table, UChar32 c,
                                const uint8_t *s8, int32_t &sIndex, int32_t sLength) {
-    // The caller handled ASCII and valid/supported Latin.
+    // The caller handled ASCII and valid/supported Latin or script block characters.
     U_ASSERT(c > 0x7f);
     int32_t i2 = sIndex + 1;
     if(i2 < sLength || sLength < 0) {
@@ -820,7 +962,7 @@ CollationFastLatin::lookupUTF8(const uint16_t *table, UChar32 c,
         uint8_t t2 = s8[i2];
         sIndex += 2;
         if(c == 0xe2 && t1 == 0x80 && 0x80 <= t2 && t2 <= 0xbf) {
-            return table[(LATIN_LIMIT - 0x80) + t2];  // 2000..203F -> 0180..01BF
+            return table[(Layout::PUNCT_INDEX - 0x80) + t2];  // 2000..203F
         } else if(c == 0xef && t1 == 0xbf) {
             if(t2 == 0xbe) {
                 return MERGE_WEIGHT;  // U+FFFE
@@ -832,19 +974,20 @@ CollationFastLatin::lookupUTF8(const uint16_t *table, UChar32 c,
     return BAIL_OUT;
 }
 
+template<typename Layout>
 uint32_t
-CollationFastLatin::lookupUTF8Unsafe(const uint16_t *table, UChar32 c,
+CollationFastLatin::lookupUTF8Unsafe(const uint16_t *table, const Layout &layout, UChar32 c,
                                      const uint8_t *s8, int32_t &sIndex) {
     // The caller handled ASCII.
     // The string is well-formed and contains only supported characters.
     U_ASSERT(c > 0x7f);
-    if(c <= LATIN_MAX_UTF8_LEAD) {
-        return table[((c - 0xc2) << 6) + s8[sIndex++]];  // 0080..017F
+    if(c < 0xe0) {
+        return table[layout.getBlockIndexUTF8(c, s8[sIndex++])];  // Latin or script block
     }
     uint8_t t2 = s8[sIndex + 1];
     sIndex += 2;
     if(c == 0xe2) {
-        return table[(LATIN_LIMIT - 0x80) + t2];  // 2000..203F -> 0180..01BF
+        return table[(Layout::PUNCT_INDEX - 0x80) + t2];  // 2000..203F
     } else if(t2 == 0xbe) {
         return MERGE_WEIGHT;  // U+FFFE
     } else {
@@ -852,13 +995,14 @@ CollationFastLatin::lookupUTF8Unsafe(const uint16_t *table, UChar32 c,
     }
 }
 
+template<typename Layout>
 uint32_t
-CollationFastLatin::nextPair(const uint16_t *table, UChar32 c, uint32_t ce,
+CollationFastLatin::nextPair(const uint16_t *table, const Layout &layout, UChar32 c, uint32_t ce,
                              const UChar *s16, const uint8_t *s8, int32_t &sIndex, int32_t &sLength) {
     if(ce >= MIN_LONG || ce < CONTRACTION) {
         return ce;  // simple or special mini CE
     } else if(ce >= EXPANSION) {
-        int32_t index = NUM_FAST_CHARS + (ce & INDEX_MASK);
+        int32_t index = Layout::NUM_CHARS + (ce & INDEX_MASK);
         return ((uint32_t)table[index + 1] << 16) | table[index];
     } else /* ce >= CONTRACTION */ {
         if(c == 0 && sLength < 0) {
@@ -867,36 +1011,37 @@ CollationFastLatin::nextPair(const uint16_t *table, UChar32 c, uint32_t ce,
         }
         // Contraction list: Default mapping followed by
         // 0 or more single-character contraction suffix mappings.
-        int32_t index = NUM_FAST_CHARS + (ce & INDEX_MASK);
+        int32_t index = Layout::NUM_CHARS + (ce & INDEX_MASK);
         if(sIndex != sLength) {
             // Read the next character.
             int32_t c2;
             int32_t nextIndex = sIndex;
             if(s16 != NULL) {
                 c2 = s16[nextIndex++];
-                if(c2 > LATIN_MAX) {
-                    if(PUNCT_START <= c2 && c2 < PUNCT_LIMIT) {
-                        c2 = c2 - PUNCT_START + LATIN_LIMIT;  // 2000..203F -> 0180..01BF
-                    } else if(c2 == 0xfffe || c2 == 0xffff) {
-                        c2 = -1;  // U+FFFE & U+FFFF cannot occur in contractions.
-                    } else {
-                        return BAIL_OUT;
-                    }
+                int32_t x = layout.getPrimaryIndex(c2);
+                if(x >= 0) {
+                    c2 = x;
+                } else if(PUNCT_START <= c2 && c2 < PUNCT_LIMIT) {
+                    c2 = c2 - PUNCT_START + Layout::PUNCT_INDEX;  // 2000..203F
+                } else if(c2 == 0xfffe || c2 == 0xffff) {
+                    c2 = -1;  // U+FFFE & U+FFFF cannot occur in contractions.
+                } else {
+                    return BAIL_OUT;
                 }
             } else {
                 c2 = s8[nextIndex++];
                 if(c2 > 0x7f) {
                     uint8_t t;
-                    if(c2 <= 0xc5 && 0xc2 <= c2 && nextIndex != sLength &&
+                    if(layout.isBlockLead(c2) && nextIndex != sLength &&
                             0x80 <= (t = s8[nextIndex]) && t <= 0xbf) {
-                        c2 = ((c2 - 0xc2) << 6) + t;  // 0080..017F
+                        c2 = layout.getBlockIndexUTF8(c2, t);  // Latin or script block
                         ++nextIndex;
                     } else {
                         int32_t i2 = nextIndex + 1;
                         if(i2 < sLength || sLength < 0) {
                             if(c2 == 0xe2 && s8[nextIndex] == 0x80 &&
                                     0x80 <= (t = s8[i2]) && t <= 0xbf) {
-                                c2 = (LATIN_LIMIT - 0x80) + t;  // 2000..203F -> 0180..01BF
+                                c2 = (Layout::PUNCT_INDEX - 0x80) + t;  // 2000..203F
                             } else if(c2 == 0xef && s8[nextIndex] == 0xbf &&
                                     ((t = s8[i2]) == 0xbe || t == 0xbf)) {
                                 c2 = -1;  // U+FFFE & U+FFFF cannot occur in contractions.
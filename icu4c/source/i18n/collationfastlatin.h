@@ -46,6 +46,18 @@ class U_I18N_API CollationFastLatin /* all static */ {
     // excludes U+FFFE & U+FFFF
     static const int32_t NUM_FAST_CHARS = LATIN_LIMIT + (PUNCT_LIMIT - PUNCT_START);
 
+    /**
+     * A fast script table covers ASCII, one block of this many code points
+     * starting at a multiple of 0x40 below U+0800 (see getScriptBlockStart()),
+     * and the same punctuation as the fast Latin table.
+     * Latin letters are not supported in a fast script table.
+     */
+    static const int32_t SCRIPT_BLOCK_LENGTH = 0x80;
+    /** Number of fast script characters with precomputed primaries: ASCII + script block. */
+    static const int32_t SCRIPT_PRIMARIES_LENGTH = 0x80 + SCRIPT_BLOCK_LENGTH;
+    static const int32_t NUM_FAST_SCRIPT_CHARS =
+            SCRIPT_PRIMARIES_LENGTH + (PUNCT_LIMIT - PUNCT_START);
+
     // Note on the supported weight ranges:
     // Analysis of UCA 6.3 and CLDR 23 non-search tailorings shows that
     // the CEs for characters in the above ranges, excluding expansions with length >2,
@@ -201,6 +213,27 @@ class U_I18N_API CollationFastLatin /* all static */ {
         }
     }
 
+    /**
+     * Like getCharIndex() but for a fast script table with the given script block.
+     */
+    static inline int32_t getScriptCharIndex(UChar c, UChar32 blockStart) {
+        if(c <= 0x7f) {
+            return c;
+        } else if((uint32_t)(c - blockStart) < (uint32_t)SCRIPT_BLOCK_LENGTH) {
+            return c - blockStart + 0x80;
+        } else if(PUNCT_START <= c && c < PUNCT_LIMIT) {
+            return c - (PUNCT_START - SCRIPT_PRIMARIES_LENGTH);
+        } else {
+            return -1;
+        }
+    }
+
+    /**
+     * Returns the first code point of the fast script table block for the script,
+     * or -1 if there is no fast script table support for it.
+     */
+    static UChar32 getScriptBlockStart(int32_t script);
+
     /**
      * Computes the options value for the compare functions
      * and writes the precomputed primary weights.
@@ -210,6 +243,16 @@ class U_I18N_API CollationFastLatin /* all static */ {
     static int32_t getOptions(const CollationData *data, const CollationSettings &settings,
                               uint16_t *primaries, int32_t capacity);
 
+    /**
+     * Same as getOptions() but for a fast script table built for the data.
+     * Returns -1 if the table is NULL
+     * or if the script fastpath is not supported for the settings.
+     * The capacity must be SCRIPT_PRIMARIES_LENGTH.
+     */
+    static int32_t getScriptOptions(const CollationData *data, const uint16_t *table,
+                                    const CollationSettings &settings,
+                                    uint16_t *primaries, int32_t capacity);
+
     static int32_t compareUTF16(const uint16_t *table, const uint16_t *primaries, int32_t options,
                                 const UChar *left, int32_t leftLength,
                                 const UChar *right, int32_t rightLength);
@@ -218,14 +261,49 @@ class U_I18N_API CollationFastLatin /* all static */ {
                                const uint8_t *left, int32_t leftLength,
                                const uint8_t *right, int32_t rightLength);
 
+    /**
+     * Same as compareUTF16() but with a fast script table
+     * and its getScriptOptions() primaries and options.
+     */
+    static int32_t compareScriptUTF16(const uint16_t *table, const uint16_t *primaries,
+                                      int32_t options,
+                                      const UChar *left, int32_t leftLength,
+                                      const UChar *right, int32_t rightLength);
+
+    static int32_t compareScriptUTF8(const uint16_t *table, const uint16_t *primaries,
+                                     int32_t options,
+                                     const uint8_t *left, int32_t leftLength,
+                                     const uint8_t *right, int32_t rightLength);
+
 private:
+    static int32_t getOptions(const CollationData *data, const uint16_t *table, int32_t script,
+                              const CollationSettings &settings,
+                              uint16_t *primaries, int32_t length);
+
+    // The Layout type parameter maps characters to table indexes,
+    // either for the fast Latin table or for a fast script table.
+    template<typename Layout>
+    static int32_t compareUTF16(const uint16_t *table, const Layout &layout,
+                                const uint16_t *primaries, int32_t options,
+                                const UChar *left, int32_t leftLength,
+                                const UChar *right, int32_t rightLength);
+    template<typename Layout>
+    static int32_t compareUTF8(const uint16_t *table, const Layout &layout,
+                               const uint16_t *primaries, int32_t options,
+                               const uint8_t *left, int32_t leftLength,
+                               const uint8_t *right, int32_t rightLength);
+
+    template<typename Layout>
     static uint32_t lookup(const uint16_t *table, UChar32 c);
+    template<typename Layout>
     static uint32_t lookupUTF8(const uint16_t *table, UChar32 c,
                                const uint8_t *s8, int32_t &sIndex, int32_t sLength);
-    static uint32_t lookupUTF8Unsafe(const uint16_t *table, UChar32 c,
+    template<typename Layout>
+    static uint32_t lookupUTF8Unsafe(const uint16_t *table, const Layout &layout, UChar32 c,
                                      const uint8_t *s8, int32_t &sIndex);
 
-    static uint32_t nextPair(const uint16_t *table, UChar32 c, uint32_t ce,
+    template<typename Layout>
+    static uint32_t nextPair(const uint16_t *table, const Layout &layout, UChar32 c, uint32_t ce,
                              const UChar *s16, const uint8_t *s8, int32_t &sIndex, int32_t &sLength);
 
     static inline uint32_t getPrimaries(uint32_t variableTop, uint32_t pair) {
@@ -313,6 +391,33 @@ class U_I18N_API CollationFastLatin /* all static */ {
  * and it is simpler to store only the fast-Latin weights.
  */
 
+/*
+ * Format of a CollationFastLatin script table.
+ *
+ * A fast script table is built at runtime for a tailoring which reorders
+ * a script with a small alphabet to the front, for example [reorder Cyrl].
+ * It is never stored in the collation data files.
+ *
+ * The format is the same as for the fast Latin table, with these differences:
+ *
+ * The header has two more units after the varTops:
+ *   uint16_t script -- UScriptCode of the script
+ *   uint16_t blockStart -- first code point of the script block,
+ *                          see CollationFastLatin::getScriptBlockStart()
+ *
+ * uint16_t miniCEs[0x140]
+ *   A mini collation element for each character U+0000..U+007F,
+ *   blockStart..blockStart+7F, and U+2000..U+203F.
+ *   The contraction character indexes use the same order.
+ *
+ * Mini primaries are assigned to the special groups, the digits, and the script,
+ * but not to Latin letters, which bail out.
+ * Since reordering does not change the relative order of these ranges
+ * unless it moves the special groups or digits,
+ * the table is valid for other reorderings of the same data as well;
+ * see CollationFastLatin::getScriptOptions().
+ */
+
 U_NAMESPACE_END
 
 #endif  // !UCONFIG_NO_COLLATION
@@ -87,10 +87,14 @@ binarySearch(const int64_t list[], int32_t limit, int64_t ce) {
 }  // namespace
 
 CollationFastLatinBuilder::CollationFastLatinBuilder(UErrorCode &errorCode)
-        : ce0(0), ce1(0),
+        : script(USCRIPT_LATIN),
+          blockStart(0x80), blockLimit(CollationFastLatin::LATIN_LIMIT),
+          numFastChars(CollationFastLatin::NUM_FAST_CHARS),
+          ce0(0), ce1(0),
           contractionCEs(errorCode), uniqueCEs(errorCode),
           miniCEs(NULL),
-          firstDigitPrimary(0), firstLatinPrimary(0), lastLatinPrimary(0),
+          firstDigitPrimary(0),
+          lastLowPrimary(0), firstScriptPrimary(0), lastScriptPrimary(0),
           firstShortPrimary(0), shortPrimaryOverflow(FALSE),
           headerLength(0) {
 }
@@ -101,6 +105,27 @@ CollationFastLatinBuilder::~CollationFastLatinBuilder() {
 
 UBool
 CollationFastLatinBuilder::forData(const CollationData &data, UErrorCode &errorCode) {
+    return build(data, errorCode);
+}
+
+UBool
+CollationFastLatinBuilder::forScript(const CollationData &data, int32_t sc,
+                                     UErrorCode &errorCode) {
+    if(U_FAILURE(errorCode)) { return FALSE; }
+    UChar32 start = CollationFastLatin::getScriptBlockStart(sc);
+    if(start < 0) {
+        errorCode = U_ILLEGAL_ARGUMENT_ERROR;
+        return FALSE;
+    }
+    script = sc;
+    blockStart = start;
+    blockLimit = start + CollationFastLatin::SCRIPT_BLOCK_LENGTH;
+    numFastChars = CollationFastLatin::NUM_FAST_SCRIPT_CHARS;
+    return build(data, errorCode);
+}
+
+UBool
+CollationFastLatinBuilder::build(const CollationData &data, UErrorCode &errorCode) {
     if(U_FAILURE(errorCode)) { return FALSE; }
     if(!result.isEmpty()) {  // This builder is not reusable.
         errorCode = U_INVALID_STATE_ERROR;
@@ -115,7 +140,7 @@ CollationFastLatinBuilder::forData(const CollationData &data, UErrorCode &errorC
     if(shortPrimaryOverflow) {
         // Give digits long mini primaries,
         // so that there are more short primaries for letters.
-        firstShortPrimary = firstLatinPrimary;
+        firstShortPrimary = firstScriptPrimary;
         resetCEs();
         getCEs(data, errorCode);
         if(!encodeUniqueCEs(errorCode)) { return FALSE; }
@@ -139,6 +164,9 @@ UBool
 CollationFastLatinBuilder::loadGroups(const CollationData &data, UErrorCode &errorCode) {
     if(U_FAILURE(errorCode)) { return FALSE; }
     headerLength = 1 + NUM_SPECIAL_GROUPS;
+    if(script != USCRIPT_LATIN) {
+        headerLength += 2;  // script & blockStart
+    }
     uint32_t r0 = (CollationFastLatin::VERSION << 8) | headerLength;
     result.append((UChar)r0);
     // The first few reordering groups should be special groups
@@ -153,12 +181,20 @@ CollationFastLatinBuilder::loadGroups(const CollationData &data, UErrorCode &err
     }
 
     firstDigitPrimary = data.getFirstPrimaryForGroup(UCOL_REORDER_CODE_DIGIT);
-    firstLatinPrimary = data.getFirstPrimaryForGroup(USCRIPT_LATIN);
-    lastLatinPrimary = data.getLastPrimaryForGroup(USCRIPT_LATIN);
-    if(firstDigitPrimary == 0 || firstLatinPrimary == 0) {
+    firstScriptPrimary = data.getFirstPrimaryForGroup(script);
+    lastScriptPrimary = data.getLastPrimaryForGroup(script);
+    if(firstDigitPrimary == 0 || firstScriptPrimary == 0) {
         // missing data
         return FALSE;
     }
+    if(script == USCRIPT_LATIN) {
+        lastLowPrimary = lastScriptPrimary;
+    } else {
+        // Latin letters and any scripts between the digits and the fast script
+        // would be reordered relative to the fast script by its reorder code.
+        lastLowPrimary = data.getLastPrimaryForGroup(UCOL_REORDER_CODE_DIGIT);
+        result.append((UChar)script).append((UChar)blockStart);
+    }
     return TRUE;
 }
 
@@ -206,7 +242,10 @@ CollationFastLatinBuilder::getCEs(const CollationData &data, UErrorCode &errorCo
     if(U_FAILURE(errorCode)) { return; }
     int32_t i = 0;
     for(UChar c = 0;; ++i, ++c) {
-        if(c == CollationFastLatin::LATIN_LIMIT) {
+        if(c == 0x80) {
+            c = blockStart;
+        }
+        if(c == blockLimit) {
             c = CollationFastLatin::PUNCT_START;
         } else if(c == CollationFastLatin::PUNCT_LIMIT) {
             break;
@@ -303,8 +342,9 @@ CollationFastLatinBuilder::getCEsFromCE32(const CollationData &data, UChar32 c,
     // We do not support an ignorable ce0 unless it is completely ignorable.
     uint32_t p0 = (uint32_t)(ce0 >> 32);
     if(p0 == 0) { return FALSE; }
-    // We only support primaries up to the Latin script.
-    if(p0 > lastLatinPrimary) { return FALSE; }
+    // We only support primaries up to the Latin script,
+    // or the special groups, digits and the fast script.
+    if(!isSupportedPrimary(p0)) { return FALSE; }
     // We support non-common secondary and case weights only together with short primaries.
     uint32_t lower32_0 = (uint32_t)ce0;
     if(p0 < firstShortPrimary) {
@@ -320,7 +360,8 @@ CollationFastLatinBuilder::getCEsFromCE32(const CollationData &data, UChar32 c,
         // This is so that we can test the first primary and use the same mask for both,
         // and determine for both whether they are variable.
         uint32_t p1 = (uint32_t)(ce1 >> 32);
-        if(p1 == 0 ? p0 < firstShortPrimary : !inSameGroup(p0, p1)) { return FALSE; }
+        if(p1 == 0 ? p0 < firstShortPrimary :
+                !inSameGroup(p0, p1) || !isSupportedPrimary(p1)) { return FALSE; }
         uint32_t lower32_1 = (uint32_t)ce1;
         // No tertiary CEs.
         if((lower32_1 >> 16) == 0) { return FALSE; }
@@ -361,7 +402,7 @@ CollationFastLatinBuilder::getCEsFromContractionCE32(const CollationData &data,
     UCharsTrie::Iterator suffixes(p + 2, 0, errorCode);
     while(suffixes.next(errorCode)) {
         const UnicodeString &suffix = suffixes.getString();
-        int32_t x = CollationFastLatin::getCharIndex(suffix.charAt(0));
+        int32_t x = getCharIndex(suffix.charAt(0));
         if(x < 0) { continue; }  // ignore anything but fast Latin text
         if(x == prevX) {
             if(addContraction) {
@@ -565,11 +606,11 @@ UBool
 CollationFastLatinBuilder::encodeCharCEs(UErrorCode &errorCode) {
     if(U_FAILURE(errorCode)) { return FALSE; }
     int32_t miniCEsStart = result.length();
-    for(int32_t i = 0; i < CollationFastLatin::NUM_FAST_CHARS; ++i) {
+    for(int32_t i = 0; i < numFastChars; ++i) {
         result.append((UChar)0);  // initialize to completely ignorable
     }
     int32_t indexBase = result.length();
-    for(int32_t i = 0; i < CollationFastLatin::NUM_FAST_CHARS; ++i) {
+    for(int32_t i = 0; i < numFastChars; ++i) {
         int64_t ce = charCEs[i][0];
         if(isContractionCharCE(ce)) { continue; }  // defer contraction
         uint32_t miniCE = encodeTwoCEs(ce, charCEs[i][1]);
@@ -595,9 +636,9 @@ CollationFastLatinBuilder::encodeContractions(UErrorCode &errorCode) {
     // We encode all contraction lists so that the first word of a list
     // terminates the previous list, and we only need one additional terminator at the end.
     if(U_FAILURE(errorCode)) { return FALSE; }
-    int32_t indexBase = headerLength + CollationFastLatin::NUM_FAST_CHARS;
+    int32_t indexBase = headerLength + numFastChars;
     int32_t firstContractionIndex = result.length();
-    for(int32_t i = 0; i < CollationFastLatin::NUM_FAST_CHARS; ++i) {
+    for(int32_t i = 0; i < numFastChars; ++i) {
         int64_t ce = charCEs[i][0];
         if(!isContractionCharCE(ce)) { continue; }
         int32_t contractionIndex = result.length() - indexBase;
@@ -645,11 +686,14 @@ CollationFastLatinBuilder::encodeContractions(UErrorCode &errorCode) {
         printf(" %04x", result[i]);
     }
     printf("\n   char mini CEs");
-    U_ASSERT(CollationFastLatin::NUM_FAST_CHARS % 16 == 0);
+    U_ASSERT(numFastChars % 16 == 0);
     for(; i < indexBase; i += 16) {
         UChar32 c = i - headerLength;
-        if(c >= CollationFastLatin::LATIN_LIMIT) {
-            c = CollationFastLatin::PUNCT_START + c - CollationFastLatin::LATIN_LIMIT;
+        if(c >= 0x80) {
+            c += blockStart - 0x80;
+            if(c >= blockLimit) {
+                c = CollationFastLatin::PUNCT_START + c - blockLimit;
+            }
         }
         printf("\n %04x:", c);
         for(int32_t j = 0; j < 16; ++j) {
@@ -21,6 +21,7 @@
 #include "unicode/ucol.h"
 #include "unicode/unistr.h"
 #include "unicode/uobject.h"
+#include "unicode/uscript.h"
 #include "collation.h"
 #include "collationfastlatin.h"
 #include "uvectr64.h"
@@ -36,6 +37,15 @@ class U_I18N_API CollationFastLatinBuilder : public UObject {
 
     UBool forData(const CollationData &data, UErrorCode &errorCode);
 
+    /**
+     * Builds a fast script table for the data and the script.
+     * See the CollationFastLatin script table format.
+     *
+     * @param script a script for which CollationFastLatin::getScriptBlockStart() >= 0
+     * @return TRUE if the table was built
+     */
+    UBool forScript(const CollationData &data, int32_t script, UErrorCode &errorCode);
+
     const uint16_t *getTable() const {
         return reinterpret_cast<const uint16_t *>(result.getBuffer());
     }
@@ -45,8 +55,17 @@ class U_I18N_API CollationFastLatinBuilder : public UObject {
     // space, punct, symbol, currency (not digit)
     enum { NUM_SPECIAL_GROUPS = UCOL_REORDER_CODE_CURRENCY - UCOL_REORDER_CODE_FIRST + 1 };
 
+    UBool build(const CollationData &data, UErrorCode &errorCode);
     UBool loadGroups(const CollationData &data, UErrorCode &errorCode);
     UBool inSameGroup(uint32_t p, uint32_t q) const;
+    UBool isSupportedPrimary(uint32_t p) const {
+        return p <= lastLowPrimary || (firstScriptPrimary <= p && p <= lastScriptPrimary);
+    }
+    int32_t getCharIndex(UChar c) const {
+        return script == USCRIPT_LATIN ?
+            CollationFastLatin::getCharIndex(c) :
+            CollationFastLatin::getScriptCharIndex(c, blockStart);
+    }
 
     void resetCEs();
     void getCEs(const CollationData &data, UErrorCode &errorCode);
@@ -68,6 +87,13 @@ class U_I18N_API CollationFastLatinBuilder : public UObject {
 
     static const uint32_t CONTRACTION_FLAG = 0x80000000;
 
+    // USCRIPT_LATIN for the fast Latin table, otherwise the fast script.
+    int32_t script;
+    // Characters blockStart..blockLimit-1 follow ASCII in the table.
+    UChar32 blockStart;
+    UChar32 blockLimit;
+    int32_t numFastChars;
+
     // temporary "buffer"
     int64_t ce0, ce1;
 
@@ -82,8 +108,12 @@ class U_I18N_API CollationFastLatinBuilder : public UObject {
     // These are constant for a given root collator.
     uint32_t lastSpecialPrimaries[NUM_SPECIAL_GROUPS];
     uint32_t firstDigitPrimary;
-    uint32_t firstLatinPrimary;
-    uint32_t lastLatinPrimary;
+    // Supported primaries are those up to lastLowPrimary
+    // (up to the end of Latin for fast Latin, up to the digits for a fast script)
+    // and those of the script (Latin or the fast script).
+    uint32_t lastLowPrimary;
+    uint32_t firstScriptPrimary;
+    uint32_t lastScriptPrimary;
     // This determines the first normal primary weight which is mapped to
     // a short mini primary. It must be >=firstDigitPrimary.
     uint32_t firstShortPrimary;
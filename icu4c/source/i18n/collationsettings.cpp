@@ -34,12 +34,16 @@ CollationSettings::CollationSettings(const CollationSettings &other)
           minHighNoReorder(other.minHighNoReorder),
           reorderRanges(NULL), reorderRangesLength(0),
           reorderCodes(NULL), reorderCodesLength(0), reorderCodesCapacity(0),
-          fastLatinOptions(other.fastLatinOptions) {
+          fastLatinOptions(other.fastLatinOptions),
+          fastScriptOptions(other.fastScriptOptions) {
     UErrorCode errorCode = U_ZERO_ERROR;
     copyReorderingFrom(other, errorCode);
     if(fastLatinOptions >= 0) {
         uprv_memcpy(fastLatinPrimaries, other.fastLatinPrimaries, sizeof(fastLatinPrimaries));
     }
+    if(fastScriptOptions >= 0) {
+        uprv_memcpy(fastScriptPrimaries, other.fastScriptPrimaries, sizeof(fastScriptPrimaries));
+    }
 }
 
 CollationSettings::~CollationSettings() {
@@ -0,0 +1,418 @@
+// © 2016 and later: Unicode, Inc. and others.
+// License & terms of use: http://www.unicode.org/copyright.html
+/*
+*******************************************************************************
+*   file name:  collationsort.cpp
+*   encoding:   UTF-8
+*   tab size:   8 (not used)
+*   indentation:4
+*
+*   RuleBasedCollator::sortStrings(): Sorting batches of strings via
+*   sort keys and a most-significant-byte-first radix sort,
+*   with key generation and sorting split into tasks for a caller-supplied runner,
+*   or by comparing the strings where that is estimated to be faster.
+*/
+
+#include "unicode/utypes.h"
+
+#if !UCONFIG_NO_COLLATION
+
+#include "unicode/bytestream.h"
+#include "unicode/tblcoll.h"
+#include "bytesinkutil.h"
+#include "charstr.h"
+#include "cmemory.h"
+#include "cstring.h"
+#include "uarrsort.h"
+#include "utask_imp.h"
+#include "uvectr32.h"
+
+#include <atomic>
+
+U_NAMESPACE_BEGIN
+
+namespace {
+
+/** Upper limit for the number of parallel tasks per call. */
+const int32_t kMaxTasks = 64;
+/**
+ * Batches with fewer strings are sorted by comparing the strings:
+ * Generating all of the sort keys costs more than the comparisons.
+ */
+const int32_t kMinKeySortCount = 64;
+/** Number of strings whose sort keys are generated to choose between the two ways of sorting. */
+const int32_t kSampleCount = 32;
+/**
+ * Sorting via sort keys is chosen when the average sort key length in bytes
+ * is at most this factor times log2(count), the number of comparisons per string.
+ * Generating a key costs time proportional to its length,
+ * while a comparison usually stops at the first primary difference.
+ * Measured single-threaded with collperf2 on 10k strings:
+ * sort keys of 13..17 bytes sorted 2..3 times faster via keys,
+ * ~42 bytes broke even, and longer keys favored comparisons.
+ */
+const int32_t kMaxKeyBytesPerComparison = 3;
+/** Each additional parallel task gets at least this many strings. */
+const int32_t kMinStringsPerTask = 4096;
+/** Buckets with at most this many keys are finished with an insertion sort. */
+const int32_t kMaxInsertionSortLength = 16;
+/**
+ * The radix sort does not recurse deeper than this.
+ * It switches to a comparison sort, which is faster for very long common prefixes
+ * and bounds the stack usage.
+ */
+const int32_t kMaxRadixSortDepth = 24;
+
+/** A sort key together with the index of its string. */
+struct SortItem {
+    const uint8_t *key;
+    int32_t index;
+};
+
+/**
+ * Compares two sort keys from a byte offset where they are known to be equal,
+ * and then their indexes, so that equal keys keep the input order.
+ */
+inline int32_t compareItems(const SortItem &a, const SortItem &b, int32_t offset) {
+    int32_t diff = uprv_strcmp(reinterpret_cast<const char *>(a.key) + offset,
+                               reinterpret_cast<const char *>(b.key) + offset);
+    return diff != 0 ? diff : a.index - b.index;
+}
+
+int32_t U_CALLCONV
+compareItemsAt(const void *context, const void *left, const void *right) {
+    return compareItems(*static_cast<const SortItem *>(left), *static_cast<const SortItem *>(right),
+                        *static_cast<const int32_t *>(context));
+}
+
+void insertionSort(SortItem *items, int32_t length, int32_t offset) {
+    for (int32_t i = 1; i < length; ++i) {
+        SortItem item = items[i];
+        int32_t j = i;
+        for (; j > 0 && compareItems(items[j - 1], item, offset) > 0; --j) {
+            items[j] = items[j - 1];
+        }
+        items[j] = item;
+    }
+}
+
+const int32_t kSplit = -1;
+
+/**
+ * Distributes the items into buckets by their key bytes at the offset,
+ * keeping the order within each bucket (stable counting sort).
+ * Sort keys do not contain zero bytes except for the terminator,
+ * so bucket 0 collects the keys that end at the offset.
+ * @param starts receives the bucket start indexes, and the length at starts[256]
+ * @return kSplit if the items were distributed,
+ *         or else the key byte that all of the items have at the offset
+ *         (then they were not moved)
+ */
+int32_t distribute(SortItem *items, SortItem *temp, int32_t length, int32_t offset,
+                   int32_t starts[257]) {
+    int32_t counts[256];
+    uprv_memset(counts, 0, sizeof(counts));
+    for (int32_t i = 0; i < length; ++i) {
+        ++counts[items[i].key[offset]];
+    }
+    int32_t b = items[0].key[offset];
+    if (counts[b] == length) {
+        return b;
+    }
+    int32_t start = 0;
+    for (int32_t i = 0; i < 256; ++i) {
+        starts[i] = start;
+        start += counts[i];
+        counts[i] = starts[i];  // next index in bucket i
+    }
+    starts[256] = length;
+    for (int32_t i = 0; i < length; ++i) {
+        temp[counts[items[i].key[offset]]++] = items[i];
+    }
+    uprv_memcpy(items, temp, (size_t)length * sizeof(SortItem));
+    return kSplit;
+}
+
+/**
+ * Sorts items whose keys are equal before the offset.
+ * temp is scratch space for as many items.
+ */
+void radixSort(SortItem *items, SortItem *temp, int32_t length, int32_t offset, int32_t depth) {
+    for (;;) {
+        if (length <= kMaxInsertionSortLength) {
+            insertionSort(items, length, offset);
+            return;
+        }
+        if (depth > kMaxRadixSortDepth) {
+            UErrorCode errorCode = U_ZERO_ERROR;
+            uprv_sortArray(items, length, (int32_t)sizeof(SortItem),
+                           compareItemsAt, &offset, FALSE, &errorCode);
+            return;
+        }
+        int32_t starts[257];
+        int32_t b = distribute(items, temp, length, offset, starts);
+        if (b == 0) {
+            return;  // All keys are equal, and still in input order.
+        } else if (b != kSplit) {
+            ++offset;  // All keys continue with the same byte.
+            continue;
+        }
+        for (b = 1; b < 256; ++b) {
+            int32_t start = starts[b];
+            int32_t bucketLength = starts[b + 1] - start;
+            if (bucketLength > 1) {
+                radixSort(items + start, temp + start, bucketLength, offset + 1, depth + 1);
+            }
+        }
+        return;
+    }
+}
+
+/** The sort keys for a contiguous range of the strings. */
+struct KeyChunk : public UMemory {
+    KeyChunk() : start(0), limit(0), errorCode(U_ZERO_ERROR) {}
+
+    int32_t start;
+    int32_t limit;
+    CharString keys;
+    UErrorCode errorCode;
+};
+
+inline int32_t getSortKeys(const RuleBasedCollator &coll,
+                           const UChar *const strings[], const int32_t lengths[], int32_t count,
+                           ByteSink &sink, int32_t offsets[], UErrorCode &errorCode) {
+    return coll.internalGetSortKeys(strings, lengths, count, sink, -1, offsets, NULL, errorCode);
+}
+
+inline int32_t getSortKeys(const RuleBasedCollator &coll,
+                           const char *const strings[], const int32_t lengths[], int32_t count,
+                           ByteSink &sink, int32_t offsets[], UErrorCode &errorCode) {
+    return coll.internalGetSortKeysUTF8(strings, lengths, count, sink, -1, offsets, NULL, errorCode);
+}
+
+inline UCollationResult compareStrings(const RuleBasedCollator &coll,
+                                       const UChar *left, int32_t leftLength,
+                                       const UChar *right, int32_t rightLength,
+                                       UErrorCode &errorCode) {
+    return coll.compare(left, leftLength, right, rightLength, errorCode);
+}
+
+inline UCollationResult compareStrings(const RuleBasedCollator &coll,
+                                       const char *left, int32_t leftLength,
+                                       const char *right, int32_t rightLength,
+                                       UErrorCode &errorCode) {
+    return coll.internalCompareUTF8(left, leftLength, right, rightLength, errorCode);
+}
+
+template<typename Char>
+struct CompareContext {
+    const RuleBasedCollator &coll;
+    const Char *const *strings;
+    const int32_t *lengths;
+    UErrorCode &errorCode;
+};
+
+/** Compares two strings by their indexes, and equal strings by their indexes. */
+template<typename Char>
+int32_t U_CALLCONV
+compareIndexes(const void *context, const void *left, const void *right) {
+    const CompareContext<Char> &cc = *static_cast<const CompareContext<Char> *>(context);
+    int32_t i = *static_cast<const int32_t *>(left);
+    int32_t j = *static_cast<const int32_t *>(right);
+    UCollationResult result = compareStrings(
+        cc.coll,
+        cc.strings[i], cc.lengths != NULL ? cc.lengths[i] : -1,
+        cc.strings[j], cc.lengths != NULL ? cc.lengths[j] : -1, cc.errorCode);
+    return result != UCOL_EQUAL ? result : i - j;
+}
+
+/**
+ * Estimates from the sort keys of a sample of the strings
+ * whether sorting via sort keys is faster than comparing the strings.
+ */
+template<typename Char>
+UBool preferSortKeys(const RuleBasedCollator &coll,
+                     const Char *const strings[], const int32_t lengths[], int32_t count,
+                     UErrorCode &errorCode) {
+    const Char *sampleStrings[kSampleCount];
+    int32_t sampleLengths[kSampleCount];
+    int32_t sampleOffsets[kSampleCount + 1];
+    for (int32_t k = 0; k < kSampleCount; ++k) {
+        int32_t i = static_cast<int32_t>(static_cast<int64_t>(count) * k / kSampleCount);
+        sampleStrings[k] = strings[i];
+        sampleLengths[k] = lengths != NULL ? lengths[i] : -1;
+    }
+    CharString keys;
+    CharStringByteSink sink(&keys);
+    getSortKeys(coll, sampleStrings, sampleLengths, kSampleCount, sink, sampleOffsets, errorCode);
+    if (U_FAILURE(errorCode)) { return FALSE; }
+    int32_t log2Count = 0;
+    for (int32_t n = count; n > 1; n >>= 1) {
+        ++log2Count;
+    }
+    return keys.length() <= kMaxKeyBytesPerComparison * log2Count * kSampleCount;
+}
+
+template<typename Char>
+void doSortStrings(const RuleBasedCollator &coll,
+                   const Char *const strings[], const int32_t lengths[], int32_t count,
+                   int32_t permutation[],
+                   int32_t maxTasks, UTaskRunner runner, const void *runnerContext,
+                   UErrorCode &errorCode) {
+    if (U_FAILURE(errorCode)) { return; }
+    if (count < 0 || (count > 0 && (strings == NULL || permutation == NULL))) {
+        errorCode = U_ILLEGAL_ARGUMENT_ERROR;
+        return;
+    }
+    for (int32_t i = 0; i < count; ++i) {
+        if (strings[i] == NULL && (lengths == NULL || lengths[i] != 0)) {
+            errorCode = U_ILLEGAL_ARGUMENT_ERROR;
+            return;
+        }
+        permutation[i] = i;
+    }
+    if (count < kMinKeySortCount || !preferSortKeys(coll, strings, lengths, count, errorCode)) {
+        if (U_FAILURE(errorCode)) { return; }
+        CompareContext<Char> context = { coll, strings, lengths, errorCode };
+        uprv_sortArray(permutation, count, (int32_t)sizeof(int32_t),
+                       compareIndexes<Char>, &context, FALSE, &errorCode);
+        return;
+    }
+
+    // Without a runner, all of the work is done in a single task on the calling thread.
+    int32_t parallelCount = runner != NULL ? maxTasks : 1;
+    if (parallelCount > count / kMinStringsPerTask) {
+        parallelCount = count / kMinStringsPerTask;
+    }
+    if (parallelCount > kMaxTasks) {
+        parallelCount = kMaxTasks;
+    } else if (parallelCount < 1) {
+        parallelCount = 1;
+    }
+
+    // Generate the sort keys, one chunk of strings per task.
+    // Chunk k writes its count+1 offsets at offsets[start+k].
+    LocalMemory<int32_t> offsets;
+    LocalMemory<SortItem> items, temp;
+    KeyChunk chunks[kMaxTasks];
+    if (offsets.allocateInsteadAndReset(count + parallelCount) == NULL ||
+            items.allocateInsteadAndReset(count) == NULL ||
+            temp.allocateInsteadAndReset(count) == NULL) {
+        errorCode = U_MEMORY_ALLOCATION_ERROR;
+        return;
+    }
+    for (int32_t k = 0; k < parallelCount; ++k) {
+        chunks[k].start = static_cast<int32_t>(static_cast<int64_t>(count) * k / parallelCount);
+        chunks[k].limit = static_cast<int32_t>(static_cast<int64_t>(count) * (k + 1) / parallelCount);
+    }
+    int32_t *offsetsArray = offsets.getAlias();
+    auto generate = [&coll, strings, lengths, offsetsArray, &chunks](int32_t k) {
+        KeyChunk &chunk = chunks[k];
+        CharStringByteSink sink(&chunk.keys);
+        int32_t *chunkOffsets = offsetsArray + chunk.start + k;
+        int32_t n = chunk.limit - chunk.start;
+        getSortKeys(coll, strings + chunk.start, lengths != NULL ? lengths + chunk.start : NULL, n,
+                    sink, chunkOffsets, chunk.errorCode);
+        if (U_SUCCESS(chunk.errorCode) && chunk.keys.length() != chunkOffsets[n]) {
+            chunk.errorCode = U_MEMORY_ALLOCATION_ERROR;
+        }
+    };
+    uprv_runTasks(runner, runnerContext, parallelCount, generate);
+    SortItem *itemsArray = items.getAlias();
+    for (int32_t k = 0; k < parallelCount; ++k) {
+        const KeyChunk &chunk = chunks[k];
+        if (U_FAILURE(chunk.errorCode)) {
+            errorCode = chunk.errorCode;
+            return;
+        }
+        const uint8_t *keys = reinterpret_cast<const uint8_t *>(chunk.keys.data());
+        const int32_t *chunkOffsets = offsetsArray + chunk.start + k;
+        for (int32_t i = chunk.start; i < chunk.limit; ++i) {
+            itemsArray[i].key = keys + chunkOffsets[i - chunk.start];
+            itemsArray[i].index = i;
+        }
+    }
+
+    // Split the items by their leading key bytes until each bucket is small enough
+    // to be one of several sort tasks per parallel task.
+    // The vectors hold (start, length, offset) triples.
+    UVector32 pending(errorCode), tasks(errorCode);
+    int32_t maxTaskLength = parallelCount == 1 ? count : count / (parallelCount * 8);
+    pending.addElement(0, errorCode);
+    pending.addElement(count, errorCode);
+    pending.addElement(0, errorCode);
+    while (U_SUCCESS(errorCode) && !pending.isEmpty()) {
+        int32_t offset = pending.popi();
+        int32_t length = pending.popi();
+        int32_t start = pending.popi();
+        if (length <= maxTaskLength) {
+            tasks.addElement(start, errorCode);
+            tasks.addElement(length, errorCode);
+            tasks.addElement(offset, errorCode);
+            continue;
+        }
+        int32_t starts[257];
+        int32_t b = distribute(itemsArray + start, temp.getAlias() + start, length, offset, starts);
+        if (b == 0) {
+            continue;  // All keys are equal, and still in input order.
+        } else if (b != kSplit) {
+            pending.addElement(start, errorCode);
+            pending.addElement(length, errorCode);
+            pending.addElement(offset + 1, errorCode);
+            continue;
+        }
+        for (b = 1; b < 256; ++b) {
+            int32_t bucketLength = starts[b + 1] - starts[b];
+            if (bucketLength > 1) {
+                pending.addElement(start + starts[b], errorCode);
+                pending.addElement(bucketLength, errorCode);
+                pending.addElement(offset + 1, errorCode);
+            }
+        }
+    }
+    if (U_FAILURE(errorCode)) { return; }
+
+    // Sort the buckets, with each parallel task taking the next sort task until there are none left.
+    int32_t taskCount = tasks.size() / 3;
+    if (parallelCount > taskCount) {
+        parallelCount = taskCount;
+    }
+    std::atomic<int32_t> nextTask(0);
+    SortItem *tempArray = temp.getAlias();
+    auto sortTasks = [&nextTask, &tasks, taskCount, itemsArray, tempArray](int32_t /*k*/) {
+        int32_t t;
+        while ((t = nextTask++) < taskCount) {
+            int32_t start = tasks.elementAti(3 * t);
+            radixSort(itemsArray + start, tempArray + start,
+                      tasks.elementAti(3 * t + 1), tasks.elementAti(3 * t + 2), 0);
+        }
+    };
+    uprv_runTasks(runner, runnerContext, parallelCount, sortTasks);
+    for (int32_t i = 0; i < count; ++i) {
+        permutation[i] = itemsArray[i].index;
+    }
+}
+
+}  // namespace
+
+void
+RuleBasedCollator::sortStrings(const UChar *const strings[], const int32_t lengths[], int32_t count,
+                               int32_t permutation[],
+                               int32_t maxTasks, UTaskRunner runner, const void *runnerContext,
+                               UErrorCode &errorCode) const {
+    doSortStrings(*this, strings, lengths, count, permutation,
+                  maxTasks, runner, runnerContext, errorCode);
+}
+
+void
+RuleBasedCollator::sortStringsUTF8(const char *const strings[], const int32_t lengths[],
+                                   int32_t count, int32_t permutation[],
+                                   int32_t maxTasks, UTaskRunner runner, const void *runnerContext,
+                                   UErrorCode &errorCode) const {
+    doSortStrings(*this, strings, lengths, count, permutation,
+                  maxTasks, runner, runnerContext, errorCode);
+}
+
+U_NAMESPACE_END
+
+#endif  // !UCONFIG_NO_COLLATION
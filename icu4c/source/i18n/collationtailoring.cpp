@@ -22,6 +22,8 @@
 #include "unicode/uvernum.h"
 #include "cmemory.h"
 #include "collationdata.h"
+#include "collationfastlatin.h"
+#include "collationfastlatinbuilder.h"
 #include "collationsettings.h"
 #include "collationtailoring.h"
 #include "normalizer2impl.h"
@@ -35,6 +37,7 @@ U_NAMESPACE_BEGIN
 CollationTailoring::CollationTailoring(const CollationSettings *baseSettings)
         : data(NULL), settings(baseSettings),
           actualLocale(""),
+          fastScriptTable(NULL), fastScriptTableLength(0),
           ownedData(NULL),
           builder(NULL), memory(NULL), bundle(NULL),
           trie(NULL), unsafeBackwardSet(NULL),
@@ -56,6 +59,7 @@ CollationTailoring::CollationTailoring(const CollationSettings *baseSettings)
 
 CollationTailoring::~CollationTailoring() {
     SharedObject::clearPtr(settings);
+    uprv_free(fastScriptTable);
     delete ownedData;
     delete builder;
     udata_close(memory);
@@ -82,6 +86,27 @@ CollationTailoring::ensureOwnedData(UErrorCode &errorCode) {
     return TRUE;
 }
 
+void
+CollationTailoring::buildFastScriptTable(UErrorCode &errorCode) {
+    if(U_FAILURE(errorCode) || fastScriptTable != NULL) { return; }
+    // Without a fast Latin table, the data does not support the fast paths at all.
+    if(data == NULL || data->fastLatinTable == NULL || settings->reorderCodesLength == 0) {
+        return;
+    }
+    int32_t script = settings->reorderCodes[0];
+    if(CollationFastLatin::getScriptBlockStart(script) < 0) { return; }
+    CollationFastLatinBuilder builder(errorCode);
+    if(!builder.forScript(*data, script, errorCode)) { return; }
+    int32_t length = builder.lengthOfTable();
+    fastScriptTable = static_cast<uint16_t *>(uprv_malloc(length * 2));
+    if(fastScriptTable == NULL) {
+        errorCode = U_MEMORY_ALLOCATION_ERROR;
+        return;
+    }
+    uprv_memcpy(fastScriptTable, builder.getTable(), length * 2);
+    fastScriptTableLength = length;
+}
+
 void
 CollationTailoring::makeBaseVersion(const UVersionInfo ucaVersion, UVersionInfo version) {
     version[0] = UCOL_BUILDER_VERSION;
@@ -56,6 +56,14 @@ struct U_I18N_API CollationTailoring : public SharedObject {
 
     UBool ensureOwnedData(UErrorCode &errorCode);
 
+    /**
+     * Builds the CollationFastLatin script table
+     * if the settings reorder a script with fast script support to the front,
+     * as in [reorder Cyrl].
+     * Call this after setting the data and the settings.
+     */
+    void buildFastScriptTable(UErrorCode &errorCode);
+
     static void makeBaseVersion(const UVersionInfo ucaVersion, UVersionInfo version);
     void setVersion(const UVersionInfo baseVersion, const UVersionInfo rulesVersion);
     int32_t getUCAVersion() const;
@@ -73,6 +81,9 @@ struct U_I18N_API CollationTailoring : public SharedObject {
     // version[2]: bits 7..6=w, bits 5..0=r
     // version[3]= (s<<5)+(s>>3)+t+(q<<4)+(q>>4)
     UVersionInfo version;
+    // CollationFastLatin script table, or NULL; owned
+    uint16_t *fastScriptTable;
+    int32_t fastScriptTableLength;
 
     // owned objects
     CollationData *ownedData;
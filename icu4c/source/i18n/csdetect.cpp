@@ -150,7 +150,8 @@ void CharsetDetector::setRecognizers(UErrorCode &status)
 CharsetDetector::CharsetDetector(UErrorCode &status)
   : textIn(new InputText(status)), resultArray(NULL),
     resultCount(0), fStripTags(FALSE), fFreshTextSet(FALSE),
-    fEnabledRecognizers(NULL)
+    fEnabledRecognizers(NULL), fStreams(NULL), fStopConfidence(0),
+    fNextCheckLength(0), fStreamDone(FALSE)
 {
     if (U_FAILURE(status)) {
         return;
@@ -192,6 +193,20 @@ CharsetDetector::~CharsetDetector()
     if (fEnabledRecognizers) {
         uprv_free(fEnabledRecognizers);
     }
+
+    closeStreams();
+}
+
+void CharsetDetector::closeStreams()
+{
+    if (fStreams != NULL) {
+        for(int32_t i = 0; i < fCSRecognizers_size; i += 1) {
+            delete fStreams[i];
+        }
+
+        uprv_free(fStreams);
+        fStreams = NULL;
+    }
 }
 
 void CharsetDetector::setText(const char *in, int32_t len)
@@ -200,6 +215,107 @@ void CharsetDetector::setText(const char *in, int32_t len)
     fFreshTextSet = TRUE;
 }
 
+// Input length at which appendText() first checks for the stop confidence.
+//   Later checks happen each time the length doubles.
+#define FIRST_STOP_CHECK_LENGTH 1024
+
+UBool CharsetDetector::appendText(const char *in, int32_t len, UErrorCode &status)
+{
+    if (U_FAILURE(status)) {
+        return FALSE;
+    }
+
+    if (!textIn->fIsStream) {
+        if (fStreams == NULL) {
+            fStreams = NEW_ARRAY(CharsetRecogStream *, fCSRecognizers_size);
+
+            if (fStreams == NULL) {
+                status = U_MEMORY_ALLOCATION_ERROR;
+                return FALSE;
+            }
+
+            for (int32_t i = 0; i < fCSRecognizers_size; i += 1) {
+                fStreams[i] = fCSRecognizers[i]->recognizer->openStream(status);
+            }
+
+            if (U_FAILURE(status)) {
+                // Do not keep a partial set of streams for the next call.
+                closeStreams();
+                return FALSE;
+            }
+        }
+
+        textIn->startStream(status);
+
+        if (U_FAILURE(status)) {
+            return FALSE;
+        }
+
+        for (int32_t i = 0; i < fCSRecognizers_size; i += 1) {
+            if (fStreams[i] != NULL) {
+                fStreams[i]->reset();
+            }
+        }
+
+        fNextCheckLength = FIRST_STOP_CHECK_LENGTH;
+        fStreamDone = FALSE;
+        fFreshTextSet = TRUE;
+    }
+
+    if (fStreamDone) {
+        return FALSE;
+    }
+
+    if (len == -1) {
+        len = (int32_t)uprv_strlen(in);
+    }
+
+    if (len > 0) {
+        const uint8_t *bytes = (const uint8_t *) in;
+
+        textIn->appendText(bytes, len);
+
+        // One pass over the chunk for each recognizer that scans all of the input.
+        //   The others only look at the sample kept by textIn.
+        for (int32_t i = 0; i < fCSRecognizers_size; i += 1) {
+            if (fStreams[i] != NULL) {
+                fStreams[i]->update(bytes, len);
+            }
+        }
+
+        fFreshTextSet = TRUE;
+    }
+
+    if (fStopConfidence > 0 && textIn->fStreamLength >= fNextCheckLength) {
+        int32_t matchCount = 0;
+        const CharsetMatch * const *matches = detectAll(matchCount, status);
+
+        while (fNextCheckLength <= textIn->fStreamLength) {
+            fNextCheckLength *= 2;
+        }
+
+        if (U_SUCCESS(status) && matchCount > 0 && matches[0]->getConfidence() >= fStopConfidence) {
+            fStreamDone = TRUE;
+        }
+    }
+
+    return !fStreamDone;
+}
+
+void CharsetDetector::setStopConfidence(int32_t confidence, UErrorCode &status)
+{
+    if (U_FAILURE(status)) {
+        return;
+    }
+
+    if (confidence < 0 || confidence > 100) {
+        status = U_ILLEGAL_ARGUMENT_ERROR;
+        return;
+    }
+
+    fStopConfidence = confidence;
+}
+
 UBool CharsetDetector::setStripTagsFlag(UBool flag)
 {
     UBool temp = fStripTags;
@@ -257,7 +373,13 @@ const CharsetMatch * const *CharsetDetector::detectAll(int32_t &maxMatchesFound,
         resultCount = 0;
         for (i = 0; i < fCSRecognizers_size; i += 1) {
             csr = fCSRecognizers[i]->recognizer;
-            if (csr->match(textIn, resultArray[resultCount])) {
+            UBool isMatch;
+            if (textIn->fIsStream && fStreams[i] != NULL) {
+                isMatch = fStreams[i]->match(textIn, resultArray[resultCount]);
+            } else {
+                isMatch = csr->match(textIn, resultArray[resultCount]);
+            }
+            if (isMatch) {
                 resultCount++;
             }
         }
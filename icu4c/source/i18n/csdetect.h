@@ -21,6 +21,7 @@ U_NAMESPACE_BEGIN
 class InputText;
 class CharsetRecognizer;
 class CharsetMatch;
+class CharsetRecogStream;
 
 class CharsetDetector : public UMemory
 {
@@ -31,11 +32,18 @@ class CharsetDetector : public UMemory
     UBool fStripTags;   // If true, setText() will strip tags from input text.
     UBool fFreshTextSet;
     static void setRecognizers(UErrorCode &status);
+    void closeStreams();
 
     UBool *fEnabledRecognizers;  // If not null, active set of charset recognizers had
                                 // been changed from the default. The array index is
                                 // corresponding to fCSRecognizers. See setDetectableCharset().
 
+    // Streamed input, see appendText().
+    CharsetRecogStream **fStreams;  // One per recognizer, NULL if it has no streaming support.
+    int32_t fStopConfidence;        // 0, or the confidence at which to stop examining input.
+    int64_t fNextCheckLength;       // Input length at which to check for the stop confidence.
+    UBool fStreamDone;              // True once the stop confidence has been reached.
+
 public:
     CharsetDetector(UErrorCode &status);
 
@@ -43,6 +51,10 @@ class CharsetDetector : public UMemory
 
     void setText(const char *in, int32_t len);
 
+    UBool appendText(const char *in, int32_t len, UErrorCode &status);
+
+    void setStopConfidence(int32_t confidence, UErrorCode &status);
+
     const CharsetMatch * const *detectAll(int32_t &maxMatchesFound, UErrorCode &status);
 
     const CharsetMatch *detect(UErrorCode& status);
@@ -25,6 +25,16 @@ const char *CharsetRecognizer::getLanguage() const
     return "";
 }
 
+CharsetRecogStream *CharsetRecognizer::openStream(UErrorCode & /*status*/) const
+{
+    return NULL;
+}
+
+CharsetRecogStream::~CharsetRecogStream()
+{
+    // nothing to do.
+}
+
 U_NAMESPACE_END    
 
 #endif
@@ -19,6 +19,7 @@
 U_NAMESPACE_BEGIN
 
 class CharsetMatch;
+class CharsetRecogStream;
 
 class CharsetRecognizer : public UMemory
 {
@@ -48,9 +49,49 @@ class CharsetRecognizer : public UMemory
      */
     virtual UBool match(InputText *textIn, CharsetMatch *results) const = 0;
 
+    /*
+     * For incremental detection: Create an object that accumulates the statistics
+     * of this recognizer over successive chunks of the raw input.
+     *
+     * Recognizers that only look at a bounded prefix or sample of the input
+     * return NULL (the default). For those, match() is called on the
+     * InputText, which holds the sample of the streamed input.
+     */
+    virtual CharsetRecogStream *openStream(UErrorCode &status) const;
+
     virtual ~CharsetRecognizer();
 };
 
+/*
+ * Per-detector state of a CharsetRecognizer for incremental detection.
+ * See CharsetRecognizer::openStream().
+ */
+class CharsetRecogStream : public UMemory
+{
+ public:
+    virtual ~CharsetRecogStream();
+
+    /*
+     * Forget the statistics of previous input.
+     */
+    virtual void reset() = 0;
+
+    /*
+     * Accumulate statistics over the next chunk of raw input bytes.
+     *
+     * Return false if further input cannot change the match result,
+     * for example because the input was already found to be illegal in this charset.
+     */
+    virtual UBool update(const uint8_t *bytes, int32_t length) = 0;
+
+    /*
+     * Like CharsetRecognizer::match(), but for all of the input so far.
+     * The InputText holds the sample of the streamed input, starting with its first bytes.
+     * Can be called repeatedly between update() calls.
+     */
+    virtual UBool match(InputText *textIn, CharsetMatch *results) const = 0;
+};
+
 U_NAMESPACE_END
 
 #endif
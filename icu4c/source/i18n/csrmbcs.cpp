@@ -114,8 +114,10 @@ static int32_t binarySearch(const uint16_t *array, int32_t len, uint16_t value)
     return -1;
 }
 
-IteratedChar::IteratedChar() : 
-charValue(0), index(-1), nextIndex(0), error(FALSE), done(FALSE)
+IteratedChar::IteratedChar(const uint8_t *prefix, int32_t prefixLength,
+                           const uint8_t *input, int32_t inputLength) : 
+charValue(0), index(-1), nextIndex(0), error(FALSE), done(FALSE),
+prefix(prefix), prefixLength(prefixLength), input(input), inputLength(inputLength)
 {
     // nothing else to do.
 }
@@ -129,15 +131,29 @@ charValue(0), index(-1), nextIndex(0), error(FALSE), done(FALSE)
     done      = FALSE;
 }*/
 
-int32_t IteratedChar::nextByte(InputText *det)
+int32_t IteratedChar::nextByte()
 {
-    if (nextIndex >= det->fRawLength) {
+    if (nextIndex < prefixLength) {
+        return prefix[nextIndex++];
+    }
+
+    if (nextIndex >= prefixLength + inputLength) {
         done = TRUE;
 
         return -1;
     }
 
-    return det->fRawInput[nextIndex++];
+    return input[nextIndex++ - prefixLength];
+}
+
+void MBCSCharCounts::reset()
+{
+    singleByteCharCount = 0;
+    doubleByteCharCount = 0;
+    commonCharCount     = 0;
+    badCharCount        = 0;
+    totalCharCount      = 0;
+    isMismatch          = FALSE;
 }
 
 CharsetRecog_mbcs::~CharsetRecog_mbcs()
@@ -146,40 +162,55 @@ CharsetRecog_mbcs::~CharsetRecog_mbcs()
 }
 
 int32_t CharsetRecog_mbcs::match_mbcs(InputText *det, const uint16_t commonChars[], int32_t commonCharsLen) const {
-    int32_t singleByteCharCount = 0;
-    int32_t doubleByteCharCount = 0;
-    int32_t commonCharCount     = 0;
-    int32_t badCharCount        = 0;
-    int32_t totalCharCount      = 0;
-    int32_t confidence          = 0;
-    IteratedChar iter;
+    MBCSCharCounts counts;
+    IteratedChar iter(NULL, 0, det->fRawInput, det->fRawLength);
 
-    while (nextChar(&iter, det)) {
-        totalCharCount++;
+    counts.reset();
+    countChars(iter, det->fRawLength, commonChars, commonCharsLen, counts);
+    return getConfidence(counts, commonChars);
+}
+
+void CharsetRecog_mbcs::countChars(IteratedChar &iter, int32_t limit,
+                                   const uint16_t commonChars[], int32_t commonCharsLen,
+                                   MBCSCharCounts &counts) const {
+    while (!counts.isMismatch && iter.nextIndex < limit && nextChar(&iter)) {
+        counts.totalCharCount++;
 
         if (iter.error) {
-            badCharCount++;
+            counts.badCharCount++;
         } else {
             if (iter.charValue <= 0xFF) {
-                singleByteCharCount++;
+                counts.singleByteCharCount++;
             } else {
-                doubleByteCharCount++;
+                counts.doubleByteCharCount++;
 
                 if (commonChars != 0) {
                     if (binarySearch(commonChars, commonCharsLen, static_cast<uint16_t>(iter.charValue)) >= 0){
-                        commonCharCount += 1;
+                        counts.commonCharCount += 1;
                     }
                 }
             }
         }
 
 
-        if (badCharCount >= 2 && badCharCount*5 >= doubleByteCharCount) {
+        if (counts.badCharCount >= 2 && counts.badCharCount*5 >= counts.doubleByteCharCount) {
             // Bail out early if the byte data is not matching the encoding scheme.
             // break detectBlock;
-            return confidence;
+            counts.isMismatch = TRUE;
         }
     }
+}
+
+int32_t CharsetRecog_mbcs::getConfidence(const MBCSCharCounts &counts, const uint16_t commonChars[]) {
+    int32_t doubleByteCharCount = counts.doubleByteCharCount;
+    int32_t commonCharCount     = counts.commonCharCount;
+    int32_t badCharCount        = counts.badCharCount;
+    int32_t totalCharCount      = counts.totalCharCount;
+    int32_t confidence          = 0;
+
+    if (counts.isMismatch) {
+        return confidence;
+    }
 
     if (doubleByteCharCount <= 10 && badCharCount == 0) {
         // Not many multi-byte chars.
@@ -236,16 +267,95 @@ int32_t CharsetRecog_mbcs::match_mbcs(InputText *det, const uint16_t commonChars
     return confidence;
 }
 
+namespace {
+
+/*
+ * Counts the characters of one MBCS encoding across chunks of input.
+ * The trailing bytes of each chunk that may hold an incomplete character
+ * are carried over and iterated ahead of the next chunk.
+ */
+class CharsetRecogStream_mbcs : public CharsetRecogStream {
+public:
+    CharsetRecogStream_mbcs(const CharsetRecog_mbcs *recognizer,
+                            const uint16_t commonChars[], int32_t commonCharsLen) :
+        fRecognizer(recognizer), fCommonChars(commonChars), fCommonCharsLen(commonCharsLen) {
+        reset();
+    }
+
+    virtual ~CharsetRecogStream_mbcs() {}
+
+    virtual void reset() {
+        fCounts.reset();
+        fCarryLength = 0;
+    }
+
+    virtual UBool update(const uint8_t *bytes, int32_t length) {
+        if (fCounts.isMismatch) {
+            return FALSE;
+        }
+        IteratedChar iter(fCarry, fCarryLength, bytes, length);
+        int32_t total = fCarryLength + length;
+        // A character is at most 4 bytes long. Leave any that might be
+        //   cut off by the end of this chunk for the next one.
+        fRecognizer->countChars(iter, total - (MAX_CHAR_LENGTH - 1),
+                                    fCommonChars, fCommonCharsLen, fCounts);
+        if (fCounts.isMismatch) {
+            return FALSE;
+        }
+        int32_t carryLength = 0;
+        uint8_t carry[MAX_CHAR_LENGTH];
+        for (int32_t i = iter.nextIndex; i < total; ++i) {
+            carry[carryLength++] = i < fCarryLength ? fCarry[i] : bytes[i - fCarryLength];
+        }
+        uprv_memcpy(fCarry, carry, carryLength);
+        fCarryLength = carryLength;
+        return TRUE;
+    }
+
+    virtual UBool match(InputText *textIn, CharsetMatch *results) const {
+        MBCSCharCounts counts = fCounts;
+        IteratedChar iter(NULL, 0, fCarry, fCarryLength);
+        fRecognizer->countChars(iter, fCarryLength, fCommonChars, fCommonCharsLen, counts);
+        int32_t confidence = CharsetRecog_mbcs::getConfidence(counts, fCommonChars);
+        results->set(textIn, fRecognizer, confidence);
+        return (confidence > 0);
+    }
+
+private:
+    static const int32_t MAX_CHAR_LENGTH = 4;
+
+    const CharsetRecog_mbcs *fRecognizer;
+    const uint16_t *fCommonChars;
+    int32_t fCommonCharsLen;
+    MBCSCharCounts fCounts;
+    uint8_t fCarry[MAX_CHAR_LENGTH];
+    int32_t fCarryLength;
+};
+
+}  // namespace
+
+CharsetRecogStream *CharsetRecog_mbcs::openMBCSStream(const uint16_t commonChars[], int32_t commonCharsLen,
+                                                      UErrorCode &status) const {
+    if (U_FAILURE(status)) {
+        return NULL;
+    }
+    CharsetRecogStream *stream = new CharsetRecogStream_mbcs(this, commonChars, commonCharsLen);
+    if (stream == NULL) {
+        status = U_MEMORY_ALLOCATION_ERROR;
+    }
+    return stream;
+}
+
 CharsetRecog_sjis::~CharsetRecog_sjis()
 {
     // nothing to do
 }
 
-UBool CharsetRecog_sjis::nextChar(IteratedChar* it, InputText* det) const {
+UBool CharsetRecog_sjis::nextChar(IteratedChar* it) const {
     it->index = it->nextIndex;
     it->error = FALSE;
 
-    int32_t firstByte = it->charValue = it->nextByte(det);
+    int32_t firstByte = it->charValue = it->nextByte();
 
     if (firstByte < 0) {
         return FALSE;
@@ -255,7 +365,7 @@ UBool CharsetRecog_sjis::nextChar(IteratedChar* it, InputText* det) const {
         return TRUE;
     }
 
-    int32_t secondByte = it->nextByte(det);
+    int32_t secondByte = it->nextByte();
     if (secondByte >= 0) {
         it->charValue = (firstByte << 8) | secondByte;
     }
@@ -275,6 +385,11 @@ UBool CharsetRecog_sjis::match(InputText* det, CharsetMatch *results) const {
     return (confidence > 0);
 }
 
+CharsetRecogStream *CharsetRecog_sjis::openStream(UErrorCode &status) const
+{
+    return openMBCSStream(commonChars_sjis, UPRV_LENGTHOF(commonChars_sjis), status);
+}
+
 const char *CharsetRecog_sjis::getName() const
 {
     return "Shift_JIS";
@@ -290,14 +405,14 @@ CharsetRecog_euc::~CharsetRecog_euc()
     // nothing to do
 }
 
-UBool CharsetRecog_euc::nextChar(IteratedChar* it, InputText* det) const {
+UBool CharsetRecog_euc::nextChar(IteratedChar* it) const {
     int32_t firstByte  = 0;
     int32_t secondByte = 0;
     int32_t thirdByte  = 0;
 
     it->index = it->nextIndex;
     it->error = FALSE;
-    firstByte = it->charValue = it->nextByte(det);
+    firstByte = it->charValue = it->nextByte();
 
     if (firstByte < 0) {
         // Ran off the end of the input data
@@ -309,7 +424,7 @@ UBool CharsetRecog_euc::nextChar(IteratedChar* it, InputText* det) const {
         return TRUE;
     }
 
-    secondByte = it->nextByte(det);
+    secondByte = it->nextByte();
     if (secondByte >= 0) {
         it->charValue = (it->charValue << 8) | secondByte;
     }
@@ -341,7 +456,7 @@ UBool CharsetRecog_euc::nextChar(IteratedChar* it, InputText* det) const {
     if (firstByte == 0x8F) {
         // Code set 3.
         // Three byte total char size, two bytes of actual char value.
-        thirdByte    = it->nextByte(det);
+        thirdByte    = it->nextByte();
         it->charValue = (it->charValue << 8) | thirdByte;
 
         if (thirdByte < 0xa1) {
@@ -376,6 +491,11 @@ UBool CharsetRecog_euc_jp::match(InputText *det, CharsetMatch *results) const
     return (confidence > 0);
 }
 
+CharsetRecogStream *CharsetRecog_euc_jp::openStream(UErrorCode &status) const
+{
+    return openMBCSStream(commonChars_euc_jp, UPRV_LENGTHOF(commonChars_euc_jp), status);
+}
+
 CharsetRecog_euc_kr::~CharsetRecog_euc_kr()
 {
     // nothing to do
@@ -398,18 +518,23 @@ UBool CharsetRecog_euc_kr::match(InputText *det, CharsetMatch *results) const
     return (confidence > 0);
 }
 
+CharsetRecogStream *CharsetRecog_euc_kr::openStream(UErrorCode &status) const
+{
+    return openMBCSStream(commonChars_euc_kr, UPRV_LENGTHOF(commonChars_euc_kr), status);
+}
+
 CharsetRecog_big5::~CharsetRecog_big5()
 {
     // nothing to do
 }
 
-UBool CharsetRecog_big5::nextChar(IteratedChar* it, InputText* det) const
+UBool CharsetRecog_big5::nextChar(IteratedChar* it) const
 {
     int32_t firstByte;
 
     it->index = it->nextIndex;
     it->error = FALSE;
-    firstByte = it->charValue = it->nextByte(det);
+    firstByte = it->charValue = it->nextByte();
 
     if (firstByte < 0) {
         return FALSE;
@@ -420,7 +545,7 @@ UBool CharsetRecog_big5::nextChar(IteratedChar* it, InputText* det) const
         return TRUE;
     }
 
-    int32_t secondByte = it->nextByte(det);
+    int32_t secondByte = it->nextByte();
     if (secondByte >= 0)  {
         it->charValue = (it->charValue << 8) | secondByte;
     }
@@ -450,12 +575,17 @@ UBool CharsetRecog_big5::match(InputText *det, CharsetMatch *results) const
     return (confidence > 0);
 }
 
+CharsetRecogStream *CharsetRecog_big5::openStream(UErrorCode &status) const
+{
+    return openMBCSStream(commonChars_big5, UPRV_LENGTHOF(commonChars_big5), status);
+}
+
 CharsetRecog_gb_18030::~CharsetRecog_gb_18030()
 {
     // nothing to do
 }
 
-UBool CharsetRecog_gb_18030::nextChar(IteratedChar* it, InputText* det) const {
+UBool CharsetRecog_gb_18030::nextChar(IteratedChar* it) const {
     int32_t firstByte  = 0;
     int32_t secondByte = 0;
     int32_t thirdByte  = 0;
@@ -463,7 +593,7 @@ UBool CharsetRecog_gb_18030::nextChar(IteratedChar* it, InputText* det) const {
 
     it->index = it->nextIndex;
     it->error = FALSE;
-    firstByte = it->charValue = it->nextByte(det);
+    firstByte = it->charValue = it->nextByte();
 
     if (firstByte < 0) {
         // Ran off the end of the input data
@@ -475,7 +605,7 @@ UBool CharsetRecog_gb_18030::nextChar(IteratedChar* it, InputText* det) const {
         return TRUE;
     }
 
-    secondByte = it->nextByte(det);
+    secondByte = it->nextByte();
     if (secondByte >= 0) {
         it->charValue = (it->charValue << 8) | secondByte;
     }
@@ -489,10 +619,10 @@ UBool CharsetRecog_gb_18030::nextChar(IteratedChar* it, InputText* det) const {
 
         // Four byte char
         if (secondByte >= 0x30 && secondByte <= 0x39) {
-            thirdByte = it->nextByte(det);
+            thirdByte = it->nextByte();
 
             if (thirdByte >= 0x81 && thirdByte <= 0xFE) {
-                fourthByte = it->nextByte(det);
+                fourthByte = it->nextByte();
 
                 if (fourthByte >= 0x30 && fourthByte <= 0x39) {
                     it->charValue = (it->charValue << 16) | (thirdByte << 8) | fourthByte;
@@ -526,5 +656,10 @@ UBool CharsetRecog_gb_18030::match(InputText *det, CharsetMatch *results) const
     return (confidence > 0);
 }
 
+CharsetRecogStream *CharsetRecog_gb_18030::openStream(UErrorCode &status) const
+{
+    return openMBCSStream(commonChars_gb_18030, UPRV_LENGTHOF(commonChars_gb_18030), status);
+}
+
 U_NAMESPACE_END
 #endif
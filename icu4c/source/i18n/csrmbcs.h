@@ -38,10 +38,32 @@ class IteratedChar : public UMemory
     UBool    error;
     UBool    done;
 
+    // The bytes being iterated are prefix[0..prefixLength-1] followed by
+    //   input[0..inputLength-1]. The prefix holds bytes carried over from the
+    //   previous chunk when detecting a stream of input.
+    const uint8_t *prefix;
+    int32_t  prefixLength;
+    const uint8_t *input;
+    int32_t  inputLength;
+
 public:
-    IteratedChar();
+    IteratedChar(const uint8_t *prefix, int32_t prefixLength, const uint8_t *input, int32_t inputLength);
     //void reset();
-    int32_t nextByte(InputText* det);
+    int32_t nextByte();
+};
+
+/**
+ * Character counts collected by CharsetRecog_mbcs::countChars().
+ */
+struct MBCSCharCounts {
+    int32_t singleByteCharCount;
+    int32_t doubleByteCharCount;
+    int32_t commonCharCount;
+    int32_t badCharCount;
+    int32_t totalCharCount;
+    UBool   isMismatch;     // TRUE once the data is known not to match the encoding scheme
+
+    void reset();
 };
 
 
@@ -62,6 +84,13 @@ class CharsetRecog_mbcs : public CharsetRecognizer {
      */
     int32_t match_mbcs(InputText* det, const uint16_t commonChars[], int32_t commonCharsLen) const;
 
+    /**
+     * Open a CharsetRecogStream that counts characters of this encoding incrementally.
+     * For use by openStream() in subclasses.
+     */
+    CharsetRecogStream *openMBCSStream(const uint16_t commonChars[], int32_t commonCharsLen,
+                                       UErrorCode &status) const;
+
 public:
 
     virtual ~CharsetRecog_mbcs();
@@ -83,12 +112,23 @@ class CharsetRecog_mbcs : public CharsetRecognizer {
      *  This function is not a method of class IteratedChar only because
      *   that would require a lot of extra derived classes, which is awkward.
      * @param it  The IteratedChar "struct" into which the returned char is placed.
-     * @param det The charset detector, which is needed to get at the input byte data
-     *            being iterated over.
+     *            It also holds the input byte data being iterated over.
      * @return    True if a character was returned, false at end of input.
      */
-    virtual UBool nextChar(IteratedChar *it, InputText *textIn) const = 0;
+    virtual UBool nextChar(IteratedChar *it) const = 0;
+
+    /**
+     * Count the characters returned by nextChar() until the iterator reaches limit
+     *   or runs off the end of its input.
+     * Stops early, setting counts.isMismatch, if the data does not match the encoding scheme.
+     */
+    void countChars(IteratedChar &iter, int32_t limit, const uint16_t commonChars[], int32_t commonCharsLen,
+                    MBCSCharCounts &counts) const;
 
+    /**
+     * Compute the match confidence, 0-100, from character counts.
+     */
+    static int32_t getConfidence(const MBCSCharCounts &counts, const uint16_t commonChars[]);
 };
 
 
@@ -100,10 +140,12 @@ class CharsetRecog_sjis : public CharsetRecog_mbcs {
 public:
     virtual ~CharsetRecog_sjis();
 
-    UBool nextChar(IteratedChar *it, InputText *det) const;
+    UBool nextChar(IteratedChar *it) const;
 
     UBool match(InputText* input, CharsetMatch *results) const;
 
+    CharsetRecogStream *openStream(UErrorCode &status) const;
+
     const char *getName() const;
     const char *getLanguage() const;
 
@@ -131,7 +173,7 @@ class CharsetRecog_euc : public CharsetRecog_mbcs
      *  Character "value" is simply the raw bytes that make up the character
      *     packed into an int.
      */
-    UBool nextChar(IteratedChar *it, InputText *det) const;
+    UBool nextChar(IteratedChar *it) const;
 };
 
 /**
@@ -147,6 +189,8 @@ class CharsetRecog_euc_jp : public CharsetRecog_euc
     const char *getLanguage() const;
 
     UBool match(InputText* input, CharsetMatch *results) const;
+
+    CharsetRecogStream *openStream(UErrorCode &status) const;
 };
 
 /**
@@ -162,6 +206,8 @@ class CharsetRecog_euc_kr : public CharsetRecog_euc
     const char *getLanguage() const;
 
     UBool match(InputText* input, CharsetMatch *results) const;
+
+    CharsetRecogStream *openStream(UErrorCode &status) const;
 };
 
 /**
@@ -174,12 +220,14 @@ class CharsetRecog_big5 : public CharsetRecog_mbcs
 public:
     virtual ~CharsetRecog_big5();
 
-    UBool nextChar(IteratedChar* it, InputText* det) const;
+    UBool nextChar(IteratedChar *it) const;
 
     const char *getName() const;
     const char *getLanguage() const;
 
     UBool match(InputText* input, CharsetMatch *results) const;
+
+    CharsetRecogStream *openStream(UErrorCode &status) const;
 };
 
 
@@ -193,12 +241,14 @@ class CharsetRecog_gb_18030 : public CharsetRecog_mbcs
 public:
     virtual ~CharsetRecog_gb_18030();
 
-    UBool nextChar(IteratedChar* it, InputText* det) const;
+    UBool nextChar(IteratedChar *it) const;
 
     const char *getName() const;
     const char *getLanguage() const;
 
     UBool match(InputText* input, CharsetMatch *results) const;
+
+    CharsetRecogStream *openStream(UErrorCode &status) const;
 };
 
 U_NAMESPACE_END
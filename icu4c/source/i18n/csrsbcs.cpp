@@ -14,6 +14,7 @@
 #if !UCONFIG_NO_CONVERSION
 #include "csrsbcs.h"
 #include "csmatch.h"
+#include "umutex.h"
 
 #define N_GRAM_SIZE 3
 #define N_GRAM_MASK 0xFFFFFF
@@ -120,13 +121,11 @@ void NGramParser::parseCharacters(InputText *det)
     }
 }
 
-int32_t NGramParser::parse(InputText *det)
+/*
+ * Confidence from the number of n-grams that were found in a table.
+ */
+static int32_t getNGramConfidence(int32_t hitCount, int32_t ngramCount)
 {
-    parseCharacters(det);
-
-    // TODO: Is this OK? The buffer could have ended in the middle of a word...
-    addByte(0x20);
-
     double rawPercent = (double) hitCount / (double) ngramCount;
 
     //            if (rawPercent <= 2.0) {
@@ -142,6 +141,16 @@ int32_t NGramParser::parse(InputText *det)
     return (int32_t) (rawPercent * 300.0);
 }
 
+int32_t NGramParser::parse(InputText *det)
+{
+    parseCharacters(det);
+
+    // TODO: Is this OK? The buffer could have ended in the middle of a word...
+    addByte(0x20);
+
+    return getNGramConfidence(hitCount, ngramCount);
+}
+
 #if !UCONFIG_ONLY_HTML_CONVERSION
 static const uint8_t unshapeMap_IBM420[] = {
 /*           -0    -1    -2    -3    -4    -5    -6    -7    -8    -9    -A    -B    -C    -D    -E    -F   */
@@ -251,15 +260,6 @@ CharsetRecog_sbcs::~CharsetRecog_sbcs()
     // nothing to do
 }
 
-int32_t CharsetRecog_sbcs::match_sbcs(InputText *det, const int32_t ngrams[],  const uint8_t byteMap[]) const
-{
-    NGramParser parser(ngrams, byteMap);
-    int32_t result;
-
-    result = parser.parse(det);
-
-    return result;
-}
 
 static const uint8_t charMap_8859_1[] = {
     0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 
@@ -884,6 +884,269 @@ static const int32_t ngrams_8859_9_tr[] = {
     0x6E206B, 0x6E6461, 0x6E6465, 0x6E6520, 0x6E6920, 0x6E696E, 0x6EFD20, 0x72696E, 0x72FD6E, 0x766520, 0x796120, 0x796F72, 0xFD6E20, 0xFD6E64, 0xFD6EFD, 0xFDF0FD,
 };
 
+//
+// The n-gram tables above are scored all at once, in one pass over the input.
+//
+// Tables that share a byte map see the same mapped bytes, and so the same
+//   n-grams. For each byte map, the n-grams of all of its tables are merged
+//   into one hash table whose entries record which of the tables contain the
+//   n-gram. The input is walked once; for each byte map, the n-gram is computed
+//   and looked up once per byte, and the hit counts of all tables are kept in
+//   the InputText for the CharsetRecog_sbcs::match() functions that follow.
+//
+// The IBM420 recognizers unshape their input first, and still use NGramParser_IBM420.
+//
+
+#define NGRAM_MAX_TABLES 32
+#define NGRAM_MAX_MAPS 16
+#define NGRAM_HASH_CAPACITY 4096
+
+struct NGramHashEntry {
+    int32_t  ngram;
+    uint32_t tables;    // bit i is set if the n-gram is in table firstTable+i of the byte map
+};
+
+struct NGramMapInfo {
+    const uint8_t *charMap;
+    int32_t firstTable;     // index of the first table for this byte map in gNGramTables
+    int32_t tableCount;
+    int32_t hashStart;      // start of this byte map's hash table in gNGramHash
+    int32_t hashMask;       // hash table capacity - 1
+};
+
+static const int32_t *gNGramTables[NGRAM_MAX_TABLES];
+static int32_t gNGramTableCount = 0;
+static NGramMapInfo gNGramMaps[NGRAM_MAX_MAPS];
+static int32_t gNGramMapCount = 0;
+static NGramHashEntry gNGramHash[NGRAM_HASH_CAPACITY];
+static int32_t gNGramHashLength = 0;
+static icu::UInitOnce gNGramInitOnce = U_INITONCE_INITIALIZER;
+
+static inline int32_t hashNGram(int32_t ngram, int32_t hashMask)
+{
+    return (int32_t) (((uint32_t) ngram * 0x9E3779B1u) >> 12) & hashMask;
+}
+
+static void addNGramMap(const uint8_t *charMap)
+{
+    U_ASSERT(gNGramMapCount < NGRAM_MAX_MAPS);
+    NGramMapInfo &map = gNGramMaps[gNGramMapCount++];
+
+    map.charMap    = charMap;
+    map.firstTable = gNGramTableCount;
+    map.tableCount = 0;
+    map.hashStart  = 0;
+    map.hashMask   = 0;
+}
+
+static void addNGramTable(const int32_t *ngrams)
+{
+    U_ASSERT(gNGramTableCount < NGRAM_MAX_TABLES);
+    gNGramTables[gNGramTableCount++] = ngrams;
+    gNGramMaps[gNGramMapCount - 1].tableCount += 1;
+}
+
+/*
+ * Build the merged hash table for the last byte map from its n-gram tables.
+ */
+static void buildNGramHash()
+{
+    NGramMapInfo &map = gNGramMaps[gNGramMapCount - 1];
+    int32_t capacity = 1;
+
+    // Keep the hash table at most half full.
+    while (capacity < map.tableCount * 64 * 2) {
+        capacity <<= 1;
+    }
+
+    U_ASSERT(map.tableCount <= 32);
+    U_ASSERT(gNGramHashLength + capacity <= NGRAM_HASH_CAPACITY);
+    map.hashStart = gNGramHashLength;
+    map.hashMask  = capacity - 1;
+    gNGramHashLength += capacity;
+
+    NGramHashEntry *hash = gNGramHash + map.hashStart;
+    for (int32_t t = 0; t < map.tableCount; t += 1) {
+        const int32_t *ngrams = gNGramTables[map.firstTable + t];
+
+        for (int32_t i = 0; i < 64; i += 1) {
+            int32_t h = hashNGram(ngrams[i], map.hashMask);
+
+            while (hash[h].tables != 0 && hash[h].ngram != ngrams[i]) {
+                h = (h + 1) & map.hashMask;
+            }
+
+            hash[h].ngram   = ngrams[i];
+            hash[h].tables |= (uint32_t) 1 << t;
+        }
+    }
+}
+
+static void U_CALLCONV initNGramTables()
+{
+    uint32_t i;
+
+    addNGramMap(charMap_8859_1);
+    for (i = 0; i < UPRV_LENGTHOF(ngrams_8859_1); i += 1) {
+        addNGramTable(ngrams_8859_1[i].ngrams);
+    }
+    buildNGramHash();
+
+    addNGramMap(charMap_8859_2);
+    for (i = 0; i < UPRV_LENGTHOF(ngrams_8859_2); i += 1) {
+        addNGramTable(ngrams_8859_2[i].ngrams);
+    }
+    buildNGramHash();
+
+    addNGramMap(charMap_8859_5);
+    addNGramTable(ngrams_8859_5_ru);
+    buildNGramHash();
+
+    addNGramMap(charMap_8859_6);
+    addNGramTable(ngrams_8859_6_ar);
+    buildNGramHash();
+
+    addNGramMap(charMap_8859_7);
+    addNGramTable(ngrams_8859_7_el);
+    buildNGramHash();
+
+    addNGramMap(charMap_8859_8);
+    addNGramTable(ngrams_8859_8_I_he);
+    addNGramTable(ngrams_8859_8_he);
+    buildNGramHash();
+
+    addNGramMap(charMap_8859_9);
+    addNGramTable(ngrams_8859_9_tr);
+    buildNGramHash();
+
+    addNGramMap(charMap_windows_1251);
+    addNGramTable(ngrams_windows_1251);
+    buildNGramHash();
+
+    addNGramMap(charMap_windows_1256);
+    addNGramTable(ngrams_windows_1256);
+    buildNGramHash();
+
+    addNGramMap(charMap_KOI8_R);
+    addNGramTable(ngrams_KOI8_R);
+    buildNGramHash();
+
+#if !UCONFIG_ONLY_HTML_CONVERSION
+    addNGramMap(charMap_IBM424_he);
+    addNGramTable(ngrams_IBM424_he_rtl);
+    addNGramTable(ngrams_IBM424_he_ltr);
+    buildNGramHash();
+#endif
+}
+
+/*
+ * Count the n-gram hits of all tables, the same way as NGramParser::parse()
+ * does for one table.
+ */
+static void scoreNGrams(InputText *det)
+{
+    int32_t *hits   = det->fNGramHits;
+    int32_t *counts = det->fNGramHits + gNGramTableCount;
+    int32_t ngram[NGRAM_MAX_MAPS];
+    UBool ignoreSpace[NGRAM_MAX_MAPS];
+    int32_t m;
+
+    uprv_memset(hits, 0, (gNGramTableCount + gNGramMapCount) * sizeof(hits[0]));
+    for (m = 0; m < gNGramMapCount; m += 1) {
+        ngram[m] = 0;
+        ignoreSpace[m] = FALSE;
+    }
+
+    // After the input, each byte map gets a final space, like NGramParser::parse().
+    for (int32_t i = 0; i <= det->fInputLen; i += 1) {
+        int32_t b = i < det->fInputLen ? det->fInputBytes[i] : -1;
+
+        for (m = 0; m < gNGramMapCount; m += 1) {
+            const NGramMapInfo &map = gNGramMaps[m];
+            uint8_t mb;
+
+            if (b >= 0) {
+                mb = map.charMap[b];
+
+                // TODO: 0x20 might not be a space in all character sets...
+                if (mb == 0) {
+                    continue;
+                }
+
+                UBool skip = (mb == 0x20 && ignoreSpace[m]);
+                ignoreSpace[m] = (mb == 0x20);
+                if (skip) {
+                    continue;
+                }
+            } else {
+                mb = 0x20;
+            }
+
+            int32_t thisNgram = ngram[m] = ((ngram[m] << 8) + mb) & N_GRAM_MASK;
+            const NGramHashEntry *hash = gNGramHash + map.hashStart;
+            int32_t h = hashNGram(thisNgram, map.hashMask);
+
+            counts[m] += 1;
+
+            while (hash[h].tables != 0) {
+                if (hash[h].ngram == thisNgram) {
+                    uint32_t tables = hash[h].tables;
+
+                    for (int32_t t = map.firstTable; tables != 0; t += 1, tables >>= 1) {
+                        if (tables & 1) {
+                            hits[t] += 1;
+                        }
+                    }
+                    break;
+                }
+                h = (h + 1) & map.hashMask;
+            }
+        }
+    }
+}
+
+int32_t CharsetRecog_sbcs::match_sbcs(InputText *det, const int32_t ngrams[],  const uint8_t byteMap[]) const
+{
+    umtx_initOnce(gNGramInitOnce, &initNGramTables);
+
+    for (int32_t m = 0; m < gNGramMapCount; m += 1) {
+        const NGramMapInfo &map = gNGramMaps[m];
+
+        if (map.charMap != byteMap) {
+            continue;
+        }
+
+        for (int32_t t = map.firstTable; t < map.firstTable + map.tableCount; t += 1) {
+            if (gNGramTables[t] != ngrams) {
+                continue;
+            }
+
+            if (det->fNGramHits == NULL) {
+                det->fNGramHits = (int32_t *) uprv_malloc(
+                    (NGRAM_MAX_TABLES + NGRAM_MAX_MAPS) * sizeof(int32_t));
+                if (det->fNGramHits == NULL) {
+                    break;
+                }
+            }
+
+            if (!det->fNGramsScored) {
+                scoreNGrams(det);
+                det->fNGramsScored = TRUE;
+            }
+
+            return getNGramConfidence(det->fNGramHits[t], det->fNGramHits[gNGramTableCount + m]);
+        }
+    }
+
+    // Not one of the merged tables, or out of memory: score this table by itself.
+    NGramParser parser(ngrams, byteMap);
+    int32_t result;
+
+    result = parser.parse(det);
+
+    return result;
+}
+
 CharsetRecog_8859_1::~CharsetRecog_8859_1()
 {
     // nothing to do
@@ -120,20 +120,10 @@ CharsetRecog_UTF_32::~CharsetRecog_UTF_32()
     // nothing to do
 }
 
-UBool CharsetRecog_UTF_32::match(InputText* textIn, CharsetMatch *results) const
+void CharsetRecog_UTF_32::countChars(const uint8_t *input, int32_t length,
+                                      int32_t &numValid, int32_t &numInvalid) const
 {
-    const uint8_t *input = textIn->fRawInput;
-    int32_t limit = (textIn->fRawLength / 4) * 4;
-    int32_t numValid = 0;
-    int32_t numInvalid = 0;
-    bool hasBOM = FALSE;
-    int32_t confidence = 0;
-
-    if (limit > 0 && getChar(input, 0) == 0x0000FEFFUL) {
-        hasBOM = TRUE;
-    }
-
-    for(int32_t i = 0; i < limit; i += 4) {
+    for(int32_t i = 0; i < length; i += 4) {
         int32_t ch = getChar(input, i);
 
         if (ch < 0 || ch >= 0x10FFFF || (ch >= 0xD800 && ch <= 0xDFFF)) {
@@ -142,7 +132,17 @@ UBool CharsetRecog_UTF_32::match(InputText* textIn, CharsetMatch *results) const
             numValid += 1;
         }
     }
+}
 
+UBool CharsetRecog_UTF_32::matchCounts(InputText *textIn, int32_t numValid, int32_t numInvalid,
+                                       CharsetMatch *results) const
+{
+    bool hasBOM = FALSE;
+    int32_t confidence = 0;
+
+    if (textIn->fRawLength >= 4 && getChar(textIn->fRawInput, 0) == 0x0000FEFFUL) {
+        hasBOM = TRUE;
+    }
 
     // Cook up some sort of confidence score, based on presense of a BOM
     //    and the existence of valid and/or invalid multi-byte sequences.
@@ -163,6 +163,80 @@ UBool CharsetRecog_UTF_32::match(InputText* textIn, CharsetMatch *results) const
     return (confidence > 0);
 }
 
+UBool CharsetRecog_UTF_32::match(InputText* textIn, CharsetMatch *results) const
+{
+    int32_t limit = (textIn->fRawLength / 4) * 4;
+    int32_t numValid = 0;
+    int32_t numInvalid = 0;
+
+    countChars(textIn->fRawInput, limit, numValid, numInvalid);
+    return matchCounts(textIn, numValid, numInvalid, results);
+}
+
+namespace {
+
+/*
+ * Counts UTF-32 code points across chunks, carrying a partial
+ * code unit from one chunk to the next.
+ */
+class CharsetRecogStream_UTF_32 : public CharsetRecogStream {
+public:
+    CharsetRecogStream_UTF_32(const CharsetRecog_UTF_32 *recognizer) : fRecognizer(recognizer) {
+        reset();
+    }
+
+    virtual ~CharsetRecogStream_UTF_32() {}
+
+    virtual void reset() {
+        fNumValid = fNumInvalid = fPendingLength = 0;
+    }
+
+    virtual UBool update(const uint8_t *bytes, int32_t length) {
+        if (fPendingLength > 0) {
+            while (fPendingLength < 4 && length > 0) {
+                fPending[fPendingLength++] = *bytes++;
+                --length;
+            }
+            if (fPendingLength < 4) {
+                return TRUE;
+            }
+            fRecognizer->countChars(fPending, 4, fNumValid, fNumInvalid);
+            fPendingLength = 0;
+        }
+        int32_t limit = (length / 4) * 4;
+        fRecognizer->countChars(bytes, limit, fNumValid, fNumInvalid);
+        while (limit < length) {
+            fPending[fPendingLength++] = bytes[limit++];
+        }
+        return TRUE;
+    }
+
+    virtual UBool match(InputText *textIn, CharsetMatch *results) const {
+        return fRecognizer->matchCounts(textIn, fNumValid, fNumInvalid, results);
+    }
+
+private:
+    const CharsetRecog_UTF_32 *fRecognizer;
+    int32_t fNumValid;
+    int32_t fNumInvalid;
+    uint8_t fPending[4];
+    int32_t fPendingLength;
+};
+
+}  // namespace
+
+CharsetRecogStream *CharsetRecog_UTF_32::openStream(UErrorCode &status) const
+{
+    if (U_FAILURE(status)) {
+        return NULL;
+    }
+    CharsetRecogStream *stream = new CharsetRecogStream_UTF_32(this);
+    if (stream == NULL) {
+        status = U_MEMORY_ALLOCATION_ERROR;
+    }
+    return stream;
+}
+
 CharsetRecog_UTF_32_BE::~CharsetRecog_UTF_32_BE()
 {
     // nothing to do
@@ -75,6 +75,19 @@ class CharsetRecog_UTF_32 : public CharsetRecog_Unicode
     const char* getName() const = 0;
 
     UBool match(InputText* textIn, CharsetMatch *results) const;
+
+    CharsetRecogStream *openStream(UErrorCode &status) const;
+
+    /**
+     * Count the valid and invalid code points in input[0..length-1].
+     * length must be a multiple of 4.
+     */
+    void countChars(const uint8_t *input, int32_t length, int32_t &numValid, int32_t &numInvalid) const;
+
+    /**
+     * Set the match result from code point counts collected with countChars().
+     */
+    UBool matchCounts(InputText *textIn, int32_t numValid, int32_t numInvalid, CharsetMatch *results) const;
 };
 
 
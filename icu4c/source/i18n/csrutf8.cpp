@@ -26,61 +26,65 @@ const char *CharsetRecog_UTF8::getName() const
     return "UTF-8";
 }
 
-UBool CharsetRecog_UTF8::match(InputText* input, CharsetMatch *results) const {
-    bool hasBOM = FALSE;
-    int32_t numValid = 0;
-    int32_t numInvalid = 0;
-    const uint8_t *inputBytes = input->fRawInput;
-    int32_t i;
-    int32_t trailBytes = 0;
-    int32_t confidence;
-
-    if (input->fRawLength >= 3 && 
-        inputBytes[0] == 0xEF && inputBytes[1] == 0xBB && inputBytes[2] == 0xBF) {
-            hasBOM = TRUE;
-    }
-
-    // Scan for multi-byte sequences
-    for (i=0; i < input->fRawLength; i += 1) {
-        int32_t b = inputBytes[i];
-
-        if ((b & 0x80) == 0) {
-            continue;   // ASCII
-        }
+namespace {
 
-        // Hi bit on char found.  Figure out how long the sequence should be
-        if ((b & 0x0E0) == 0x0C0) {
-            trailBytes = 1;
-        } else if ((b & 0x0F0) == 0x0E0) {
-            trailBytes = 2;
-        } else if ((b & 0x0F8) == 0xF0) {
-            trailBytes = 3;
-        } else {
-            numInvalid += 1;
-            continue;
-        }
+/*
+ * Counts valid and invalid UTF-8 multi-byte sequences.
+ * Can be fed the input in chunks; a sequence may span chunks.
+ */
+struct UTF8Counts {
+    int32_t numValid;
+    int32_t numInvalid;
+    int32_t trailBytes;     // trail bytes still expected for the current sequence
 
-        // Verify that we've got the right number of trail bytes in the sequence
-        for (;;) {
-            i += 1;
+    void reset() {
+        numValid = numInvalid = trailBytes = 0;
+    }
 
-            if (i >= input->fRawLength) {
-                break;
+    void count(const uint8_t *inputBytes, int32_t length) {
+        for (int32_t i = 0; i < length; i += 1) {
+            int32_t b = inputBytes[i];
+
+            if (trailBytes > 0) {
+                // Verify that we've got the right number of trail bytes in the sequence
+                if ((b & 0xC0) != 0x080) {
+                    numInvalid += 1;
+                    trailBytes = 0;
+                } else if (--trailBytes == 0) {
+                    numValid += 1;
+                }
+                continue;
             }
 
-            b = inputBytes[i];
-
-            if ((b & 0xC0) != 0x080) {
-                numInvalid += 1;
-                break;
+            if ((b & 0x80) == 0) {
+                continue;   // ASCII
             }
 
-            if (--trailBytes == 0) {
-                numValid += 1;
-                break;
+            // Hi bit on char found.  Figure out how long the sequence should be
+            if ((b & 0x0E0) == 0x0C0) {
+                trailBytes = 1;
+            } else if ((b & 0x0F0) == 0x0E0) {
+                trailBytes = 2;
+            } else if ((b & 0x0F8) == 0xF0) {
+                trailBytes = 3;
+            } else {
+                numInvalid += 1;
             }
         }
+    }
+};
 
+UBool matchUTF8(const CharsetRecognizer *recognizer, InputText *input,
+                const UTF8Counts &counts, CharsetMatch *results) {
+    bool hasBOM = FALSE;
+    int32_t numValid = counts.numValid;
+    int32_t numInvalid = counts.numInvalid;
+    const uint8_t *inputBytes = input->fRawInput;
+    int32_t confidence;
+
+    if (input->fRawLength >= 3 && 
+        inputBytes[0] == 0xEF && inputBytes[1] == 0xBB && inputBytes[2] == 0xBF) {
+            hasBOM = TRUE;
     }
 
     // Cook up some sort of confidence score, based on presence of a BOM
@@ -103,9 +107,56 @@ UBool CharsetRecog_UTF8::match(InputText* input, CharsetMatch *results) const {
         confidence = 25;
     }
 
-    results->set(input, this, confidence);
+    results->set(input, recognizer, confidence);
     return (confidence > 0);
 }
 
+class CharsetRecogStream_UTF8 : public CharsetRecogStream {
+public:
+    CharsetRecogStream_UTF8(const CharsetRecognizer *recognizer) : fRecognizer(recognizer) {
+        fCounts.reset();
+    }
+
+    virtual ~CharsetRecogStream_UTF8() {}
+
+    virtual void reset() {
+        fCounts.reset();
+    }
+
+    virtual UBool update(const uint8_t *bytes, int32_t length) {
+        fCounts.count(bytes, length);
+        return TRUE;
+    }
+
+    virtual UBool match(InputText *textIn, CharsetMatch *results) const {
+        return matchUTF8(fRecognizer, textIn, fCounts, results);
+    }
+
+private:
+    const CharsetRecognizer *fRecognizer;
+    UTF8Counts fCounts;
+};
+
+}  // namespace
+
+UBool CharsetRecog_UTF8::match(InputText* input, CharsetMatch *results) const {
+    UTF8Counts counts;
+    counts.reset();
+    // Scan for multi-byte sequences
+    counts.count(input->fRawInput, input->fRawLength);
+    return matchUTF8(this, input, counts, results);
+}
+
+CharsetRecogStream *CharsetRecog_UTF8::openStream(UErrorCode &status) const {
+    if (U_FAILURE(status)) {
+        return NULL;
+    }
+    CharsetRecogStream *stream = new CharsetRecogStream_UTF8(this);
+    if (stream == NULL) {
+        status = U_MEMORY_ALLOCATION_ERROR;
+    }
+    return stream;
+}
+
 U_NAMESPACE_END
 #endif
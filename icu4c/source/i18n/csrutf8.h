@@ -35,6 +35,8 @@ class CharsetRecog_UTF8: public CharsetRecognizer {
      * @see com.ibm.icu.text.CharsetRecognizer#match(com.ibm.icu.text.CharsetDetector)
      */
     UBool match(InputText *input, CharsetMatch *results) const;
+
+    CharsetRecogStream *openStream(UErrorCode &status) const;
 	
 };
 
@@ -32,7 +32,17 @@ InputText::InputText(UErrorCode &status)
                                                  //   Value is percent, not absolute.
       fDeclaredEncoding(0),
       fRawInput(0),
-      fRawLength(0)
+      fRawLength(0),
+      fNGramHits(0),
+      fNGramsScored(FALSE),
+      fIsStream(FALSE),
+      fStreamLength(0),
+      fRawSample(0),
+      fStrippedSample(0),
+      fStrippedLength(0),
+      fOpenTags(0),
+      fBadTags(0),
+      fInMarkup(FALSE)
 {
     if (fInputBytes == NULL || fByteStats == NULL) {
         status = U_MEMORY_ALLOCATION_ERROR;
@@ -44,6 +54,9 @@ InputText::~InputText()
     DELETE_ARRAY(fDeclaredEncoding);
     DELETE_ARRAY(fByteStats);
     DELETE_ARRAY(fInputBytes);
+    DELETE_ARRAY(fRawSample);
+    DELETE_ARRAY(fStrippedSample);
+    DELETE_ARRAY(fNGramHits);
 }
 
 void InputText::setText(const char *in, int32_t len)
@@ -52,6 +65,74 @@ void InputText::setText(const char *in, int32_t len)
     fC1Bytes   = FALSE;
     fRawInput  = (const uint8_t *) in;
     fRawLength = len == -1? (int32_t)uprv_strlen(in) : len;
+    fIsStream  = FALSE;
+}
+
+void InputText::startStream(UErrorCode &status)
+{
+    if (U_FAILURE(status)) {
+        return;
+    }
+
+    if (fRawSample == NULL) {
+        fRawSample      = NEW_ARRAY(uint8_t, BUFFER_SIZE);
+        fStrippedSample = NEW_ARRAY(uint8_t, BUFFER_SIZE);
+
+        if (fRawSample == NULL || fStrippedSample == NULL) {
+            status = U_MEMORY_ALLOCATION_ERROR;
+            return;
+        }
+    }
+
+    fInputLen       = 0;
+    fC1Bytes        = FALSE;
+    fRawInput       = fRawSample;
+    fRawLength      = 0;
+    fIsStream       = TRUE;
+    fStreamLength   = 0;
+    fStrippedLength = 0;
+    fOpenTags       = 0;
+    fBadTags        = 0;
+    fInMarkup       = FALSE;
+}
+
+void InputText::appendText(const uint8_t *in, int32_t len)
+{
+    int32_t srci;
+
+    fStreamLength += len;
+
+    int32_t sampleLength = BUFFER_SIZE - fRawLength;
+    if (sampleLength > len) {
+        sampleLength = len;
+    }
+    if (sampleLength > 0) {
+        uprv_memcpy(fRawSample + fRawLength, in, sampleLength);
+        fRawLength += sampleLength;
+    }
+
+    // Strip markup the same way MungeInput() does for a whole buffer,
+    //   one chunk at a time.
+    for (srci = 0; srci < len && fStrippedLength < BUFFER_SIZE; srci += 1) {
+        uint8_t b = in[srci];
+
+        if (b == (uint8_t)0x3C) { /* Check for the ASCII '<' */
+            if (fInMarkup) {
+                fBadTags += 1;
+            }
+
+            fInMarkup = TRUE;
+            fOpenTags += 1;
+        }
+
+        if (! fInMarkup) {
+            fStrippedSample[fStrippedLength++] = b;
+        }
+
+        if (b == (uint8_t)0x3E) { /* Check for the ASCII '>' */
+            fInMarkup = FALSE;
+        }
+    }
 }
 
 void InputText::setDeclaredEncoding(const char* encoding, int32_t len)
@@ -94,7 +175,13 @@ void InputText::MungeInput(UBool fStripTags) {
     //     Count how many total '<' and illegal (nested) '<' occur, so we can make some
     //     guess as to whether the input was actually marked up at all.
     // TODO: Think about how this interacts with EBCDIC charsets that are detected.
-    if (fStripTags) {
+    if (fStripTags && fIsStream) {
+        // appendText() has already stripped the markup.
+        uprv_memcpy(fInputBytes, fStrippedSample, fStrippedLength);
+        fInputLen = fStrippedLength;
+        openTags  = fOpenTags;
+        badTags   = fBadTags;
+    } else if (fStripTags) {
         for (srci = 0; srci < fRawLength && dsti < BUFFER_SIZE; srci += 1) {
             b = fRawInput[srci];
 
@@ -124,8 +211,9 @@ void InputText::MungeInput(UBool fStripTags) {
     //    essentially nothing but markup abandon the markup stripping.
     //    Detection will have to work on the unstripped input.
     //
+    int64_t totalLength = fIsStream ? fStreamLength : fRawLength;
     if (openTags<5 || openTags/5 < badTags || 
-        (fInputLen < 100 && fRawLength>600))
+        (fInputLen < 100 && totalLength>600))
     {
         int32_t limit = fRawLength;
 
@@ -146,6 +234,7 @@ void InputText::MungeInput(UBool fStripTags) {
     //
 
     uprv_memset(fByteStats, 0, (sizeof fByteStats[0]) * 256);
+    fNGramsScored = FALSE;
 
     for (srci = 0; srci < fInputLen; srci += 1) {
         fByteStats[fInputBytes[srci]] += 1;
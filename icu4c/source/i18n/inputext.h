@@ -34,6 +34,18 @@ class InputText : public UMemory
     ~InputText();
 
     void setText(const char *in, int32_t len);
+
+    /**
+     * Start collecting input that is passed in chunks by appendText().
+     * Only the first BUFFER_SIZE bytes are kept, as the sample that
+     * the non-streaming recognizers look at; fRawInput refers to it.
+     */
+    void startStream(UErrorCode &status);
+
+    /**
+     * Add the next chunk of streamed input to the sample.
+     */
+    void appendText(const uint8_t *in, int32_t len);
     void setDeclaredEncoding(const char *encoding, int32_t len);
     UBool isSet() const; 
     void MungeInput(UBool fStripTags);
@@ -55,6 +67,24 @@ class InputText : public UMemory
     //   buffer here.
     int32_t                  fRawLength;    // Length of data in fRawInput array.
 
+    // N-gram statistics for the single-byte charset recognizers, scored for
+    //   all of their n-gram tables at once on first use after MungeInput().
+    //   See CharsetRecog_sbcs::match_sbcs().
+    int32_t                 *fNGramHits;    // Hits per n-gram table, then n-grams seen per byte map.
+    UBool                    fNGramsScored; // True if fNGramHits is up to date.
+
+    // Streamed input, see startStream().
+    UBool                    fIsStream;       // True if the input was given by appendText().
+    int64_t                  fStreamLength;   // Total number of bytes appended so far.
+
+private:
+    uint8_t    *fRawSample;          // First BUFFER_SIZE bytes of the streamed input.
+    uint8_t    *fStrippedSample;     // Streamed input with markup removed, up to BUFFER_SIZE bytes.
+    int32_t     fStrippedLength;
+    int32_t     fOpenTags;           // Markup counts for fStrippedSample.
+    int32_t     fBadTags;
+    UBool       fInMarkup;
+
 };
 
 U_NAMESPACE_END
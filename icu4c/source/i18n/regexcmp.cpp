@@ -2697,6 +2697,9 @@ void   RegexCompile::matchStartType() {
     int32_t    opType;                 // The opcode type of the op
     int32_t    currentLen = 0;         // Minimum length of a match to this point (loc) in the pattern
     int32_t    numInitialStrings = 0;  // Number of strings encountered that could match at start.
+    int32_t    maxForwardDest = 0;     // Largest destination of a forward branch encountered so far.
+                                       //   Ops before it may be bypassed by a match; ops at or
+                                       //   after it are on every path through the pattern.
 
     UBool      atStart = TRUE;         // True if no part of the pattern yet encountered
                                        //   could have advanced the position in a match.
@@ -2952,6 +2955,9 @@ void   RegexCompile::matchStartType() {
                     if (forwardedLength.elementAti(jmpDest) > currentLen) {
                         forwardedLength.setElementAt(currentLen, jmpDest);
                     }
+                    if (jmpDest > maxForwardDest) {
+                        maxForwardDest = jmpDest;
+                    }
                 }
             }
             atStart = FALSE;
@@ -2981,6 +2987,9 @@ void   RegexCompile::matchStartType() {
                     if (currentLen < forwardedLength.elementAti(jmpDest)) {
                         forwardedLength.setElementAt(currentLen, jmpDest);
                     }
+                    if (jmpDest > maxForwardDest) {
+                        maxForwardDest = jmpDest;
+                    }
                 }
             }
             atStart = FALSE;
@@ -3010,6 +3019,32 @@ void   RegexCompile::matchStartType() {
                     fRXPat->fInitialStringLen = stringLen;
                 }
 
+                // If no branch bypasses this string, then every match contains it.
+                //   Remember the best such string for a prefilter in find():
+                //   prefer a string at a bounded distance from the match start, then a longer one.
+                //   Strings that begin or end with a surrogate are not used, so that
+                //   a code unit search can not find them in the middle of a code point.
+                if (maxForwardDest <= loc-1) {
+                    int32_t stringStartIdx = URX_VAL(op);
+                    UChar   first = fRXPat->fLiteralText.charAt(stringStartIdx);
+                    UChar   last  = fRXPat->fLiteralText.charAt(stringStartIdx + stringLen - 1);
+                    if (!U16_IS_SURROGATE(first) && !U16_IS_SURROGATE(last)) {
+                        int32_t maxOffset = maxMatchLength(3, loc-1);
+                        if (maxOffset != INT32_MAX) {
+                            maxOffset -= stringLen;
+                        }
+                        UBool bounded     = maxOffset != INT32_MAX;
+                        UBool bestBounded = fRXPat->fRequiredStringMaxOffset != INT32_MAX;
+                        if (fRXPat->fRequiredStringLen == 0 ||
+                                (bounded && !bestBounded) ||
+                                (bounded == bestBounded && stringLen > fRXPat->fRequiredStringLen)) {
+                            fRXPat->fRequiredStringIdx       = stringStartIdx;
+                            fRXPat->fRequiredStringLen       = stringLen;
+                            fRXPat->fRequiredStringMaxOffset = maxOffset;
+                        }
+                    }
+                }
+
                 currentLen = safeIncrement(currentLen, stringLen);
                 atStart = FALSE;
             }
@@ -3061,6 +3096,9 @@ void   RegexCompile::matchStartType() {
                     if (forwardedLength.elementAti(loopEndLoc) > currentLen) {
                         forwardedLength.setElementAt(currentLen, loopEndLoc);
                     }
+                    if (loopEndLoc > maxForwardDest) {
+                        maxForwardDest = loopEndLoc;
+                    }
                 }
                 loc+=3;  // Skips over operands of CTR_INIT
             }
@@ -3115,6 +3153,17 @@ void   RegexCompile::matchStartType() {
                             if (currentLen < forwardedLength.elementAti(jmpDest)) {
                                 forwardedLength.setElementAt(currentLen, jmpDest);
                             }
+                            if (jmpDest > maxForwardDest) {
+                                maxForwardDest = jmpDest;
+                            }
+                        }
+                    }
+                    if (URX_TYPE(op) == URX_JMP || URX_TYPE(op) == URX_JMPX) {
+                        // Ops beyond the block that are the target of a jump from
+                        //   inside it are not on every path through the pattern.
+                        int32_t  jmpDest = URX_VAL(op);
+                        if (jmpDest > maxForwardDest) {
+                            maxForwardDest = jmpDest;
                         }
                     }
                     U_ASSERT(loc <= end);
@@ -33,6 +33,7 @@
 #include "regexst.h"
 #include "regextxt.h"
 #include "ucase.h"
+#include "ustr_simd.h"
 
 // #include <malloc.h>        // Needed for heapcheck testing
 
@@ -694,11 +695,20 @@ UBool RegexMatcher::find(UErrorCode &status) {
     UChar32  c;
     U_ASSERT(startPos >= 0);
 
+    // Index of the next occurrence of the pattern's required string, if it has one.
+    //   A match that starts after it must contain a later occurrence.
+    int64_t requiredPos = fPattern->fRequiredStringLen > 0 ? -1 : U_INT64_MAX;
+
     switch (fPattern->fStartType) {
     case START_NO_INFO:
         // No optimization was found.
         //  Try a match at each input position.
         for (;;) {
+            if (startPos > requiredPos && !skipToRequiredString(startPos, requiredPos)) {
+                fMatch = FALSE;
+                fHitEnd = TRUE;
+                return FALSE;
+            }
             MatchAt(startPos, FALSE, status);
             if (U_FAILURE(status)) {
                 return FALSE;
@@ -741,6 +751,14 @@ UBool RegexMatcher::find(UErrorCode &status) {
             U_ASSERT(fPattern->fMinMatchLen > 0);
             UTEXT_SETNATIVEINDEX(fInputText, startPos);
             for (;;) {
+                if (startPos > requiredPos) {
+                    if (!skipToRequiredString(startPos, requiredPos)) {
+                        fMatch = FALSE;
+                        fHitEnd = TRUE;
+                        return FALSE;
+                    }
+                    UTEXT_SETNATIVEINDEX(fInputText, startPos);
+                }
                 int64_t pos = startPos;
                 c = UTEXT_NEXT32(fInputText);
                 startPos = UTEXT_GETNATIVEINDEX(fInputText);
@@ -777,6 +795,14 @@ UBool RegexMatcher::find(UErrorCode &status) {
             UChar32 theChar = fPattern->fInitialChar;
             UTEXT_SETNATIVEINDEX(fInputText, startPos);
             for (;;) {
+                if (startPos > requiredPos) {
+                    if (!skipToRequiredString(startPos, requiredPos)) {
+                        fMatch = FALSE;
+                        fHitEnd = TRUE;
+                        return FALSE;
+                    }
+                    UTEXT_SETNATIVEINDEX(fInputText, startPos);
+                }
                 int64_t pos = startPos;
                 c = UTEXT_NEXT32(fInputText);
                 startPos = UTEXT_GETNATIVEINDEX(fInputText);
@@ -970,11 +996,20 @@ UBool RegexMatcher::findUsingChunk(UErrorCode &status) {
     UChar32  c;
     U_ASSERT(startPos >= 0);
 
+    // Index of the next occurrence of the pattern's required string, if it has one.
+    //   A match that starts after it must contain a later occurrence.
+    int32_t requiredPos = fPattern->fRequiredStringLen > 0 ? -1 : INT32_MAX;
+
     switch (fPattern->fStartType) {
     case START_NO_INFO:
         // No optimization was found.
         //  Try a match at each input position.
         for (;;) {
+            if (startPos > requiredPos && !skipToRequiredStringInChunk(startPos, requiredPos)) {
+                fMatch = FALSE;
+                fHitEnd = TRUE;
+                return FALSE;
+            }
             MatchChunkAt(startPos, FALSE, status);
             if (U_FAILURE(status)) {
                 return FALSE;
@@ -1014,6 +1049,11 @@ UBool RegexMatcher::findUsingChunk(UErrorCode &status) {
         // Match may start on any char from a pre-computed set.
         U_ASSERT(fPattern->fMinMatchLen > 0);
         for (;;) {
+            if (startPos > requiredPos && !skipToRequiredStringInChunk(startPos, requiredPos)) {
+                fMatch = FALSE;
+                fHitEnd = TRUE;
+                return FALSE;
+            }
             int32_t pos = startPos;
             U16_NEXT(inputBuf, startPos, fActiveLimit, c);  // like c = inputBuf[startPos++];
             if ((c<256 && fPattern->fInitialChars8->contains(c)) ||
@@ -1044,6 +1084,11 @@ UBool RegexMatcher::findUsingChunk(UErrorCode &status) {
         U_ASSERT(fPattern->fMinMatchLen > 0);
         UChar32 theChar = fPattern->fInitialChar;
         for (;;) {
+            if (startPos > requiredPos && !skipToRequiredStringInChunk(startPos, requiredPos)) {
+                fMatch = FALSE;
+                fHitEnd = TRUE;
+                return FALSE;
+            }
             int32_t pos = startPos;
             U16_NEXT(inputBuf, startPos, fActiveLimit, c);  // like c = inputBuf[startPos++];
             if (c == theChar) {
@@ -1143,6 +1188,131 @@ UBool RegexMatcher::findUsingChunk(UErrorCode &status) {
 
 
 
+//--------------------------------------------------------------------------------
+//
+//   skipToRequiredString()    Prefilter for find().  Every match of the pattern contains
+//                             its required string, no more than fRequiredStringMaxOffset
+//                             UTF-16 code units after the start of the match.
+//                             Find the next occurrence of the string at or after pos,
+//                             set requiredPos to its index, and advance pos to the
+//                             first position where a match containing it could begin.
+//                             Return FALSE if the string does not occur again, in which
+//                             case there can be no further match.
+//
+//--------------------------------------------------------------------------------
+UBool RegexMatcher::skipToRequiredString(int64_t &pos, int64_t &requiredPos) {
+    const UChar *requiredString = fPattern->fLiteralText.getBuffer() + fPattern->fRequiredStringIdx;
+    int32_t      requiredLen    = fPattern->fRequiredStringLen;
+    int64_t      found;
+
+    UTEXT_SETNATIVEINDEX(fInputText, pos);
+    for (;;) {
+        // Scan the rest of the current chunk for the first code unit of the string.
+        //   The string does not begin with a surrogate, so a hit is at the start of a code point.
+        int32_t offset = fInputText->chunkOffset;
+        offset += uprv_spanUCharsNotEqual(fInputText->chunkContents + offset,
+                                          fInputText->chunkLength - offset, requiredString[0]);
+        if (offset == fInputText->chunkLength) {
+            if (fInputText->chunkNativeLimit >= fActiveLimit) {
+                return FALSE;
+            }
+            UTEXT_SETNATIVEINDEX(fInputText, fInputText->chunkNativeLimit);
+            continue;
+        }
+        fInputText->chunkOffset = offset;
+        found = UTEXT_GETNATIVEINDEX(fInputText);
+        if (found >= fActiveLimit) {
+            return FALSE;
+        }
+
+        // Compare the whole string, the same way that MatchAt() does for URX_STRING.
+        int32_t requiredIndex = 0;
+        UBool   success = TRUE;
+        while (requiredIndex < requiredLen) {
+            if (UTEXT_GETNATIVEINDEX(fInputText) >= fActiveLimit) {
+                // No room for this or any later occurrence.
+                return FALSE;
+            }
+            UChar32 inputChar = UTEXT_NEXT32(fInputText);
+            UChar32 requiredChar;
+            U16_NEXT(requiredString, requiredIndex, requiredLen, requiredChar);
+            if (requiredChar != inputChar) {
+                success = FALSE;
+                break;
+            }
+        }
+        if (success) {
+            break;
+        }
+        UTEXT_SETNATIVEINDEX(fInputText, found);
+        (void)UTEXT_NEXT32(fInputText);
+    }
+
+    requiredPos = found;
+    int32_t maxOffset = fPattern->fRequiredStringMaxOffset;
+    if (maxOffset != INT32_MAX) {
+        int64_t start;
+        if (UTEXT_USES_U16(fInputText)) {
+            start = found - maxOffset;
+            if (start > pos) {
+                // Back up to the start of a code point.
+                UTEXT_SETNATIVEINDEX(fInputText, start);
+                start = UTEXT_GETNATIVEINDEX(fInputText);
+            }
+        } else {
+            // Each code point is at least one native unit long, so backing up
+            //   maxOffset code points can not skip over a possible match start.
+            UTEXT_SETNATIVEINDEX(fInputText, found);
+            for (int32_t i = 0; i < maxOffset && UTEXT_GETNATIVEINDEX(fInputText) > pos; i++) {
+                (void)UTEXT_PREVIOUS32(fInputText);
+            }
+            start = UTEXT_GETNATIVEINDEX(fInputText);
+        }
+        if (start > pos) {
+            pos = start;
+        }
+    }
+    return TRUE;
+}
+
+//--------------------------------------------------------------------------------
+//
+//   skipToRequiredStringInChunk()    skipToRequiredString(), for input text
+//                                    that is all in one UTF-16 chunk.
+//
+//--------------------------------------------------------------------------------
+UBool RegexMatcher::skipToRequiredStringInChunk(int32_t &pos, int32_t &requiredPos) {
+    const UChar *inputBuf       = fInputText->chunkContents;
+    const UChar *requiredString = fPattern->fLiteralText.getBuffer() + fPattern->fRequiredStringIdx;
+    int32_t      requiredLen    = fPattern->fRequiredStringLen;
+
+    // Scan for the first code unit of the string, then compare the rest.
+    //   The string neither begins nor ends with a surrogate, so a code unit match
+    //   is also a code point match.
+    int32_t lastStart = (int32_t)fActiveLimit - requiredLen;
+    int32_t found = pos;
+    for (;; found++) {
+        if (found <= lastStart) {
+            found += uprv_spanUCharsNotEqual(inputBuf + found, lastStart + 1 - found, requiredString[0]);
+        }
+        if (found > lastStart) {
+            return FALSE;
+        }
+        if (u_memcmp(inputBuf + found + 1, requiredString + 1, requiredLen - 1) == 0) {
+            break;
+        }
+    }
+    requiredPos = found;
+    int32_t maxOffset = fPattern->fRequiredStringMaxOffset;
+    if (maxOffset != INT32_MAX && requiredPos - maxOffset > pos) {
+        pos = requiredPos - maxOffset;
+        U16_SET_CP_START(inputBuf, 0, pos);
+    }
+    return TRUE;
+}
+
+
+
 //--------------------------------------------------------------------------------
 //
 //  group()
@@ -101,6 +101,9 @@ RegexPattern &RegexPattern::operator = (const RegexPattern &other) {
     fStartType        = other.fStartType;
     fInitialStringIdx = other.fInitialStringIdx;
     fInitialStringLen = other.fInitialStringLen;
+    fRequiredStringIdx = other.fRequiredStringIdx;
+    fRequiredStringLen = other.fRequiredStringLen;
+    fRequiredStringMaxOffset = other.fRequiredStringMaxOffset;
     *fInitialChars    = *other.fInitialChars;
     fInitialChar      = other.fInitialChar;
     *fInitialChars8   = *other.fInitialChars8;
@@ -176,6 +179,9 @@ void RegexPattern::init() {
     fStartType        = START_NO_INFO;
     fInitialStringIdx = 0;
     fInitialStringLen = 0;
+    fRequiredStringIdx = 0;
+    fRequiredStringLen = 0;
+    fRequiredStringMaxOffset = 0;
     fInitialChars     = NULL;
     fInitialChar      = 0;
     fInitialChars8    = NULL;
@@ -844,6 +850,10 @@ void RegexPattern::dumpPattern() const {
                 printf("%#x\n", fInitialChar);
             }
     }
+    if (fRequiredStringLen > 0) {
+        UnicodeString requiredString(fLiteralText, fRequiredStringIdx, fRequiredStringLen);
+        printf("   Required string: \"%s\", max offset %d\n", CStr(requiredString)(), fRequiredStringMaxOffset);
+    }
 
     printf("Named Capture Groups:\n");
     if (!fNamedCaptureMap || uhash_count(fNamedCaptureMap) == 0) {
@@ -87,6 +87,58 @@ FixedSortKeyByteSink::Resize(int32_t /*appendCapacity*/, int32_t /*length*/) {
     return FALSE;
 }
 
+/**
+ * Growable buffer for one sort key at a time,
+ * reused for a batch of keys.
+ */
+class BatchSortKeyByteSink : public SortKeyByteSink {
+public:
+    BatchSortKeyByteSink() : SortKeyByteSink(NULL, 0) {
+        buffer_ = keyBuffer.getAlias();
+        capacity_ = keyBuffer.getCapacity();
+    }
+    virtual ~BatchSortKeyByteSink();
+
+    /** Empties the buffer for the next key. */
+    void Clear() { appended_ = 0; }
+    const char *GetBytes() const { return buffer_; }
+
+private:
+    virtual void AppendBeyondCapacity(const char *bytes, int32_t n, int32_t length);
+    virtual UBool Resize(int32_t appendCapacity, int32_t length);
+
+    MaybeStackArray<char, 256> keyBuffer;
+};
+
+BatchSortKeyByteSink::~BatchSortKeyByteSink() {}
+
+void
+BatchSortKeyByteSink::AppendBeyondCapacity(const char *bytes, int32_t n, int32_t length) {
+    // buffer_ != NULL && bytes != NULL && n > 0 && appended_ > capacity_
+    if (Resize(n, length)) {
+        uprv_memcpy(buffer_ + length, bytes, n);
+    }
+}
+
+UBool
+BatchSortKeyByteSink::Resize(int32_t appendCapacity, int32_t length) {
+    if (buffer_ == NULL) {
+        return FALSE;  // allocation failed before already
+    }
+    int32_t newCapacity = 2 * capacity_;
+    int32_t altCapacity = length + 2 * appendCapacity;
+    if (newCapacity < altCapacity) {
+        newCapacity = altCapacity;
+    }
+    if (keyBuffer.resize(newCapacity, length) == NULL) {
+        SetNotOk();
+        return FALSE;
+    }
+    buffer_ = keyBuffer.getAlias();
+    capacity_ = newCapacity;
+    return TRUE;
+}
+
 }  // namespace
 
 // Not in an anonymous namespace, so that it can be a friend of CollationKey.
@@ -694,6 +746,9 @@ RuleBasedCollator::setFastLatinOptions(CollationSettings &ownedSettings) const {
     ownedSettings.fastLatinOptions = CollationFastLatin::getOptions(
             data, ownedSettings,
             ownedSettings.fastLatinPrimaries, UPRV_LENGTHOF(ownedSettings.fastLatinPrimaries));
+    ownedSettings.fastScriptOptions = CollationFastLatin::getScriptOptions(
+            data, tailoring->fastScriptTable, ownedSettings,
+            ownedSettings.fastScriptPrimaries, UPRV_LENGTHOF(ownedSettings.fastScriptPrimaries));
 }
 
 UCollationResult
@@ -1041,6 +1096,24 @@ RuleBasedCollator::doCompare(const UChar *left, int32_t leftLength,
                                                       left + equalPrefixLength, -1,
                                                       right + equalPrefixLength, -1);
         }
+    } else if(settings->fastScriptOptions >= 0) {
+        // The script fastpath bails out right away unless the first differing characters
+        // are in the table's script block, or in ASCII or punctuation.
+        if(leftLength >= 0) {
+            result = CollationFastLatin::compareScriptUTF16(tailoring->fastScriptTable,
+                                                            settings->fastScriptPrimaries,
+                                                            settings->fastScriptOptions,
+                                                            left + equalPrefixLength,
+                                                            leftLength - equalPrefixLength,
+                                                            right + equalPrefixLength,
+                                                            rightLength - equalPrefixLength);
+        } else {
+            result = CollationFastLatin::compareScriptUTF16(tailoring->fastScriptTable,
+                                                            settings->fastScriptPrimaries,
+                                                            settings->fastScriptOptions,
+                                                            left + equalPrefixLength, -1,
+                                                            right + equalPrefixLength, -1);
+        }
     } else {
         result = CollationFastLatin::BAIL_OUT_RESULT;
     }
@@ -1170,6 +1243,22 @@ RuleBasedCollator::doCompare(const uint8_t *left, int32_t leftLength,
                                                      left + equalPrefixLength, -1,
                                                      right + equalPrefixLength, -1);
         }
+    } else if(settings->fastScriptOptions >= 0) {
+        if(leftLength >= 0) {
+            result = CollationFastLatin::compareScriptUTF8(tailoring->fastScriptTable,
+                                                           settings->fastScriptPrimaries,
+                                                           settings->fastScriptOptions,
+                                                           left + equalPrefixLength,
+                                                           leftLength - equalPrefixLength,
+                                                           right + equalPrefixLength,
+                                                           rightLength - equalPrefixLength);
+        } else {
+            result = CollationFastLatin::compareScriptUTF8(tailoring->fastScriptTable,
+                                                           settings->fastScriptPrimaries,
+                                                           settings->fastScriptOptions,
+                                                           left + equalPrefixLength, -1,
+                                                           right + equalPrefixLength, -1);
+        }
     } else {
         result = CollationFastLatin::BAIL_OUT_RESULT;
     }
@@ -1353,6 +1442,69 @@ RuleBasedCollator::writeSortKey(const UChar *s, int32_t length,
     sink.Append(&terminator, 1);
 }
 
+void
+RuleBasedCollator::getSortKeyUTF8(StringPiece source, ByteSink &sink,
+                                  UErrorCode &errorCode) const {
+    if(U_FAILURE(errorCode)) { return; }
+    if(source.data() == NULL && source.length() != 0) {
+        errorCode = U_ILLEGAL_ARGUMENT_ERROR;
+        return;
+    }
+    BatchSortKeyByteSink key;
+    writeSortKeyUTF8(reinterpret_cast<const uint8_t *>(source.data()), source.length(),
+                     key, errorCode);
+    if(U_FAILURE(errorCode)) { return; }
+    if(!key.IsOk()) {
+        errorCode = U_MEMORY_ALLOCATION_ERROR;
+        return;
+    }
+    sink.Append(key.GetBytes(), key.NumberOfBytesAppended());
+    sink.Flush();
+}
+
+int32_t
+RuleBasedCollator::internalGetSortKeyUTF8(const char *s, int32_t length,
+                                          uint8_t *dest, int32_t capacity,
+                                          UErrorCode &errorCode) const {
+    if(U_FAILURE(errorCode)) { return 0; }
+    if((s == NULL && length != 0) || capacity < 0 || (dest == NULL && capacity > 0)) {
+        errorCode = U_ILLEGAL_ARGUMENT_ERROR;
+        return 0;
+    }
+    uint8_t noDest[1] = { 0 };
+    if(dest == NULL) {
+        // Distinguish pure preflighting from an allocation error.
+        dest = noDest;
+        capacity = 0;
+    }
+    FixedSortKeyByteSink sink(reinterpret_cast<char *>(dest), capacity);
+    writeSortKeyUTF8(reinterpret_cast<const uint8_t *>(s), length, sink, errorCode);
+    return U_SUCCESS(errorCode) ? sink.NumberOfBytesAppended() : 0;
+}
+
+void
+RuleBasedCollator::writeSortKeyUTF8(const uint8_t *s, int32_t length,
+                                    SortKeyByteSink &sink, UErrorCode &errorCode) const {
+    if(U_FAILURE(errorCode)) { return; }
+    UBool numeric = settings->isNumeric();
+    CollationKeys::LevelCallback callback;
+    if(settings->dontCheckFCD()) {
+        UTF8CollationIterator iter(data, numeric, s, 0, length);
+        CollationKeys::writeSortKeyUpToQuaternary(iter, data->compressibleBytes, *settings,
+                                                  sink, Collation::PRIMARY_LEVEL,
+                                                  callback, TRUE, errorCode);
+    } else {
+        FCDUTF8CollationIterator iter(data, numeric, s, 0, length);
+        CollationKeys::writeSortKeyUpToQuaternary(iter, data->compressibleBytes, *settings,
+                                                  sink, Collation::PRIMARY_LEVEL,
+                                                  callback, TRUE, errorCode);
+    }
+    if(settings->getStrength() == UCOL_IDENTICAL) {
+        writeIdenticalLevelUTF8(reinterpret_cast<const char *>(s), length, sink, errorCode);
+    }
+    sink.Append(Collation::TERMINATOR_BYTE);
+}
+
 void
 RuleBasedCollator::writeIdenticalLevel(const UChar *s, const UChar *limit,
                                        SortKeyByteSink &sink, UErrorCode &errorCode) const {
@@ -1379,6 +1531,165 @@ RuleBasedCollator::writeIdenticalLevel(const UChar *s, const UChar *limit,
     u_writeIdenticalLevelRun(prev, nfd.getBuffer(), nfd.length(), sink);
 }
 
+void
+RuleBasedCollator::writeIdenticalLevelUTF8(const char *s, int32_t length,
+                                           SortKeyByteSink &sink, UErrorCode &errorCode) const {
+    if(U_FAILURE(errorCode)) { return; }
+    // The identical level is written from the NFD form of the UTF-16 text.
+    if(length < 0) {
+        length = static_cast<int32_t>(uprv_strlen(s));
+    }
+    UnicodeString s16 = UnicodeString::fromUTF8(StringPiece(s, length));
+    const UChar *p = s16.getBuffer();
+    writeIdenticalLevel(p, p + s16.length(), sink, errorCode);
+}
+
+void
+RuleBasedCollator::getSortKeys(const UChar *const strings[], const int32_t lengths[], int32_t count,
+                               ByteSink &sink, int32_t offsets[], UErrorCode &errorCode) const {
+    internalGetSortKeys(strings, lengths, count, sink, -1, offsets, NULL, errorCode);
+    sink.Flush();
+}
+
+void
+RuleBasedCollator::getSortKeysUTF8(const char *const strings[], const int32_t lengths[],
+                                   int32_t count,
+                                   ByteSink &sink, int32_t offsets[], UErrorCode &errorCode) const {
+    internalGetSortKeysUTF8(strings, lengths, count, sink, -1, offsets, NULL, errorCode);
+    sink.Flush();
+}
+
+int32_t
+RuleBasedCollator::internalGetSortKeys(const UChar *const strings[], const int32_t lengths[],
+                                       int32_t count, ByteSink &sink, int32_t capacity,
+                                       int32_t offsets[], int32_t *pRequiredCapacity,
+                                       UErrorCode &errorCode) const {
+    if(U_FAILURE(errorCode)) { return 0; }
+    if(count < 0 || (strings == NULL && count > 0) || offsets == NULL) {
+        errorCode = U_ILLEGAL_ARGUMENT_ERROR;
+        return 0;
+    }
+    // Set up once for all of the strings.
+    UBool numeric = settings->isNumeric();
+    UBool checkFCD = !settings->dontCheckFCD();
+    UBool identical = settings->getStrength() == UCOL_IDENTICAL;
+    UTF16CollationIterator iter(data, numeric, NULL, NULL, NULL);
+    FCDUTF16CollationIterator fcdIter(data, numeric, NULL, NULL, NULL);
+    CollationKeys::LevelCallback callback;
+    BatchSortKeyByteSink key;
+    int32_t total = 0;
+    offsets[0] = 0;
+    int32_t i = 0;
+    for(; i < count; ++i) {
+        const UChar *s = strings[i];
+        int32_t length = lengths != NULL ? lengths[i] : -1;
+        if(s == NULL && length != 0) {
+            errorCode = U_ILLEGAL_ARGUMENT_ERROR;
+            break;
+        }
+        const UChar *limit = (length >= 0) ? s + length : NULL;
+        key.Clear();
+        if(checkFCD) {
+            fcdIter.setText(s, limit);
+            CollationKeys::writeSortKeyUpToQuaternary(fcdIter, data->compressibleBytes, *settings,
+                                                      key, Collation::PRIMARY_LEVEL,
+                                                      callback, TRUE, errorCode);
+        } else {
+            iter.setText(s, limit);
+            CollationKeys::writeSortKeyUpToQuaternary(iter, data->compressibleBytes, *settings,
+                                                      key, Collation::PRIMARY_LEVEL,
+                                                      callback, TRUE, errorCode);
+        }
+        if(identical) {
+            writeIdenticalLevel(s, limit, key, errorCode);
+        }
+        key.Append(Collation::TERMINATOR_BYTE);
+        if(U_FAILURE(errorCode)) { break; }
+        if(!key.IsOk()) {
+            errorCode = U_MEMORY_ALLOCATION_ERROR;
+            break;
+        }
+        int32_t keyLength = key.NumberOfBytesAppended();
+        if(capacity >= 0 && keyLength > (capacity - total)) {
+            errorCode = U_BUFFER_OVERFLOW_ERROR;
+            total += keyLength;
+            break;
+        }
+        sink.Append(key.GetBytes(), keyLength);
+        total += keyLength;
+        offsets[i + 1] = total;
+    }
+    if(pRequiredCapacity != NULL) {
+        *pRequiredCapacity = total;
+    }
+    return i;
+}
+
+int32_t
+RuleBasedCollator::internalGetSortKeysUTF8(const char *const strings[], const int32_t lengths[],
+                                           int32_t count, ByteSink &sink, int32_t capacity,
+                                           int32_t offsets[], int32_t *pRequiredCapacity,
+                                           UErrorCode &errorCode) const {
+    if(U_FAILURE(errorCode)) { return 0; }
+    if(count < 0 || (strings == NULL && count > 0) || offsets == NULL) {
+        errorCode = U_ILLEGAL_ARGUMENT_ERROR;
+        return 0;
+    }
+    // Set up once for all of the strings.
+    UBool numeric = settings->isNumeric();
+    UBool checkFCD = !settings->dontCheckFCD();
+    UBool identical = settings->getStrength() == UCOL_IDENTICAL;
+    UTF8CollationIterator iter(data, numeric, NULL, 0, 0);
+    FCDUTF8CollationIterator fcdIter(data, numeric, NULL, 0, 0);
+    CollationKeys::LevelCallback callback;
+    BatchSortKeyByteSink key;
+    int32_t total = 0;
+    offsets[0] = 0;
+    int32_t i = 0;
+    for(; i < count; ++i) {
+        const uint8_t *s = reinterpret_cast<const uint8_t *>(strings[i]);
+        int32_t length = lengths != NULL ? lengths[i] : -1;
+        if(s == NULL && length != 0) {
+            errorCode = U_ILLEGAL_ARGUMENT_ERROR;
+            break;
+        }
+        key.Clear();
+        if(checkFCD) {
+            fcdIter.setText(s, length);
+            CollationKeys::writeSortKeyUpToQuaternary(fcdIter, data->compressibleBytes, *settings,
+                                                      key, Collation::PRIMARY_LEVEL,
+                                                      callback, TRUE, errorCode);
+        } else {
+            iter.setText(s, length);
+            CollationKeys::writeSortKeyUpToQuaternary(iter, data->compressibleBytes, *settings,
+                                                      key, Collation::PRIMARY_LEVEL,
+                                                      callback, TRUE, errorCode);
+        }
+        if(identical) {
+            writeIdenticalLevelUTF8(strings[i], length, key, errorCode);
+        }
+        key.Append(Collation::TERMINATOR_BYTE);
+        if(U_FAILURE(errorCode)) { break; }
+        if(!key.IsOk()) {
+            errorCode = U_MEMORY_ALLOCATION_ERROR;
+            break;
+        }
+        int32_t keyLength = key.NumberOfBytesAppended();
+        if(capacity >= 0 && keyLength > (capacity - total)) {
+            errorCode = U_BUFFER_OVERFLOW_ERROR;
+            total += keyLength;
+            break;
+        }
+        sink.Append(key.GetBytes(), keyLength);
+        total += keyLength;
+        offsets[i + 1] = total;
+    }
+    if(pRequiredCapacity != NULL) {
+        *pRequiredCapacity = total;
+    }
+    return i;
+}
+
 namespace {
 
 /**
@@ -209,6 +209,133 @@ ucol_getSortKey(const    UCollator    *coll,
     return keySize;
 }
 
+U_CAPI int32_t U_EXPORT2
+ucol_getSortKeyUTF8(const UCollator *coll,
+                    const char *source, int32_t sourceLength,
+                    uint8_t *result, int32_t resultLength,
+                    UErrorCode *status)
+{
+    if(status==NULL || U_FAILURE(*status)) {
+        return 0;
+    }
+    if(coll==NULL || (source==NULL && sourceLength!=0) ||
+            resultLength<0 || (result==NULL && resultLength>0)) {
+        *status=U_ILLEGAL_ARGUMENT_ERROR;
+        return 0;
+    }
+    int32_t keySize;
+    const RuleBasedCollator *rbc = RuleBasedCollator::rbcFromUCollator(coll);
+    if(rbc!=NULL) {
+        keySize=rbc->internalGetSortKeyUTF8(source, sourceLength, result, resultLength, *status);
+    } else {
+        if(sourceLength<0) {
+            sourceLength=(int32_t)uprv_strlen(source);
+        }
+        CheckedArrayByteSink sink(reinterpret_cast<char *>(result), resultLength);
+        Collator::fromUCollator(coll)->getSortKeyUTF8(StringPiece(source, sourceLength), sink, *status);
+        keySize=sink.NumberOfBytesAppended();
+    }
+    if(U_FAILURE(*status)) {
+        return 0;
+    }
+    if(keySize>resultLength) {
+        *status=U_BUFFER_OVERFLOW_ERROR;
+    }
+    return keySize;
+}
+
+U_CAPI int32_t U_EXPORT2
+ucol_getSortKeys(const UCollator *coll,
+                 const UChar *const *strings, const int32_t *lengths, int32_t count,
+                 uint8_t *dest, int32_t destCapacity,
+                 int32_t *offsets, int32_t *pRequiredCapacity, UErrorCode *status)
+{
+    if(status==NULL || U_FAILURE(*status)) {
+        return 0;
+    }
+    if(coll==NULL || destCapacity<0 || (dest==NULL && destCapacity>0)) {
+        *status=U_ILLEGAL_ARGUMENT_ERROR;
+        return 0;
+    }
+    const RuleBasedCollator *rbc = RuleBasedCollator::rbcFromUCollator(coll);
+    if(rbc==NULL) {
+        *status=U_UNSUPPORTED_ERROR;
+        return 0;
+    }
+    CheckedArrayByteSink sink(reinterpret_cast<char *>(dest), destCapacity);
+    return rbc->internalGetSortKeys(strings, lengths, count, sink, destCapacity, offsets,
+                                    pRequiredCapacity, *status);
+}
+
+U_CAPI int32_t U_EXPORT2
+ucol_getSortKeysUTF8(const UCollator *coll,
+                     const char *const *strings, const int32_t *lengths, int32_t count,
+                     uint8_t *dest, int32_t destCapacity,
+                     int32_t *offsets, int32_t *pRequiredCapacity, UErrorCode *status)
+{
+    if(status==NULL || U_FAILURE(*status)) {
+        return 0;
+    }
+    if(coll==NULL || destCapacity<0 || (dest==NULL && destCapacity>0)) {
+        *status=U_ILLEGAL_ARGUMENT_ERROR;
+        return 0;
+    }
+    const RuleBasedCollator *rbc = RuleBasedCollator::rbcFromUCollator(coll);
+    if(rbc==NULL) {
+        *status=U_UNSUPPORTED_ERROR;
+        return 0;
+    }
+    CheckedArrayByteSink sink(reinterpret_cast<char *>(dest), destCapacity);
+    return rbc->internalGetSortKeysUTF8(strings, lengths, count, sink, destCapacity, offsets,
+                                        pRequiredCapacity, *status);
+}
+
+U_CAPI void U_EXPORT2
+ucol_sortStrings(const UCollator *coll,
+                 const UChar *const *strings, const int32_t *lengths, int32_t count,
+                 int32_t *permutation,
+                 int32_t maxTasks, UTaskRunner runner, const void *runnerContext,
+                 UErrorCode *status)
+{
+    if(status==NULL || U_FAILURE(*status)) {
+        return;
+    }
+    if(coll==NULL) {
+        *status=U_ILLEGAL_ARGUMENT_ERROR;
+        return;
+    }
+    const RuleBasedCollator *rbc = RuleBasedCollator::rbcFromUCollator(coll);
+    if(rbc==NULL) {
+        *status=U_UNSUPPORTED_ERROR;
+        return;
+    }
+    rbc->sortStrings(strings, lengths, count, permutation,
+                     maxTasks, runner, runnerContext, *status);
+}
+
+U_CAPI void U_EXPORT2
+ucol_sortStringsUTF8(const UCollator *coll,
+                     const char *const *strings, const int32_t *lengths, int32_t count,
+                     int32_t *permutation,
+                     int32_t maxTasks, UTaskRunner runner, const void *runnerContext,
+                     UErrorCode *status)
+{
+    if(status==NULL || U_FAILURE(*status)) {
+        return;
+    }
+    if(coll==NULL) {
+        *status=U_ILLEGAL_ARGUMENT_ERROR;
+        return;
+    }
+    const RuleBasedCollator *rbc = RuleBasedCollator::rbcFromUCollator(coll);
+    if(rbc==NULL) {
+        *status=U_UNSUPPORTED_ERROR;
+        return;
+    }
+    rbc->sortStringsUTF8(strings, lengths, count, permutation,
+                         maxTasks, runner, runnerContext, *status);
+}
+
 U_CAPI int32_t U_EXPORT2
 ucol_nextSortKeyPart(const UCollator *coll,
                      UCharIterator *iter,
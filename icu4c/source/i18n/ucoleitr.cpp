@@ -323,6 +323,19 @@ ucol_next(UCollationElements *elems,
     return CollationElementIterator::fromUCollationElements(elems)->next(*status);
 }
 
+U_CAPI int32_t U_EXPORT2
+ucol_nextCEs(UCollationElements *elems,
+             int64_t *ces, int32_t *offsets, int32_t capacity,
+             UErrorCode *status)
+{
+    if (U_FAILURE(*status)) {
+        return 0;
+    }
+
+    return CollationElementIterator::fromUCollationElements(elems)->nextCEs(
+        ces, offsets, capacity, *status);
+}
+
 U_NAMESPACE_BEGIN
 
 int64_t
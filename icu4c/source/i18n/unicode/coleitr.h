@@ -191,6 +191,33 @@ class U_I18N_API CollationElementIterator U_FINAL : public UObject {
     */
     int32_t previous(UErrorCode& status);
 
+#ifndef U_HIDE_DRAFT_API
+    /**
+    * Fetches the next collation elements in the string into a caller-provided array,
+    * as native 64-bit CEs rather than as pairs of 32-bit orders.
+    * A native CE has the primary weight in its upper 32 bits,
+    * followed by the 16-bit secondary weight and
+    * the 16-bit tertiary weight (including the case bits).
+    * Completely ignorable CEs are returned as 0.
+    *
+    * This continues forward iteration like next():
+    * If next() has returned only the first half of a 64-bit CE,
+    * then the rest of that CE is skipped.
+    * It sets U_INVALID_STATE_ERROR after previous() without an intervening
+    * reset() or setOffset().
+    *
+    * @param ces the array to be filled with CEs
+    * @param offsets if not NULL, then offsets[i] receives the string offset after ces[i],
+    *                that is, the value that getOffset() would return after next()
+    * @param capacity the number of elements available at ces (and offsets), must be >=0
+    * @param status the error code status
+    * @return the number of CEs written; less than capacity only
+    *         if the end of the string has been reached
+    * @draft ICU 69
+    */
+    int32_t nextCEs(int64_t *ces, int32_t *offsets, int32_t capacity, UErrorCode &status);
+#endif  // U_HIDE_DRAFT_API
+
     /**
     * Gets the primary order of a collation order.
     * @param order the collation order
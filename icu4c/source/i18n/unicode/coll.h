@@ -58,6 +58,7 @@
 
 #if !UCONFIG_NO_COLLATION
 
+#include "unicode/bytestream.h"
 #include "unicode/uobject.h"
 #include "unicode/ucol.h"
 #include "unicode/unorm.h"
@@ -1041,6 +1042,33 @@ class U_I18N_API Collator : public UObject {
     virtual int32_t getSortKey(const char16_t*source, int32_t sourceLength,
                                uint8_t*result, int32_t resultLength) const = 0;
 
+#ifndef U_FORCE_HIDE_DRAFT_API
+    /**
+     * Writes the sort key for a UTF-8 string to a ByteSink.
+     * The key is the same as for the equivalent UTF-16 string,
+     * including its terminating zero byte.
+     * Ill-formed UTF-8 sequences sort like U+FFFD.
+     *
+     * The base class implementation converts the string to UTF-16
+     * and calls getSortKey(). RuleBasedCollator overrides it
+     * and collates the UTF-8 text directly.
+     *
+     * @param source UTF-8 string.
+     *        Note that a StringPiece can be implicitly constructed
+     *        from a std::string or a NUL-terminated const char * string.
+     * @param sink ByteSink to which the sort key is appended.
+     *        sink.Flush() is called at the end.
+     * @param errorCode Standard ICU error code. Its input value must
+     *        pass the U_SUCCESS() test, or else the function returns
+     *        immediately. Check for U_FAILURE() on output or use with
+     *        function chaining. (See User Guide for details.)
+     * @see ucol_getSortKeyUTF8
+     * @draft ICU 69
+     */
+    virtual void getSortKeyUTF8(StringPiece source, ByteSink &sink,
+                                UErrorCode &errorCode) const;
+#endif  // U_FORCE_HIDE_DRAFT_API
+
     /**
      * Produce a bound for a given sortkey and a number of levels.
      * Return value is always the number of bytes needed, regardless of
@@ -615,6 +615,10 @@ class U_I18N_API RegexPattern U_FINAL : public UObject {
     int32_t         fStartType;    // Info on how a match must start.
     int32_t         fInitialStringIdx;     //
     int32_t         fInitialStringLen;
+    int32_t         fRequiredStringIdx;    // A literal string that is part of every match,
+    int32_t         fRequiredStringLen;    //   or length 0 if there is none.
+    int32_t         fRequiredStringMaxOffset;  // Max distance from match start to the
+                                           //   required string, INT32_MAX if unbounded.
     UnicodeSet     *fInitialChars;
     UChar32         fInitialChar;
     Regex8BitSet   *fInitialChars8;
@@ -1787,6 +1791,8 @@ class U_I18N_API RegexMatcher U_FINAL : public UObject {
     int64_t              appendGroup(int32_t groupNum, UText *dest, UErrorCode &status) const;
     
     UBool                findUsingChunk(UErrorCode &status);
+    UBool                skipToRequiredString(int64_t &pos, int64_t &requiredPos);
+    UBool                skipToRequiredStringInChunk(int32_t &pos, int32_t &requiredPos);
     void                 MatchChunkAt(int32_t startIdx, UBool toEnd, UErrorCode &status);
     UBool                isChunkWordBoundary(int32_t pos);
 
@@ -68,6 +68,7 @@
 
 #if !UCONFIG_NO_COLLATION
 
+#include "unicode/bytestream.h"
 #include "unicode/coll.h"
 #include "unicode/locid.h"
 #include "unicode/uiter.h"
@@ -655,6 +656,154 @@ class U_I18N_API RuleBasedCollator U_FINAL : public Collator {
     virtual int32_t getSortKey(const char16_t *source, int32_t sourceLength,
                                uint8_t *result, int32_t resultLength) const;
 
+#ifndef U_FORCE_HIDE_DRAFT_API
+    /**
+     * Writes the sort key for a UTF-8 string to a ByteSink.
+     * The UTF-8 text is collated directly, without conversion to UTF-16
+     * (except for the identical level, if the strength is UCOL_IDENTICAL).
+     * The key is the same as for the equivalent UTF-16 string,
+     * including its terminating zero byte.
+     * Ill-formed UTF-8 sequences sort like U+FFFD.
+     *
+     * @param source UTF-8 string.
+     *        Note that a StringPiece can be implicitly constructed
+     *        from a std::string or a NUL-terminated const char * string.
+     * @param sink ByteSink to which the sort key is appended.
+     *        sink.Flush() is called at the end.
+     * @param errorCode Standard ICU error code. Its input value must
+     *        pass the U_SUCCESS() test, or else the function returns
+     *        immediately. Check for U_FAILURE() on output or use with
+     *        function chaining. (See User Guide for details.)
+     * @see ucol_getSortKeyUTF8
+     * @draft ICU 69
+     */
+    virtual void getSortKeyUTF8(StringPiece source, ByteSink &sink,
+                                UErrorCode &errorCode) const;
+#endif  // U_FORCE_HIDE_DRAFT_API
+
+#ifndef U_HIDE_DRAFT_API
+    /**
+     * Writes the sort keys for a batch of UTF-16 strings to one ByteSink,
+     * one after another, and records where each one starts.
+     * This is faster than calling getSortKey() for each string:
+     * The collation iterators and the key buffer are reused from one string to the next,
+     * and there is no preflighting.
+     *
+     * Each sort key is written with its terminating zero byte, as with getSortKey().
+     * The sink can be a growable arena, for example a StringByteSink,
+     * or a CheckedArrayByteSink.
+     * sink.Flush() is called at the end.
+     *
+     * @param strings array of count pointers to UTF-16 strings
+     * @param lengths array of count string lengths, where -1 means NUL-terminated;
+     *        if nullptr, then all of the strings are NUL-terminated
+     * @param count number of strings, must be >=0
+     * @param sink ByteSink to which the sort keys are appended
+     * @param offsets array of count+1 offsets to be filled:
+     *        The sort key for strings[i] is written at offsets[i]
+     *        up to offsets[i+1] (exclusive, including the zero byte),
+     *        counted from the first byte appended in this call.
+     *        offsets[0]=0, and offsets[count] is the total number of bytes.
+     * @param errorCode Standard ICU error code. Its input value must
+     *        pass the U_SUCCESS() test, or else the function returns
+     *        immediately. Check for U_FAILURE() on output or use with
+     *        function chaining. (See User Guide for details.)
+     * @see ucol_getSortKeys
+     * @draft ICU 69
+     */
+    void getSortKeys(const char16_t *const strings[], const int32_t lengths[], int32_t count,
+                     ByteSink &sink, int32_t offsets[], UErrorCode &errorCode) const;
+
+    /**
+     * Writes the sort keys for a batch of UTF-8 strings to one ByteSink,
+     * one after another, and records where each one starts.
+     * Same as getSortKeys() except for the input encoding.
+     * The keys are the same as for the equivalent UTF-16 strings.
+     * Ill-formed UTF-8 sequences sort like U+FFFD.
+     *
+     * @param strings array of count pointers to UTF-8 strings
+     * @param lengths array of count string lengths, where -1 means NUL-terminated;
+     *        if nullptr, then all of the strings are NUL-terminated
+     * @param count number of strings, must be >=0
+     * @param sink ByteSink to which the sort keys are appended
+     * @param offsets array of count+1 offsets to be filled, see getSortKeys()
+     * @param errorCode Standard ICU error code. Its input value must
+     *        pass the U_SUCCESS() test, or else the function returns
+     *        immediately. Check for U_FAILURE() on output or use with
+     *        function chaining. (See User Guide for details.)
+     * @see ucol_getSortKeysUTF8
+     * @draft ICU 69
+     */
+    void getSortKeysUTF8(const char *const strings[], const int32_t lengths[], int32_t count,
+                         ByteSink &sink, int32_t offsets[], UErrorCode &errorCode) const;
+
+    /**
+     * Sorts a batch of UTF-16 strings according to this collator.
+     * The strings themselves are not moved; instead, the sorted order is
+     * returned as a permutation of their indexes.
+     * The sort is stable: Strings that compare equal remain in their input order.
+     *
+     * A small batch is sorted by comparing strings.
+     * For a larger one, this generates the sort keys and sorts them
+     * with a most-significant-byte-first radix sort, which avoids
+     * collating each string again for each of its roughly log(count) comparisons,
+     * unless the sort keys of a sample of the strings are long enough
+     * that comparing the strings is expected to be faster.
+     * Both the key generation and the radix sort of large batches
+     * can be split into independent tasks for a caller-supplied runner.
+     * ICU does not create threads itself.
+     * If runner is nullptr, then all of the work is done on the calling thread.
+     *
+     * @param strings array of count pointers to UTF-16 strings
+     * @param lengths array of count string lengths, where -1 means NUL-terminated;
+     *        if nullptr, then all of the strings are NUL-terminated
+     * @param count number of strings, must be >=0
+     * @param permutation array of count indexes to be filled:
+     *        strings[permutation[0]] sorts first,
+     *        strings[permutation[count-1]] sorts last
+     * @param maxTasks maximum number of tasks to be run in parallel,
+     *        typically the number of available threads
+     * @param runner caller-supplied function that runs the tasks; can be nullptr
+     * @param runnerContext passed into runner
+     * @param errorCode Standard ICU error code. Its input value must
+     *        pass the U_SUCCESS() test, or else the function returns
+     *        immediately. Check for U_FAILURE() on output or use with
+     *        function chaining. (See User Guide for details.)
+     * @see ucol_sortStrings
+     * @draft ICU 69
+     */
+    void sortStrings(const char16_t *const strings[], const int32_t lengths[], int32_t count,
+                     int32_t permutation[],
+                     int32_t maxTasks, UTaskRunner runner, const void *runnerContext,
+                     UErrorCode &errorCode) const;
+
+    /**
+     * Sorts a batch of UTF-8 strings according to this collator.
+     * Same as sortStrings() except for the input encoding.
+     * Ill-formed UTF-8 sequences sort like U+FFFD.
+     *
+     * @param strings array of count pointers to UTF-8 strings
+     * @param lengths array of count string lengths, where -1 means NUL-terminated;
+     *        if nullptr, then all of the strings are NUL-terminated
+     * @param count number of strings, must be >=0
+     * @param permutation array of count indexes to be filled, see sortStrings()
+     * @param maxTasks maximum number of tasks to be run in parallel,
+     *        typically the number of available threads
+     * @param runner caller-supplied function that runs the tasks; can be nullptr
+     * @param runnerContext passed into runner
+     * @param errorCode Standard ICU error code. Its input value must
+     *        pass the U_SUCCESS() test, or else the function returns
+     *        immediately. Check for U_FAILURE() on output or use with
+     *        function chaining. (See User Guide for details.)
+     * @see ucol_sortStringsUTF8
+     * @draft ICU 69
+     */
+    void sortStringsUTF8(const char *const strings[], const int32_t lengths[], int32_t count,
+                         int32_t permutation[],
+                         int32_t maxTasks, UTaskRunner runner, const void *runnerContext,
+                         UErrorCode &errorCode) const;
+#endif  // U_HIDE_DRAFT_API
+
     /**
      * Retrieves the reordering codes for this collator.
      * @param dest The array to fill with the script ordering.
@@ -796,6 +945,39 @@ class U_I18N_API RuleBasedCollator U_FINAL : public Collator {
      * @internal for tests & tools
      */
     void internalGetCEs(const UnicodeString &str, UVector64 &ces, UErrorCode &errorCode) const;
+
+    /**
+     * Implements ucol_getSortKeyUTF8() without an intermediate buffer.
+     * Like getSortKey(), this writes as much of the key as fits
+     * and returns the length of the whole key.
+     * @internal
+     */
+    int32_t internalGetSortKeyUTF8(const char *s, int32_t length,
+                                   uint8_t *dest, int32_t capacity, UErrorCode &errorCode) const;
+
+    /**
+     * Implements getSortKeys() and ucol_getSortKeys().
+     * If capacity>=0, then this stops before the first sort key
+     * that would make the output longer than capacity bytes,
+     * sets U_BUFFER_OVERFLOW_ERROR, and sets *pRequiredCapacity (if not NULL)
+     * to the capacity needed for writing that key as well.
+     * @return the number of strings whose sort keys were written
+     * @internal
+     */
+    int32_t internalGetSortKeys(const char16_t *const strings[], const int32_t lengths[],
+                                int32_t count, ByteSink &sink, int32_t capacity,
+                                int32_t offsets[], int32_t *pRequiredCapacity,
+                                UErrorCode &errorCode) const;
+
+    /**
+     * Implements getSortKeysUTF8() and ucol_getSortKeysUTF8().
+     * @see internalGetSortKeys
+     * @internal
+     */
+    int32_t internalGetSortKeysUTF8(const char *const strings[], const int32_t lengths[],
+                                    int32_t count, ByteSink &sink, int32_t capacity,
+                                    int32_t offsets[], int32_t *pRequiredCapacity,
+                                    UErrorCode &errorCode) const;
 #endif  // U_HIDE_INTERNAL_API
 
 protected:
@@ -837,9 +1019,15 @@ class U_I18N_API RuleBasedCollator U_FINAL : public Collator {
     void writeSortKey(const char16_t *s, int32_t length,
                       SortKeyByteSink &sink, UErrorCode &errorCode) const;
 
+    void writeSortKeyUTF8(const uint8_t *s, int32_t length,
+                          SortKeyByteSink &sink, UErrorCode &errorCode) const;
+
     void writeIdenticalLevel(const char16_t *s, const char16_t *limit,
                              SortKeyByteSink &sink, UErrorCode &errorCode) const;
 
+    void writeIdenticalLevelUTF8(const char *s, int32_t length,
+                                 SortKeyByteSink &sink, UErrorCode &errorCode) const;
+
     const CollationSettings &getDefaultSettings() const;
 
     void setAttributeDefault(int32_t attribute) {
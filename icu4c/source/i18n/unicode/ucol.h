@@ -19,6 +19,7 @@
 #include "unicode/uloc.h"
 #include "unicode/uset.h"
 #include "unicode/uscript.h"
+#include "unicode/utask.h"
 
 #if U_SHOW_CPLUSPLUS_API
 #include "unicode/localpointer.h"
@@ -1024,6 +1025,192 @@ ucol_getSortKey(const    UCollator    *coll,
         uint8_t        *result,
         int32_t        resultLength);
 
+#ifndef U_HIDE_DRAFT_API
+/**
+ * Get a sort key for a UTF-8 string from a UCollator.
+ * The UTF-8 text is collated directly, without conversion to UTF-16
+ * (except for the identical level, if the strength is UCOL_IDENTICAL).
+ * The key is the same as ucol_getSortKey() returns for the equivalent UTF-16 string,
+ * including its terminating zero byte.
+ * Ill-formed UTF-8 sequences sort like U+FFFD.
+ *
+ * @param coll The UCollator containing the collation rules.
+ * @param source The UTF-8 string to transform.
+ * @param sourceLength The length of source, or -1 if null-terminated.
+ * @param result A pointer to a buffer to receive the sort key.
+ * @param resultLength The maximum size of result.
+ * @param status A pointer to a standard ICU error code. Its input value must
+ *        pass the U_SUCCESS() test, or else the function returns
+ *        immediately. Check for U_FAILURE() on output or use with
+ *        function chaining. (See User Guide for details.)
+ * @return The size needed to fully store the sort key.
+ *      If there was an internal error generating the sort key,
+ *      a zero value is returned.
+ *      If the size is greater than resultLength, then the contents of result is
+ *      undefined, and *status is set to U_BUFFER_OVERFLOW_ERROR (preflighting).
+ * @see ucol_getSortKey
+ * @draft ICU 69
+ */
+U_CAPI int32_t U_EXPORT2
+ucol_getSortKeyUTF8(const UCollator *coll,
+                    const char *source, int32_t sourceLength,
+                    uint8_t *result, int32_t resultLength,
+                    UErrorCode *status);
+
+/**
+ * Writes the sort keys for a batch of strings into one buffer,
+ * one after another, and records where each one starts.
+ * This is faster than calling ucol_getSortKey() for each string:
+ * The collation iterators and the key buffer are reused from one string to the next,
+ * and there is no preflighting.
+ *
+ * Each sort key is written with its terminating zero byte, as with ucol_getSortKey().
+ * The function writes the keys for as many strings as fit completely
+ * into the buffer, and returns their number n.
+ * If n<count, then it sets U_BUFFER_OVERFLOW_ERROR and
+ * *pRequiredCapacity=offsets[n] plus the length of the sort key for strings[n].
+ * The caller can then reset the error code, enlarge the buffer
+ * (keeping the first offsets[n] bytes) to at least *pRequiredCapacity,
+ * and call the function again for the remaining strings, writing to dest+offsets[n].
+ * The buffer contents from offsets[n] on is undefined.
+ * Only the key that did not fit is generated twice; there is no other preflighting.
+ *
+ * @param coll The UCollator containing the collation rules.
+ * @param strings Array of count pointers to the strings.
+ * @param lengths Array of count string lengths, where -1 means NUL-terminated;
+ *        if NULL, then all of the strings are NUL-terminated.
+ * @param count The number of strings, must be >=0.
+ * @param dest A pointer to the buffer for the sort keys.
+ * @param destCapacity The size of the buffer.
+ * @param offsets Array of at least count+1 offsets:
+ *        The sort key for strings[i] is written to dest+offsets[i]
+ *        up to dest+offsets[i+1] (exclusive, including the zero byte), for i<n.
+ *        offsets[0]=0, and offsets[n] is the total number of bytes written.
+ * @param pRequiredCapacity If not NULL, receives the buffer capacity needed
+ *        for writing one more key than were written: offsets[n] if n==count,
+ *        otherwise offsets[n] plus the length of the sort key for strings[n].
+ * @param status A pointer to a standard ICU error code. Its input value must
+ *        pass the U_SUCCESS() test, or else the function returns
+ *        immediately. Check for U_FAILURE() on output or use with
+ *        function chaining. (See User Guide for details.)
+ *        Set to U_BUFFER_OVERFLOW_ERROR if n<count because the buffer is too small.
+ * @return The number n of strings whose sort keys were written, 0..count.
+ * @see ucol_getSortKey
+ * @draft ICU 69
+ */
+U_CAPI int32_t U_EXPORT2
+ucol_getSortKeys(const UCollator *coll,
+                 const UChar *const *strings, const int32_t *lengths, int32_t count,
+                 uint8_t *dest, int32_t destCapacity,
+                 int32_t *offsets, int32_t *pRequiredCapacity, UErrorCode *status);
+
+/**
+ * Writes the sort keys for a batch of UTF-8 strings into one buffer,
+ * one after another, and records where each one starts.
+ * Same as ucol_getSortKeys() except for the input encoding.
+ * The keys are the same as for the equivalent UTF-16 strings.
+ * Ill-formed UTF-8 sequences sort like U+FFFD.
+ *
+ * @param coll The UCollator containing the collation rules.
+ * @param strings Array of count pointers to the UTF-8 strings.
+ * @param lengths Array of count string lengths, where -1 means NUL-terminated;
+ *        if NULL, then all of the strings are NUL-terminated.
+ * @param count The number of strings, must be >=0.
+ * @param dest A pointer to the buffer for the sort keys.
+ * @param destCapacity The size of the buffer.
+ * @param offsets Array of at least count+1 offsets, see ucol_getSortKeys().
+ * @param pRequiredCapacity If not NULL, receives the buffer capacity needed
+ *        for writing one more key, see ucol_getSortKeys().
+ * @param status A pointer to a standard ICU error code. Its input value must
+ *        pass the U_SUCCESS() test, or else the function returns
+ *        immediately. Check for U_FAILURE() on output or use with
+ *        function chaining. (See User Guide for details.)
+ *        Set to U_BUFFER_OVERFLOW_ERROR if n<count because the buffer is too small.
+ * @return The number n of strings whose sort keys were written, 0..count.
+ * @see ucol_getSortKeys
+ * @draft ICU 69
+ */
+U_CAPI int32_t U_EXPORT2
+ucol_getSortKeysUTF8(const UCollator *coll,
+                     const char *const *strings, const int32_t *lengths, int32_t count,
+                     uint8_t *dest, int32_t destCapacity,
+                     int32_t *offsets, int32_t *pRequiredCapacity, UErrorCode *status);
+
+/**
+ * Sorts a batch of strings according to the collator.
+ * The strings themselves are not moved; instead, the sorted order is
+ * returned as a permutation of their indexes.
+ * The sort is stable: Strings that compare equal remain in their input order.
+ *
+ * A small batch is sorted by comparing strings.
+ * For a larger one, this generates the sort keys and sorts them
+ * with a most-significant-byte-first radix sort, which avoids
+ * collating each string again for each of its roughly log(count) comparisons,
+ * unless the sort keys of a sample of the strings are long enough
+ * that comparing the strings is expected to be faster.
+ * Both the key generation and the radix sort of large batches
+ * can be split into independent tasks for a caller-supplied runner.
+ * ICU does not create threads itself.
+ * If runner is NULL, then all of the work is done on the calling thread.
+ *
+ * @param coll The UCollator containing the collation rules.
+ *        It must be a RuleBasedCollator, otherwise U_UNSUPPORTED_ERROR is set.
+ * @param strings Array of count pointers to the strings.
+ * @param lengths Array of count string lengths, where -1 means NUL-terminated;
+ *        if NULL, then all of the strings are NUL-terminated.
+ * @param count The number of strings, must be >=0.
+ * @param permutation Array of count indexes to be filled:
+ *        strings[permutation[0]] sorts first,
+ *        strings[permutation[count-1]] sorts last.
+ * @param maxTasks The maximum number of tasks to be run in parallel,
+ *        typically the number of available threads.
+ * @param runner Caller-supplied function that runs the tasks; can be NULL.
+ * @param runnerContext Passed into runner.
+ * @param status A pointer to a standard ICU error code. Its input value must
+ *        pass the U_SUCCESS() test, or else the function returns
+ *        immediately. Check for U_FAILURE() on output or use with
+ *        function chaining. (See User Guide for details.)
+ * @see ucol_strcoll
+ * @draft ICU 69
+ */
+U_CAPI void U_EXPORT2
+ucol_sortStrings(const UCollator *coll,
+                 const UChar *const *strings, const int32_t *lengths, int32_t count,
+                 int32_t *permutation,
+                 int32_t maxTasks, UTaskRunner runner, const void *runnerContext,
+                 UErrorCode *status);
+
+/**
+ * Sorts a batch of UTF-8 strings according to the collator.
+ * Same as ucol_sortStrings() except for the input encoding.
+ * Ill-formed UTF-8 sequences sort like U+FFFD.
+ *
+ * @param coll The UCollator containing the collation rules.
+ *        It must be a RuleBasedCollator, otherwise U_UNSUPPORTED_ERROR is set.
+ * @param strings Array of count pointers to the UTF-8 strings.
+ * @param lengths Array of count string lengths, where -1 means NUL-terminated;
+ *        if NULL, then all of the strings are NUL-terminated.
+ * @param count The number of strings, must be >=0.
+ * @param permutation Array of count indexes to be filled, see ucol_sortStrings().
+ * @param maxTasks The maximum number of tasks to be run in parallel,
+ *        typically the number of available threads.
+ * @param runner Caller-supplied function that runs the tasks; can be NULL.
+ * @param runnerContext Passed into runner.
+ * @param status A pointer to a standard ICU error code. Its input value must
+ *        pass the U_SUCCESS() test, or else the function returns
+ *        immediately. Check for U_FAILURE() on output or use with
+ *        function chaining. (See User Guide for details.)
+ * @see ucol_sortStrings
+ * @draft ICU 69
+ */
+U_CAPI void U_EXPORT2
+ucol_sortStringsUTF8(const UCollator *coll,
+                     const char *const *strings, const int32_t *lengths, int32_t count,
+                     int32_t *permutation,
+                     int32_t maxTasks, UTaskRunner runner, const void *runnerContext,
+                     UErrorCode *status);
+#endif  /* U_HIDE_DRAFT_API */
+
 
 /** Gets the next count bytes of a sort key. Caller needs
  *  to preserve state array between calls and to provide
@@ -178,6 +178,36 @@ ucol_next(UCollationElements *elems, UErrorCode *status);
 U_CAPI int32_t U_EXPORT2 
 ucol_previous(UCollationElements *elems, UErrorCode *status);
 
+#ifndef U_HIDE_DRAFT_API
+/**
+ * Fetch the next collation elements in the text into a caller-provided array,
+ * as native 64-bit CEs rather than as pairs of 32-bit orders.
+ * A native CE has the primary weight in its upper 32 bits,
+ * followed by the 16-bit secondary weight and
+ * the 16-bit tertiary weight (including the case bits).
+ * Completely ignorable CEs are returned as 0.
+ *
+ * This continues forward iteration like ucol_next().
+ * If ucol_next() has returned only the first half of a 64-bit CE,
+ * then the rest of that CE is skipped.
+ * @param elems The UCollationElements containing the text.
+ * @param ces The array to be filled with CEs.
+ * @param offsets If not NULL, then offsets[i] receives the text offset after ces[i],
+ *                that is, the value that ucol_getOffset() would return after ucol_next().
+ * @param capacity The number of elements available at ces (and offsets), must be >=0.
+ * @param status A pointer to a UErrorCode to receive any errors.
+ *               U_INVALID_STATE_ERROR after ucol_previous() without an intervening
+ *               ucol_reset() or ucol_setOffset().
+ * @return The number of CEs written; less than capacity only
+ *         if the end of the text has been reached.
+ * @draft ICU 69
+ */
+U_CAPI int32_t U_EXPORT2
+ucol_nextCEs(UCollationElements *elems,
+             int64_t *ces, int32_t *offsets, int32_t capacity,
+             UErrorCode *status);
+#endif  /* U_HIDE_DRAFT_API */
+
 /**
  * Get the maximum length of any expansion sequences that end with the 
  * specified comparison order.
@@ -130,6 +130,60 @@ U_NAMESPACE_END
 U_CAPI void U_EXPORT2
 ucsdet_setText(UCharsetDetector *ucsd, const char *textIn, int32_t len, UErrorCode *status);
 
+#ifndef U_HIDE_DRAFT_API
+/**
+  * Append the next chunk of input byte data whose charset is to be detected.
+  *
+  * This allows detection over input that arrives in pieces, such as from a
+  * file or a network connection, without first collecting all of it in one buffer.
+  * The first call after the detector is opened, or after ucsdet_setText(),
+  * starts a new stream of input; each later call continues it.
+  * Call ucsdet_setText() to discard the streamed input and start over.
+  *
+  * Each chunk is examined during this call, and the detector does not
+  * keep a reference to it; the caller may reuse the buffer afterwards.
+  * The detector keeps a bounded sample of the start of the input,
+  * plus a small amount of per-charset state, regardless of the total length.
+  * Detection results for streamed input are the same as for the
+  * concatenated input passed to ucsdet_setText().
+  * Functions that return text from a match, such as ucsdet_getUChars(),
+  * only see the retained sample in this mode.
+  *
+  * @param ucsd   the charset detector to be used.
+  * @param textIn the next chunk of input text of unknown encoding.
+  * @param len    the length of the chunk, or -1 if it is NUL terminated.
+  * @param status any error conditions are reported back in this variable.
+  * @return FALSE if the best match has reached the confidence set with
+  *         ucsdet_setStopConfidence(), so that more input is not needed;
+  *         otherwise TRUE.
+  *
+  * @see ucsdet_setStopConfidence
+  * @draft ICU 69
+  */
+U_CAPI UBool U_EXPORT2
+ucsdet_appendText(UCharsetDetector *ucsd, const char *textIn, int32_t len, UErrorCode *status);
+
+/**
+  * Set the confidence at which detection over streamed input may stop early.
+  *
+  * While input is appended with ucsdet_appendText(), the detector
+  * periodically checks the best match. Once its confidence is at least the
+  * given value, ucsdet_appendText() returns FALSE and ignores further input
+  * until ucsdet_setText() is called.
+  *
+  * @param ucsd       the charset detector to be used.
+  * @param confidence the stop confidence, 1..100, or 0 (the default)
+  *                   to always examine all of the input.
+  * @param status     any error conditions are reported back in this variable.
+  *                   U_ILLEGAL_ARGUMENT_ERROR if confidence is out of range.
+  *
+  * @see ucsdet_appendText
+  * @draft ICU 69
+  */
+U_CAPI void U_EXPORT2
+ucsdet_setStopConfidence(UCharsetDetector *ucsd, int32_t confidence, UErrorCode *status);
+#endif  /* U_HIDE_DRAFT_API */
+
 
 /** Set the declared encoding for charset detection.
  *  The declared encoding of an input text is an encoding obtained
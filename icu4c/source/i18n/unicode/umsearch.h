@@ -0,0 +1,171 @@
+// © 2016 and later: Unicode, Inc. and others.
+// License & terms of use: http://www.unicode.org/copyright.html
+
+// umsearch.h
+// created: 2021jan25
+
+#ifndef UMSEARCH_H
+#define UMSEARCH_H
+
+#include "unicode/utypes.h"
+
+#if !UCONFIG_NO_COLLATION && !UCONFIG_NO_BREAK_ITERATION
+
+#include "unicode/ucol.h"
+#include "unicode/ubrk.h"
+
+#if U_SHOW_CPLUSPLUS_API
+#include "unicode/localpointer.h"
+#endif   // U_SHOW_CPLUSPLUS_API
+
+/**
+ * \file
+ * \brief C API: Language-sensitive search for multiple patterns at once
+ *
+ * A UMultiStringSearch finds all occurrences of any of a set of patterns in a text,
+ * with the same language-sensitive matching as a UStringSearch:
+ * The patterns are compiled at the strength of the collator into an automaton
+ * over collation elements, and the text is scanned once for all of them,
+ * rather than once per pattern.
+ *
+ * Matches in collation element space are validated exactly as by usearch_search():
+ * A match must not start or end inside a combining sequence or in the middle of
+ * a character that expands to several collation elements, and its bounds must be
+ * boundaries of the break iterator if there is one.
+ * All matches are reported, including overlapping ones, so for each pattern
+ * the matches are those that a UStringSearch for that pattern alone would find
+ * with USEARCH_OVERLAP turned on.
+ *
+ * Only the standard element comparison is supported,
+ * see USEARCH_ELEMENT_COMPARISON in usearch.h.
+ *
+ * \code
+ * const UChar *patterns[] = { u"apple", u"pear", u"plum" };
+ * UMultiStringSearch *ms = umsearch_open(patterns, NULL, 3, text, -1,
+ *                                        collator, NULL, &errorCode);
+ * int32_t patternIndex, start, limit;
+ * while (umsearch_next(ms, &patternIndex, &start, &limit, &errorCode)) {
+ *     // patterns[patternIndex] matches text[start..limit[
+ * }
+ * umsearch_close(ms);
+ * \endcode
+ *
+ * @see usearch_openFromCollator
+ */
+
+#ifndef U_HIDE_DRAFT_API
+
+/**
+ * Opaque type for a search for multiple patterns.
+ * @see umsearch_open
+ * @draft ICU 69
+ */
+struct UMultiStringSearch;
+/** @draft ICU 69 */
+typedef struct UMultiStringSearch UMultiStringSearch;
+
+/**
+ * Creates a search for multiple patterns, using the collator's rules and strength.
+ * The collator is used only while opening the search, and is not adopted.
+ * The patterns are copied.
+ *
+ * The UMultiStringSearch retains a pointer to the text.
+ * The caller must not modify or delete it while using the UMultiStringSearch.
+ *
+ * NOTE: As with UStringSearch, the collator must not have
+ * collate digits as numbers (UCOL_NUMERIC_COLLATION) turned on.
+ *
+ * @param patterns array of patternCount patterns
+ * @param patternLengths array of patternCount pattern lengths,
+ *                       where -1 stands for a NUL-terminated pattern;
+ *                       NULL if all of the patterns are NUL-terminated
+ * @param patternCount the number of patterns, must be >0
+ * @param text text string
+ * @param textlength length of the text string, -1 for null-termination
+ * @param collator used for the language rules
+ * @param breakiter A BreakIterator that will be used to restrict the points
+ *                  at which matches are detected, or NULL.
+ *                  It is retained but not adopted, see usearch_openFromCollator().
+ * @param status for errors if it occurs. If any argument is NULL where that
+ *               is not allowed, or if any pattern or the text is empty,
+ *               or if any pattern is completely ignorable at the collator's strength,
+ *               then U_ILLEGAL_ARGUMENT_ERROR is returned.
+ * @return the search data structure, or NULL if there is an error
+ * @draft ICU 69
+ */
+U_CAPI UMultiStringSearch * U_EXPORT2
+umsearch_open(const UChar *const *patterns, const int32_t *patternLengths, int32_t patternCount,
+              const UChar *text, int32_t textlength,
+              const UCollator *collator, UBreakIterator *breakiter,
+              UErrorCode *status);
+
+/**
+ * Destroys and cleans up the search data structure.
+ * @param msearch the UMultiStringSearch to clean up, can be NULL
+ * @draft ICU 69
+ */
+U_CAPI void U_EXPORT2
+umsearch_close(UMultiStringSearch *msearch);
+
+/**
+ * Sets the text to be searched, and resets the search to the start of the text.
+ * This can also be used to search the same text again.
+ * The UMultiStringSearch retains a pointer to the text.
+ * @param msearch the search data structure
+ * @param text the new text
+ * @param textlength length of the text, -1 for null-termination
+ * @param status for errors if it occurs. If the text is NULL or empty,
+ *               then U_ILLEGAL_ARGUMENT_ERROR is returned.
+ * @draft ICU 69
+ */
+U_CAPI void U_EXPORT2
+umsearch_setText(UMultiStringSearch *msearch, const UChar *text, int32_t textlength,
+                 UErrorCode *status);
+
+/**
+ * Finds the next match of any of the patterns.
+ *
+ * Matches are returned in the order in which they end in collation element space,
+ * which is nearly always the order of their limits in the text.
+ * Among matches that end with the same collation element,
+ * longer patterns are returned first. Identical patterns are returned
+ * in the order in which they were passed into umsearch_open().
+ *
+ * @param msearch the search data structure
+ * @param patternIndex receives the index of the matching pattern; can be NULL
+ * @param matchStart receives the start index of the match in the text; can be NULL
+ * @param matchLimit receives the index after the match in the text; can be NULL
+ * @param status for errors if it occurs. Note that no match found is not an error.
+ * @return TRUE if a match was found, FALSE at the end of the text.
+ *         When FALSE is returned, the out-parameters are set to -1.
+ * @draft ICU 69
+ */
+U_CAPI UBool U_EXPORT2
+umsearch_next(UMultiStringSearch *msearch,
+              int32_t *patternIndex, int32_t *matchStart, int32_t *matchLimit,
+              UErrorCode *status);
+
+#if U_SHOW_CPLUSPLUS_API
+
+U_NAMESPACE_BEGIN
+
+/**
+ * \class LocalUMultiStringSearchPointer
+ * "Smart pointer" class, closes a UMultiStringSearch via umsearch_close().
+ * For most methods see the LocalPointerBase base class.
+ *
+ * @see LocalPointerBase
+ * @see LocalPointer
+ * @draft ICU 69
+ */
+U_DEFINE_LOCAL_OPEN_POINTER(LocalUMultiStringSearchPointer, UMultiStringSearch, umsearch_close);
+
+U_NAMESPACE_END
+
+#endif  // U_SHOW_CPLUSPLUS_API
+
+#endif  // U_HIDE_DRAFT_API
+
+#endif  // !UCONFIG_NO_COLLATION && !UCONFIG_NO_BREAK_ITERATION
+
+#endif  // UMSEARCH_H
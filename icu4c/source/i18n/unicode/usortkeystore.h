@@ -0,0 +1,236 @@
+// © 2016 and later: Unicode, Inc. and others.
+// License & terms of use: http://www.unicode.org/copyright.html
+
+// usortkeystore.h
+// created: 2021jan18
+
+#ifndef USORTKEYSTORE_H
+#define USORTKEYSTORE_H
+
+#include "unicode/utypes.h"
+
+#if !UCONFIG_NO_COLLATION
+
+#include "unicode/ucol.h"
+
+#if U_SHOW_CPLUSPLUS_API
+#include "unicode/localpointer.h"
+#endif   // U_SHOW_CPLUSPLUS_API
+
+/**
+ * \file
+ * \brief C API: Compact, memory-mappable store of collation sort keys
+ *
+ * A USortKeyStore holds a sorted list of sort keys, as returned by ucol_getSortKey()
+ * or ucol_getSortKeys(), in a compact binary form which can be written to a file
+ * and later used directly from memory, for example from a memory-mapped file.
+ *
+ * The keys are front-coded: Each key after the first one in a block stores only
+ * the length of the prefix it shares with the previous key, and the remaining bytes.
+ * The first key of each block is stored in full, and a table of block offsets
+ * allows for a binary search over the blocks.
+ * Lookups compare the query key with the stored keys without reconstructing them.
+ *
+ * Keys are identified by their index in the sorted list.
+ * Typically, an application stores the sort keys for a sorted list of records
+ * and maps the indexes returned by the lookup functions to those records.
+ *
+ * The binary data is in the platform endianness and charset family
+ * and must be stored in 32-bit-aligned memory.
+ *
+ * \code
+ * // Find the records whose strings compare primary-equal to the query string.
+ * int32_t limit;
+ * int32_t start = usortkeystore_getBoundRange(store, queryKey, -1,
+ *                                             UCOL_BOUND_UPPER, 1, &limit, &errorCode);
+ * for (int32_t i = start; i < limit; ++i) {
+ *     // records[i] matches.
+ * }
+ * \endcode
+ *
+ * @see ucol_getSortKey
+ * @see ucol_getBound
+ */
+
+#ifndef U_HIDE_DRAFT_API
+
+/**
+ * Opaque type for an immutable store of sort keys.
+ * @see usortkeystore_openFromBinary
+ * @draft ICU 69
+ */
+struct USortKeyStore;
+/** @draft ICU 69 */
+typedef struct USortKeyStore USortKeyStore;
+
+/**
+ * Writes the binary form of a sort key store for an ascending list of sort keys.
+ * The keys are given in the layout written by ucol_getSortKeys():
+ * Key i is at keys+offsets[i] up to keys+offsets[i+1] (exclusive),
+ * including its terminating zero byte.
+ *
+ * The keys must be in ascending order as by strcmp(). Duplicates are allowed.
+ * Otherwise the function sets U_ILLEGAL_ARGUMENT_ERROR.
+ *
+ * @param keys the sort keys, one after another
+ * @param offsets array of count+1 offsets into keys
+ * @param count the number of keys, must be >=0
+ * @param blockSize the number of keys per block which share front coding;
+ *                  larger blocks are more compact but slower to search;
+ *                  0 selects the default (16), otherwise must be 1..1024
+ * @param data a pointer to 32-bit-aligned memory to be filled with the store data;
+ *             can be NULL if capacity==0
+ * @param capacity the number of bytes available at data, or 0 for pure preflighting
+ * @param pErrorCode an in/out ICU UErrorCode;
+ *                   U_BUFFER_OVERFLOW_ERROR if the capacity is too small
+ * @return the number of bytes written or (if buffer overflow) needed for the store
+ *
+ * @see usortkeystore_openFromBinary
+ * @see ucol_getSortKeys
+ * @draft ICU 69
+ */
+U_CAPI int32_t U_EXPORT2
+usortkeystore_build(const uint8_t *keys, const int32_t *offsets, int32_t count,
+                    int32_t blockSize,
+                    void *data, int32_t capacity, UErrorCode *pErrorCode);
+
+/**
+ * Opens a sort key store from its binary form, stored in 32-bit-aligned memory.
+ * The store aliases the data: The memory must remain valid and unchanged
+ * as long as the store is used.
+ * You must usortkeystore_close() the store once you are done using it.
+ *
+ * This function walks the whole key data once to check its structure,
+ * so that lookups in a store opened from corrupt data cannot read out of bounds.
+ *
+ * @param data a pointer to 32-bit-aligned memory containing the binary data
+ *             written by usortkeystore_build()
+ * @param length the number of bytes available at data;
+ *               can be more than necessary
+ * @param pActualLength receives the actual number of bytes at data taken up by the store;
+ *                      can be NULL
+ * @param pErrorCode an in/out ICU UErrorCode;
+ *                   U_INVALID_FORMAT_ERROR if the data is not a valid sort key store
+ * @return the store
+ *
+ * @see usortkeystore_build
+ * @draft ICU 69
+ */
+U_CAPI USortKeyStore * U_EXPORT2
+usortkeystore_openFromBinary(const void *data, int32_t length, int32_t *pActualLength,
+                             UErrorCode *pErrorCode);
+
+/**
+ * Closes a sort key store and releases associated memory.
+ * Does not release the binary data.
+ *
+ * @param store the store
+ * @draft ICU 69
+ */
+U_CAPI void U_EXPORT2
+usortkeystore_close(USortKeyStore *store);
+
+/**
+ * Returns the number of keys in the store.
+ *
+ * @param store the store
+ * @return the number of keys
+ * @draft ICU 69
+ */
+U_CAPI int32_t U_EXPORT2
+usortkeystore_getCount(const USortKeyStore *store);
+
+/**
+ * Reconstructs one of the stored sort keys, with its terminating zero byte.
+ *
+ * @param store the store
+ * @param index the key index, 0..count-1
+ * @param dest buffer for the key; can be NULL if capacity==0
+ * @param capacity the number of bytes available at dest, or 0 for pure preflighting
+ * @param pErrorCode an in/out ICU UErrorCode;
+ *                   U_BUFFER_OVERFLOW_ERROR if the capacity is too small
+ * @return the length of the key including its terminating zero byte
+ * @draft ICU 69
+ */
+U_CAPI int32_t U_EXPORT2
+usortkeystore_getKey(const USortKeyStore *store, int32_t index,
+                     uint8_t *dest, int32_t capacity, UErrorCode *pErrorCode);
+
+/**
+ * Returns the index of the first stored key which is greater than or equal to the given key,
+ * or the number of keys if there is none.
+ *
+ * @param store the store
+ * @param key a sort key or bound
+ * @param length the length of the key, or -1 if it is zero-terminated
+ * @param pErrorCode an in/out ICU UErrorCode
+ * @return the index of the first key >= key
+ * @draft ICU 69
+ */
+U_CAPI int32_t U_EXPORT2
+usortkeystore_lowerBound(const USortKeyStore *store, const uint8_t *key, int32_t length,
+                         UErrorCode *pErrorCode);
+
+/**
+ * Returns the index of the first stored key which is greater than the given key,
+ * or the number of keys if there is none.
+ *
+ * @param store the store
+ * @param key a sort key or bound
+ * @param length the length of the key, or -1 if it is zero-terminated
+ * @param pErrorCode an in/out ICU UErrorCode
+ * @return the index of the first key > key
+ * @draft ICU 69
+ */
+U_CAPI int32_t U_EXPORT2
+usortkeystore_upperBound(const USortKeyStore *store, const uint8_t *key, int32_t length,
+                         UErrorCode *pErrorCode);
+
+/**
+ * Finds the range of stored keys which fall between the lower bound and the upper bound
+ * that ucol_getBound() produces for the given sort key.
+ * For example, with noOfLevels=1 and UCOL_BOUND_UPPER, the range contains the keys
+ * whose strings are primary-equal to the string of the given key.
+ * With UCOL_BOUND_UPPER_LONG, it also contains the keys of strings
+ * which start with such a string.
+ *
+ * @param store the store
+ * @param key the sort key
+ * @param length the length of the key, or -1 if it is zero-terminated
+ * @param boundType UCOL_BOUND_UPPER or UCOL_BOUND_UPPER_LONG
+ * @param noOfLevels the number of levels to compare, see ucol_getBound()
+ * @param pLimit receives the index after the last key in the range
+ * @param pErrorCode an in/out ICU UErrorCode
+ * @return the index of the first key in the range; equal to *pLimit if the range is empty
+ * @see ucol_getBound
+ * @draft ICU 69
+ */
+U_CAPI int32_t U_EXPORT2
+usortkeystore_getBoundRange(const USortKeyStore *store, const uint8_t *key, int32_t length,
+                            UColBoundMode boundType, uint32_t noOfLevels,
+                            int32_t *pLimit, UErrorCode *pErrorCode);
+
+#if U_SHOW_CPLUSPLUS_API
+
+U_NAMESPACE_BEGIN
+
+/**
+ * \class LocalUSortKeyStorePointer
+ * "Smart pointer" class, closes a USortKeyStore via usortkeystore_close().
+ * For most methods see the LocalPointerBase base class.
+ *
+ * @see LocalPointerBase
+ * @see LocalPointer
+ * @draft ICU 69
+ */
+U_DEFINE_LOCAL_OPEN_POINTER(LocalUSortKeyStorePointer, USortKeyStore, usortkeystore_close);
+
+U_NAMESPACE_END
+
+#endif  // U_SHOW_CPLUSPLUS_API
+
+#endif  // U_HIDE_DRAFT_API
+
+#endif  // !UCONFIG_NO_COLLATION
+
+#endif  // USORTKEYSTORE_H
@@ -14,6 +14,7 @@
 #if !UCONFIG_NO_COLLATION && !UCONFIG_NO_BREAK_ITERATION
 
 #include "unicode/usearch.h"
+#include "unicode/umsearch.h"
 #include "unicode/ustring.h"
 #include "unicode/uchar.h"
 #include "unicode/utf16.h"
@@ -23,6 +24,9 @@
 #include "ucln_in.h"
 #include "uassert.h"
 #include "ustr_imp.h"
+#include "uarrsort.h"
+#include "uvectr32.h"
+#include "uvectr64.h"
 
 U_NAMESPACE_USE
 
@@ -95,6 +99,17 @@ inline int hashFromCE32(uint32_t ce)
     return hc;
 }
 
+/**
+* Getting the hash value of a processed collation element, see hashFromCE32().
+* @param pce 64-bit processed collation element
+* @return hash code
+*/
+static
+inline int hashFromPCE(int64_t pce)
+{
+    return hashFromCE32((uint32_t)(pce >> 32) ^ (uint32_t)pce);
+}
+
 U_CDECL_BEGIN
 static UBool U_CALLCONV
 usearch_cleanup(void) {
@@ -422,6 +437,20 @@ inline uint16_t initializePatternPCETable(UStringSearch *strsrch,
     pattern->pces       = pcetable;
     pattern->pcesLength = offset;
 
+    // Horspool shift table: For each pce, the distance from its last occurrence
+    // before the end of the pattern to the last pce, or the pattern length if none.
+    // Colliding pces share the smaller shift, which only costs extra candidates.
+    int16_t defaultShift = offset < INT16_MAX ? (int16_t)offset : INT16_MAX;
+    for (int32_t i = 0; i < MAX_TABLE_SIZE_; ++i) {
+        pattern->pceShift[i] = defaultShift;
+    }
+    for (uint32_t i = 0; i + 1 < offset; ++i) {
+        uint32_t shift = offset - 1 - i;
+        if (shift < (uint32_t)defaultShift) {
+            pattern->pceShift[hashFromPCE(pcetable[i])] = (int16_t)shift;
+        }
+    }
+
     return result;
 }
 
@@ -1065,15 +1094,19 @@ inline UBool isOutOfBounds(int32_t textlength, int32_t offset)
 }
 
 /**
-* Checks for identical match
+* Checks for identical match against the given pattern text
 * @param strsrch string search data
 * @param start offset of possible match
 * @param end offset of possible match
+* @param patText pattern text
+* @param patTextLength length of the pattern text
 * @return TRUE if identical match is found
 */
 static
 inline UBool checkIdentical(const UStringSearch *strsrch, int32_t start,
-                                  int32_t    end)
+                                  int32_t    end,
+                            const UChar     *patText,
+                                  int32_t    patTextLength)
 {
     if (strsrch->strength != UCOL_IDENTICAL) {
         return TRUE;
@@ -1086,11 +1119,26 @@ inline UBool checkIdentical(const UStringSearch *strsrch, int32_t start,
     strsrch->nfd->normalize(
         UnicodeString(FALSE, strsrch->search->text + start, end - start), t2, status);
     strsrch->nfd->normalize(
-        UnicodeString(FALSE, strsrch->pattern.text, strsrch->pattern.textLength), p2, status);
+        UnicodeString(FALSE, patText, patTextLength), p2, status);
     // return FALSE if NFD failed
     return U_SUCCESS(status) && t2 == p2;
 }
 
+/**
+* Checks for identical match
+* @param strsrch string search data
+* @param start offset of possible match
+* @param end offset of possible match
+* @return TRUE if identical match is found
+*/
+static
+inline UBool checkIdentical(const UStringSearch *strsrch, int32_t start,
+                                  int32_t    end)
+{
+    return checkIdentical(strsrch, start, end,
+                          strsrch->pattern.text, strsrch->pattern.textLength);
+}
+
 #if BOYER_MOORE
 /**
 * Checks to see if the match is repeated
@@ -3464,7 +3512,7 @@ namespace {
 #define   MAX_TARGET_IGNORABLES_PER_PAT_JAMO_L 8
 #define   MAX_TARGET_IGNORABLES_PER_PAT_OTHER 3
 #define   MIGHT_BE_JAMO_L(c) ((c >= 0x1100 && c <= 0x115E) || (c >= 0x3131 && c <= 0x314E) || (c >= 0x3165 && c <= 0x3186))
-struct CEIBuffer {
+struct CEIBuffer : public UMemory {
     CEI                  defBuf[DEFAULT_CEBUFFER_SIZE];
     CEI                 *buf;
     int32_t              bufSize;
@@ -3479,6 +3527,7 @@ struct CEIBuffer {
                ~CEIBuffer();
    const CEI   *get(int32_t index);
    const CEI   *getPrevious(int32_t index);
+   const CEI   *getAhead(int32_t index);
 };
 
 
@@ -3567,6 +3616,17 @@ const CEI *CEIBuffer::get(int32_t index) {
     return &buf[i];
 }
 
+// Get the CE with the specified index, fetching all of the CEs before it
+//   that have not been fetched yet.
+//   Index must be greater than n-history_size, see get().
+//
+const CEI *CEIBuffer::getAhead(int32_t index) {
+    while (limitIx < index) {
+        get(limitIx);
+    }
+    return get(index);
+}
+
 // Get the CE with the specified index.
 //   Index must be in the range
 //          n-history_size < index < n+1
@@ -3839,6 +3899,171 @@ UChar32 codePointBefore(const USearch &search, int32_t index) {
 
 }  // namespace
 
+/*
+ * Determines the bounds in string index space of a match found in CE space,
+ * from the target CE at targetIx up to but not including the one at targetIx+targetIxOffset.
+ * patCE is the last pattern CE.
+ * Returns FALSE if the CE range does not correspond to an acceptable character range.
+ */
+static UBool getMatchBounds(UStringSearch *strsrch, CEIBuffer &ceb,
+                            int32_t targetIx, int32_t targetIxOffset, int64_t patCE,
+                            int32_t *matchStart, int32_t *matchLimit) {
+    UBool      found = TRUE;
+    const CEI *firstCEI = ceb.get(targetIx);
+    int32_t    mStart;
+    int32_t    mLimit;
+    int32_t    minLimit;
+    int32_t    maxLimit;
+
+    // We have found a match in CE space.
+    // Now determine the bounds in string index space.
+    //  There still is a chance of match failure if the CE range not correspond to
+    //     an acceptable character range.
+    //
+    const CEI *lastCEI  = ceb.get(targetIx + targetIxOffset - 1);
+
+    mStart   = firstCEI->lowIndex;
+    minLimit = lastCEI->lowIndex;
+
+    // Look at the CE following the match.  If it is UCOL_NULLORDER the match
+    //   extended to the end of input, and the match is good.
+
+    // Look at the high and low indices of the CE following the match. If
+    // they are the same it means one of two things:
+    //    1. The match extended to the last CE from the target text, which is OK, or
+    //    2. The last CE that was part of the match is in an expansion that extends
+    //       to the first CE after the match. In this case, we reject the match.
+    const CEI *nextCEI = 0;
+    if (strsrch->search->elementComparisonType == 0) {
+        nextCEI  = ceb.get(targetIx + targetIxOffset);
+        maxLimit = nextCEI->lowIndex;
+        if (nextCEI->lowIndex == nextCEI->highIndex && nextCEI->ce != UCOL_PROCESSED_NULLORDER) {
+            found = FALSE;
+        }
+    } else {
+        for ( ; ; ++targetIxOffset ) {
+            nextCEI = ceb.get(targetIx + targetIxOffset);
+            maxLimit = nextCEI->lowIndex;
+            // If we are at the end of the target too, match succeeds
+            if (  nextCEI->ce == UCOL_PROCESSED_NULLORDER ) {
+                break;
+            }
+            // As long as the next CE has primary weight of 0,
+            // it is part of the last target element matched by the pattern;
+            // make sure it can be part of a match with the last patCE
+            if ( (((nextCEI->ce) >> 32) & 0xFFFF0000UL) == 0 ) {
+                UCompareCEsResult ceMatch = compareCE64s(nextCEI->ce, patCE, strsrch->search->elementComparisonType);
+                if ( ceMatch == U_CE_NO_MATCH || ceMatch == U_CE_SKIP_PATN ) {
+                    found = FALSE;
+                    break;
+                }
+            // If lowIndex == highIndex, this target CE is part of an expansion of the last matched
+            // target element, but it has non-zero primary weight => match fails
+            } else if ( nextCEI->lowIndex == nextCEI->highIndex ) {
+                found = false;
+                break;
+            // Else the target CE is not part of an expansion of the last matched element, match succeeds
+            } else {
+                break;
+            }
+        }
+    }
+
+
+    // Check for the start of the match being within a combining sequence.
+    //   This can happen if the pattern itself begins with a combining char, and
+    //   the match found combining marks in the target text that were attached
+    //    to something else.
+    //   This type of match should be rejected for not completely consuming a
+    //   combining sequence.
+    if (!isBreakBoundary(strsrch, mStart)) {
+        found = FALSE;
+    }
+
+    // Check for the start of the match being within an Collation Element Expansion,
+    //   meaning that the first char of the match is only partially matched.
+    //   With expansions, the first CE will report the index of the source
+    //   character, and all subsequent (expansions) CEs will report the source index of the
+    //    _following_ character.
+    int32_t secondIx = firstCEI->highIndex;
+    if (mStart == secondIx) {
+        found = FALSE;
+    }
+
+    // Allow matches to end in the middle of a grapheme cluster if the following
+    // conditions are met; this is needed to make prefix search work properly in
+    // Indic, see #11750
+    // * the default breakIter is being used
+    // * the next collation element after this combining sequence
+    //   - has non-zero primary weight
+    //   - corresponds to a separate character following the one at end of the current match
+    //   (the second of these conditions, and perhaps both, may be redundant given the
+    //   subsequent check for normalization boundary; however they are likely much faster
+    //   tests in any case)
+    // * the match limit is a normalization boundary
+    UBool allowMidclusterMatch = FALSE;
+    if (strsrch->search->text != NULL && strsrch->search->textLength > maxLimit) {
+        allowMidclusterMatch =
+                strsrch->search->breakIter == NULL &&
+                nextCEI != NULL && (((nextCEI->ce) >> 32) & 0xFFFF0000UL) != 0 &&
+                maxLimit >= lastCEI->highIndex && nextCEI->highIndex > maxLimit &&
+                (strsrch->nfd->hasBoundaryBefore(codePointAt(*strsrch->search, maxLimit)) ||
+                    strsrch->nfd->hasBoundaryAfter(codePointBefore(*strsrch->search, maxLimit)));
+    }
+    // If those conditions are met, then:
+    // * do NOT advance the candidate match limit (mLimit) to a break boundary; however
+    //   the match limit may be backed off to a previous break boundary. This handles
+    //   cases in which mLimit includes target characters that are ignorable with current
+    //   settings (such as space) and which extend beyond the pattern match.
+    // * do NOT require that end of the combining sequence not extend beyond the match in CE space
+    // * do NOT require that match limit be on a breakIter boundary
+
+    //  Advance the match end position to the first acceptable match boundary.
+    //    This advances the index over any combining characters.
+    mLimit = maxLimit;
+    if (minLimit < maxLimit) {
+        // When the last CE's low index is same with its high index, the CE is likely
+        // a part of expansion. In this case, the index is located just after the
+        // character corresponding to the CEs compared above. If the index is right
+        // at the break boundary, move the position to the next boundary will result
+        // incorrect match length when there are ignorable characters exist between
+        // the position and the next character produces CE(s). See ticket#8482.
+        if (minLimit == lastCEI->highIndex && isBreakBoundary(strsrch, minLimit)) {
+            mLimit = minLimit;
+        } else {
+            int32_t nba = nextBoundaryAfter(strsrch, minLimit);
+            // Note that we can have nba < maxLimit && nba >= minLImit, in which
+            // case we want to set mLimit to nba regardless of allowMidclusterMatch
+            // (i.e. we back off mLimit to the previous breakIterator boundary).
+            if (nba >= lastCEI->highIndex && (!allowMidclusterMatch || nba < maxLimit)) {
+                mLimit = nba;
+            }
+        }
+    }
+
+#ifdef USEARCH_DEBUG
+    if (getenv("USEARCH_DEBUG") != NULL) {
+        printf("minLimit, maxLimit, mLimit = %d, %d, %d\n", minLimit, maxLimit, mLimit);
+    }
+#endif
+
+    if (!allowMidclusterMatch) {
+        // If advancing to the end of a combining sequence in character indexing space
+        //   advanced us beyond the end of the match in CE space, reject this match.
+        if (mLimit > maxLimit) {
+            found = FALSE;
+        }
+
+        if (!isBreakBoundary(strsrch, mLimit)) {
+            found = FALSE;
+        }
+    }
+
+    *matchStart = mStart;
+    *matchLimit = mLimit;
+    return found;
+}
+
 U_CAPI UBool U_EXPORT2 usearch_search(UStringSearch  *strsrch,
                                        int32_t        startIdx,
                                        int32_t        *matchStart,
@@ -3887,9 +4112,14 @@ U_CAPI UBool U_EXPORT2 usearch_search(UStringSearch  *strsrch,
 
     int32_t  mStart = -1;
     int32_t  mLimit = -1;
-    int32_t  minLimit;
-    int32_t  maxLimit;
 
+    // With the standard element comparison, the pattern matches at targetIx only if
+    // the target CEs there are equal to the pattern CEs. In particular, the target CE
+    // aligned with the last pattern CE must be equal to it. If it is not,
+    // then we can skip ahead by the Horspool shift for that target CE.
+    int32_t  lastPatIx = strsrch->pattern.pcesLength - 1;
+    UBool    useShifts = strsrch->search->elementComparisonType == 0 && lastPatIx >= 0;
+    int64_t  lastPatCE = useShifts ? strsrch->pattern.pces[lastPatIx] : 0;
 
 
     // Outer loop moves over match starting positions in the
@@ -3913,6 +4143,24 @@ U_CAPI UBool U_EXPORT2 usearch_search(UStringSearch  *strsrch,
         //  position from the outer loop.
         int32_t targetIxOffset = 0;
         int64_t patCE = 0;
+        if (useShifts) {
+            for (;;) {
+                const CEI *alignedCEI = ceb.getAhead(targetIx + lastPatIx);
+                if (alignedCEI == NULL) {
+                    *status = U_INTERNAL_PROGRAM_ERROR;
+                    break;
+                }
+                // At the end of the input, let the code below detect the mismatch.
+                if (alignedCEI->ce == lastPatCE || alignedCEI->ce == UCOL_PROCESSED_NULLORDER) {
+                    break;
+                }
+                targetIx += strsrch->pattern.pceShift[hashFromPCE(alignedCEI->ce)];
+            }
+        }
+        if (U_FAILURE(*status)) {
+            found = FALSE;
+            break;
+        }
         // For targetIx > 0, this ceb.get gets a CE that is as far back in the ring buffer
         // (compared to the last CE fetched for the previous targetIx value) as we need to go
         // for this targetIx value, so if it is non-NULL then other ceb.get calls should be OK.
@@ -3957,149 +4205,7 @@ U_CAPI UBool U_EXPORT2 usearch_search(UStringSearch  *strsrch,
         }
 
 
-        // We have found a match in CE space.
-        // Now determine the bounds in string index space.
-        //  There still is a chance of match failure if the CE range not correspond to
-        //     an acceptable character range.
-        //
-        const CEI *lastCEI  = ceb.get(targetIx + targetIxOffset - 1);
-
-        mStart   = firstCEI->lowIndex;
-        minLimit = lastCEI->lowIndex;
-
-        // Look at the CE following the match.  If it is UCOL_NULLORDER the match
-        //   extended to the end of input, and the match is good.
-
-        // Look at the high and low indices of the CE following the match. If
-        // they are the same it means one of two things:
-        //    1. The match extended to the last CE from the target text, which is OK, or
-        //    2. The last CE that was part of the match is in an expansion that extends
-        //       to the first CE after the match. In this case, we reject the match.
-        const CEI *nextCEI = 0;
-        if (strsrch->search->elementComparisonType == 0) {
-            nextCEI  = ceb.get(targetIx + targetIxOffset);
-            maxLimit = nextCEI->lowIndex;
-            if (nextCEI->lowIndex == nextCEI->highIndex && nextCEI->ce != UCOL_PROCESSED_NULLORDER) {
-                found = FALSE;
-            }
-        } else {
-            for ( ; ; ++targetIxOffset ) {
-                nextCEI = ceb.get(targetIx + targetIxOffset);
-                maxLimit = nextCEI->lowIndex;
-                // If we are at the end of the target too, match succeeds
-                if (  nextCEI->ce == UCOL_PROCESSED_NULLORDER ) {
-                    break;
-                }
-                // As long as the next CE has primary weight of 0,
-                // it is part of the last target element matched by the pattern;
-                // make sure it can be part of a match with the last patCE
-                if ( (((nextCEI->ce) >> 32) & 0xFFFF0000UL) == 0 ) {
-                    UCompareCEsResult ceMatch = compareCE64s(nextCEI->ce, patCE, strsrch->search->elementComparisonType);
-                    if ( ceMatch == U_CE_NO_MATCH || ceMatch == U_CE_SKIP_PATN ) {
-                        found = FALSE;
-                        break;
-                    }
-                // If lowIndex == highIndex, this target CE is part of an expansion of the last matched
-                // target element, but it has non-zero primary weight => match fails
-                } else if ( nextCEI->lowIndex == nextCEI->highIndex ) {
-                    found = false;
-                    break;
-                // Else the target CE is not part of an expansion of the last matched element, match succeeds
-                } else {
-                    break;
-                }
-            }
-        }
-
-
-        // Check for the start of the match being within a combining sequence.
-        //   This can happen if the pattern itself begins with a combining char, and
-        //   the match found combining marks in the target text that were attached
-        //    to something else.
-        //   This type of match should be rejected for not completely consuming a
-        //   combining sequence.
-        if (!isBreakBoundary(strsrch, mStart)) {
-            found = FALSE;
-        }
-
-        // Check for the start of the match being within an Collation Element Expansion,
-        //   meaning that the first char of the match is only partially matched.
-        //   With expansions, the first CE will report the index of the source
-        //   character, and all subsequent (expansions) CEs will report the source index of the
-        //    _following_ character.
-        int32_t secondIx = firstCEI->highIndex;
-        if (mStart == secondIx) {
-            found = FALSE;
-        }
-
-        // Allow matches to end in the middle of a grapheme cluster if the following
-        // conditions are met; this is needed to make prefix search work properly in
-        // Indic, see #11750
-        // * the default breakIter is being used
-        // * the next collation element after this combining sequence
-        //   - has non-zero primary weight
-        //   - corresponds to a separate character following the one at end of the current match
-        //   (the second of these conditions, and perhaps both, may be redundant given the
-        //   subsequent check for normalization boundary; however they are likely much faster
-        //   tests in any case)
-        // * the match limit is a normalization boundary
-        UBool allowMidclusterMatch = FALSE;
-        if (strsrch->search->text != NULL && strsrch->search->textLength > maxLimit) {
-            allowMidclusterMatch =
-                    strsrch->search->breakIter == NULL &&
-                    nextCEI != NULL && (((nextCEI->ce) >> 32) & 0xFFFF0000UL) != 0 &&
-                    maxLimit >= lastCEI->highIndex && nextCEI->highIndex > maxLimit &&
-                    (strsrch->nfd->hasBoundaryBefore(codePointAt(*strsrch->search, maxLimit)) ||
-                        strsrch->nfd->hasBoundaryAfter(codePointBefore(*strsrch->search, maxLimit)));
-        }
-        // If those conditions are met, then:
-        // * do NOT advance the candidate match limit (mLimit) to a break boundary; however
-        //   the match limit may be backed off to a previous break boundary. This handles
-        //   cases in which mLimit includes target characters that are ignorable with current
-        //   settings (such as space) and which extend beyond the pattern match.
-        // * do NOT require that end of the combining sequence not extend beyond the match in CE space
-        // * do NOT require that match limit be on a breakIter boundary
-
-        //  Advance the match end position to the first acceptable match boundary.
-        //    This advances the index over any combining characters.
-        mLimit = maxLimit;
-        if (minLimit < maxLimit) {
-            // When the last CE's low index is same with its high index, the CE is likely
-            // a part of expansion. In this case, the index is located just after the
-            // character corresponding to the CEs compared above. If the index is right
-            // at the break boundary, move the position to the next boundary will result
-            // incorrect match length when there are ignorable characters exist between
-            // the position and the next character produces CE(s). See ticket#8482.
-            if (minLimit == lastCEI->highIndex && isBreakBoundary(strsrch, minLimit)) {
-                mLimit = minLimit;
-            } else {
-                int32_t nba = nextBoundaryAfter(strsrch, minLimit);
-                // Note that we can have nba < maxLimit && nba >= minLImit, in which
-                // case we want to set mLimit to nba regardless of allowMidclusterMatch
-                // (i.e. we back off mLimit to the previous breakIterator boundary).
-                if (nba >= lastCEI->highIndex && (!allowMidclusterMatch || nba < maxLimit)) {
-                    mLimit = nba;
-                }
-            }
-        }
-
-    #ifdef USEARCH_DEBUG
-        if (getenv("USEARCH_DEBUG") != NULL) {
-            printf("minLimit, maxLimit, mLimit = %d, %d, %d\n", minLimit, maxLimit, mLimit);
-        }
-    #endif
-
-        if (!allowMidclusterMatch) {
-            // If advancing to the end of a combining sequence in character indexing space
-            //   advanced us beyond the end of the match in CE space, reject this match.
-            if (mLimit > maxLimit) {
-                found = FALSE;
-            }
-
-            if (!isBreakBoundary(strsrch, mLimit)) {
-                found = FALSE;
-            }
-        }
+        found = getMatchBounds(strsrch, ceb, targetIx, targetIxOffset, patCE, &mStart, &mLimit);
 
         if (! checkIdentical(strsrch, mStart, mLimit)) {
             found = FALSE;
@@ -4951,4 +5057,387 @@ UBool usearch_handlePreviousCanonical(UStringSearch *strsrch,
 #endif
 }
 
+// multiple pattern search ------------------------------------------------
+
+/*
+ * A UMultiStringSearch runs an Aho-Corasick automaton over the processed CEs
+ * of the text, so that the text is scanned once for all of the patterns.
+ * Each candidate match in CE space is then validated with the same code as
+ * in usearch_search(). An internal UStringSearch provides the text iterator,
+ * the break iterators and the settings for that validation; its pattern is
+ * the one with the most CEs, which sizes the CEIBuffer for all of them.
+ *
+ * State 0 is the root. The goto edges of each state are sorted by CE
+ * for binary search. Each state that completes a pattern stores the first such
+ * pattern, and identical patterns are chained via nextSamePattern.
+ * outputLinks point to the nearest state on the failure chain
+ * that completes a pattern, or to the root.
+ */
+struct UMultiStringSearch : public UMemory {
+    UMultiStringSearch(UErrorCode &errorCode) :
+            strsrch(NULL),
+            patternTextStarts(errorCode), patternLengths(errorCode),
+            lastPCEs(errorCode), nextSamePattern(errorCode),
+            edgeStarts(errorCode), edgeCEs(errorCode), edgeTargets(errorCode),
+            failures(errorCode), outputs(errorCode), outputLinks(errorCode),
+            ceIndex(0), state(0), outState(0), outPattern(-1) {}
+    ~UMultiStringSearch() {
+        usearch_close(strsrch);
+    }
+
+    int32_t findEdge(int32_t s, int64_t ce) const {
+        const int64_t *ces = edgeCEs.getBuffer();
+        int32_t start = edgeStarts.elementAti(s);
+        int32_t limit = edgeStarts.elementAti(s + 1);
+        while (start < limit) {
+            int32_t i = (start + limit) / 2;
+            if (ce < ces[i]) {
+                limit = i;
+            } else if (ce > ces[i]) {
+                start = i + 1;
+            } else {
+                return edgeTargets.elementAti(i);
+            }
+        }
+        return -1;
+    }
+
+    int32_t nextState(int32_t s, int64_t ce) const {
+        for (;;) {
+            int32_t t = findEdge(s, ce);
+            if (t >= 0) {
+                return t;
+            }
+            if (s == 0) {
+                return 0;
+            }
+            s = failures.elementAti(s);
+        }
+    }
+
+    void reset(UErrorCode &errorCode) {
+        ucol_setOffset(strsrch->textIter, 0, &errorCode);
+        ceb.adoptInsteadAndCheckErrorCode(new CEIBuffer(strsrch, &errorCode), errorCode);
+        ceIndex = 0;
+        state = 0;
+        outState = 0;
+        outPattern = -1;
+    }
+
+    UStringSearch *strsrch;
+    UnicodeString patternTexts;   // all of the patterns, concatenated
+    UVector32 patternTextStarts;  // patternCount+1 indexes into patternTexts
+    UVector32 patternLengths;     // number of pces per pattern
+    UVector64 lastPCEs;           // last pce per pattern
+    UVector32 nextSamePattern;    // next pattern with the same pces, or -1
+
+    UVector32 edgeStarts;         // stateCount+1 indexes into edgeCEs & edgeTargets
+    UVector64 edgeCEs;
+    UVector32 edgeTargets;
+    UVector32 failures;
+    UVector32 outputs;            // first pattern completed in a state, or -1
+    UVector32 outputLinks;
+
+    LocalPointer<CEIBuffer> ceb;
+    int32_t ceIndex;              // index of the next CE to be consumed
+    int32_t state;
+    int32_t outState;             // state whose completed patterns are being reported
+    int32_t outPattern;           // next pattern to be validated, or -1
+};
+
+namespace {
+
+struct MSearchEdge {
+    int64_t ce;
+    int32_t target;
+};
+
+int32_t U_CALLCONV
+compareMSearchEdges(const void * /*context*/, const void *left, const void *right) {
+    int64_t l = static_cast<const MSearchEdge *>(left)->ce;
+    int64_t r = static_cast<const MSearchEdge *>(right)->ce;
+    return l < r ? -1 : l > r ? 1 : 0;
+}
+
+/*
+ * Builds the trie of pattern pces with unsorted edge lists,
+ * and then the sorted edges, failure links and output links
+ * of the UMultiStringSearch.
+ */
+class MSearchBuilder : public UMemory {
+public:
+    MSearchBuilder(UMultiStringSearch &ms, UErrorCode &errorCode) :
+            ms(ms), firstEdges(errorCode), edgeCEs(errorCode),
+            edgeTargets(errorCode), edgeNexts(errorCode) {
+        addState(errorCode);
+    }
+
+    void addPattern(int32_t patternIndex, const int64_t *pces, int32_t length,
+                    UErrorCode &errorCode) {
+        int32_t s = 0;
+        for (int32_t i = 0; i < length && U_SUCCESS(errorCode); ++i) {
+            int32_t e = firstEdges.elementAti(s);
+            while (e >= 0 && edgeCEs.elementAti(e) != pces[i]) {
+                e = edgeNexts.elementAti(e);
+            }
+            if (e >= 0) {
+                s = edgeTargets.elementAti(e);
+            } else {
+                int32_t t = addState(errorCode);
+                edgeCEs.addElement(pces[i], errorCode);
+                edgeTargets.addElement(t, errorCode);
+                edgeNexts.addElement(firstEdges.elementAti(s), errorCode);
+                firstEdges.setElementAt(edgeCEs.size() - 1, s);
+                s = t;
+            }
+        }
+        ms.patternLengths.addElement(length, errorCode);
+        ms.lastPCEs.addElement(pces[length - 1], errorCode);
+        ms.nextSamePattern.addElement(-1, errorCode);
+        if (U_FAILURE(errorCode)) { return; }
+        int32_t p = ms.outputs.elementAti(s);
+        if (p < 0) {
+            ms.outputs.setElementAt(patternIndex, s);
+        } else {
+            int32_t next;
+            while ((next = ms.nextSamePattern.elementAti(p)) >= 0) {
+                p = next;
+            }
+            ms.nextSamePattern.setElementAt(patternIndex, p);
+        }
+    }
+
+    void build(UErrorCode &errorCode) {
+        if (U_FAILURE(errorCode)) { return; }
+        int32_t stateCount = firstEdges.size();
+        MaybeStackArray<MSearchEdge, 16> edges;
+        for (int32_t s = 0; s < stateCount; ++s) {
+            ms.edgeStarts.addElement(ms.edgeCEs.size(), errorCode);
+            int32_t count = 0;
+            for (int32_t e = firstEdges.elementAti(s); e >= 0; e = edgeNexts.elementAti(e)) {
+                if (count == edges.getCapacity() && edges.resize(2 * count, count) == NULL) {
+                    errorCode = U_MEMORY_ALLOCATION_ERROR;
+                    return;
+                }
+                edges[count].ce = edgeCEs.elementAti(e);
+                edges[count].target = edgeTargets.elementAti(e);
+                ++count;
+            }
+            uprv_sortArray(edges.getAlias(), count, (int32_t)sizeof(MSearchEdge),
+                           compareMSearchEdges, NULL, FALSE, &errorCode);
+            for (int32_t i = 0; i < count; ++i) {
+                ms.edgeCEs.addElement(edges[i].ce, errorCode);
+                ms.edgeTargets.addElement(edges[i].target, errorCode);
+            }
+        }
+        ms.edgeStarts.addElement(ms.edgeCEs.size(), errorCode);
+        ms.failures.setSize(stateCount);
+        ms.outputLinks.setSize(stateCount);
+        if (U_FAILURE(errorCode)) { return; }
+
+        // Breadth-first, so that the failure state of a state is complete
+        // before the state's own edges are followed.
+        UVector32 queue(stateCount, errorCode);
+        queue.addElement(0, errorCode);
+        ms.failures.setElementAt(0, 0);
+        ms.outputLinks.setElementAt(0, 0);
+        for (int32_t qi = 0; qi < queue.size() && U_SUCCESS(errorCode); ++qi) {
+            int32_t s = queue.elementAti(qi);
+            int32_t limit = ms.edgeStarts.elementAti(s + 1);
+            for (int32_t i = ms.edgeStarts.elementAti(s); i < limit; ++i) {
+                int32_t t = ms.edgeTargets.elementAti(i);
+                int32_t f = s == 0 ? 0 : ms.nextState(ms.failures.elementAti(s), ms.edgeCEs.elementAti(i));
+                ms.failures.setElementAt(f, t);
+                ms.outputLinks.setElementAt(
+                    ms.outputs.elementAti(f) >= 0 ? f : ms.outputLinks.elementAti(f), t);
+                queue.addElement(t, errorCode);
+            }
+        }
+    }
+
+private:
+    int32_t addState(UErrorCode &errorCode) {
+        firstEdges.addElement(-1, errorCode);
+        ms.outputs.addElement(-1, errorCode);
+        return firstEdges.size() - 1;
+    }
+
+    UMultiStringSearch &ms;
+    UVector32 firstEdges;  // per state, the first of its edges, or -1
+    UVector64 edgeCEs;
+    UVector32 edgeTargets;
+    UVector32 edgeNexts;   // next edge of the same state, or -1
+};
+
+}  // namespace
+
+U_CAPI UMultiStringSearch * U_EXPORT2
+umsearch_open(const UChar *const *patterns, const int32_t *patternLengths, int32_t patternCount,
+              const UChar *text, int32_t textlength,
+              const UCollator *collator, UBreakIterator *breakiter,
+              UErrorCode *status) {
+    if (U_FAILURE(*status)) {
+        return NULL;
+    }
+    if (patterns == NULL || patternCount <= 0) {
+        *status = U_ILLEGAL_ARGUMENT_ERROR;
+        return NULL;
+    }
+    LocalPointer<UMultiStringSearch> ms(new UMultiStringSearch(*status), *status);
+    if (U_FAILURE(*status)) {
+        return NULL;
+    }
+    for (int32_t i = 0; i < patternCount; ++i) {
+        int32_t length = patternLengths == NULL ? -1 : patternLengths[i];
+        if (patterns[i] == NULL || length < -1) {
+            *status = U_ILLEGAL_ARGUMENT_ERROR;
+            return NULL;
+        }
+        if (length < 0) {
+            length = u_strlen(patterns[i]);
+        }
+        ms->patternTextStarts.addElement(ms->patternTexts.length(), *status);
+        ms->patternTexts.append(patterns[i], length);
+    }
+    ms->patternTextStarts.addElement(ms->patternTexts.length(), *status);
+    if (U_SUCCESS(*status) && ms->patternTexts.isBogus()) {
+        *status = U_MEMORY_ALLOCATION_ERROR;
+    }
+    if (U_FAILURE(*status)) {
+        return NULL;
+    }
+
+    // Compute the pces of each pattern with the internal UStringSearch,
+    // and finally leave it set to the longest pattern.
+    const UChar *patternText = ms->patternTexts.getBuffer();
+    ms->strsrch = usearch_openFromCollator(patternText, ms->patternTextStarts.elementAti(1),
+                                           text, textlength, collator, breakiter, status);
+    MSearchBuilder builder(*ms, *status);
+    int32_t longest = 0;
+    int32_t maxPCEsLength = 0;
+    for (int32_t i = 0; i < patternCount && U_SUCCESS(*status); ++i) {
+        int32_t start = ms->patternTextStarts.elementAti(i);
+        usearch_setPattern(ms->strsrch, patternText + start,
+                           ms->patternTextStarts.elementAti(i + 1) - start, status);
+        if (U_FAILURE(*status)) {
+            break;
+        }
+        initializePatternPCETable(ms->strsrch, status);
+        int32_t pcesLength = ms->strsrch->pattern.pcesLength;
+        if (U_SUCCESS(*status) && pcesLength == 0) {
+            *status = U_ILLEGAL_ARGUMENT_ERROR;
+        }
+        if (U_FAILURE(*status)) {
+            break;
+        }
+        if (pcesLength > maxPCEsLength) {
+            longest = i;
+            maxPCEsLength = pcesLength;
+        }
+        builder.addPattern(i, ms->strsrch->pattern.pces, pcesLength, *status);
+    }
+    builder.build(*status);
+    if (U_SUCCESS(*status)) {
+        int32_t start = ms->patternTextStarts.elementAti(longest);
+        usearch_setPattern(ms->strsrch, patternText + start,
+                           ms->patternTextStarts.elementAti(longest + 1) - start, status);
+    }
+    if (U_SUCCESS(*status)) {
+        initializePatternPCETable(ms->strsrch, status);
+        ms->reset(*status);
+    }
+    if (U_FAILURE(*status)) {
+        return NULL;
+    }
+    return ms.orphan();
+}
+
+U_CAPI void U_EXPORT2
+umsearch_close(UMultiStringSearch *msearch) {
+    delete msearch;
+}
+
+U_CAPI void U_EXPORT2
+umsearch_setText(UMultiStringSearch *msearch, const UChar *text, int32_t textlength,
+                 UErrorCode *status) {
+    if (U_FAILURE(*status)) {
+        return;
+    }
+    if (msearch == NULL) {
+        *status = U_ILLEGAL_ARGUMENT_ERROR;
+        return;
+    }
+    usearch_setText(msearch->strsrch, text, textlength, status);
+    if (U_SUCCESS(*status)) {
+        msearch->reset(*status);
+    }
+}
+
+U_CAPI UBool U_EXPORT2
+umsearch_next(UMultiStringSearch *msearch,
+              int32_t *patternIndex, int32_t *matchStart, int32_t *matchLimit,
+              UErrorCode *status) {
+    int32_t p = -1;
+    int32_t mStart = -1;
+    int32_t mLimit = -1;
+    UBool found = FALSE;
+    if (U_SUCCESS(*status) && msearch == NULL) {
+        *status = U_ILLEGAL_ARGUMENT_ERROR;
+    }
+    while (U_SUCCESS(*status)) {
+        if (msearch->outPattern < 0) {
+            // Consume the next text CE.
+            const CEI *cei = msearch->ceb->get(msearch->ceIndex);
+            if (cei == NULL) {
+                *status = U_INTERNAL_PROGRAM_ERROR;
+                break;
+            }
+            if (cei->ce == UCOL_PROCESSED_NULLORDER) {
+                break;
+            }
+            int32_t s = msearch->state = msearch->nextState(msearch->state, cei->ce);
+            ++msearch->ceIndex;
+            if (msearch->outputs.elementAti(s) < 0) {
+                s = msearch->outputLinks.elementAti(s);
+            }
+            msearch->outState = s;
+            msearch->outPattern = msearch->outputs.elementAti(s);
+            continue;
+        }
+
+        p = msearch->outPattern;
+        msearch->outPattern = msearch->nextSamePattern.elementAti(p);
+        if (msearch->outPattern < 0) {
+            msearch->outState = msearch->outputLinks.elementAti(msearch->outState);
+            msearch->outPattern = msearch->outputs.elementAti(msearch->outState);
+        }
+
+        // Pattern p matches the CEs up to the last consumed one.
+        int32_t length = msearch->patternLengths.elementAti(p);
+        int32_t patStart = msearch->patternTextStarts.elementAti(p);
+        found = getMatchBounds(msearch->strsrch, *msearch->ceb, msearch->ceIndex - length, length,
+                               msearch->lastPCEs.elementAti(p), &mStart, &mLimit) &&
+                checkIdentical(msearch->strsrch, mStart, mLimit,
+                               msearch->patternTexts.getBuffer() + patStart,
+                               msearch->patternTextStarts.elementAti(p + 1) - patStart);
+        if (found) {
+            break;
+        }
+    }
+
+    if (!found) {
+        p = mStart = mLimit = -1;
+    }
+    if (patternIndex != NULL) {
+        *patternIndex = p;
+    }
+    if (matchStart != NULL) {
+        *matchStart = mStart;
+    }
+    if (matchLimit != NULL) {
+        *matchLimit = mLimit;
+    }
+    return found;
+}
+
 #endif /* #if !UCONFIG_NO_COLLATION */
@@ -0,0 +1,483 @@
+// © 2016 and later: Unicode, Inc. and others.
+// License & terms of use: http://www.unicode.org/copyright.html
+/*
+*******************************************************************************
+*   file name:  usortkeystore.cpp
+*   encoding:   UTF-8
+*   tab size:   8 (not used)
+*   indentation:4
+*
+*   USortKeyStore: Front-coded, block-indexed, memory-mappable
+*   list of sorted collation sort keys.
+*/
+
+#include "unicode/utypes.h"
+
+#if !UCONFIG_NO_COLLATION
+
+#include "unicode/ucol.h"
+#include "unicode/usortkeystore.h"
+#include "cmemory.h"
+#include "cstring.h"
+#include "putilimp.h"
+
+U_NAMESPACE_USE
+
+/*
+ * Binary format, in platform endianness, 32-bit-aligned:
+ *
+ * int32_t indexes[IX_COUNT];
+ * int32_t blockOffsets[blockCount+1];  // into keyData; the last one is keyDataLength
+ * uint8_t keyData[keyDataLength];  // padded with zero bytes to a multiple of 4
+ *
+ * where blockCount=(keyCount+blockSize-1)/blockSize.
+ *
+ * The keys are stored without their terminating zero bytes.
+ * The first key of a block is stored as
+ *     varint length, bytes[length]
+ * and each further key of the block as
+ *     varint shared, varint suffixLength, bytes[suffixLength]
+ * where shared is the length of the prefix that the key shares with the previous key.
+ * A varint stores 7 bits per byte, least significant bits first;
+ * bit 7 is set on all but the last byte.
+ */
+
+namespace {
+
+const int32_t SORT_KEY_STORE_SIG = 0x534b7374;  // "SKst"
+
+enum {
+    IX_SIGNATURE,
+    IX_KEY_COUNT,
+    IX_BLOCK_SIZE,
+    IX_KEY_DATA_LENGTH,
+    IX_RESERVED_4,
+    IX_RESERVED_5,
+    IX_COUNT
+};
+
+const int32_t DEFAULT_BLOCK_SIZE = 16;
+const int32_t MAX_BLOCK_SIZE = 1024;
+
+/** Appends key data bytes, or only counts them beyond the capacity. */
+class KeyDataWriter {
+public:
+    KeyDataWriter(uint8_t *dest, int32_t capacity) : dest(dest), capacity(capacity), length(0) {}
+
+    void append(uint8_t b) {
+        if(length < capacity) { dest[length] = b; }
+        ++length;
+    }
+    void appendVarint(int32_t value) {
+        uint32_t v = (uint32_t)value;
+        while(v >= 0x80) {
+            append((uint8_t)(v | 0x80));
+            v >>= 7;
+        }
+        append((uint8_t)v);
+    }
+    void append(const uint8_t *s, int32_t n) {
+        if(length < capacity) {
+            uprv_memcpy(dest + length, s, uprv_min(n, capacity - length));
+        }
+        length += n;
+    }
+
+    uint8_t *dest;
+    int32_t capacity;
+    int32_t length;
+};
+
+inline int32_t readVarint(const uint8_t *&p) {
+    uint32_t value = 0;
+    int32_t shift = 0;
+    uint8_t b;
+    do {
+        b = *p++;
+        value |= (uint32_t)(b & 0x7f) << shift;
+        shift += 7;
+    } while(b >= 0x80);
+    return (int32_t)value;
+}
+
+/**
+ * Like readVarint() but does not read at or beyond limit,
+ * and rejects values that do not fit into a non-negative int32_t.
+ */
+UBool readCheckedVarint(const uint8_t *&p, const uint8_t *limit, int32_t &value) {
+    uint32_t v = 0;
+    int32_t shift = 0;
+    uint8_t b;
+    do {
+        if(p >= limit) { return FALSE; }
+        b = *p++;
+        if(shift == 28 && b > 7) { return FALSE; }  // more than 31 bits
+        v |= (uint32_t)(b & 0x7f) << shift;
+        shift += 7;
+    } while(b >= 0x80);
+    value = (int32_t)v;
+    return TRUE;
+}
+
+/**
+ * Checks that the front-coded keys of one block lie within [p, limit) and fill it,
+ * and that no key shares a longer prefix with its predecessor than that key's length.
+ */
+UBool isValidBlock(const uint8_t *p, const uint8_t *limit, int32_t count) {
+    int32_t prevLength;
+    if(!readCheckedVarint(p, limit, prevLength) || (limit - p) < prevLength) {
+        return FALSE;
+    }
+    p += prevLength;
+    while(--count > 0) {
+        int32_t shared, suffixLength;
+        if(!readCheckedVarint(p, limit, shared) || shared > prevLength ||
+                !readCheckedVarint(p, limit, suffixLength) || (limit - p) < suffixLength ||
+                suffixLength > INT32_MAX - shared) {
+            return FALSE;
+        }
+        p += suffixLength;
+        prevLength = shared + suffixLength;
+    }
+    return p == limit;
+}
+
+/**
+ * Compares s and t like strcmp() and sets lcp to the length of their common prefix.
+ */
+int32_t compareKeys(const uint8_t *s, int32_t sLength, const uint8_t *t, int32_t tLength,
+                    int32_t &lcp) {
+    int32_t i = 0;
+    while(i < sLength && i < tLength && s[i] == t[i]) { ++i; }
+    lcp = i;
+    if(i < sLength && i < tLength) {
+        return (int32_t)s[i] - (int32_t)t[i];
+    }
+    return (int32_t)(i < sLength) - (int32_t)(i < tLength);
+}
+
+/** Key length without the terminating zero byte. */
+inline int32_t keyLength(const uint8_t *key, int32_t length) {
+    if(length < 0) {
+        return (int32_t)uprv_strlen((const char *)key);
+    } else if(length > 0 && key[length - 1] == 0) {
+        return length - 1;
+    } else {
+        return length;
+    }
+}
+
+}  // namespace
+
+struct USortKeyStore {
+    const int32_t *blockOffsets;
+    const uint8_t *keyData;
+    int32_t keyCount;
+    int32_t blockSize;
+    int32_t blockCount;
+};
+
+namespace {
+
+/**
+ * Returns the index of the first stored key that is greater than the query,
+ * or greater than or equal to it if !inclusive.
+ * All keys before that index precede the query.
+ */
+int32_t findLimit(const USortKeyStore *store, const uint8_t *q, int32_t qLength,
+                  UBool inclusive) {
+    // Binary search for the first block whose first key does not precede the query.
+    int32_t start = 0, limit = store->blockCount;
+    while(start < limit) {
+        int32_t mid = (start + limit) / 2;
+        const uint8_t *p = store->keyData + store->blockOffsets[mid];
+        int32_t length = readVarint(p);
+        int32_t lcp;
+        int32_t cmp = compareKeys(p, length, q, qLength, lcp);
+        if(cmp < 0 || (cmp == 0 && inclusive)) {
+            start = mid + 1;
+        } else {
+            limit = mid;
+        }
+    }
+    if(start == 0) { return 0; }
+    // Scan the previous block, whose first key precedes the query.
+    // matchLength is the length of the prefix that the previous key shares with the query.
+    // We do not reconstruct the keys:
+    // If a key shares less than that with its predecessor, then it is greater than the query.
+    // If it shares more, then it precedes the query just like its predecessor.
+    int32_t block = start - 1;
+    const uint8_t *p = store->keyData + store->blockOffsets[block];
+    int32_t length = readVarint(p);
+    int32_t matchLength;
+    compareKeys(p, length, q, qLength, matchLength);
+    p += length;
+    int32_t index = block * store->blockSize;
+    int32_t blockLimit = uprv_min(index + store->blockSize, store->keyCount);
+    while(++index < blockLimit) {
+        int32_t shared = readVarint(p);
+        int32_t suffixLength = readVarint(p);
+        const uint8_t *suffix = p;
+        p += suffixLength;
+        if(shared < matchLength) {
+            return index;
+        } else if(shared == matchLength) {
+            // Compare the rest of the key with the rest of the query.
+            int32_t lcp;
+            int32_t cmp = compareKeys(suffix, suffixLength, q + shared, qLength - shared, lcp);
+            if(cmp > 0 || (cmp == 0 && !inclusive)) {
+                return index;
+            }
+            matchLength = shared + lcp;
+        }
+    }
+    return index;
+}
+
+}  // namespace
+
+U_CAPI int32_t U_EXPORT2
+usortkeystore_build(const uint8_t *keys, const int32_t *offsets, int32_t count,
+                    int32_t blockSize,
+                    void *data, int32_t capacity, UErrorCode *pErrorCode) {
+    if(U_FAILURE(*pErrorCode)) { return 0; }
+    if(blockSize == 0) { blockSize = DEFAULT_BLOCK_SIZE; }
+    if(count < 0 || (count > 0 && (keys == NULL || offsets == NULL)) ||
+            blockSize < 0 || MAX_BLOCK_SIZE < blockSize ||
+            capacity < 0 || (capacity > 0 && (data == NULL || U_POINTER_MASK_LSB(data, 3) != 0))) {
+        *pErrorCode = U_ILLEGAL_ARGUMENT_ERROR;
+        return 0;
+    }
+    int32_t blockCount = (count / blockSize) + (count % blockSize != 0);
+    if(blockCount > INT32_MAX / 4 - IX_COUNT - 1) {
+        *pErrorCode = U_INDEX_OUTOFBOUNDS_ERROR;
+        return 0;
+    }
+    int32_t headerLength = (IX_COUNT + blockCount + 1) * 4;
+    int32_t *indexes = (int32_t *)data;
+    int32_t *blockOffsets = indexes + IX_COUNT;
+    UBool fitsHeader = capacity >= headerLength;
+    KeyDataWriter writer(fitsHeader ? (uint8_t *)data + headerLength : NULL,
+                         fitsHeader ? capacity - headerLength : 0);
+
+    const uint8_t *prev = NULL;
+    int32_t prevLength = 0;
+    for(int32_t i = 0; i < count; ++i) {
+        int32_t length = offsets[i + 1] - offsets[i];
+        if(offsets[i] < 0 || length < 0) {
+            *pErrorCode = U_ILLEGAL_ARGUMENT_ERROR;
+            return 0;
+        }
+        const uint8_t *key = keys + offsets[i];
+        length = keyLength(key, length);
+        int32_t shared = 0;
+        if(prev != NULL) {
+            int32_t cmp = compareKeys(key, length, prev, prevLength, shared);
+            if(cmp < 0) {
+                *pErrorCode = U_ILLEGAL_ARGUMENT_ERROR;  // not sorted
+                return 0;
+            }
+        }
+        if((i % blockSize) == 0) {
+            if(fitsHeader) { blockOffsets[i / blockSize] = writer.length; }
+            writer.appendVarint(length);
+            writer.append(key, length);
+        } else {
+            writer.appendVarint(shared);
+            writer.appendVarint(length - shared);
+            writer.append(key + shared, length - shared);
+        }
+        if(writer.length > INT32_MAX - headerLength - 3) {
+            *pErrorCode = U_INDEX_OUTOFBOUNDS_ERROR;
+            return 0;
+        }
+        prev = key;
+        prevLength = length;
+    }
+    int32_t keyDataLength = writer.length;
+    while((writer.length & 3) != 0) { writer.append(0); }
+    int32_t totalLength = headerLength + writer.length;
+    if(totalLength > capacity) {
+        *pErrorCode = U_BUFFER_OVERFLOW_ERROR;
+        return totalLength;
+    }
+    indexes[IX_SIGNATURE] = SORT_KEY_STORE_SIG;
+    indexes[IX_KEY_COUNT] = count;
+    indexes[IX_BLOCK_SIZE] = blockSize;
+    indexes[IX_KEY_DATA_LENGTH] = keyDataLength;
+    indexes[IX_RESERVED_4] = 0;
+    indexes[IX_RESERVED_5] = 0;
+    blockOffsets[blockCount] = keyDataLength;
+    return totalLength;
+}
+
+U_CAPI USortKeyStore * U_EXPORT2
+usortkeystore_openFromBinary(const void *data, int32_t length, int32_t *pActualLength,
+                             UErrorCode *pErrorCode) {
+    if(U_FAILURE(*pErrorCode)) { return NULL; }
+    if(data == NULL || length <= 0 || U_POINTER_MASK_LSB(data, 3) != 0) {
+        *pErrorCode = U_ILLEGAL_ARGUMENT_ERROR;
+        return NULL;
+    }
+    const int32_t *indexes = (const int32_t *)data;
+    if(length < IX_COUNT * 4 || indexes[IX_SIGNATURE] != SORT_KEY_STORE_SIG) {
+        *pErrorCode = U_INVALID_FORMAT_ERROR;
+        return NULL;
+    }
+    int32_t keyCount = indexes[IX_KEY_COUNT];
+    int32_t blockSize = indexes[IX_BLOCK_SIZE];
+    int32_t keyDataLength = indexes[IX_KEY_DATA_LENGTH];
+    if(keyCount < 0 || blockSize <= 0 || MAX_BLOCK_SIZE < blockSize || keyDataLength < 0) {
+        *pErrorCode = U_INVALID_FORMAT_ERROR;
+        return NULL;
+    }
+    int32_t blockCount = (keyCount / blockSize) + (keyCount % blockSize != 0);
+    if(blockCount > INT32_MAX / 4 - IX_COUNT - 1) {
+        *pErrorCode = U_INVALID_FORMAT_ERROR;
+        return NULL;
+    }
+    int32_t headerLength = IX_COUNT + blockCount + 1;
+    // Check the lengths in units of 4 bytes so that they do not overflow.
+    int32_t length4 = length / 4;
+    if(length4 < headerLength || (length4 - headerLength) < (keyDataLength + 3) / 4) {
+        *pErrorCode = U_INVALID_FORMAT_ERROR;
+        return NULL;
+    }
+    const int32_t *blockOffsets = indexes + IX_COUNT;
+    const uint8_t *keyData = (const uint8_t *)(blockOffsets + blockCount + 1);
+    if(blockOffsets[0] != 0 || blockOffsets[blockCount] != keyDataLength) {
+        *pErrorCode = U_INVALID_FORMAT_ERROR;
+        return NULL;
+    }
+    // The lookup functions trust the key data; check that it stays within its blocks.
+    for(int32_t block = 0; block < blockCount; ++block) {
+        int32_t start = blockOffsets[block];
+        int32_t limit = blockOffsets[block + 1];
+        if(limit < start || keyDataLength < limit ||
+                !isValidBlock(keyData + start, keyData + limit,
+                              uprv_min(blockSize, keyCount - block * blockSize))) {
+            *pErrorCode = U_INVALID_FORMAT_ERROR;
+            return NULL;
+        }
+    }
+
+    USortKeyStore *store = (USortKeyStore *)uprv_malloc(sizeof(USortKeyStore));
+    if(store == NULL) {
+        *pErrorCode = U_MEMORY_ALLOCATION_ERROR;
+        return NULL;
+    }
+    store->blockOffsets = blockOffsets;
+    store->keyData = keyData;
+    store->keyCount = keyCount;
+    store->blockSize = blockSize;
+    store->blockCount = blockCount;
+    if(pActualLength != NULL) {
+        *pActualLength = headerLength * 4 + ((keyDataLength + 3) & ~3);
+    }
+    return store;
+}
+
+U_CAPI void U_EXPORT2
+usortkeystore_close(USortKeyStore *store) {
+    uprv_free(store);
+}
+
+U_CAPI int32_t U_EXPORT2
+usortkeystore_getCount(const USortKeyStore *store) {
+    return store->keyCount;
+}
+
+U_CAPI int32_t U_EXPORT2
+usortkeystore_getKey(const USortKeyStore *store, int32_t index,
+                     uint8_t *dest, int32_t capacity, UErrorCode *pErrorCode) {
+    if(U_FAILURE(*pErrorCode)) { return 0; }
+    if(store == NULL || capacity < 0 || (capacity > 0 && dest == NULL)) {
+        *pErrorCode = U_ILLEGAL_ARGUMENT_ERROR;
+        return 0;
+    }
+    if(index < 0 || store->keyCount <= index) {
+        *pErrorCode = U_INDEX_OUTOFBOUNDS_ERROR;
+        return 0;
+    }
+    int32_t block = index / store->blockSize;
+    const uint8_t *p = store->keyData + store->blockOffsets[block];
+    int32_t length = readVarint(p);
+    MaybeStackArray<uint8_t, 128> key;
+    if(length > key.getCapacity() && key.resize(length) == NULL) {
+        *pErrorCode = U_MEMORY_ALLOCATION_ERROR;
+        return 0;
+    }
+    uprv_memcpy(key.getAlias(), p, length);
+    p += length;
+    for(int32_t i = block * store->blockSize; i < index; ++i) {
+        int32_t shared = readVarint(p);
+        int32_t suffixLength = readVarint(p);
+        length = shared + suffixLength;
+        if(length > key.getCapacity() && key.resize(length, shared) == NULL) {
+            *pErrorCode = U_MEMORY_ALLOCATION_ERROR;
+            return 0;
+        }
+        uprv_memcpy(key.getAlias() + shared, p, suffixLength);
+        p += suffixLength;
+    }
+    if(length < capacity) {
+        uprv_memcpy(dest, key.getAlias(), length);
+        dest[length] = 0;
+    } else {
+        *pErrorCode = U_BUFFER_OVERFLOW_ERROR;
+    }
+    return length + 1;
+}
+
+U_CAPI int32_t U_EXPORT2
+usortkeystore_lowerBound(const USortKeyStore *store, const uint8_t *key, int32_t length,
+                         UErrorCode *pErrorCode) {
+    if(U_FAILURE(*pErrorCode)) { return 0; }
+    if(store == NULL || key == NULL || length < -1) {
+        *pErrorCode = U_ILLEGAL_ARGUMENT_ERROR;
+        return 0;
+    }
+    return findLimit(store, key, keyLength(key, length), FALSE);
+}
+
+U_CAPI int32_t U_EXPORT2
+usortkeystore_upperBound(const USortKeyStore *store, const uint8_t *key, int32_t length,
+                         UErrorCode *pErrorCode) {
+    if(U_FAILURE(*pErrorCode)) { return 0; }
+    if(store == NULL || key == NULL || length < -1) {
+        *pErrorCode = U_ILLEGAL_ARGUMENT_ERROR;
+        return 0;
+    }
+    return findLimit(store, key, keyLength(key, length), TRUE);
+}
+
+U_CAPI int32_t U_EXPORT2
+usortkeystore_getBoundRange(const USortKeyStore *store, const uint8_t *key, int32_t length,
+                            UColBoundMode boundType, uint32_t noOfLevels,
+                            int32_t *pLimit, UErrorCode *pErrorCode) {
+    if(U_FAILURE(*pErrorCode)) { return 0; }
+    if(store == NULL || key == NULL || length < -1 || pLimit == NULL ||
+            (boundType != UCOL_BOUND_UPPER && boundType != UCOL_BOUND_UPPER_LONG)) {
+        *pErrorCode = U_ILLEGAL_ARGUMENT_ERROR;
+        return 0;
+    }
+    // The bounds are at most two bytes longer than the key.
+    MaybeStackArray<uint8_t, 128> bound;
+    int32_t capacity = keyLength(key, length) + 3;
+    if(capacity > bound.getCapacity() && bound.resize(capacity) == NULL) {
+        *pErrorCode = U_MEMORY_ALLOCATION_ERROR;
+        return 0;
+    }
+    int32_t boundLength = ucol_getBound(key, length, UCOL_BOUND_LOWER, noOfLevels,
+                                        bound.getAlias(), capacity, pErrorCode);
+    if(U_FAILURE(*pErrorCode)) { return 0; }
+    int32_t start = findLimit(store, bound.getAlias(), keyLength(bound.getAlias(), boundLength),
+                              FALSE);
+    boundLength = ucol_getBound(key, length, boundType, noOfLevels,
+                                bound.getAlias(), capacity, pErrorCode);
+    if(U_FAILURE(*pErrorCode)) { return 0; }
+    *pLimit = findLimit(store, bound.getAlias(), keyLength(bound.getAlias(), boundLength), TRUE);
+    return start;
+}
+
+#endif  // !UCONFIG_NO_COLLATION
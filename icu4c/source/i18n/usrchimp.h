@@ -163,6 +163,8 @@ struct UPattern {
           int16_t             defaultShiftSize;
           int16_t             shift[MAX_TABLE_SIZE_];
           int16_t             backShift[MAX_TABLE_SIZE_];
+          // Horspool shifts for the pces, used by usearch_search()
+          int16_t             pceShift[MAX_TABLE_SIZE_];
 };
 
 struct UStringSearch {
@@ -101,6 +101,14 @@ class U_I18N_API FCDUTF16CollationIterator : public UTF16CollationIterator {
 
     virtual int32_t getOffset() const;
 
+    void setText(const UChar *s, const UChar *lim) {
+        reset();
+        rawStart = segmentStart = start = pos = s;
+        segmentLimit = NULL;
+        rawLimit = limit = lim;
+        checkDir = 1;
+    }
+
     virtual UChar32 nextCodePoint(UErrorCode &errorCode);
 
     virtual UChar32 previousCodePoint(UErrorCode &errorCode);
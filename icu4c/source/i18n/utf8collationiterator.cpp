@@ -24,6 +24,7 @@
 #include "collationiterator.h"
 #include "normalizer2impl.h"
 #include "uassert.h"
+#include "ustr_simd.h"
 #include "utf8collationiterator.h"
 
 U_NAMESPACE_BEGIN
@@ -127,6 +128,44 @@ UTF8CollationIterator::backwardNumCodePoints(int32_t num, UErrorCode & /*errorCo
 
 // FCDUTF8CollationIterator ------------------------------------------------ ***
 
+namespace {
+
+/**
+ * Returns the end of the initial span of s[start..length[ which passes the FCD check
+ * without looking at the characters one by one:
+ * Bytes below CC (ASCII, trail bytes, and lead bytes of U+0080..U+02FF)
+ * are skipped 16 at a time,
+ * and the span ends before the character which precedes the first one with lccc!=0
+ * (according to CollationFCD::mayHaveLccc()), because that character might have tccc!=0.
+ * Character boundaries are the same as with U8_NEXT_OR_FFFD().
+ */
+int32_t
+spanFCDInert(const uint8_t *s, int32_t start, int32_t length) {
+    int32_t p = start;
+    int32_t lastStart = start;  // start of the last character before p
+    for(;;) {
+        int32_t n = uprv_spanBytesBelow(s + p, length - p, 0xcc);
+        if(n > 0) {
+            p += n;
+            // The run ends with a single byte, or with a two-byte character C2..CB + trail.
+            lastStart = p - 1;
+            if(n >= 2 && U8_IS_TRAIL(s[p - 1]) && s[p - 2] >= 0xc2) {
+                lastStart = p - 2;
+            }
+        }
+        if(p == length) { return length; }
+        int32_t cpStart = p;
+        UChar32 c;
+        U8_NEXT_OR_FFFD(s, p, length, c);
+        if(CollationFCD::mayHaveLccc(c)) {
+            return cpStart == start ? start : lastStart;
+        }
+        lastStart = cpStart;
+    }
+}
+
+}  // namespace
+
 FCDUTF8CollationIterator::~FCDUTF8CollationIterator() {}
 
 void
@@ -161,6 +200,17 @@ FCDUTF8CollationIterator::handleNextCE32(UChar32 &c, UErrorCode &errorCode) {
                 // ASCII 00..7F
                 return trie->data32[c];
             }
+            if(length >= 0) {
+                // Rather than checking each non-ASCII character,
+                // treat the following run of FCD-inert text as an FCD segment.
+                int32_t inertLimit = spanFCDInert(u8, pos - 1, length);
+                if(inertLimit != pos - 1) {
+                    --pos;
+                    limit = inertLimit;
+                    state = IN_FCD_SEGMENT;
+                    return UTF8CollationIterator::handleNextCE32(c, errorCode);
+                }
+            }
             uint8_t t1, t2;
             if(0xe0 <= c && c < 0xf0 &&
                     ((pos + 1) < length || length < 0) &&
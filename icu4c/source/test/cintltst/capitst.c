@@ -27,6 +27,7 @@
 #include "unicode/ustring.h"
 #include "unicode/ures.h"
 #include "unicode/ucoleitr.h"
+#include "unicode/usortkeystore.h"
 #include "cintltst.h"
 #include "capitst.h"
 #include "ccolltst.h"
@@ -78,6 +79,10 @@ void addCollAPITest(TestNode** root)
     addTest(root, &TestBounds, "tscoll/capitst/TestBounds");
     addTest(root, &TestGetLocale, "tscoll/capitst/TestGetLocale");
     addTest(root, &TestSortKeyBufferOverrun, "tscoll/capitst/TestSortKeyBufferOverrun");
+    addTest(root, &TestGetSortKeys, "tscoll/capitst/TestGetSortKeys");
+    addTest(root, &TestGetSortKeyUTF8, "tscoll/capitst/TestGetSortKeyUTF8");
+    addTest(root, &TestSortStrings, "tscoll/capitst/TestSortStrings");
+    addTest(root, &TestSortKeyStore, "tscoll/capitst/TestSortKeyStore");
     addTest(root, &TestAttribute, "tscoll/capitst/TestAttribute");
     addTest(root, &TestGetTailoredSet, "tscoll/capitst/TestGetTailoredSet");
     addTest(root, &TestMergeSortKeys, "tscoll/capitst/TestMergeSortKeys");
@@ -1740,6 +1745,509 @@ void TestSortKeyBufferOverrun(void) {
     ucol_close(coll);
 }
 
+/*
+ * Generate the sort keys in several calls, growing the buffer whenever
+ * ucol_getSortKeys() stops early with U_BUFFER_OVERFLOW_ERROR,
+ * and compare with ucol_getSortKey().
+ */
+void TestGetSortKeys(void) {
+    static const char *const cStrings[] = {
+        "abc", "ABC", "c\\u00f4te", "cote\\u0302", "a\\u0323\\u0302", "", "x10",
+        "\\U0001F600", "\\u0F73\\u0F71\\u0F72",
+        "A very Merry liTTle-lamB.. A very Merry liTTle-lamB.. A very Merry liTTle-lamB.."
+    };
+    enum { COUNT = UPRV_LENGTHOF(cStrings) };
+    UChar uStrings[COUNT][100];
+    const UChar *strings[COUNT];
+    int32_t lengths[COUNT];
+    char utf8Strings[COUNT][300];
+    const char *strings8[COUNT];
+    int32_t lengths8[COUNT];
+    int32_t offsets[COUNT + 1], offsets8[COUNT + 1];
+    uint8_t *keys = NULL, *keys8 = NULL;
+    int32_t capacity = 4, capacity8 = 4;
+    int32_t i, n, n8, required, calls = 0;
+    UErrorCode status = U_ZERO_ERROR;
+    UCollator *coll = ucol_open("root", &status);
+    if (U_FAILURE(status)) {
+        log_err_status(status, "ucol_open(root) failed - %s\n", u_errorName(status));
+        return;
+    }
+    ucol_setAttribute(coll, UCOL_NORMALIZATION_MODE, UCOL_ON, &status);
+    for (i = 0; i < COUNT; ++i) {
+        lengths[i] = u_unescape(cStrings[i], uStrings[i], UPRV_LENGTHOF(uStrings[i]));
+        strings[i] = uStrings[i];
+        u_strToUTF8(utf8Strings[i], UPRV_LENGTHOF(utf8Strings[i]), &lengths8[i],
+                    uStrings[i], lengths[i], &status);
+        strings8[i] = utf8Strings[i];
+    }
+    keys = (uint8_t *)malloc(capacity);
+    keys8 = (uint8_t *)malloc(capacity8);
+
+    /* Resume at the first string whose key did not fit. */
+    for (n = 0; n < COUNT && U_SUCCESS(status); ++calls) {
+        int32_t done = n == 0 ? 0 : offsets[n];
+        int32_t written = ucol_getSortKeys(coll, strings + n, lengths + n, COUNT - n,
+                                           keys + done, capacity - done, offsets + n,
+                                           &required, &status);
+        /* The new offsets are relative to keys + done. */
+        for (i = n; i <= n + written; ++i) {
+            offsets[i] += done;
+        }
+        n += written;
+        if (n < COUNT) {
+            if (status != U_BUFFER_OVERFLOW_ERROR || required <= capacity - done) {
+                log_err("ucol_getSortKeys() stopped early with %s, required capacity %d\n",
+                        u_errorName(status), (int)required);
+                break;
+            }
+            status = U_ZERO_ERROR;
+            capacity *= 2;
+            if (capacity < done + required) {
+                capacity = done + required;
+            }
+            keys = (uint8_t *)realloc(keys, capacity);
+        } else if (required != offsets[COUNT] - done) {
+            log_err("ucol_getSortKeys() required capacity %d != %d\n",
+                    (int)required, (int)(offsets[COUNT] - done));
+        }
+    }
+    for (n8 = 0; n8 < COUNT && U_SUCCESS(status);) {
+        int32_t done = n8 == 0 ? 0 : offsets8[n8];
+        int32_t written = ucol_getSortKeysUTF8(coll, strings8 + n8, lengths8 + n8, COUNT - n8,
+                                               keys8 + done, capacity8 - done, offsets8 + n8,
+                                               &required, &status);
+        for (i = n8; i <= n8 + written; ++i) {
+            offsets8[i] += done;
+        }
+        n8 += written;
+        if (n8 < COUNT) {
+            if (status != U_BUFFER_OVERFLOW_ERROR || required <= capacity8 - done) {
+                log_err("ucol_getSortKeysUTF8() stopped early with %s, required capacity %d\n",
+                        u_errorName(status), (int)required);
+                break;
+            }
+            status = U_ZERO_ERROR;
+            capacity8 *= 2;
+            if (capacity8 < done + required) {
+                capacity8 = done + required;
+            }
+            keys8 = (uint8_t *)realloc(keys8, capacity8);
+        }
+    }
+    if (U_FAILURE(status)) {
+        log_err("ucol_getSortKeys() failed - %s\n", u_errorName(status));
+    } else {
+        if (calls < 2) {
+            log_err("ucol_getSortKeys() did not stop early for a small buffer\n");
+        }
+        for (i = 0; i < COUNT; ++i) {
+            uint8_t key[300];
+            int32_t length = ucol_getSortKey(coll, strings[i], lengths[i], key, UPRV_LENGTHOF(key));
+            if (length != offsets[i + 1] - offsets[i] ||
+                    0 != memcmp(key, keys + offsets[i], length)) {
+                log_err("ucol_getSortKeys() key %d differs from ucol_getSortKey()\n", (int)i);
+            }
+            if (offsets8[i + 1] != offsets[i + 1] ||
+                    0 != memcmp(keys8 + offsets8[i], keys + offsets[i], length)) {
+                log_err("ucol_getSortKeysUTF8() key %d differs from ucol_getSortKeys()\n", (int)i);
+            }
+        }
+    }
+
+    /* Illegal arguments. */
+    status = U_ZERO_ERROR;
+    ucol_getSortKeys(coll, strings, lengths, COUNT, NULL, 10, offsets, NULL, &status);
+    if (status != U_ILLEGAL_ARGUMENT_ERROR) {
+        log_err("ucol_getSortKeys(dest=NULL, destCapacity=10) did not fail - %s\n", u_errorName(status));
+    }
+
+    /* Not even the first key fits. */
+    status = U_ZERO_ERROR;
+    n = ucol_getSortKeys(coll, strings, lengths, COUNT, NULL, 0, offsets, &required, &status);
+    if (status != U_BUFFER_OVERFLOW_ERROR || n != 0 || offsets[0] != 0 ||
+            required != ucol_getSortKey(coll, strings[0], lengths[0], NULL, 0)) {
+        log_err("ucol_getSortKeys(dest=NULL, destCapacity=0) should return 0 "
+                "with U_BUFFER_OVERFLOW_ERROR and the first key length, got %d & %s & %d\n",
+                (int)n, u_errorName(status), (int)required);
+    }
+    status = U_ZERO_ERROR;
+    n8 = ucol_getSortKeysUTF8(coll, strings8 + COUNT - 1, lengths8 + COUNT - 1, 1,
+                              keys8, 4, offsets8, &required, &status);
+    if (status != U_BUFFER_OVERFLOW_ERROR || n8 != 0 || offsets8[0] != 0 ||
+            required != ucol_getSortKey(coll, strings[COUNT - 1], lengths[COUNT - 1], NULL, 0)) {
+        log_err("ucol_getSortKeysUTF8(destCapacity=4) should return 0 "
+                "with U_BUFFER_OVERFLOW_ERROR and the key length, got %d & %s & %d\n",
+                (int)n8, u_errorName(status), (int)required);
+    }
+    /* An empty batch fits into an empty buffer. */
+    status = U_ZERO_ERROR;
+    n = ucol_getSortKeys(coll, strings, lengths, 0, NULL, 0, offsets, &required, &status);
+    if (U_FAILURE(status) || n != 0 || offsets[0] != 0 || required != 0) {
+        log_err("ucol_getSortKeys(count=0) should return 0 - %s\n", u_errorName(status));
+    }
+    free(keys);
+    free(keys8);
+    ucol_close(coll);
+}
+
+void TestGetSortKeyUTF8(void) {
+    static const char *const cStrings[] = {
+        "abc", "ABC", "c\\u00f4te", "cote\\u0302", "a\\u0323\\u0302", "", "x10",
+        "\\U0001F600", "\\u0F73\\u0F71\\u0F72",
+        "A very Merry liTTle-lamB.. A very Merry liTTle-lamB.. A very Merry liTTle-lamB.."
+    };
+    UChar s16[100];
+    char s8[300];
+    uint8_t key[300], key8[300];
+    int32_t i, length, length8, length16;
+    UErrorCode status = U_ZERO_ERROR;
+    UCollator *coll = ucol_open("root", &status);
+    if (U_FAILURE(status)) {
+        log_err_status(status, "ucol_open(root) failed - %s\n", u_errorName(status));
+        return;
+    }
+    ucol_setAttribute(coll, UCOL_NORMALIZATION_MODE, UCOL_ON, &status);
+    for (i = 0; i < UPRV_LENGTHOF(cStrings) && U_SUCCESS(status); ++i) {
+        length16 = u_unescape(cStrings[i], s16, UPRV_LENGTHOF(s16));
+        u_strToUTF8(s8, UPRV_LENGTHOF(s8), &length8, s16, length16, &status);
+        length = ucol_getSortKey(coll, s16, length16, key, UPRV_LENGTHOF(key));
+        if (ucol_getSortKeyUTF8(coll, s8, length8, key8, UPRV_LENGTHOF(key8), &status) != length ||
+                U_FAILURE(status) || 0 != memcmp(key, key8, length)) {
+            log_err("ucol_getSortKeyUTF8(%d) differs from ucol_getSortKey() - %s\n",
+                    (int)i, u_errorName(status));
+        }
+        /* NUL-terminated */
+        if (ucol_getSortKeyUTF8(coll, s8, -1, key8, UPRV_LENGTHOF(key8), &status) != length ||
+                U_FAILURE(status) || 0 != memcmp(key, key8, length)) {
+            log_err("ucol_getSortKeyUTF8(%d, -1) differs from ucol_getSortKey() - %s\n",
+                    (int)i, u_errorName(status));
+        }
+        /* preflighting */
+        if (ucol_getSortKeyUTF8(coll, s8, length8, NULL, 0, &status) != length ||
+                status != U_BUFFER_OVERFLOW_ERROR) {
+            log_err("ucol_getSortKeyUTF8(%d, preflighting) failed - %s\n",
+                    (int)i, u_errorName(status));
+        }
+        status = U_ZERO_ERROR;
+    }
+
+    /* Ill-formed UTF-8 sorts like U+FFFD. */
+    s16[0] = 0x61;
+    s16[1] = s16[2] = 0xfffd;
+    s16[3] = 0x62;
+    length = ucol_getSortKey(coll, s16, 4, key, UPRV_LENGTHOF(key));
+    if (ucol_getSortKeyUTF8(coll, "a\xC0\x80" "b", 4, key8, UPRV_LENGTHOF(key8), &status) != length ||
+            U_FAILURE(status) || 0 != memcmp(key, key8, length)) {
+        log_err("ucol_getSortKeyUTF8(ill-formed) differs from ucol_getSortKey(U+FFFD) - %s\n",
+                u_errorName(status));
+    }
+
+    /* Illegal arguments. */
+    status = U_ZERO_ERROR;
+    ucol_getSortKeyUTF8(coll, NULL, 3, key8, UPRV_LENGTHOF(key8), &status);
+    if (status != U_ILLEGAL_ARGUMENT_ERROR) {
+        log_err("ucol_getSortKeyUTF8(source=NULL) did not fail - %s\n", u_errorName(status));
+    }
+    status = U_ZERO_ERROR;
+    ucol_getSortKeyUTF8(coll, "abc", 3, NULL, 10, &status);
+    if (status != U_ILLEGAL_ARGUMENT_ERROR) {
+        log_err("ucol_getSortKeyUTF8(result=NULL, resultLength=10) did not fail - %s\n",
+                u_errorName(status));
+    }
+    ucol_close(coll);
+}
+
+/*
+ * Sets strings[0..count-1] to pseudo-random, reproducible strings of up to five pieces
+ * with case and accent variants, digits, and empty strings,
+ * stored in uStrings, and sets their lengths.
+ */
+static void makeSortTestStrings(UChar (*uStrings)[40], const UChar **strings, int32_t *lengths,
+                                int32_t count) {
+    static const char *const pieces[] = {
+        "a", "A", "\\u00e0", "a\\u0300", "b", "-", "1", "10", "\\u4e00", ""
+    };
+    uint32_t seed = 1;
+    int32_t i, j;
+    for (i = 0; i < count; ++i) {
+        char s[100] = "";
+        int32_t length;
+        seed = seed * 1103515245 + 12345;
+        length = (int32_t)((seed >> 16) % 6);
+        for (j = 0; j < length; ++j) {
+            seed = seed * 1103515245 + 12345;
+            strcat(s, pieces[(seed >> 16) % UPRV_LENGTHOF(pieces)]);
+        }
+        lengths[i] = u_unescape(s, uStrings[i], UPRV_LENGTHOF(uStrings[i]));
+        strings[i] = uStrings[i];
+    }
+}
+
+void TestSortStrings(void) {
+    enum { COUNT = 300 };
+    UChar uStrings[COUNT][40];
+    const UChar *strings[COUNT];
+    int32_t lengths[COUNT];
+    char utf8Strings[COUNT][100];
+    const char *strings8[COUNT];
+    int32_t lengths8[COUNT];
+    int32_t permutation[COUNT], permutation8[COUNT];
+    int32_t i, n;
+    UErrorCode status = U_ZERO_ERROR;
+    UCollator *coll = ucol_open("root", &status);
+    if (U_FAILURE(status)) {
+        log_err_status(status, "ucol_open(root) failed - %s\n", u_errorName(status));
+        return;
+    }
+    makeSortTestStrings(uStrings, strings, lengths, COUNT);
+    for (i = 0; i < COUNT; ++i) {
+        u_strToUTF8(utf8Strings[i], UPRV_LENGTHOF(utf8Strings[i]), &lengths8[i],
+                    uStrings[i], lengths[i], &status);
+        strings8[i] = utf8Strings[i];
+    }
+    /* 30 strings are sorted by comparison, 300 via sort keys. */
+    for (n = 30; n <= COUNT && U_SUCCESS(status); n *= 10) {
+        ucol_sortStrings(coll, strings, lengths, n, permutation, 1, NULL, NULL, &status);
+        ucol_sortStringsUTF8(coll, strings8, NULL, n, permutation8, 1, NULL, NULL, &status);
+        if (U_FAILURE(status)) {
+            log_err("ucol_sortStrings(%d) failed - %s\n", (int)n, u_errorName(status));
+            break;
+        }
+        for (i = 1; i < n; ++i) {
+            int32_t p = permutation[i - 1], q = permutation[i];
+            UCollationResult order = ucol_strcoll(coll, strings[p], lengths[p], strings[q], lengths[q]);
+            if (order == UCOL_GREATER || (order == UCOL_EQUAL && p > q)) {
+                log_err("ucol_sortStrings(%d): strings %d and %d are out of order\n",
+                        (int)n, (int)p, (int)q);
+                break;
+            }
+        }
+        if (0 != memcmp(permutation, permutation8, n * sizeof(int32_t))) {
+            log_err("ucol_sortStringsUTF8(%d) differs from ucol_sortStrings()\n", (int)n);
+        }
+    }
+
+    /* Illegal arguments. */
+    status = U_ZERO_ERROR;
+    ucol_sortStrings(NULL, strings, lengths, COUNT, permutation, 1, NULL, NULL, &status);
+    if (status != U_ILLEGAL_ARGUMENT_ERROR) {
+        log_err("ucol_sortStrings(coll=NULL) did not fail - %s\n", u_errorName(status));
+    }
+    status = U_ZERO_ERROR;
+    ucol_sortStrings(coll, strings, lengths, COUNT, NULL, 1, NULL, NULL, &status);
+    if (status != U_ILLEGAL_ARGUMENT_ERROR) {
+        log_err("ucol_sortStrings(permutation=NULL) did not fail - %s\n", u_errorName(status));
+    }
+    ucol_close(coll);
+}
+
+/* Returns the number of sorted keys that are less than the query, or less than or equal to it. */
+static int32_t countKeysBefore(const uint8_t *keys, const int32_t *offsets, int32_t count,
+                               const uint8_t *query, UBool inclusive) {
+    int32_t i;
+    for (i = 0; i < count; ++i) {
+        int32_t cmp = strcmp((const char *)keys + offsets[i], (const char *)query);
+        if (cmp > 0 || (cmp == 0 && !inclusive)) {
+            break;
+        }
+    }
+    return i;
+}
+
+void TestSortKeyStore(void) {
+    enum { COUNT = 300 };
+    static const char *const cQueries[] = { "", "a", "AB", "b-", "zz", "\\u4e00\\u4e00" };
+    enum { QUERY_COUNT = COUNT + UPRV_LENGTHOF(cQueries) };
+    static const int32_t blockSizes[] = { 1, 5, 0 };
+    UChar uStrings[QUERY_COUNT][40];
+    const UChar *strings[QUERY_COUNT];
+    int32_t lengths[QUERY_COUNT];
+    const UChar *sorted[COUNT];
+    int32_t sortedLengths[COUNT];
+    int32_t permutation[COUNT];
+    int32_t offsets[COUNT + 1], queryOffsets[QUERY_COUNT + 1];
+    uint8_t *keys, *queryKeys;
+    int32_t i, b;
+    UErrorCode status = U_ZERO_ERROR;
+    UCollator *coll = ucol_open("root", &status);
+    if (U_FAILURE(status)) {
+        log_err_status(status, "ucol_open(root) failed - %s\n", u_errorName(status));
+        return;
+    }
+    makeSortTestStrings(uStrings, strings, lengths, COUNT);
+    for (i = COUNT; i < QUERY_COUNT; ++i) {
+        lengths[i] = u_unescape(cQueries[i - COUNT], uStrings[i], UPRV_LENGTHOF(uStrings[i]));
+        strings[i] = uStrings[i];
+    }
+    /* The stored keys are for the sorted strings; the queries are all of the strings. */
+    ucol_sortStrings(coll, strings, lengths, COUNT, permutation, 1, NULL, NULL, &status);
+    for (i = 0; i < COUNT; ++i) {
+        sorted[i] = strings[permutation[i]];
+        sortedLengths[i] = lengths[permutation[i]];
+    }
+    keys = (uint8_t *)malloc(COUNT * 100);
+    queryKeys = (uint8_t *)malloc(QUERY_COUNT * 100);
+    if (U_FAILURE(status) || keys == NULL || queryKeys == NULL ||
+            ucol_getSortKeys(coll, sorted, sortedLengths, COUNT,
+                             keys, COUNT * 100, offsets, NULL, &status) != COUNT ||
+            ucol_getSortKeys(coll, strings, lengths, QUERY_COUNT,
+                             queryKeys, QUERY_COUNT * 100, queryOffsets, NULL, &status) != QUERY_COUNT) {
+        log_err("unable to get the sort keys - %s\n", u_errorName(status));
+        free(keys);
+        free(queryKeys);
+        ucol_close(coll);
+        return;
+    }
+
+    for (b = 0; b < UPRV_LENGTHOF(blockSizes); ++b) {
+        int32_t blockSize = blockSizes[b];
+        int32_t length, actualLength;
+        uint32_t *data;
+        USortKeyStore *store;
+        status = U_ZERO_ERROR;
+        length = usortkeystore_build(keys, offsets, COUNT, blockSize, NULL, 0, &status);
+        if (status != U_BUFFER_OVERFLOW_ERROR) {
+            log_err("usortkeystore_build(blockSize=%d) preflighting - %s\n",
+                    (int)blockSize, u_errorName(status));
+            continue;
+        }
+        log_verbose("blockSize=%d: %d bytes for %d bytes of keys\n",
+                    (int)blockSize, (int)length, (int)offsets[COUNT]);
+        data = (uint32_t *)malloc(length);
+        status = U_ZERO_ERROR;
+        if (usortkeystore_build(keys, offsets, COUNT, blockSize, data, length, &status) != length ||
+                U_FAILURE(status)) {
+            log_err("usortkeystore_build(blockSize=%d) failed - %s\n",
+                    (int)blockSize, u_errorName(status));
+            free(data);
+            continue;
+        }
+        store = usortkeystore_openFromBinary(data, length, &actualLength, &status);
+        if (U_FAILURE(status) || actualLength != length || usortkeystore_getCount(store) != COUNT) {
+            log_err("usortkeystore_openFromBinary(blockSize=%d) failed - %s\n",
+                    (int)blockSize, u_errorName(status));
+            usortkeystore_close(store);
+            free(data);
+            continue;
+        }
+        for (i = 0; i < COUNT; ++i) {
+            uint8_t key[100];
+            int32_t keyLength = usortkeystore_getKey(store, i, key, UPRV_LENGTHOF(key), &status);
+            if (U_FAILURE(status) || keyLength != offsets[i + 1] - offsets[i] ||
+                    0 != memcmp(key, keys + offsets[i], keyLength)) {
+                log_err("usortkeystore_getKey(blockSize=%d, %d) differs from the original key - %s\n",
+                        (int)blockSize, (int)i, u_errorName(status));
+                break;
+            }
+        }
+        for (i = 0; i < QUERY_COUNT && U_SUCCESS(status); ++i) {
+            const uint8_t *query = queryKeys + queryOffsets[i];
+            int32_t queryLength = queryOffsets[i + 1] - queryOffsets[i];
+            int32_t level;
+            if (usortkeystore_lowerBound(store, query, -1, &status) !=
+                    countKeysBefore(keys, offsets, COUNT, query, FALSE) ||
+                    usortkeystore_upperBound(store, query, queryLength, &status) !=
+                    countKeysBefore(keys, offsets, COUNT, query, TRUE)) {
+                log_err("usortkeystore_lowerBound/upperBound(blockSize=%d, query %d) wrong\n",
+                        (int)blockSize, (int)i);
+            }
+            for (level = 1; level <= 3; ++level) {
+                UColBoundMode boundType = (level & 1) ? UCOL_BOUND_UPPER : UCOL_BOUND_UPPER_LONG;
+                uint8_t lower[100], upper[100];
+                int32_t start, limit;
+                ucol_getBound(query, -1, UCOL_BOUND_LOWER, level, lower, UPRV_LENGTHOF(lower), &status);
+                ucol_getBound(query, -1, boundType, level, upper, UPRV_LENGTHOF(upper), &status);
+                start = usortkeystore_getBoundRange(store, query, -1, boundType, level, &limit, &status);
+                if (U_FAILURE(status) ||
+                        start != countKeysBefore(keys, offsets, COUNT, lower, FALSE) ||
+                        limit != countKeysBefore(keys, offsets, COUNT, upper, TRUE)) {
+                    log_err("usortkeystore_getBoundRange(blockSize=%d, query %d, level %d) "
+                            "wrong [%d, %d[ - %s\n",
+                            (int)blockSize, (int)i, (int)level, (int)start, (int)limit,
+                            u_errorName(status));
+                }
+            }
+        }
+
+        /* Errors. */
+        status = U_ZERO_ERROR;
+        if (usortkeystore_getKey(store, 0, NULL, 0, &status) != offsets[1] - offsets[0] ||
+                status != U_BUFFER_OVERFLOW_ERROR) {
+            log_err("usortkeystore_getKey(preflighting) - %s\n", u_errorName(status));
+        }
+        status = U_ZERO_ERROR;
+        usortkeystore_getKey(store, COUNT, NULL, 0, &status);
+        if (status != U_INDEX_OUTOFBOUNDS_ERROR) {
+            log_err("usortkeystore_getKey(index=count) did not fail - %s\n", u_errorName(status));
+        }
+        usortkeystore_close(store);
+        status = U_ZERO_ERROR;
+        usortkeystore_openFromBinary(data, length - 4, NULL, &status);
+        if (status != U_INVALID_FORMAT_ERROR) {
+            log_err("usortkeystore_openFromBinary(truncated) did not fail - %s\n", u_errorName(status));
+        }
+        {
+            /* data[6..] are the block offsets, followed by the key data. */
+            int32_t blockCount = (COUNT + (int32_t)data[2] - 1) / (int32_t)data[2];
+            uint32_t *blockOffsets = data + 6;
+            uint8_t *keyData = (uint8_t *)(blockOffsets + blockCount + 1);
+            uint32_t savedOffset = blockOffsets[1];
+            blockOffsets[1] = blockOffsets[2] + 1;
+            status = U_ZERO_ERROR;
+            usortkeystore_openFromBinary(data, length, NULL, &status);
+            if (status != U_INVALID_FORMAT_ERROR) {
+                log_err("usortkeystore_openFromBinary(decreasing block offsets) did not fail - %s\n",
+                        u_errorName(status));
+            }
+            blockOffsets[1] = data[3] + 1;
+            status = U_ZERO_ERROR;
+            usortkeystore_openFromBinary(data, length, NULL, &status);
+            if (status != U_INVALID_FORMAT_ERROR) {
+                log_err("usortkeystore_openFromBinary(block offset beyond the key data) "
+                        "did not fail - %s\n", u_errorName(status));
+            }
+            blockOffsets[1] = savedOffset;
+            /* The second key cannot share more than the whole first key. */
+            if (data[2] >= 2 && keyData[0] < 0x7f && keyData[1 + keyData[0]] < 0x80) {
+                uint8_t savedShared = keyData[1 + keyData[0]];
+                keyData[1 + keyData[0]] = (uint8_t)(keyData[0] + 1);
+                status = U_ZERO_ERROR;
+                usortkeystore_openFromBinary(data, length, NULL, &status);
+                if (status != U_INVALID_FORMAT_ERROR) {
+                    log_err("usortkeystore_openFromBinary(shared prefix too long) did not fail - %s\n",
+                            u_errorName(status));
+                }
+                keyData[1 + keyData[0]] = savedShared;
+            }
+            status = U_ZERO_ERROR;
+            store = usortkeystore_openFromBinary(data, length, NULL, &status);
+            if (U_FAILURE(status)) {
+                log_err("usortkeystore_openFromBinary(restored data) failed - %s\n", u_errorName(status));
+            }
+            usortkeystore_close(store);
+        }
+        data[0] ^= 1;
+        status = U_ZERO_ERROR;
+        usortkeystore_openFromBinary(data, length, NULL, &status);
+        if (status != U_INVALID_FORMAT_ERROR) {
+            log_err("usortkeystore_openFromBinary(bad signature) did not fail - %s\n",
+                    u_errorName(status));
+        }
+        free(data);
+    }
+
+    /* The keys must be sorted. */
+    status = U_ZERO_ERROR;
+    usortkeystore_build(queryKeys, queryOffsets, QUERY_COUNT, 0, NULL, 0, &status);
+    if (status != U_ILLEGAL_ARGUMENT_ERROR) {
+        log_err("usortkeystore_build(unsorted keys) did not fail - %s\n", u_errorName(status));
+    }
+    free(keys);
+    free(queryKeys);
+    ucol_close(coll);
+}
+
 static void TestAttribute()
 {
     UErrorCode error = U_ZERO_ERROR;
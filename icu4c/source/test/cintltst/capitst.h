@@ -98,6 +98,22 @@
      * Test buffer overrun while having smaller buffer for sortkey (j1865)
      */
     void TestSortKeyBufferOverrun(void);
+    /**
+     * Test ucol_getSortKeys() and ucol_getSortKeysUTF8() with a growing buffer
+     */
+    void TestGetSortKeys(void);
+    /**
+     * Test ucol_getSortKeyUTF8() against ucol_getSortKey()
+     */
+    void TestGetSortKeyUTF8(void);
+    /**
+     * Test ucol_sortStrings() and ucol_sortStringsUTF8()
+     */
+    void TestSortStrings(void);
+    /**
+     * Test the USortKeyStore lookups against a linear search over the sort keys
+     */
+    void TestSortKeyStore(void);
     /**
      * Test getting and setting of attributes
      */
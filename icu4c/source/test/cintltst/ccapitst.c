@@ -83,6 +83,7 @@ static void TestSubstString(void);
 static void InvalidArguments(void);
 static void TestGetName(void);
 static void TestUTFBOM(void);
+static void TestConverterPool(void);
 
 void addTestConvert(TestNode** root);
 
@@ -120,6 +121,7 @@ void addTestConvert(TestNode** root)
     addTest(root, &InvalidArguments,            "tsconv/ccapitst/InvalidArguments");
     addTest(root, &TestGetName,                 "tsconv/ccapitst/TestGetName");
     addTest(root, &TestUTFBOM,                  "tsconv/ccapitst/TestUTFBOM");
+    addTest(root, &TestConverterPool,           "tsconv/ccapitst/TestConverterPool");
 }
 
 static void ListNames(void) {
@@ -3756,3 +3758,85 @@ static void TestUTFBOM() {
         ucnv_close(cnv);
     }
 }
+
+static void TestConverterPool() {
+    static const UChar text[] = { 0x61, 0xe4, 0x20ac, 0x7a };
+    char bytes[20];
+    int64_t hits0, misses0, hits, misses;
+    UConverter *cnv, *cnv2;
+    UErrorCode errorCode = U_ZERO_ERROR;
+
+    ucnv_getPoolStatistics(&hits0, &misses0);
+
+    cnv = ucnv_openPooled("UTF-8", &errorCode);
+    if (U_FAILURE(errorCode)) {
+        log_err("ucnv_openPooled(UTF-8) failed - %s\n", u_errorName(errorCode));
+        return;
+    }
+    /* Leave partial state behind; the pooled converter must come back reset. */
+    ucnv_fromUChars(cnv, bytes, (int32_t)sizeof(bytes), text, 1, &errorCode);
+    ucnv_returnToPool(cnv);
+
+    /* Different alias, same canonical name. */
+    cnv2 = ucnv_openPooled("utf8", &errorCode);
+    ucnv_getPoolStatistics(&hits, &misses);
+    if (U_FAILURE(errorCode) || cnv2 != cnv || hits != hits0 + 1 || misses != misses0 + 1) {
+        log_err("ucnv_openPooled(utf8) did not reuse the pooled converter: "
+                "%s hits +%d misses +%d\n",
+                u_errorName(errorCode), (int)(hits - hits0), (int)(misses - misses0));
+    }
+    if (ucnv_fromUCountPending(cnv2, &errorCode) != 0 || ucnv_toUCountPending(cnv2, &errorCode) != 0) {
+        log_err("pooled converter was not reset\n");
+    }
+
+    /* A converter with a custom substitution string is closed, not pooled. */
+    ucnv_setSubstChars(cnv2, "?", 1, &errorCode);
+    ucnv_returnToPool(cnv2);
+    cnv = ucnv_openPooled("UTF-8", &errorCode);
+    ucnv_getPoolStatistics(&hits, &misses);
+    if (U_FAILURE(errorCode) || hits != hits0 + 1 || misses != misses0 + 2) {
+        log_err("a modified converter was pooled: %s hits +%d misses +%d\n",
+                u_errorName(errorCode), (int)(hits - hits0), (int)(misses - misses0));
+    }
+    ucnv_returnToPool(cnv);
+
+    /* Names with options bypass the pool but still work. */
+    errorCode = U_ZERO_ERROR;
+    cnv = ucnv_openPooled("ibm-37,swaplfnl", &errorCode);
+    if (U_FAILURE(errorCode)) {
+        log_data_err("ucnv_openPooled(ibm-37,swaplfnl) failed - %s\n", u_errorName(errorCode));
+    } else {
+        ucnv_returnToPool(cnv);
+        cnv = ucnv_openPooled("ibm-37,swaplfnl", &errorCode);
+        ucnv_getPoolStatistics(&hits, &misses);
+        if (U_FAILURE(errorCode) || hits != hits0 + 1 || misses != misses0 + 4) {
+            log_err("a converter with options was pooled: %s hits +%d misses +%d\n",
+                    u_errorName(errorCode), (int)(hits - hits0), (int)(misses - misses0));
+        }
+        ucnv_returnToPool(cnv);
+    }
+
+    /* ucnv_flushCache() closes pooled converters so that their data can be unloaded. */
+    errorCode = U_ZERO_ERROR;
+    ucnv_flushCache();
+    cnv = ucnv_openPooled("ibm-1047", &errorCode);
+    if (U_FAILURE(errorCode)) {
+        log_data_err("ucnv_openPooled(ibm-1047) failed - %s\n", u_errorName(errorCode));
+    } else {
+        int32_t length;
+        ucnv_returnToPool(cnv);
+        if (ucnv_flushCache() != 1) {
+            log_err("ucnv_flushCache() did not release the pooled ibm-1047 converter\n");
+        }
+        cnv = ucnv_openPooled("ibm-1047", &errorCode);
+        length = ucnv_fromUChars(cnv, bytes, (int32_t)sizeof(bytes), text, 1, &errorCode);
+        if (U_FAILURE(errorCode) || length != 1 || bytes[0] != (char)0x81) {
+            log_err("ibm-1047 converter from the pool after ucnv_flushCache() failed - %s\n",
+                    u_errorName(errorCode));
+        }
+        ucnv_returnToPool(cnv);
+    }
+
+    ucnv_returnToPool(NULL);
+    ucnv_getPoolStatistics(NULL, NULL);
+}
@@ -58,6 +58,7 @@ void addCollIterTest(TestNode** root)
     addTest(root, &TestSmallBuffer, "tscoll/citertst/TestSmallBuffer");
     addTest(root, &TestDiscontiguos, "tscoll/citertst/TestDiscontiguos");
     addTest(root, &TestSearchCollatorElements, "tscoll/citertst/TestSearchCollatorElements");
+    addTest(root, &TestNextCEs, "tscoll/citertst/TestNextCEs");
 }
 
 /* The locales we support */
@@ -1258,4 +1259,86 @@ static void TestSearchCollatorElements(void)
     }
 }
 
+static void TestNextCEs(void)
+{
+    static const char *const locales[] = { "root", "ja", "th", "ko", "es@collation=traditional" };
+    static const int32_t capacities[] = { 1, 3, 200 };
+    int32_t l, c;
+    for (l = 0; l < UPRV_LENGTHOF(locales); ++l) {
+        UErrorCode status = U_ZERO_ERROR;
+        UCollator *coll = ucol_open(locales[l], &status);
+        UCollationElements *uce;
+        int32_t orders[200], orderOffsets[200];
+        int32_t orderCount = 0;
+        if (U_FAILURE(status)) {
+            log_data_err("error, locale %s, ucol_open failed: %s\n", locales[l], u_errorName(status));
+            continue;
+        }
+        ucol_setAttribute(coll, UCOL_NORMALIZATION_MODE, UCOL_ON, &status);
+        uce = ucol_openElements(coll, tsceText, kLen_tsceText, &status);
+        if (U_FAILURE(status)) {
+            log_err("error, locale %s, ucol_openElements failed: %s\n", locales[l], u_errorName(status));
+            ucol_close(coll);
+            continue;
+        }
+        for (;;) {
+            int32_t order = ucol_next(uce, &status);
+            if (order == UCOL_NULLORDER || orderCount == UPRV_LENGTHOF(orders)) { break; }
+            orderOffsets[orderCount] = ucol_getOffset(uce);
+            orders[orderCount++] = order;
+        }
+
+        for (c = 0; c < UPRV_LENGTHOF(capacities); ++c) {
+            int64_t ces[200];
+            int32_t offsets[200];
+            int32_t i, j = 0, length = 0, n;
+            ucol_reset(uce);
+            do {
+                n = ucol_nextCEs(uce, ces + length, offsets + length, capacities[c], &status);
+                length += n;
+            } while (n == capacities[c] && length + capacities[c] <= UPRV_LENGTHOF(ces));
+            if (U_FAILURE(status)) {
+                log_err("error, locale %s, ucol_nextCEs failed: %s\n", locales[l], u_errorName(status));
+                break;
+            }
+            /* Split each 64-bit CE like ucol_next() does. */
+            for (i = 0; i < length && j < orderCount; ++i) {
+                uint32_t p = (uint32_t)(ces[i] >> 32);
+                uint32_t lower32 = (uint32_t)ces[i];
+                uint32_t firstHalf = (p & 0xffff0000) | ((lower32 >> 16) & 0xff00) | ((lower32 >> 8) & 0xff);
+                uint32_t secondHalf = (p << 16) | ((lower32 >> 8) & 0xff00) | (lower32 & 0x3f);
+                if ((uint32_t)orders[j] != firstHalf || orderOffsets[j] != offsets[i] ||
+                        (secondHalf != 0 &&
+                            (++j == orderCount || (uint32_t)orders[j] != (secondHalf | 0xc0)))) {
+                    log_err("error, locale %s, capacity %d: ucol_nextCEs CE %d differs from ucol_next\n",
+                            locales[l], (int)capacities[c], (int)i);
+                    break;
+                }
+                ++j;
+            }
+            if (i != length || j != orderCount) {
+                log_err("error, locale %s, capacity %d: ucol_nextCEs returned %d CEs for %d orders\n",
+                        locales[l], (int)capacities[c], (int)length, (int)orderCount);
+            }
+            if (ucol_nextCEs(uce, ces, NULL, UPRV_LENGTHOF(ces), &status) != 0) {
+                log_err("error, locale %s, ucol_nextCEs returned CEs at the end of the text\n", locales[l]);
+            }
+        }
+
+        /* Same as ucol_next(), ucol_nextCEs() does not continue backward iteration. */
+        ucol_reset(uce);
+        ucol_previous(uce, &status);
+        {
+            int64_t ce;
+            ucol_nextCEs(uce, &ce, NULL, 1, &status);
+            if (status != U_INVALID_STATE_ERROR) {
+                log_err("error, locale %s, ucol_nextCEs after ucol_previous did not fail - %s\n",
+                        locales[l], u_errorName(status));
+            }
+        }
+        ucol_closeElements(uce);
+        ucol_close(coll);
+    }
+}
+
 #endif /* #if !UCONFIG_NO_COLLATION */
@@ -90,6 +90,10 @@ static void TestDiscontiguos(void);
 * normalization on AND jamo tailoring, among other things.
 */
 static void TestSearchCollatorElements(void);
+/**
+* Tests that ucol_nextCEs() returns the same CEs and offsets as ucol_next().
+*/
+static void TestNextCEs(void);
 
 /*------------------------------------------------------------------------
  Internal utilities
@@ -38,6 +38,7 @@ static void Test_strFromUTF32_surrogates(void);
 static void Test_UChar_UTF8_API(void);
 static void Test_FromUTF8(void);
 static void Test_FromUTF8Lenient(void);
+static void Test_UTF8ASCIIRuns(void);
 static void Test_UChar_WCHART_API(void);
 static void Test_widestrs(void);
 static void Test_WCHART_LongString(void);
@@ -55,6 +56,7 @@ addUCharTransformTest(TestNode** root)
    addTest(root, &Test_UChar_UTF8_API, "custrtrn/Test_UChar_UTF8_API");
    addTest(root, &Test_FromUTF8, "custrtrn/Test_FromUTF8");
    addTest(root, &Test_FromUTF8Lenient, "custrtrn/Test_FromUTF8Lenient");
+   addTest(root, &Test_UTF8ASCIIRuns, "custrtrn/Test_UTF8ASCIIRuns");
    addTest(root, &Test_UChar_WCHART_API,  "custrtrn/Test_UChar_WCHART_API");
    addTest(root, &Test_widestrs,  "custrtrn/Test_widestrs");
 #if !UCONFIG_NO_FILE_IO && !UCONFIG_NO_LEGACY_CONVERSION
@@ -928,6 +930,66 @@ Test_FromUTF8(void) {
     }
 }
 
+/*
+ * Test ASCII runs of many lengths between non-ASCII characters,
+ * to exercise the block-at-a-time ASCII copying in u_strFromUTF8WithSub()
+ * and u_strToUTF8WithSub() at every block boundary,
+ * with and without enough destination capacity.
+ */
+static void
+Test_UTF8ASCIIRuns(void) {
+    static const UChar32 nonASCII[]={ 0xe9, 0x4e2d, 0x1f600 };
+    char utf8[2000], utf8Out[2000];
+    UChar utf16[1000], utf16Out[1000];
+    int32_t utf8Length=0, utf16Length=0, runLength, i, capacity, destLength;
+    UErrorCode errorCode;
+
+    for(runLength=0; runLength<=40; ++runLength) {
+        for(i=0; i<runLength; ++i) {
+            char c=(char)(0x21+(runLength+i)%0x5e);
+            utf8[utf8Length++]=c;
+            utf16[utf16Length++]=(UChar)c;
+        }
+        {
+            UChar32 c=nonASCII[runLength%UPRV_LENGTHOF(nonASCII)];
+            UBool isError=FALSE;
+            U8_APPEND((uint8_t *)utf8, utf8Length, UPRV_LENGTHOF(utf8), c, isError);
+            U16_APPEND_UNSAFE(utf16, utf16Length, c);
+            (void)isError;
+        }
+    }
+    /* Trailing ASCII run. */
+    for(i=0; i<37; ++i) {
+        utf8[utf8Length++]='a';
+        utf16[utf16Length++]=0x61;
+    }
+
+    for(capacity=0; capacity<=utf16Length+1; capacity+=(capacity<40 ? 1 : 23)) {
+        errorCode=U_ZERO_ERROR;
+        destLength=-99;
+        u_strFromUTF8WithSub(capacity==0 ? NULL : utf16Out, capacity, &destLength,
+                             utf8, utf8Length, 0xfffd, NULL, &errorCode);
+        if(destLength!=utf16Length ||
+                (capacity>=utf16Length ? U_FAILURE(errorCode) : errorCode!=U_BUFFER_OVERFLOW_ERROR) ||
+                (capacity>=utf16Length && 0!=u_memcmp(utf16, utf16Out, utf16Length))) {
+            log_err("error: u_strFromUTF8WithSub(ASCII runs, capacity=%ld) fails: destLength=%ld - %s\n",
+                    (long)capacity, (long)destLength, u_errorName(errorCode));
+        }
+    }
+    for(capacity=0; capacity<=utf8Length+1; capacity+=(capacity<40 ? 1 : 23)) {
+        errorCode=U_ZERO_ERROR;
+        destLength=-99;
+        u_strToUTF8WithSub(capacity==0 ? NULL : utf8Out, capacity, &destLength,
+                           utf16, utf16Length, 0xfffd, NULL, &errorCode);
+        if(destLength!=utf8Length ||
+                (capacity>=utf8Length ? U_FAILURE(errorCode) : errorCode!=U_BUFFER_OVERFLOW_ERROR) ||
+                (capacity>=utf8Length && 0!=uprv_memcmp(utf8, utf8Out, utf8Length))) {
+            log_err("error: u_strToUTF8WithSub(ASCII runs, capacity=%ld) fails: destLength=%ld - %s\n",
+                    (long)capacity, (long)destLength, u_errorName(errorCode));
+        }
+    }
+}
+
 /* test u_strFromUTF8Lenient() */
 static void
 Test_FromUTF8Lenient(void) {
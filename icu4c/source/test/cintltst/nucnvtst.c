@@ -43,6 +43,7 @@ static void TestSignatureDetection(void);
 static void TestUTF7(void);
 static void TestIMAP(void);
 static void TestUTF8(void);
+static void TestUTF8BulkOffsets(void);
 static void TestCESU8(void);
 static void TestUTF16(void);
 static void TestUTF16BE(void);
@@ -259,6 +260,7 @@ void addTestNewConvert(TestNode** root)
    addTest(root, &TestUTF7, "tsconv/nucnvtst/TestUTF7");
    addTest(root, &TestIMAP, "tsconv/nucnvtst/TestIMAP");
    addTest(root, &TestUTF8, "tsconv/nucnvtst/TestUTF8");
+   addTest(root, &TestUTF8BulkOffsets, "tsconv/nucnvtst/TestUTF8BulkOffsets");
 
    /* test ucnv_getNextUChar() for charsets that encode single surrogates with complete byte sequences */
    addTest(root, &TestCESU8, "tsconv/nucnvtst/TestCESU8");
@@ -1961,6 +1963,194 @@ static void TestUTF8() {
     ucnv_close(cnv);
 }
 
+/*
+ * Converts UTF-8 to UTF-16 with at most srcChunk input bytes and destChunk output units
+ * per call, and checks the offsets of each call against the expected ones.
+ * Offsets are relative to the source pointer at the start of each call,
+ * or -1 for output that belongs to a character started in an earlier call.
+ */
+static void
+checkUTF8ChunkedToUnicode(UConverter *cnv,
+                          const uint8_t *utf8, int32_t utf8Length,
+                          const UChar *utf16, int32_t utf16Length,
+                          const int32_t *expOffsets,
+                          int32_t srcChunk, int32_t destChunk) {
+    UChar out[1000];
+    int32_t offsets[1000];
+    const char *src=(const char *)utf8, *srcLimit=src+utf8Length;
+    UChar *dest=out, *outLimit=out+UPRV_LENGTHOF(out);
+    UErrorCode errorCode=U_ZERO_ERROR;
+
+    ucnv_reset(cnv);
+    for(;;) {
+        const char *callSrc=src;
+        const char *chunkLimit=(srcLimit-src)>srcChunk ? src+srcChunk : srcLimit;
+        UChar *callDest=dest;
+        UChar *destLimit=(outLimit-dest)>destChunk ? dest+destChunk : outLimit;
+        UBool flush=(UBool)(chunkLimit==srcLimit);
+        int32_t i;
+
+        ucnv_toUnicode(cnv, &dest, destLimit, &src, chunkLimit, offsets+(callDest-out),
+                       flush, &errorCode);
+        for(i=(int32_t)(callDest-out); i<(int32_t)(dest-out) && i<utf16Length; ++i) {
+            int32_t expected=expOffsets[i]-(int32_t)(callSrc-(const char *)utf8);
+            if(offsets[i]!=(expected>=0 ? expected : -1)) {
+                log_err("UTF-8 chunked toUnicode (%d/%d): offsets[%d]=%d but expected %d\n",
+                        srcChunk, destChunk, i, offsets[i], expected>=0 ? expected : -1);
+                return;
+            }
+        }
+        if(errorCode==U_BUFFER_OVERFLOW_ERROR) {
+            errorCode=U_ZERO_ERROR;
+        } else if(U_FAILURE(errorCode)) {
+            log_err("UTF-8 chunked toUnicode (%d/%d) failed - %s\n",
+                    srcChunk, destChunk, u_errorName(errorCode));
+            return;
+        } else if(flush) {
+            break;
+        }
+    }
+    if((dest-out)!=utf16Length || 0!=u_memcmp(utf16, out, utf16Length)) {
+        log_err("UTF-8 chunked toUnicode (%d/%d) produced the wrong output\n",
+                srcChunk, destChunk);
+    }
+}
+
+/* Same as checkUTF8ChunkedToUnicode() but from UTF-16 to UTF-8. */
+static void
+checkUTF8ChunkedFromUnicode(UConverter *cnv,
+                            const UChar *utf16, int32_t utf16Length,
+                            const uint8_t *utf8, int32_t utf8Length,
+                            const int32_t *expOffsets,
+                            int32_t srcChunk, int32_t destChunk) {
+    char out[1200];
+    int32_t offsets[1200];
+    const UChar *src=utf16, *srcLimit=src+utf16Length;
+    char *dest=out, *outLimit=out+UPRV_LENGTHOF(out);
+    UErrorCode errorCode=U_ZERO_ERROR;
+
+    ucnv_reset(cnv);
+    for(;;) {
+        const UChar *callSrc=src;
+        const UChar *chunkLimit=(srcLimit-src)>srcChunk ? src+srcChunk : srcLimit;
+        char *callDest=dest;
+        char *destLimit=(outLimit-dest)>destChunk ? dest+destChunk : outLimit;
+        UBool flush=(UBool)(chunkLimit==srcLimit);
+        int32_t i;
+
+        ucnv_fromUnicode(cnv, &dest, destLimit, &src, chunkLimit, offsets+(callDest-out),
+                         flush, &errorCode);
+        for(i=(int32_t)(callDest-out); i<(int32_t)(dest-out) && i<utf8Length; ++i) {
+            int32_t expected=expOffsets[i]-(int32_t)(callSrc-utf16);
+            if(offsets[i]!=(expected>=0 ? expected : -1)) {
+                log_err("UTF-8 chunked fromUnicode (%d/%d): offsets[%d]=%d but expected %d\n",
+                        srcChunk, destChunk, i, offsets[i], expected>=0 ? expected : -1);
+                return;
+            }
+        }
+        if(errorCode==U_BUFFER_OVERFLOW_ERROR) {
+            errorCode=U_ZERO_ERROR;
+        } else if(U_FAILURE(errorCode)) {
+            log_err("UTF-8 chunked fromUnicode (%d/%d) failed - %s\n",
+                    srcChunk, destChunk, u_errorName(errorCode));
+            return;
+        } else if(flush) {
+            break;
+        }
+    }
+    if((dest-out)!=utf8Length || 0!=uprv_memcmp(utf8, out, utf8Length)) {
+        log_err("UTF-8 chunked fromUnicode (%d/%d) produced the wrong output\n",
+                srcChunk, destChunk);
+    }
+}
+
+/*
+ * Long runs of ASCII and of multi-byte characters, and an ill-formed sequence,
+ * converted each way with offsets, in one call and in small chunks
+ * so that the bulk loop stops at source and target buffer boundaries.
+ * Exercises the bulk conversion of well-formed text in the UTF-8 converter.
+ */
+static void TestUTF8BulkOffsets() {
+    static const UChar32 cps[]={ 0xe9, 0x4e2d, 0x1f600 };
+    static const int32_t chunkLengths[]={ 1, 2, 3, 5, 16, 61, 2000 };
+    uint8_t utf8[1200], utf8Out[1200];
+    UChar utf16[1000], utf16Out[1000];
+    int32_t toUOffsets[1000], fromUOffsets[1200], expToUOffsets[1000], expFromUOffsets[1200];
+    int32_t utf8Length=0, utf16Length=0, run, i;
+    const char *src;
+    char *dest;
+    const UChar *src16;
+    UChar *dest16;
+    UErrorCode errorCode=U_ZERO_ERROR;
+    UConverter *cnv=ucnv_open("UTF-8", &errorCode);
+    if(U_FAILURE(errorCode)) {
+        log_data_err("Unable to open a UTF-8 converter: %s\n", u_errorName(errorCode));
+        return;
+    }
+
+    for(run=0; run<24; ++run) {
+        for(i=0; i<run+13; ++i) {
+            expToUOffsets[utf16Length]=utf8Length;
+            expFromUOffsets[utf8Length]=utf16Length;
+            utf16[utf16Length++]=(UChar)(0x41+i%26);
+            utf8[utf8Length++]=(uint8_t)(0x41+i%26);
+        }
+        for(i=0; i<run%5; ++i) {
+            UChar32 c=cps[(run+i)%3];
+            int32_t j, start8=utf8Length, start16=utf16Length;
+            U8_APPEND_UNSAFE(utf8, utf8Length, c);
+            U16_APPEND_UNSAFE(utf16, utf16Length, c);
+            for(j=start16; j<utf16Length; ++j) { expToUOffsets[j]=start8; }
+            for(j=start8; j<utf8Length; ++j) { expFromUOffsets[j]=start16; }
+        }
+    }
+
+    src=(const char *)utf8;
+    dest16=utf16Out;
+    ucnv_toUnicode(cnv, &dest16, utf16Out+UPRV_LENGTHOF(utf16Out), &src, src+utf8Length,
+                   toUOffsets, TRUE, &errorCode);
+    if(U_FAILURE(errorCode) || (dest16-utf16Out)!=utf16Length ||
+            0!=u_memcmp(utf16, utf16Out, utf16Length) ||
+            0!=uprv_memcmp(expToUOffsets, toUOffsets, utf16Length*4)) {
+        log_err("UTF-8 bulk toUnicode with offsets failed - %s\n", u_errorName(errorCode));
+    }
+
+    src16=utf16;
+    dest=(char *)utf8Out;
+    ucnv_fromUnicode(cnv, &dest, (char *)utf8Out+UPRV_LENGTHOF(utf8Out), &src16, src16+utf16Length,
+                     fromUOffsets, TRUE, &errorCode);
+    if(U_FAILURE(errorCode) || (dest-(char *)utf8Out)!=utf8Length ||
+            0!=uprv_memcmp(utf8, utf8Out, utf8Length) ||
+            0!=uprv_memcmp(expFromUOffsets, fromUOffsets, utf8Length*4)) {
+        log_err("UTF-8 bulk fromUnicode with offsets failed - %s\n", u_errorName(errorCode));
+    }
+
+    /* Small source and target buffers split characters across calls. */
+    for(i=0; i<UPRV_LENGTHOF(chunkLengths); ++i) {
+        int32_t j;
+        for(j=0; j<UPRV_LENGTHOF(chunkLengths); ++j) {
+            checkUTF8ChunkedToUnicode(cnv, utf8, utf8Length, utf16, utf16Length, expToUOffsets,
+                                      chunkLengths[i], chunkLengths[j]);
+            checkUTF8ChunkedFromUnicode(cnv, utf16, utf16Length, utf8, utf8Length, expFromUOffsets,
+                                        chunkLengths[i], chunkLengths[j]);
+        }
+    }
+
+    /* An ill-formed byte in the first ASCII run is substituted, and conversion continues. */
+    utf8[5]=0xff;
+    utf16[5]=0xfffd;
+    src=(const char *)utf8;
+    dest16=utf16Out;
+    ucnv_toUnicode(cnv, &dest16, utf16Out+UPRV_LENGTHOF(utf16Out), &src, src+utf8Length,
+                   NULL, TRUE, &errorCode);
+    if(U_FAILURE(errorCode) || (dest16-utf16Out)!=utf16Length ||
+            0!=u_memcmp(utf16, utf16Out, utf16Length)) {
+        log_err("UTF-8 bulk toUnicode with an ill-formed byte failed - %s\n", u_errorName(errorCode));
+    }
+
+    ucnv_close(cnv);
+}
+
 static void TestCESU8() {
     /* test input */
     static const uint8_t in[]={
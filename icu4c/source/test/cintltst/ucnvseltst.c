@@ -33,12 +33,14 @@
 
 static void TestSelector(void);
 static void TestUPropsVector(void);
+static void TestUnpairedSurrogates(void);
 void addCnvSelTest(TestNode** root);  /* Declaration required to suppress compiler warnings. */
 
 void addCnvSelTest(TestNode** root)
 {
     addTest(root, &TestSelector, "tsconv/ucnvseltst/TestSelector");
     addTest(root, &TestUPropsVector, "tsconv/ucnvseltst/TestUPropsVector");
+    addTest(root, &TestUnpairedSurrogates, "tsconv/ucnvseltst/TestUnpairedSurrogates");
 }
 
 static const char **gAvailableNames = NULL;
@@ -347,6 +349,33 @@ static void verifyResult(UEnumeration* res, const UBool *resultsManually) {
   uenum_close(res);
 }
 
+/* checks each of count consecutive masks from ucnvsel_select*Strings() */
+static void verifyMasks(const UConverterSelector *sel, const uint32_t *masks, int32_t count,
+                        const UBool *resultsManually) {
+  UErrorCode status = U_ZERO_ERROR;
+  int32_t num_encodings = ucnvsel_countEncodings(sel, &status);
+  int32_t columns = (num_encodings + 31) / 32;
+  int32_t i, j;
+
+  for (j = 0; j < count; ++j, masks += columns) {
+    for (i = 0; i < num_encodings; ++i) {
+      const char *name = ucnvsel_getEncodingName(sel, i, &status);
+      UBool fromMask = (UBool)((masks[i >> 5] >> (i & 31)) & 1);
+      int32_t encIndex;
+      if (U_FAILURE(status)) {
+        log_err("ucnvsel_getEncodingName(%ld) failed - %s\n", (long)i, u_errorName(status));
+        return;
+      }
+      encIndex = findIndex(name);
+      if (resultsManually[encIndex] != fromMask) {
+        log_err("failure in converter selector batch mode\n"
+                "converter %s had conflicting results for string %ld -- manual: %d, system %d\n",
+                name, (long)j, resultsManually[encIndex], fromMask);
+      }
+    }
+  }
+}
+
 static UConverterSelector *
 serializeAndUnserialize(UConverterSelector *sel, char **buffer, UErrorCode *status) {
   char *new_buffer;
@@ -380,6 +409,7 @@ static void TestSelector()
 {
   TestText text;
   USet* excluded_sets[3] = { NULL };
+  uint32_t *masks;
   int32_t i, testCaseIdx;
 
   if (!getAvailableNames()) {
@@ -390,6 +420,8 @@ static void TestSelector()
   }
 
   excluded_sets[0] = uset_openEmpty();
+  /* masks for a batch of the same string twice, with and without length */
+  masks = (uint32_t *)uprv_malloc(2 * ((gCountAvailable + 31) / 32) * 4);
   for(i = 1 ; i < 3 ; i++) {
     excluded_sets[i] = uset_open(i*30, i*30+500);
   }
@@ -469,6 +501,28 @@ static void TestSelector()
         /* UTF-8 NUL-terminated */
         verifyResult(ucnvsel_selectForUTF8(sel_rt, s, -1, &status), manual_rt);
         verifyResult(ucnvsel_selectForUTF8(sel_fb, s, -1, &status), manual_fb);
+        /* UTF-8 batch */
+        {
+          const char *strings8[2];
+          int32_t lengths[2], masksLength;
+          strings8[0] = strings8[1] = s;
+          lengths[0] = length8;
+          lengths[1] = -1;
+          masksLength = ucnvsel_selectForUTF8Strings(sel_rt, strings8, lengths, 2, NULL, 0, &status);
+          if (status != U_BUFFER_OVERFLOW_ERROR || masksLength != 2 * ((num_encodings + 31) / 32)) {
+            log_err("ucnvsel_selectForUTF8Strings(preflighting) failed - %s, length %ld\n",
+                    u_errorName(status), (long)masksLength);
+          }
+          status = U_ZERO_ERROR;
+          ucnvsel_selectForUTF8Strings(sel_rt, strings8, lengths, 2, masks, masksLength, &status);
+          verifyMasks(sel_rt, masks, 2, manual_rt);
+          ucnvsel_selectForUTF8Strings(sel_fb, strings8, lengths, 2, masks, masksLength, &status);
+          verifyMasks(sel_fb, masks, 2, manual_fb);
+          if (U_FAILURE(status)) {
+            log_err("ucnvsel_selectForUTF8Strings() failed - %s\n", u_errorName(status));
+            status = U_ZERO_ERROR;
+          }
+        }
 
         u_strFromUTF8(utf16, UPRV_LENGTHOF(utf16), &length16, s, length8, &status);
         if (U_FAILURE(status)) {
@@ -485,6 +539,22 @@ static void TestSelector()
             /* UTF-16 NUL-terminated */
             verifyResult(ucnvsel_selectForString(sel_rt, utf16, -1, &status), manual_rt);
             verifyResult(ucnvsel_selectForString(sel_fb, utf16, -1, &status), manual_fb);
+            /* UTF-16 batch */
+            {
+              const UChar *strings16[2];
+              int32_t lengths[2], masksLength;
+              strings16[0] = strings16[1] = utf16;
+              lengths[0] = length16;
+              lengths[1] = -1;
+              masksLength = ucnvsel_selectForStrings(sel_rt, strings16, lengths, 2,
+                                                     masks, 2 * ((num_encodings + 31) / 32), &status);
+              verifyMasks(sel_rt, masks, 2, manual_rt);
+              ucnvsel_selectForStrings(sel_fb, strings16, lengths, 2, masks, masksLength, &status);
+              verifyMasks(sel_fb, masks, 2, manual_fb);
+              if (U_FAILURE(status)) {
+                log_err("ucnvsel_selectForStrings() failed - %s\n", u_errorName(status));
+              }
+            }
           }
         }
 
@@ -498,6 +568,7 @@ static void TestSelector()
     uprv_free((void *)encodings);
   }
 
+  uprv_free(masks);
   releaseAvailableNames();
   text_close(&text);
   for(i = 0 ; i < 3 ; i++) {
@@ -538,3 +609,65 @@ static void TestUPropsVector() {
 
     upvec_close(pv);
 }
+
+/*
+ * An unpaired lead surrogate is looked up with its lead code unit value,
+ * as with the original UTrie2 macros, which ignores the excluded code points.
+ * An unpaired trail surrogate is looked up with its code point value.
+ */
+static void TestUnpairedSurrogates() {
+    static const char *const names[] = { "ISO-8859-1", "windows-1252", "Shift_JIS" };
+    static const UChar lead[] = { 0x61, 0xd800, 0x62 };
+    static const UChar leadAtEnd[] = { 0x61, 0xdbff };
+    static const UChar trail[] = { 0x61, 0xdc00, 0x62 };
+    const UChar *strings[3];
+    int32_t lengths[3];
+    uint32_t masks[3];
+    UErrorCode errorCode = U_ZERO_ERROR;
+    USet *surrogates = uset_open(0xd800, 0xdfff);
+    UConverterSelector *sel = ucnvsel_open(names, UPRV_LENGTHOF(names), surrogates,
+                                           UCNV_ROUNDTRIP_SET, &errorCode);
+    UEnumeration *e;
+    int32_t count;
+    uset_close(surrogates);
+    if (U_FAILURE(errorCode)) {
+        log_data_err("ucnvsel_open() failed - %s\n", u_errorName(errorCode));
+        return;
+    }
+
+    e = ucnvsel_selectForString(sel, lead, UPRV_LENGTHOF(lead), &errorCode);
+    count = uenum_count(e, &errorCode);
+    uenum_close(e);
+    if (U_FAILURE(errorCode) || count != 0) {
+        log_err("ucnvsel_selectForString(isolated lead surrogate) selected %ld converters - %s\n",
+                (long)count, u_errorName(errorCode));
+    }
+    e = ucnvsel_selectForString(sel, leadAtEnd, UPRV_LENGTHOF(leadAtEnd), &errorCode);
+    count = uenum_count(e, &errorCode);
+    uenum_close(e);
+    if (U_FAILURE(errorCode) || count != 0) {
+        log_err("ucnvsel_selectForString(lead surrogate at end) selected %ld converters - %s\n",
+                (long)count, u_errorName(errorCode));
+    }
+    e = ucnvsel_selectForString(sel, trail, UPRV_LENGTHOF(trail), &errorCode);
+    count = uenum_count(e, &errorCode);
+    uenum_close(e);
+    if (U_FAILURE(errorCode) || count != UPRV_LENGTHOF(names)) {
+        log_err("ucnvsel_selectForString(isolated trail surrogate) selected %ld converters - %s\n",
+                (long)count, u_errorName(errorCode));
+    }
+
+    /* the batch function uses the same lookup */
+    strings[0] = lead;
+    strings[1] = leadAtEnd;
+    strings[2] = trail;
+    lengths[0] = UPRV_LENGTHOF(lead);
+    lengths[1] = UPRV_LENGTHOF(leadAtEnd);
+    lengths[2] = UPRV_LENGTHOF(trail);
+    ucnvsel_selectForStrings(sel, strings, lengths, 3, masks, UPRV_LENGTHOF(masks), &errorCode);
+    if (U_FAILURE(errorCode) || masks[0] != 0 || masks[1] != 0 || masks[2] != 7) {
+        log_err("ucnvsel_selectForStrings(unpaired surrogates) = { %lx, %lx, %lx } - %s\n",
+                (long)masks[0], (long)masks[1], (long)masks[2], u_errorName(errorCode));
+    }
+    ucnvsel_close(sel);
+}
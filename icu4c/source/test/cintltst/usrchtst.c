@@ -15,6 +15,7 @@
 #if !UCONFIG_NO_COLLATION && !UCONFIG_NO_BREAK_ITERATION && !UCONFIG_NO_FILE_IO
 
 #include "unicode/usearch.h"
+#include "unicode/umsearch.h"
 #include "unicode/ustring.h"
 #include "ccolltst.h"
 #include "cmemory.h"
@@ -3044,6 +3045,231 @@ static void TestIndicPrefixMatch(void)
     close();
 }
 
+/*
+ * Searches a long text made of a few letters, so that there are many partial matches
+ * which the search must skip correctly, and compares with a simple character-by-character search.
+ */
+static void TestLongTextMatches(void)
+{
+    enum { TEXT_LENGTH = 3000 };
+    /* a A b B c a-acute; at primary strength all a's are equal, at secondary only a and A */
+    static const UChar letters[] = { 0x61, 0x41, 0x62, 0x42, 0x63, 0xe1 };
+    static const UChar primaryKeys[] = { 0x61, 0x61, 0x62, 0x62, 0x63, 0x61 };
+    static const UChar secondaryKeys[] = { 0x61, 0x61, 0x62, 0x62, 0x63, 0xe1 };
+    static const char *const patterns[] = { "b", "ab", "abcab", "aab", "ba\\u00e1b", "bbbbbb", "cbabcabca" };
+    static const UCollationStrength strengths[] = { UCOL_PRIMARY, UCOL_SECONDARY };
+    UChar text[TEXT_LENGTH];
+    uint32_t seed = 1;
+    int32_t i, p, st;
+    UErrorCode status = U_ZERO_ERROR;
+    UCollator *coll = ucol_open("root", &status);
+    if (U_FAILURE(status)) {
+        log_err_status(status, "ucol_open(root) failed - %s\n", u_errorName(status));
+        return;
+    }
+    for (i = 0; i < TEXT_LENGTH; ++i) {
+        seed = seed * 1103515245 + 12345;
+        /* Favor a and b for more partial matches. */
+        text[i] = letters[(seed >> 16) % 5 == 4 ? (seed >> 20) % 6 : (seed >> 16) % 4];
+    }
+    for (st = 0; st < UPRV_LENGTHOF(strengths); ++st) {
+        const UChar *keys = strengths[st] == UCOL_PRIMARY ? primaryKeys : secondaryKeys;
+        ucol_setStrength(coll, strengths[st]);
+        for (p = 0; p < UPRV_LENGTHOF(patterns); ++p) {
+            UChar pattern[20], patternKeys[20];
+            int32_t patternLength = u_unescape(patterns[p], pattern, UPRV_LENGTHOF(pattern));
+            int32_t expected = -1, match, count = 0;
+            UStringSearch *search;
+            for (i = 0; i < patternLength; ++i) {
+                int32_t j = 0;
+                while (letters[j] != pattern[i]) { ++j; }
+                patternKeys[i] = keys[j];
+            }
+            status = U_ZERO_ERROR;
+            search = usearch_openFromCollator(pattern, patternLength, text, TEXT_LENGTH,
+                                              coll, NULL, &status);
+            usearch_setAttribute(search, USEARCH_OVERLAP, USEARCH_ON, &status);
+            if (U_FAILURE(status)) {
+                log_err("usearch_openFromCollator(%s) failed - %s\n", patterns[p], u_errorName(status));
+                continue;
+            }
+            for (match = usearch_first(search, &status);; match = usearch_next(search, &status)) {
+                /* Find the next expected match. */
+                for (++expected; expected <= TEXT_LENGTH - patternLength; ++expected) {
+                    int32_t j = 0;
+                    while (j < patternLength) {
+                        int32_t k = 0;
+                        while (letters[k] != text[expected + j]) { ++k; }
+                        if (keys[k] != patternKeys[j]) { break; }
+                        ++j;
+                    }
+                    if (j == patternLength) { break; }
+                }
+                if (expected > TEXT_LENGTH - patternLength) {
+                    expected = USEARCH_DONE;
+                }
+                if (U_FAILURE(status) || match != expected ||
+                        (match != USEARCH_DONE && usearch_getMatchedLength(search) != patternLength)) {
+                    log_err("strength %d, pattern %s: match %d at %d, expected at %d - %s\n",
+                            (int)strengths[st], patterns[p], (int)count, (int)match, (int)expected,
+                            u_errorName(status));
+                    break;
+                }
+                if (match == USEARCH_DONE) { break; }
+                ++count;
+            }
+            log_verbose("strength %d, pattern %s: %d matches\n", (int)strengths[st], patterns[p], (int)count);
+            usearch_close(search);
+        }
+    }
+    ucol_close(coll);
+}
+
+/*
+ * Searches for a set of patterns with a UMultiStringSearch
+ * and compares with the matches of one UStringSearch per pattern, with overlap.
+ * The patterns share prefixes and suffixes, and one is duplicated.
+ * The text has combining marks and expansions, which exercise the match validation.
+ */
+static void TestMultiPattern(void)
+{
+    enum { TEXT_LENGTH = 2000, MAX_MATCHES = 1000 };
+    /* a b A c a-acute combining-acute sharp-s space */
+    static const UChar letters[] = { 0x61, 0x62, 0x41, 0x63, 0xe1, 0x301, 0xdf, 0x20 };
+    static const char *const patternStrings[] = {
+        "ab", "b", "bab", "abab", "ab", "s", "ss", "a\\u0301b", "\\u00e1", "c a", "b\\u00dfa", "A"
+    };
+    static const UCollationStrength strengths[] = { UCOL_PRIMARY, UCOL_TERTIARY, UCOL_IDENTICAL };
+    enum { PATTERN_COUNT = UPRV_LENGTHOF(patternStrings) };
+    UChar text[TEXT_LENGTH];
+    UChar patternBuffers[PATTERN_COUNT][20];
+    const UChar *patterns[PATTERN_COUNT];
+    int32_t patternLengths[PATTERN_COUNT];
+    static int32_t expected[PATTERN_COUNT][MAX_MATCHES][2];
+    static const UChar shortText[] = { 0x78, 0x62, 0x61, 0x62, 0x79 };  /* xbaby */
+    static const UChar acute[] = { 0x301 };
+    /*
+     * Matches of (pattern, start, limit, only at primary strength) in xbaby,
+     * ordered by their last CE, longer patterns first, and equal patterns in order.
+     */
+    static const int32_t shortTextMatches[][4] = {
+        { 1, 1, 2, 0 }, { 8, 2, 3, 1 }, { 11, 2, 3, 1 }, { 2, 1, 4, 0 },
+        { 0, 2, 4, 0 }, { 4, 2, 4, 0 }, { 7, 2, 4, 1 }, { 1, 3, 4, 0 }
+    };
+    int32_t expectedCounts[PATTERN_COUNT];
+    uint32_t seed = 1;
+    int32_t i, p, st;
+    UErrorCode status = U_ZERO_ERROR;
+    UCollator *coll = ucol_open("root", &status);
+    if (U_FAILURE(status)) {
+        log_err_status(status, "ucol_open(root) failed - %s\n", u_errorName(status));
+        return;
+    }
+    for (i = 0; i < TEXT_LENGTH; ++i) {
+        seed = seed * 1103515245 + 12345;
+        text[i] = letters[(seed >> 16) % UPRV_LENGTHOF(letters)];
+    }
+    for (p = 0; p < PATTERN_COUNT; ++p) {
+        patternLengths[p] = u_unescape(patternStrings[p], patternBuffers[p], 20);
+        patterns[p] = patternBuffers[p];
+    }
+    for (st = 0; st < UPRV_LENGTHOF(strengths); ++st) {
+        UMultiStringSearch *msearch;
+        int32_t counts[PATTERN_COUNT] = { 0 };
+        int32_t patternIndex, start, limit, total = 0;
+        ucol_setStrength(coll, strengths[st]);
+        for (p = 0; p < PATTERN_COUNT; ++p) {
+            int32_t match;
+            UStringSearch *search;
+            status = U_ZERO_ERROR;
+            search = usearch_openFromCollator(patterns[p], patternLengths[p], text, TEXT_LENGTH,
+                                              coll, NULL, &status);
+            usearch_setAttribute(search, USEARCH_OVERLAP, USEARCH_ON, &status);
+            expectedCounts[p] = 0;
+            for (match = usearch_first(search, &status);
+                    U_SUCCESS(status) && match != USEARCH_DONE && expectedCounts[p] < MAX_MATCHES;
+                    match = usearch_next(search, &status)) {
+                expected[p][expectedCounts[p]][0] = match;
+                expected[p][expectedCounts[p]][1] = match + usearch_getMatchedLength(search);
+                ++expectedCounts[p];
+            }
+            if (U_FAILURE(status)) {
+                log_err("strength %d, pattern %s: usearch failed - %s\n",
+                        (int)strengths[st], patternStrings[p], u_errorName(status));
+            }
+            usearch_close(search);
+        }
+
+        status = U_ZERO_ERROR;
+        msearch = umsearch_open(patterns, patternLengths, PATTERN_COUNT, text, TEXT_LENGTH,
+                                coll, NULL, &status);
+        if (U_FAILURE(status)) {
+            log_err("strength %d: umsearch_open() failed - %s\n", (int)strengths[st], u_errorName(status));
+            continue;
+        }
+        while (umsearch_next(msearch, &patternIndex, &start, &limit, &status)) {
+            int32_t n = counts[patternIndex]++;
+            ++total;
+            if (n >= expectedCounts[patternIndex] ||
+                    start != expected[patternIndex][n][0] || limit != expected[patternIndex][n][1]) {
+                log_err("strength %d, pattern %s: match %d at [%d, %d[ not expected\n",
+                        (int)strengths[st], patternStrings[patternIndex], (int)n, (int)start, (int)limit);
+                break;
+            }
+        }
+        if (U_FAILURE(status)) {
+            log_err("strength %d: umsearch_next() failed - %s\n", (int)strengths[st], u_errorName(status));
+        }
+        for (p = 0; p < PATTERN_COUNT; ++p) {
+            if (counts[p] != expectedCounts[p]) {
+                log_err("strength %d, pattern %s: %d matches, expected %d\n",
+                        (int)strengths[st], patternStrings[p], (int)counts[p], (int)expectedCounts[p]);
+            }
+        }
+        log_verbose("strength %d: %d matches\n", (int)strengths[st], (int)total);
+
+        /* Search the same text again, and then a short one. */
+        status = U_ZERO_ERROR;
+        umsearch_setText(msearch, text, TEXT_LENGTH, &status);
+        for (i = 0; umsearch_next(msearch, NULL, NULL, NULL, &status); ++i) {}
+        if (U_FAILURE(status) || i != total) {
+            log_err("strength %d: %d matches after umsearch_setText(), expected %d - %s\n",
+                    (int)strengths[st], (int)i, (int)total, u_errorName(status));
+        }
+        umsearch_setText(msearch, shortText, UPRV_LENGTHOF(shortText), &status);
+        for (i = 0; i < UPRV_LENGTHOF(shortTextMatches); ++i) {
+            const int32_t *m = shortTextMatches[i];
+            if (strengths[st] != UCOL_PRIMARY && m[3]) {
+                continue;
+            }
+            if (!umsearch_next(msearch, &patternIndex, &start, &limit, &status) ||
+                    patternIndex != m[0] || start != m[1] || limit != m[2]) {
+                log_err("strength %d: match %d in xbaby is %d at [%d, %d[, expected %d at [%d, %d[ - %s\n",
+                        (int)strengths[st], (int)i, (int)patternIndex, (int)start, (int)limit,
+                        (int)m[0], (int)m[1], (int)m[2], u_errorName(status));
+                break;
+            }
+        }
+        if (umsearch_next(msearch, &patternIndex, &start, &limit, &status) ||
+                patternIndex != -1 || start != -1 || limit != -1) {
+            log_err("strength %d: too many matches in xbaby\n", (int)strengths[st]);
+        }
+        umsearch_close(msearch);
+    }
+
+    /* Completely ignorable patterns are rejected. */
+    ucol_setStrength(coll, UCOL_PRIMARY);
+    status = U_ZERO_ERROR;
+    patterns[0] = acute;
+    patternLengths[0] = 1;
+    umsearch_close(umsearch_open(patterns, patternLengths, 1, text, TEXT_LENGTH, coll, NULL, &status));
+    if (status != U_ILLEGAL_ARGUMENT_ERROR) {
+        log_err("umsearch_open(ignorable pattern) - %s, expected U_ILLEGAL_ARGUMENT_ERROR\n",
+                u_errorName(status));
+    }
+    ucol_close(coll);
+}
+
 /**
 * addSearchTest
 */
@@ -3108,6 +3334,8 @@ void addSearchTest(TestNode** root)
     addTest(root, &TestMatchFollowedByIgnorables, "tscoll/usrchtst/TestMatchFollowedByIgnorables");
     addTest(root, &TestIndicPrefixMatch, "tscoll/usrchtst/TestIndicPrefixMatch");
     addTest(root, &TestUInt16Overflow, "tscoll/usrchtst/TestUInt16Overflow");
+    addTest(root, &TestLongTextMatches, "tscoll/usrchtst/TestLongTextMatches");
+    addTest(root, &TestMultiPattern, "tscoll/usrchtst/TestMultiPattern");
 }
 
 #endif /* #if !UCONFIG_NO_COLLATION */
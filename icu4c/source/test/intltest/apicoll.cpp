@@ -44,9 +44,11 @@
 #include "unicode/strenum.h"
 #include "unicode/ustring.h"
 #include "unicode/ucol.h"
+#include "unicode/bytestream.h"
 
 #include "sfwdchit.h"
 #include "cmemory.h"
+#include "simplethread.h"
 #include <stdlib.h>
 
 void
@@ -1284,6 +1286,312 @@ void CollationAPITest::TestSortKeyOverflow() {
     }
 }
 
+void CollationAPITest::TestSortKeys() {
+    IcuTestErrorCode errorCode(*this, "TestSortKeys()");
+    LocalPointer<RuleBasedCollator> coll(dynamic_cast<RuleBasedCollator *>(
+        Collator::createInstance(Locale::getFrench(), errorCode)));
+    if (errorCode.errDataIfFailureAndReset("Collator::createInstance(French) failed")) {
+        return;
+    }
+    // Include text that is not FCD, a long string, and an empty one.
+    UnicodeString strings[] = {
+        UnicodeString(u"abc"), UnicodeString(u"ABC"), UnicodeString(u"c\u00F4te"),
+        UnicodeString(u"cote\u0302"), UnicodeString(u"a\u0323\u0302"), UnicodeString(u"\u1EAD"),
+        UnicodeString(), UnicodeString(u"x10"), UnicodeString(u"x9"),
+        UnicodeString(u"\uFFFD\U0001F600"), UnicodeString(u"\u0F73\u0F71\u0F72"),
+        UnicodeString(u"\u4E00\u30AB\u3099"), UnicodeString()
+    };
+    const int32_t count = UPRV_LENGTHOF(strings);
+    UnicodeString longString;
+    for (int32_t i = 0; i < 300; ++i) {
+        longString.append(u"e\u0301", 2).append((UChar)(0x61 + i % 26));
+    }
+    strings[count - 1] = longString;
+    const UChar *p16[count];
+    int32_t lengths16[count];
+    std::string strings8[count];
+    const char *p8[count];
+    int32_t lengths8[count];
+    for (int32_t i = 0; i < count; ++i) {
+        // Also usable as NUL-terminated strings.
+        p16[i] = strings[i].getTerminatedBuffer();
+        lengths16[i] = strings[i].length();
+        strings[i].toUTF8String(strings8[i]);
+        p8[i] = strings8[i].c_str();
+        lengths8[i] = static_cast<int32_t>(strings8[i].length());
+    }
+    static const struct {
+        UColAttribute attr;
+        UColAttributeValue value;
+    } settings[] = {
+        { UCOL_NORMALIZATION_MODE, UCOL_OFF },
+        { UCOL_NORMALIZATION_MODE, UCOL_ON },
+        { UCOL_NUMERIC_COLLATION, UCOL_ON },
+        { UCOL_ALTERNATE_HANDLING, UCOL_SHIFTED },
+        { UCOL_STRENGTH, UCOL_IDENTICAL }
+    };
+    for (int32_t si = 0; si < UPRV_LENGTHOF(settings); ++si) {
+        coll->setAttribute(settings[si].attr, settings[si].value, errorCode);
+        std::string keys16, keys8, keysTerminated;
+        int32_t offsets16[count + 1], offsets8[count + 1], offsetsTerminated[count + 1];
+        StringByteSink<std::string> sink16(&keys16), sink8(&keys8), sinkTerminated(&keysTerminated);
+        coll->getSortKeys(p16, lengths16, count, sink16, offsets16, errorCode);
+        coll->getSortKeysUTF8(p8, lengths8, count, sink8, offsets8, errorCode);
+        coll->getSortKeys(p16, nullptr, count, sinkTerminated, offsetsTerminated, errorCode);
+        if (errorCode.errIfFailureAndReset("getSortKeys() setting %d", (int)si)) {
+            continue;
+        }
+        if (offsets16[0] != 0 || offsets16[count] != (int32_t)keys16.length()) {
+            errln("getSortKeys() setting %d: wrong offsets[0] or offsets[count]", (int)si);
+            continue;
+        }
+        if (keys8 != keys16 || keysTerminated != keys16 ||
+                0 != uprv_memcmp(offsets8, offsets16, sizeof(offsets16)) ||
+                0 != uprv_memcmp(offsetsTerminated, offsets16, sizeof(offsets16))) {
+            errln("getSortKeys() setting %d: UTF-8 or NUL-terminated keys differ", (int)si);
+        }
+        for (int32_t i = 0; i < count; ++i) {
+            uint8_t key[6000];
+            int32_t length = coll->getSortKey(strings[i], key, UPRV_LENGTHOF(key));
+            if (length != offsets16[i + 1] - offsets16[i] ||
+                    0 != uprv_memcmp(key, keys16.data() + offsets16[i], length)) {
+                errln("getSortKeys() setting %d: key %d differs from getSortKey()", (int)si, (int)i);
+            }
+        }
+    }
+
+    // Illegal arguments.
+    std::string keys;
+    StringByteSink<std::string> sink(&keys);
+    int32_t offsets[3];
+    const UChar *withNull[2] = { u"a", nullptr };
+    int32_t withNullLengths[2] = { 1, 3 };
+    coll->getSortKeys(withNull, withNullLengths, 2, sink, offsets, errorCode);
+    errorCode.expectErrorAndReset(U_ILLEGAL_ARGUMENT_ERROR, "getSortKeys(NULL string)");
+    coll->getSortKeys(withNull, withNullLengths, 1, sink, nullptr, errorCode);
+    errorCode.expectErrorAndReset(U_ILLEGAL_ARGUMENT_ERROR, "getSortKeys(offsets=NULL)");
+    coll->getSortKeys(nullptr, nullptr, 0, sink, offsets, errorCode);
+    if (!errorCode.errIfFailureAndReset("getSortKeys(count=0)") && offsets[0] != 0) {
+        errln("getSortKeys(count=0) did not set offsets[0]=0");
+    }
+}
+
+void CollationAPITest::TestSortKeyUTF8() {
+    IcuTestErrorCode errorCode(*this, "TestSortKeyUTF8()");
+    LocalPointer<Collator> coll(Collator::createInstance(Locale::getFrench(), errorCode));
+    if (errorCode.errDataIfFailureAndReset("Collator::createInstance(French) failed")) {
+        return;
+    }
+    // Include text that is not FCD, ill-formed UTF-8, a long string, and an empty one.
+    const UnicodeString strings[] = {
+        UnicodeString(u"abc"), UnicodeString(u"ABC"), UnicodeString(u"c\u00F4te"),
+        UnicodeString(u"cote\u0302"), UnicodeString(u"a\u0323\u0302"), UnicodeString(u"\u1EAD"),
+        UnicodeString(), UnicodeString(u"x10"), UnicodeString(u"x9"),
+        UnicodeString(u"\U0001F600"), UnicodeString(u"\u0F73\u0F71\u0F72"),
+        UnicodeString(u"\u4E00\u30AB\u3099")
+    };
+    std::string strings8[UPRV_LENGTHOF(strings) + 4] = {
+        "a\xC0\x80" "b", "\xE0\x80z\xF4\x90\x80\x80", "\xED\xA0\x80\xCC"
+    };
+    const int32_t count = UPRV_LENGTHOF(strings8);
+    for (int32_t i = 0; i < UPRV_LENGTHOF(strings); ++i) {
+        strings[i].toUTF8String(strings8[3 + i]);
+    }
+    UnicodeString longString;
+    for (int32_t i = 0; i < 300; ++i) {
+        longString.append(u"e\u0301", 2).append((UChar)(0x61 + i % 26));
+    }
+    longString.toUTF8String(strings8[count - 1]);
+    static const struct {
+        UColAttribute attr;
+        UColAttributeValue value;
+    } settings[] = {
+        { UCOL_NORMALIZATION_MODE, UCOL_OFF },
+        { UCOL_NORMALIZATION_MODE, UCOL_ON },
+        { UCOL_NUMERIC_COLLATION, UCOL_ON },
+        { UCOL_ALTERNATE_HANDLING, UCOL_SHIFTED },
+        { UCOL_STRENGTH, UCOL_IDENTICAL }
+    };
+    for (int32_t si = 0; si < UPRV_LENGTHOF(settings); ++si) {
+        coll->setAttribute(settings[si].attr, settings[si].value, errorCode);
+        for (int32_t i = 0; i < count; ++i) {
+            std::string key8;
+            StringByteSink<std::string> sink(&key8);
+            coll->getSortKeyUTF8(strings8[i], sink, errorCode);
+            if (errorCode.errIfFailureAndReset("getSortKeyUTF8() setting %d string %d",
+                                               (int)si, (int)i)) {
+                continue;
+            }
+            // Ill-formed sequences sort like U+FFFD, as with UnicodeString::fromUTF8().
+            UnicodeString s16 = UnicodeString::fromUTF8(strings8[i]);
+            uint8_t key[6000];
+            int32_t length = coll->getSortKey(s16, key, UPRV_LENGTHOF(key));
+            if (length != (int32_t)key8.length() || 0 != uprv_memcmp(key, key8.data(), length)) {
+                errln("getSortKeyUTF8() setting %d: key %d differs from getSortKey()",
+                      (int)si, (int)i);
+            }
+        }
+    }
+
+    std::string key8;
+    StringByteSink<std::string> sink(&key8);
+    coll->getSortKeyUTF8(StringPiece(nullptr, 3), sink, errorCode);
+    errorCode.expectErrorAndReset(U_ILLEGAL_ARGUMENT_ERROR, "getSortKeyUTF8(NULL string)");
+    coll->getSortKeyUTF8(StringPiece(nullptr, 0), sink, errorCode);
+    if (!errorCode.errIfFailureAndReset("getSortKeyUTF8(empty NULL string)") &&
+            (key8.empty() || key8.back() != 0)) {
+        errln("getSortKeyUTF8(empty NULL string) did not write a terminated key");
+    }
+}
+
+namespace {
+
+// Checks that the permutation sorts the strings stably.
+void checkSortedPermutation(IntlTest &test, const Collator &coll, const char *name,
+                            const UnicodeString strings[], int32_t count,
+                            const int32_t permutation[]) {
+    LocalArray<UBool> seen(new UBool[count]);
+    for (int32_t i = 0; i < count; ++i) {
+        seen[i] = FALSE;
+    }
+    for (int32_t i = 0; i < count; ++i) {
+        int32_t p = permutation[i];
+        if (p < 0 || p >= count || seen[p]) {
+            test.errln("%s: not a permutation at [%d]=%d", name, (int)i, (int)p);
+            return;
+        }
+        seen[p] = TRUE;
+    }
+    UErrorCode errorCode = U_ZERO_ERROR;
+    for (int32_t i = 1; i < count; ++i) {
+        int32_t p = permutation[i - 1], q = permutation[i];
+        UCollationResult order = coll.compare(strings[p], strings[q], errorCode);
+        if (order == UCOL_GREATER || (order == UCOL_EQUAL && p > q)) {
+            test.errln("%s: strings [%d] and [%d] at %d are out of order",
+                       name, (int)p, (int)q, (int)i);
+            return;
+        }
+    }
+}
+
+}  // namespace
+
+void CollationAPITest::TestSortStrings() {
+    IcuTestErrorCode errorCode(*this, "TestSortStrings()");
+    LocalPointer<RuleBasedCollator> coll(dynamic_cast<RuleBasedCollator *>(
+        Collator::createInstance(Locale::getFrench(), errorCode)));
+    if (errorCode.errDataIfFailureAndReset("Collator::createInstance(French) failed")) {
+        return;
+    }
+    // Pseudo-random strings with many equal ones, equal prefixes,
+    // and case, accent and normalization variants.
+    static const char16_t *const pieces[] = {
+        u"a", u"A", u"\u00E0", u"a\u0300", u"b", u"c\u00F4", u"co\u0302", u"-", u" ",
+        u"1", u"10", u"\u0E40\u0E01", u"\u4E00", u"\u30AB", u"\uFFFD", u"\U0001F600", u""
+    };
+    const int32_t count = 20000;
+    LocalArray<UnicodeString> strings(new UnicodeString[count]);
+    uint32_t seed = 1;
+    for (int32_t i = 0; i < count; ++i) {
+        seed = seed * 1103515245 + 12345;
+        int32_t length = (seed >> 16) % 8;
+        for (int32_t j = 0; j < length; ++j) {
+            seed = seed * 1103515245 + 12345;
+            strings[i].append(pieces[(seed >> 16) % UPRV_LENGTHOF(pieces)]);
+        }
+    }
+    for (int32_t i = 0; i < 300; ++i) {
+        strings[count - 1 - i % 3].append(u"e\u0301", 2);  // long equal prefixes
+    }
+    LocalArray<const UChar *> p16(new const UChar *[count]);
+    LocalArray<int32_t> lengths16(new int32_t[count]);
+    LocalArray<std::string> strings8(new std::string[count]);
+    LocalArray<const char *> p8(new const char *[count]);
+    LocalArray<int32_t> lengths8(new int32_t[count]);
+    for (int32_t i = 0; i < count; ++i) {
+        // Also usable as NUL-terminated strings.
+        p16[i] = strings[i].getTerminatedBuffer();
+        lengths16[i] = strings[i].length();
+        strings[i].toUTF8String(strings8[i]);
+        p8[i] = strings8[i].c_str();
+        lengths8[i] = static_cast<int32_t>(strings8[i].length());
+    }
+    LocalArray<int32_t> permutation(new int32_t[count]), permutation2(new int32_t[count]);
+    // Fewer strings are sorted by comparison, more of these short strings via sort keys.
+    static const int32_t counts[] = { 0, 1, 2, 40, 500, count };
+    for (int32_t ci = 0; ci < UPRV_LENGTHOF(counts); ++ci) {
+        int32_t n = counts[ci];
+        for (int32_t threads = 1; threads <= 4; threads *= 4) {
+            // One thread: No runner, all of the work is done on this thread.
+            UTaskRunner runner = threads > 1 ? runTasksOnThreads : nullptr;
+            coll->sortStrings(p16.getAlias(), lengths16.getAlias(), n,
+                              permutation.getAlias(), threads, runner, nullptr, errorCode);
+            if (errorCode.errIfFailureAndReset("sortStrings(%d strings, %d threads)",
+                                               (int)n, (int)threads)) {
+                continue;
+            }
+            checkSortedPermutation(*this, *coll, "sortStrings()",
+                                   strings.getAlias(), n, permutation.getAlias());
+            // The result is unique, so the other variants must yield the same.
+            coll->sortStringsUTF8(p8.getAlias(), lengths8.getAlias(), n,
+                                  permutation2.getAlias(), threads, runner, nullptr, errorCode);
+            if (!errorCode.errIfFailureAndReset("sortStringsUTF8(%d strings)", (int)n) &&
+                    0 != uprv_memcmp(permutation.getAlias(), permutation2.getAlias(),
+                                     n * sizeof(int32_t))) {
+                errln("sortStringsUTF8(%d strings, %d threads) differs from sortStrings()",
+                      (int)n, (int)threads);
+            }
+            coll->sortStrings(p16.getAlias(), nullptr, n, permutation2.getAlias(),
+                              threads, runner, nullptr, errorCode);
+            if (!errorCode.errIfFailureAndReset("sortStrings(%d NUL-terminated)", (int)n) &&
+                    0 != uprv_memcmp(permutation.getAlias(), permutation2.getAlias(),
+                                     n * sizeof(int32_t))) {
+                errln("sortStrings(%d NUL-terminated strings, %d threads) differs",
+                      (int)n, (int)threads);
+            }
+        }
+    }
+    // Many strings with long sort keys are also sorted by comparison.
+    const int32_t longCount = 2000;
+    LocalArray<UnicodeString> longStrings(new UnicodeString[longCount]);
+    for (int32_t i = 0; i < longCount; ++i) {
+        longStrings[i].setTo(u"Lorem ipsum dolor sit amet, consectetur adipiscing elit, ");
+        longStrings[i].append(strings[i]).append(u" sed do eiusmod tempor");
+        p16[i] = longStrings[i].getTerminatedBuffer();
+        lengths16[i] = longStrings[i].length();
+    }
+    for (int32_t threads = 1; threads <= 4; threads *= 4) {
+        coll->sortStrings(p16.getAlias(), lengths16.getAlias(), longCount, permutation.getAlias(),
+                          threads, threads > 1 ? runTasksOnThreads : nullptr, nullptr, errorCode);
+        if (!errorCode.errIfFailureAndReset("sortStrings(long strings, %d threads)", (int)threads)) {
+            checkSortedPermutation(*this, *coll, "sortStrings(long strings)",
+                                   longStrings.getAlias(), longCount, permutation.getAlias());
+        }
+    }
+    for (int32_t i = 0; i < longCount; ++i) {
+        p16[i] = strings[i].getTerminatedBuffer();
+        lengths16[i] = strings[i].length();
+    }
+
+    // At identical strength, only identical strings keep their input order.
+    coll->setAttribute(UCOL_STRENGTH, UCOL_IDENTICAL, errorCode);
+    coll->sortStrings(p16.getAlias(), lengths16.getAlias(), count, permutation.getAlias(),
+                      4, runTasksOnThreads, nullptr, errorCode);
+    if (!errorCode.errIfFailureAndReset("sortStrings(identical)")) {
+        checkSortedPermutation(*this, *coll, "sortStrings(identical)",
+                               strings.getAlias(), count, permutation.getAlias());
+    }
+
+    // Illegal arguments.
+    const UChar *withNull[2] = { u"a", nullptr };
+    coll->sortStrings(withNull, nullptr, 2, permutation.getAlias(), 1, nullptr, nullptr, errorCode);
+    errorCode.expectErrorAndReset(U_ILLEGAL_ARGUMENT_ERROR, "sortStrings(NULL string)");
+    coll->sortStrings(withNull, nullptr, 1, nullptr, 1, nullptr, nullptr, errorCode);
+    errorCode.expectErrorAndReset(U_ILLEGAL_ARGUMENT_ERROR, "sortStrings(permutation=NULL)");
+    coll->sortStrings(withNull, nullptr, -1, permutation.getAlias(), 1, nullptr, nullptr, errorCode);
+    errorCode.expectErrorAndReset(U_ILLEGAL_ARGUMENT_ERROR, "sortStrings(count=-1)");
+}
+
 void CollationAPITest::TestMaxExpansion()
 {
     UErrorCode          status = U_ZERO_ERROR;
@@ -2267,6 +2575,13 @@ void CollationAPITest::TestSubclass()
     if (abc != keyarray) {
         errln("TestCollator collationkey API is returning wrong values");
     }
+    // The base class getSortKeyUTF8() goes through getSortKey().
+    std::string key8;
+    StringByteSink<std::string> sink(&key8);
+    col1.getSortKeyUTF8("abc", sink, status);
+    if (U_FAILURE(status) || key8 != "abc") {
+        errln("TestCollator getSortKeyUTF8() is returning wrong values");
+    }
 
     UnicodeSet expectedset(0, 0x10FFFF);
     UnicodeSet *defaultset = col1.getTailoredSet(status);
@@ -2543,6 +2858,9 @@ void CollationAPITest::runIndexedTest( int32_t index, UBool exec, const char* &n
     TESTCASE_AUTO(TestSafeClone);
     TESTCASE_AUTO(TestSortKey);
     TESTCASE_AUTO(TestSortKeyOverflow);
+    TESTCASE_AUTO(TestSortKeys);
+    TESTCASE_AUTO(TestSortKeyUTF8);
+    TESTCASE_AUTO(TestSortStrings);
     TESTCASE_AUTO(TestMaxExpansion);
     TESTCASE_AUTO(TestDisplayName);
     TESTCASE_AUTO(TestAttribute);
@@ -117,6 +117,9 @@ class CollationAPITest: public IntlTestCollator {
      */
     void TestSortKey();
     void TestSortKeyOverflow();
+    void TestSortKeys();
+    void TestSortKeyUTF8();
+    void TestSortStrings();
 
     /**
      * This tests getMaxExpansion
@@ -74,13 +74,20 @@ class CollationTest : public IntlTest {
     void TestIllegalUTF8();
     void TestShortFCDData();
     void TestFCD();
+    void TestFCDInertSpans();
     void TestCollationWeights();
     void TestRootElements();
     void TestTailoredElements();
+    void TestFastScript();
     void TestDataDriven();
 
 private:
+    void checkFastScriptCompare(const char *name, const Collator &coll,
+                                const UnicodeString strings[], int32_t count,
+                                IcuTestErrorCode &errorCode);
     void checkFCD(const char *name, CollationIterator &ci, CodePointIterator &cpi);
+    void checkFCDInertSpans(const char *name, int32_t index,
+                            CollationIterator &ci, CollationIterator &nulTerminated);
     void checkAllocWeights(CollationWeights &cw,
                            uint32_t lowerLimit, uint32_t upperLimit, int32_t n,
                            int32_t someLength, int32_t minCount);
@@ -144,9 +151,11 @@ void CollationTest::runIndexedTest(int32_t index, UBool exec, const char *&name,
     TESTCASE_AUTO(TestIllegalUTF8);
     TESTCASE_AUTO(TestShortFCDData);
     TESTCASE_AUTO(TestFCD);
+    TESTCASE_AUTO(TestFCDInertSpans);
     TESTCASE_AUTO(TestCollationWeights);
     TESTCASE_AUTO(TestRootElements);
     TESTCASE_AUTO(TestTailoredElements);
+    TESTCASE_AUTO(TestFastScript);
     TESTCASE_AUTO(TestDataDriven);
     TESTCASE_AUTO_END;
 }
@@ -500,6 +509,127 @@ void CollationTest::TestFCD() {
     checkFCD("FCDUIterCollationIterator", uici, cpi);
 }
 
+void CollationTest::checkFCDInertSpans(const char *name, int32_t index,
+                                       CollationIterator &ci, CollationIterator &nulTerminated) {
+    IcuTestErrorCode errorCode(*this, "checkFCDInertSpans");
+
+    // The NUL-terminated iterator does not know the text length,
+    // so it checks one character at a time, without prescanning FCD-inert spans.
+    UVector64 ces(errorCode);
+    UVector32 offsets(errorCode);
+    offsets.addElement(0, errorCode);
+    for(;;) {
+        int64_t ce = nulTerminated.nextCE(errorCode);
+        if(ce == Collation::NO_CE) { break; }
+        ces.addElement(ce, errorCode);
+        offsets.addElement(nulTerminated.getOffset(), errorCode);
+    }
+    if(errorCode.errIfFailureAndReset("%s[%d] NUL-terminated nextCE()", name, (int)index)) {
+        return;
+    }
+
+    // Start the iteration over after each number of CEs,
+    // and turn around once to go backward and forward again.
+    for(int32_t n = 0; n <= ces.size(); ++n) {
+        ci.resetToOffset(0);
+        for(int32_t i = 0; i < n; ++i) {
+            int64_t ce = ci.nextCE(errorCode);
+            if(ce != ces.elementAti(i)) {
+                errln("%s[%d].nextCE() = %08lx%08lx != %08lx%08lx at CE %d",
+                      name, (int)index, (long)(ce >> 32), (long)(uint32_t)ce,
+                      (long)(ces.elementAti(i) >> 32), (long)(uint32_t)ces.elementAti(i),
+                      (int)i);
+                return;
+            }
+            if(ci.getOffset() != offsets.elementAti(i + 1)) {
+                errln("%s[%d].getOffset() = %d != %d after CE %d",
+                      name, (int)index, (int)ci.getOffset(), (int)offsets.elementAti(i + 1),
+                      (int)i);
+                return;
+            }
+        }
+        // Skip turning around while CEs from an expansion are still buffered.
+        if(n != 0 && n != ces.size() && offsets.elementAti(n) == offsets.elementAti(n + 1)) {
+            continue;
+        }
+        int32_t offset = ci.getOffset();
+        UChar32 c = ci.previousCodePoint(errorCode);
+        if(c < 0 ? offset != 0 : ci.getOffset() > offset) {
+            errln("%s[%d].previousCodePoint() = U+%04lx from offset %d to %d after %d CEs",
+                  name, (int)index, (long)c, (int)offset, (int)ci.getOffset(), (int)n);
+            return;
+        }
+        if(c >= 0) {
+            UChar32 c2 = ci.nextCodePoint(errorCode);
+            if(c2 != c || ci.getOffset() != offset) {
+                errln("%s[%d].nextCodePoint() = U+%04lx != U+%04lx at offset %d != %d after %d CEs",
+                      name, (int)index, (long)c2, (long)c, (int)ci.getOffset(), (int)offset, (int)n);
+                return;
+            }
+        }
+        if(errorCode.errIfFailureAndReset("%s[%d] after %d CEs", name, (int)index, (int)n)) {
+            return;
+        }
+    }
+    if(ci.nextCE(errorCode) != Collation::NO_CE) {
+        errln("%s[%d].nextCE() did not stop at the end", name, (int)index);
+    }
+}
+
+void CollationTest::TestFCDInertSpans() {
+    IcuTestErrorCode errorCode(*this, "TestFCDInertSpans");
+    const CollationData *data = CollationRoot::getData(errorCode);
+    if(errorCode.errDataIfFailureAndReset("CollationRoot::getData()")) {
+        return;
+    }
+
+    // With a known text length, FCDUTF8CollationIterator skips runs of FCD-inert text
+    // up to the character before one with lccc!=0.
+    // FCDUTF16CollationIterator is checked the same way.
+    // Put a variety of characters after runs of FCD-inert text of lengths
+    // around multiples of 16 bytes.
+    static const char *const middles[] = {
+        "\xcc\x81",                          // U+0301: lccc=230
+        "\xcc\xa7",                          // U+0327: lccc=202 < tccc(U+00E9)=230
+        "\xf0\x9d\x85\x9f\xcc\xa7",          // U+1D15F tccc=216 + U+0327
+        "\xf0\x9d\x85\xa5",                  // U+1D165: lccc=216
+        "\xf0\x90\x80\x80\xcc\x81",          // U+10000 + U+0301
+        "\xe0\xbd\xb3",                      // U+0F73: Tibetan composite vowel
+        "\xd0\xb0\xcc\x88",                  // U+0430 + U+0308
+        "\x80\xcc\x81",                      // trail byte + U+0301
+        "\xc3\xcc\x81",                      // truncated two-byte sequence + U+0301
+        "\xe1\x80\xcc\x81",                  // truncated three-byte sequence + U+0301
+        "\xc3\xa9\xa9\xcc\xa7",              // U+00E9 + trail byte + U+0327
+        "\xed\xa0\x80\xcc\x81"               // surrogate code point + U+0301
+    };
+    static const char e_acute[] = "\xc3\xa9";  // U+00E9: tccc=230
+    int32_t index = 0;
+    for(int32_t prefixLength = 0; prefixLength <= 36; ++prefixLength) {
+        std::string prefix;
+        if(prefixLength & 1) { prefix.append("a"); }
+        for(int32_t i = 0; i < prefixLength / 2; ++i) { prefix.append(e_acute); }
+        for(int32_t m = 0; m < UPRV_LENGTHOF(middles); ++m, ++index) {
+            std::string utf8(prefix);
+            utf8.append(middles[m]).append("z");
+            for(int32_t i = 0; i < 12; ++i) { utf8.append(e_acute); }
+            utf8.append("\xcc\xa7\xc3\xa9");
+
+            const uint8_t *s8 = reinterpret_cast<const uint8_t *>(utf8.c_str());
+            FCDUTF8CollationIterator u8ci(data, FALSE, s8, 0, (int32_t)utf8.length());
+            FCDUTF8CollationIterator u8nul(data, FALSE, s8, 0, -1);
+            checkFCDInertSpans("FCDUTF8CollationIterator", index, u8ci, u8nul);
+
+            // Ill-formed UTF-8 becomes U+FFFD, and supplementary code points
+            // become surrogate pairs at the same places.
+            UnicodeString s16 = UnicodeString::fromUTF8(utf8);
+            const UChar *p = s16.getTerminatedBuffer();
+            FCDUTF16CollationIterator u16ci(data, FALSE, p, p, p + s16.length());
+            FCDUTF16CollationIterator u16nul(data, FALSE, p, p, NULL);
+            checkFCDInertSpans("FCDUTF16CollationIterator", index, u16ci, u16nul);
+        }
+    }
+}
+
 void CollationTest::checkAllocWeights(CollationWeights &cw,
                                       uint32_t lowerLimit, uint32_t upperLimit, int32_t n,
                                       int32_t someLength, int32_t minCount) {
@@ -943,6 +1073,193 @@ void CollationTest::TestTailoredElements() {
     uhash_close(prevLocales);
 }
 
+namespace {
+
+// Simple deterministic pseudo-random generator for test strings.
+struct TestRandom {
+    TestRandom() : seed(0x3ea5) {}
+    int32_t next(int32_t limit) {
+        seed = seed * 1103515245 + 12345;
+        return (int32_t)((seed >> 16) % (uint32_t)limit);
+    }
+    uint32_t seed;
+};
+
+UChar32 nextFastScriptChar(TestRandom &rnd, UChar32 blockStart) {
+    // Mostly letters from the script block, with some characters
+    // the fast path handles (digits, spaces, punctuation)
+    // and some it does not (Latin, combining marks, Han, NUL).
+    static const UChar32 others[] = {
+        0x20, 0x2d, 0x27, 0x2e, 0x2c, 0x2010, 0x2019, 0x2026,
+        0x41, 0x61, 0x7a, 0xe9, 0x301, 0x308, 0x4e00, 0
+    };
+    int32_t r = rnd.next(20);
+    if(r < 14) {
+        return blockStart + rnd.next(0x80);
+    } else if(r < 16) {
+        return 0x30 + rnd.next(10);
+    } else {
+        return others[rnd.next(UPRV_LENGTHOF(others))];
+    }
+}
+
+}  // namespace
+
+void CollationTest::TestFastScript() {
+    IcuTestErrorCode errorCode(*this, "TestFastScript");
+    // Collators whose primary script is Cyrillic or Greek
+    // use the fast script path in compare() and compareUTF8().
+    // Check it against sort keys, which never use it.
+    static const struct {
+        const char *name;
+        UChar32 blockStart;
+        const char *rules;
+    } collators[] = {
+        { "ru", 0x400, NULL },
+        { "uk", 0x400, NULL },
+        { "bg", 0x400, NULL },
+        { "sr", 0x400, NULL },
+        { "el", 0x380, NULL },
+        { "[reorder Cyrl]&\\u0435<\\u0451<<<\\u0401", 0x400,
+          "[reorder Cyrl]&\\u0435<\\u0451<<<\\u0401" },
+        { "[reorder Grek Latn]", 0x380, "[reorder Grek Latn]" }
+    };
+    static const int32_t COUNT = 150;
+    UnicodeString strings[COUNT];
+    for(int32_t c = 0; c < UPRV_LENGTHOF(collators); ++c) {
+        LocalPointer<Collator> coll;
+        if(collators[c].rules == NULL) {
+            coll.adoptInstead(Collator::createInstance(Locale(collators[c].name), errorCode));
+        } else {
+            coll.adoptInstead(new RuleBasedCollator(
+                UnicodeString(collators[c].rules, -1, US_INV).unescape(), errorCode));
+        }
+        if(errorCode.errDataIfFailureAndReset("Collator(%s)", collators[c].name)) {
+            continue;
+        }
+        // Random strings, plus variants of earlier ones which differ from them
+        // in one character, so that many pairs differ only at a lower level.
+        TestRandom rnd;
+        for(int32_t i = 0; i < COUNT; ++i) {
+            UnicodeString &s = strings[i];
+            if(i < COUNT / 3) {
+                s.remove();
+                int32_t length = 1 + rnd.next(8);
+                for(int32_t j = 0; j < length; ++j) {
+                    s.append(nextFastScriptChar(rnd, collators[c].blockStart));
+                }
+            } else {
+                s = strings[rnd.next(i)];
+                int32_t index = rnd.next(s.length());
+                UChar32 cp = s.char32At(index);
+                switch(rnd.next(3)) {
+                case 0:
+                    s.replace(index, U16_LENGTH(cp),
+                              cp == u_toupper(cp) ? u_tolower(cp) : u_toupper(cp));
+                    break;
+                case 1:
+                    s.replace(index, U16_LENGTH(cp),
+                              nextFastScriptChar(rnd, collators[c].blockStart));
+                    break;
+                default:
+                    s.insert(index, nextFastScriptChar(rnd, collators[c].blockStart));
+                    break;
+                }
+            }
+        }
+        static const int32_t latinFirst[] = { USCRIPT_LATIN };
+        static const int32_t digitsLast[] = { USCRIPT_CYRILLIC, USCRIPT_GREEK, UCOL_REORDER_CODE_DIGIT };
+        for(int32_t setting = 0; setting < 11; ++setting) {
+            LocalPointer<Collator> clone(coll->clone());
+            const char *settingName;
+            switch(setting) {
+            case 0:
+                settingName = "default";
+                break;
+            case 1:
+                settingName = "primary";
+                clone->setAttribute(UCOL_STRENGTH, UCOL_PRIMARY, errorCode);
+                break;
+            case 2:
+                settingName = "secondary";
+                clone->setAttribute(UCOL_STRENGTH, UCOL_SECONDARY, errorCode);
+                break;
+            case 3:
+                settingName = "shifted quaternary";
+                clone->setAttribute(UCOL_ALTERNATE_HANDLING, UCOL_SHIFTED, errorCode);
+                clone->setAttribute(UCOL_STRENGTH, UCOL_QUATERNARY, errorCode);
+                break;
+            case 4:
+                settingName = "shifted maxVariable=space";
+                clone->setAttribute(UCOL_ALTERNATE_HANDLING, UCOL_SHIFTED, errorCode);
+                clone->setMaxVariable(UCOL_REORDER_CODE_SPACE, errorCode);
+                break;
+            case 5:
+                settingName = "caseLevel primary";
+                clone->setAttribute(UCOL_CASE_LEVEL, UCOL_ON, errorCode);
+                clone->setAttribute(UCOL_STRENGTH, UCOL_PRIMARY, errorCode);
+                break;
+            case 6:
+                settingName = "caseFirst upper";
+                clone->setAttribute(UCOL_CASE_FIRST, UCOL_UPPER_FIRST, errorCode);
+                break;
+            case 7:
+                settingName = "numeric";
+                clone->setAttribute(UCOL_NUMERIC_COLLATION, UCOL_ON, errorCode);
+                break;
+            case 8:
+                settingName = "backwards secondary";
+                clone->setAttribute(UCOL_FRENCH_COLLATION, UCOL_ON, errorCode);
+                break;
+            case 9:
+                settingName = "reorder Latn";
+                clone->setReorderCodes(latinFirst, UPRV_LENGTHOF(latinFirst), errorCode);
+                break;
+            default:
+                settingName = "reorder Cyrl Grek digit";
+                clone->setReorderCodes(digitsLast, UPRV_LENGTHOF(digitsLast), errorCode);
+                break;
+            }
+            if(errorCode.errIfFailureAndReset("setting %s on %s", settingName, collators[c].name)) {
+                continue;
+            }
+            CharString name;
+            name.append(collators[c].name, errorCode).append(" / ", errorCode).
+                append(settingName, errorCode);
+            checkFastScriptCompare(name.data(), *clone, strings, COUNT, errorCode);
+        }
+    }
+}
+
+void CollationTest::checkFastScriptCompare(const char *name, const Collator &coll,
+                                           const UnicodeString strings[], int32_t count,
+                                           IcuTestErrorCode &errorCode) {
+    CollationKey *keys = new CollationKey[count];
+    std::string *strings8 = new std::string[count];
+    for(int32_t i = 0; i < count; ++i) {
+        coll.getCollationKey(strings[i], keys[i], errorCode);
+        strings[i].toUTF8String(strings8[i]);
+    }
+    int32_t numErrors = 0;
+    for(int32_t i = 0; i < count && numErrors < 5 && errorCode.isSuccess(); ++i) {
+        for(int32_t j = 0; j < count; ++j) {
+            UCollationResult expected = keys[i].compareTo(keys[j], errorCode);
+            UCollationResult order = coll.compare(strings[i], strings[j], errorCode);
+            UCollationResult order8 = coll.compareUTF8(strings8[i], strings8[j], errorCode);
+            if(order != expected || order8 != expected) {
+                errln("%s: compare(%d)/compareUTF8(%d) != sort key comparison(%d) for strings",
+                      name, (int)order, (int)order8, (int)expected);
+                infoln(prettify(strings[i]));
+                infoln(prettify(strings[j]));
+                if(++numErrors >= 5) { break; }
+            }
+        }
+    }
+    errorCode.errIfFailureAndReset("%s: comparing strings", name);
+    delete[] keys;
+    delete[] strings8;
+}
+
 UnicodeString CollationTest::printSortKey(const uint8_t *p, int32_t length) {
     UnicodeString s;
     for(int32_t i = 0; i < length; ++i) {
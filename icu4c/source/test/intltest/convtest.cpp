@@ -40,9 +40,12 @@
 #include "unicode/utf16.h"
 #include "convtest.h"
 #include "cmemory.h"
+#include "simplethread.h"
 #include "unicode/tstdtmod.h"
 #include <string.h>
 #include <stdlib.h>
+#include <string>
+#include <vector>
 
 enum {
     // characters used in test data for callbacks
@@ -78,6 +81,9 @@ ConversionTest::runIndexedTest(int32_t index, UBool exec, const char *&name, cha
     TESTCASE_AUTO(TestDefaultIgnorableCallback);
     TESTCASE_AUTO(TestUTF8ToUTF8Overflow);
     TESTCASE_AUTO(TestUTF8ToUTF8Streaming);
+    TESTCASE_AUTO(TestConvertParallel);
+    TESTCASE_AUTO(TestMBCSToMBCS);
+    TESTCASE_AUTO(TestMBCSToUTF8);
     TESTCASE_AUTO_END;
 }
 
@@ -890,6 +896,242 @@ ConversionTest::TestUTF8ToUTF8Streaming() {
     assertSuccess("UTF-8->UTF-8", errorCode);
 }
 
+void
+ConversionTest::TestConvertParallel() {
+    IcuTestErrorCode errorCode(*this, "TestConvertParallel");
+    // About 300kB of UTF-8 with line breaks, mixed scripts, emoji (unmappable in Shift-JIS)
+    // and an ill-formed byte.
+    std::string text;
+    for (int32_t i = 0; text.length() < 300000; ++i) {
+        text.append("Line ");
+        text.append(1, (char)('0' + i % 10));
+        text.append(": ASCII text \xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e "
+                    "\xd1\x80\xd1\x83\xd1\x81 \xf0\x9f\x98\x80");
+        if (i == 1234) {
+            text.append("\xff");
+        }
+        text.append(i % 3 == 0 ? "\n" : " ");
+    }
+
+    static const char *const pairs[][2] = {
+        // { source, target }
+        { "UTF-8", "UTF-16LE" },
+        { "UTF-8", "Shift_JIS" },
+        { "UTF-8", "EUC-JP" },
+        { "UTF-8", "ISO-2022-JP" },  // stateful, converted serially
+        { "UTF-8", "UTF-8" }
+    };
+    for (int32_t i = 0; i < UPRV_LENGTHOF(pairs); ++i) {
+        const char *sourceName = pairs[i][0];
+        const char *targetName = pairs[i][1];
+        LocalUConverterPointer sourceCnv(ucnv_open(sourceName, errorCode));
+        LocalUConverterPointer targetCnv(ucnv_open(targetName, errorCode));
+        if (errorCode.errDataIfFailureAndReset("ucnv_open(%s or %s)", sourceName, targetName)) {
+            continue;
+        }
+        int32_t expectedLength = ucnv_convert(targetName, sourceName, NULL, 0,
+                                              text.data(), (int32_t)text.length(), errorCode);
+        errorCode.expectErrorAndReset(U_BUFFER_OVERFLOW_ERROR);
+        std::vector<char> expected(expectedLength + 1);
+        ucnv_convert(targetName, sourceName, expected.data(), expectedLength + 1,
+                     text.data(), (int32_t)text.length(), errorCode);
+
+        // Preflighting.
+        int32_t length = ucnv_convertParallel(targetCnv.getAlias(), sourceCnv.getAlias(), NULL, 0,
+                                              text.data(), (int32_t)text.length(),
+                                              8, runTasksOnThreads, NULL, errorCode);
+        errorCode.expectErrorAndReset(U_BUFFER_OVERFLOW_ERROR);
+        assertEquals(UnicodeString("preflight length ") + sourceName + "->" + targetName,
+                     expectedLength, length);
+
+        std::vector<char> result(expectedLength + 1);
+        length = ucnv_convertParallel(targetCnv.getAlias(), sourceCnv.getAlias(),
+                                      result.data(), expectedLength + 1,
+                                      text.data(), (int32_t)text.length(),
+                                      8, runTasksOnThreads, NULL, errorCode);
+        if (errorCode.errIfFailureAndReset("ucnv_convertParallel(%s->%s)", sourceName, targetName)) {
+            continue;
+        }
+        assertEquals(UnicodeString("length ") + sourceName + "->" + targetName, expectedLength, length);
+        assertTrue(UnicodeString("same output ") + sourceName + "->" + targetName,
+                   length == expectedLength && 0 == memcmp(expected.data(), result.data(), length));
+
+        // Convert back from the legacy charset, in parallel if possible.
+        if (strcmp(targetName, "ISO-2022-JP") != 0) {
+            int32_t expectedLength2 = ucnv_convert(sourceName, targetName, NULL, 0,
+                                                   expected.data(), expectedLength, errorCode);
+            errorCode.expectErrorAndReset(U_BUFFER_OVERFLOW_ERROR);
+            std::vector<char> expected2(expectedLength2 + 1);
+            ucnv_convert(sourceName, targetName, expected2.data(), expectedLength2 + 1,
+                         expected.data(), expectedLength, errorCode);
+            std::vector<char> result2(expectedLength2 + 1);
+            length = ucnv_convertParallel(sourceCnv.getAlias(), targetCnv.getAlias(),
+                                          result2.data(), expectedLength2 + 1,
+                                          expected.data(), expectedLength,
+                                          8, runTasksOnThreads, NULL, errorCode);
+            errorCode.errIfFailureAndReset("ucnv_convertParallel(%s->%s)", targetName, sourceName);
+            assertTrue(UnicodeString("same output ") + targetName + "->" + sourceName,
+                       length == expectedLength2 &&
+                       0 == memcmp(expected2.data(), result2.data(), length));
+        }
+    }
+}
+
+// Direct conversion between table-based codepages must yield the same results
+// as explicitly pivoting through UTF-16, also when streaming with tiny buffers.
+void
+ConversionTest::TestMBCSToMBCS() {
+    // ASCII, kanji, half-width katakana, JIS X 0212 (three bytes in EUC-JP),
+    // Chinese, Cyrillic, Latin-1 with fallbacks, unmappable emoji.
+    UnicodeString unit(
+        u"abc \u65E5\u672C\u8A9E\uFF76\uFF85 \u4E02\u4E04 \u4E2D\u6587\u7B80\u4F53 "
+        u"\u0440\u0443\u0441 \u00E9\u00A5\u00A6 \U0001F600\u3000\u2015\r\n");
+    UnicodeString text;
+    for (int32_t i = 0; i < 50; ++i) {
+        text.append(unit);
+    }
+
+    static const char *const pairs[][2] = {
+        // { source, target }
+        { "Shift_JIS", "EUC-JP" },
+        { "EUC-JP", "Shift_JIS" },
+        { "GBK", "GB18030" },
+        { "GB18030", "GBK" },
+        { "ibm-37", "windows-1252" },
+        { "windows-1251", "Shift_JIS" }
+    };
+    for (int32_t i = 0; i < UPRV_LENGTHOF(pairs); ++i) {
+        checkDirectConversion(pairs[i][0], pairs[i][1], text);
+    }
+
+    // One source converter with changing target converters, whose data
+    // is unloaded in between: The source converter remembers the table
+    // for its last target, and must not use it for another one.
+    IcuTestErrorCode errorCode(*this, "TestMBCSToMBCS");
+    LocalUConverterPointer sourceCnv(ucnv_open("Shift_JIS", errorCode));
+    if (errorCode.errDataIfFailureAndReset("ucnv_open(Shift_JIS)")) {
+        return;
+    }
+    char bytes[8000];
+    int32_t length = ucnv_fromUChars(sourceCnv.getAlias(), bytes, UPRV_LENGTHOF(bytes),
+                                     text.getBuffer(), text.length(), errorCode);
+    static const char *const targets[] = { "EUC-JP", "ibm-943_P130-1999", "EUC-JP", "windows-1251" };
+    for (int32_t i = 0; i < UPRV_LENGTHOF(targets) && errorCode.isSuccess(); ++i) {
+        LocalUConverterPointer targetCnv(ucnv_open(targets[i], errorCode));
+        UChar pivot[8000];
+        int32_t pivotLength = ucnv_toUChars(sourceCnv.getAlias(), pivot, UPRV_LENGTHOF(pivot),
+                                            bytes, length, errorCode);
+        char expected[8000];
+        int32_t expectedLength = ucnv_fromUChars(targetCnv.getAlias(), expected,
+                                                 UPRV_LENGTHOF(expected), pivot, pivotLength,
+                                                 errorCode);
+        char result[8000];
+        char *target = result;
+        const char *source = bytes;
+        ucnv_convertEx(targetCnv.getAlias(), sourceCnv.getAlias(),
+                       &target, result + UPRV_LENGTHOF(result), &source, bytes + length,
+                       NULL, NULL, NULL, NULL, TRUE, TRUE, errorCode);
+        if (errorCode.errDataIfFailureAndReset("Shift_JIS->%s", targets[i])) {
+            return;
+        }
+        assertTrue(UnicodeString("ucnv_convertEx() same as pivoting Shift_JIS->") + targets[i],
+                   (target - result) == expectedLength &&
+                   0 == memcmp(expected, result, expectedLength));
+        targetCnv.adoptInstead(NULL);
+        ucnv_flushCache();
+    }
+}
+
+// Direct conversion from table-based codepages to UTF-8.
+void
+ConversionTest::TestMBCSToUTF8() {
+    // ASCII, Latin-1, Windows-1252 C1 graphics, Cyrillic, kanji, Hangul,
+    // supplementary CJK (HKSCS), unmappable emoji, C1 controls.
+    UnicodeString unit(
+        u"abc \u00E9\u00FF\u20AC\u2122 \u0440\u0443\u0441 \u65E5\u672C\u8A9E\uFF76 "
+        u"\uD55C\uAD6D\uC5B4 \U00020021\U0002008A \U0001F600\u0085\r\n");
+    UnicodeString text;
+    for (int32_t i = 0; i < 50; ++i) {
+        text.append(unit);
+    }
+
+    static const char *const sources[] = {
+        "windows-1252", "windows-1251", "ibm-37", "ibm-37,swaplfnl", "ibm-1047",
+        "Shift_JIS", "windows-949", "GBK", "Big5-HKSCS", "ibm-1390"  // SI/SO, pivots
+    };
+    for (int32_t i = 0; i < UPRV_LENGTHOF(sources); ++i) {
+        checkDirectConversion(sources[i], "UTF-8", text);
+    }
+}
+
+// Converts text to sourceName bytes, appends some bad bytes, and checks that
+// converting those to targetName gives the same results with ucnv_convert() and
+// with streaming ucnv_convertEx() as explicitly pivoting through UTF-16.
+void
+ConversionTest::checkDirectConversion(const char *sourceName, const char *targetName,
+                                      const UnicodeString &text) {
+    IcuTestErrorCode errorCode(*this, "checkDirectConversion");
+    LocalUConverterPointer sourceCnv(ucnv_open(sourceName, errorCode));
+    LocalUConverterPointer targetCnv(ucnv_open(targetName, errorCode));
+    if (errorCode.errDataIfFailureAndReset("ucnv_open(%s or %s)", sourceName, targetName)) {
+        return;
+    }
+    // Source bytes with an unassigned or ill-formed byte sequence and a truncated one at the end.
+    char bytes[8000];
+    int32_t length = ucnv_fromUChars(sourceCnv.getAlias(), bytes, UPRV_LENGTHOF(bytes) - 4,
+                                     text.getBuffer(), text.length(), errorCode);
+    if (errorCode.errIfFailureAndReset("ucnv_fromUChars(%s)", sourceName)) {
+        return;
+    }
+    bytes[length++] = (char)0xff;
+    bytes[length++] = 'x';
+    bytes[length++] = (char)0x81;
+
+    // Expected: explicit pivoting.
+    UChar pivot[8000];
+    int32_t pivotLength = ucnv_toUChars(sourceCnv.getAlias(), pivot, UPRV_LENGTHOF(pivot),
+                                        bytes, length, errorCode);
+    char expected[8000];
+    int32_t expectedLength = ucnv_fromUChars(targetCnv.getAlias(), expected, UPRV_LENGTHOF(expected),
+                                             pivot, pivotLength, errorCode);
+    if (errorCode.errIfFailureAndReset("pivoting %s->%s", sourceName, targetName)) {
+        return;
+    }
+
+    char result[8000];
+    int32_t resultLength = ucnv_convert(targetName, sourceName, result, UPRV_LENGTHOF(result),
+                                        bytes, length, errorCode);
+    errorCode.errIfFailureAndReset("ucnv_convert(%s->%s)", sourceName, targetName);
+    assertTrue(UnicodeString("ucnv_convert() same as pivoting ") + sourceName + "->" + targetName,
+               resultLength == expectedLength && 0 == memcmp(expected, result, resultLength));
+
+    // Streaming with at most 3 bytes of input and output at a time.
+    UChar pivotBuffer[40];
+    UChar *pivotSource = pivotBuffer, *pivotTarget = pivotBuffer;
+    const char *source = bytes, *sourceEnd = bytes + length;
+    char *target = result, *targetEnd = result + UPRV_LENGTHOF(result);
+    UBool reset = TRUE;
+    for (;;) {
+        const char *sourceLimit = (sourceEnd - source) > 3 ? source + 3 : sourceEnd;
+        char *targetLimit = (targetEnd - target) > 3 ? target + 3 : targetEnd;
+        UBool flush = sourceLimit == sourceEnd;
+        ucnv_convertEx(targetCnv.getAlias(), sourceCnv.getAlias(),
+                       &target, targetLimit, &source, sourceLimit,
+                       pivotBuffer, &pivotSource, &pivotTarget, pivotBuffer + UPRV_LENGTHOF(pivotBuffer),
+                       reset, flush, errorCode);
+        reset = FALSE;
+        if (errorCode.get() == U_BUFFER_OVERFLOW_ERROR) {
+            errorCode.reset();
+        } else if (errorCode.isFailure() || flush) {
+            break;
+        }
+    }
+    errorCode.errIfFailureAndReset("streaming ucnv_convertEx(%s->%s)", sourceName, targetName);
+    resultLength = (int32_t)(target - result);
+    assertTrue(UnicodeString("streaming same as pivoting ") + sourceName + "->" + targetName,
+               resultLength == expectedLength && 0 == memcmp(expected, result, resultLength));
+}
+
 // open testdata or ICU data converter ------------------------------------- ***
 
 UConverter *
@@ -78,8 +78,14 @@ class ConversionTest : public IntlTest {
     void TestDefaultIgnorableCallback();
     void TestUTF8ToUTF8Overflow();
     void TestUTF8ToUTF8Streaming();
+    void TestConvertParallel();
+    void TestMBCSToMBCS();
+    void TestMBCSToUTF8();
 
 private:
+    void checkDirectConversion(const char *sourceName, const char *targetName,
+                               const UnicodeString &text);
+
     UBool
     ToUnicodeCase(ConversionCase &cc, UConverterToUCallback callback, const char *option);
 
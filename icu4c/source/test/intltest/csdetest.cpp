@@ -109,6 +109,10 @@ void CharsetDetectionTest::runIndexedTest( int32_t index, UBool exec, const char
             if (exec) Ticket6954Test();
             break;
 
+       case 10: name = "StreamingTest";
+            if (exec) StreamingTest();
+            break;
+
         default: name = "";
             break; //needed to end loop
     }
@@ -232,6 +236,56 @@ void CharsetDetectionTest::checkEncoding(const UnicodeString &testString, const
     }
 
     delete[] decoded;
+
+    checkStreaming(bytes.get(), byteLength, FALSE, 7, id);
+}
+
+// Detect bytes[0..byteLength-1] both as one buffer and as a stream of chunks,
+//   and check that the results are the same.
+void CharsetDetectionTest::checkStreaming(const char *bytes, int32_t byteLength, UBool stripTags,
+                                          int32_t chunkLength, const UnicodeString &id)
+{
+    UErrorCode status = U_ZERO_ERROR;
+    LocalUCharsetDetectorPointer csd(ucsdet_open(&status));
+    LocalUCharsetDetectorPointer streamCsd(ucsdet_open(&status));
+    TEST_ASSERT_SUCCESS(status);
+
+    ucsdet_enableInputFilter(csd.getAlias(), stripTags);
+    ucsdet_enableInputFilter(streamCsd.getAlias(), stripTags);
+    ucsdet_setText(csd.getAlias(), bytes, byteLength, &status);
+
+    for (int32_t start = 0; start < byteLength; start += chunkLength) {
+        int32_t length = byteLength - start < chunkLength ? byteLength - start : chunkLength;
+        if (!ucsdet_appendText(streamCsd.getAlias(), bytes + start, length, &status)) {
+            errln("ucsdet_appendText() stopped early for " + id + " without a stop confidence");
+            return;
+        }
+    }
+
+    int32_t matchCount = 0, streamMatchCount = 0;
+    const UCharsetMatch **matches = ucsdet_detectAll(csd.getAlias(), &matchCount, &status);
+    const UCharsetMatch **streamMatches = ucsdet_detectAll(streamCsd.getAlias(), &streamMatchCount, &status);
+    TEST_ASSERT_SUCCESS(status);
+
+    if (matchCount != streamMatchCount) {
+        errln("Streaming detection failure for " + id + ": expected " + matchCount +
+              " matches, got " + streamMatchCount);
+        return;
+    }
+
+    for (int32_t m = 0; m < matchCount; m += 1) {
+        const char *name = ucsdet_getName(matches[m], &status);
+        const char *streamName = ucsdet_getName(streamMatches[m], &status);
+        int32_t confidence = ucsdet_getConfidence(matches[m], &status);
+        int32_t streamConfidence = ucsdet_getConfidence(streamMatches[m], &status);
+        TEST_ASSERT_SUCCESS(status);
+
+        if (strcmp(name, streamName) != 0 || confidence != streamConfidence) {
+            errln("Streaming detection failure for " + id + ", match " + m + ": expected " + name +
+                  " (" + confidence + "), got " + streamName + " (" + streamConfidence + ")");
+            return;
+        }
+    }
 }
 
 const char *CharsetDetectionTest::getPath(char buffer[2048], const char *filename) {
@@ -839,3 +893,65 @@ void CharsetDetectionTest::Ticket6954Test() {
     TEST_ASSERT(strcmp(name1, "windows-1252")==0);
 #endif
 }
+
+void CharsetDetectionTest::StreamingTest() {
+#if !UCONFIG_NO_CONVERSION
+    UErrorCode status = U_ZERO_ERROR;
+    UnicodeString ss("<html><head><title>\u0420\u0443\u0441\u0441\u043a\u0438\u0439</title></head><body>"
+                     "<p>\u65e5\u672c\u8a9e\u306e\u30c6\u30ad\u30b9\u30c8\u3067\u3059\u3002</p>"
+                     "<p>Some English text, \u201cquoted\u201d.</p></body></html>\n", -1, US_INV);
+    UnicodeString s = ss.unescape();
+    UnicodeString text;
+
+    for (int32_t i = 0; i < 200; i += 1) {
+        text.append(s);
+    }
+
+    // Large enough that the markup-stripped sample fills up part way through.
+    std::string utf8;
+    text.toUTF8String(utf8);
+    int32_t length = (int32_t)utf8.length();
+
+    checkStreaming(utf8.data(), length, FALSE, 1, "UTF-8 html, 1-byte chunks");
+    checkStreaming(utf8.data(), length, TRUE, 1, "UTF-8 html, 1-byte chunks, filtered");
+    checkStreaming(utf8.data(), length, TRUE, 1000, "UTF-8 html, 1000-byte chunks, filtered");
+
+    int32_t sjisLength = 0;
+    std::unique_ptr<char[]> sjis(extractBytes(text, "Shift_JIS", sjisLength));
+    if (sjis) {
+        checkStreaming(sjis.get(), sjisLength, TRUE, 3, "Shift_JIS html, 3-byte chunks");
+    }
+
+    // With a stop confidence, appending ends once the result is certain.
+    LocalUCharsetDetectorPointer csd(ucsdet_open(&status));
+    ucsdet_setStopConfidence(csd.getAlias(), 101, &status);
+    TEST_ASSERT(status == U_ILLEGAL_ARGUMENT_ERROR);
+    status = U_ZERO_ERROR;
+    ucsdet_setStopConfidence(csd.getAlias(), 100, &status);
+    TEST_ASSERT_SUCCESS(status);
+
+    int32_t start = 0;
+    int32_t chunkLength = length < 256 ? length : 256;
+    while (start < length &&
+            ucsdet_appendText(csd.getAlias(), utf8.data() + start, chunkLength, &status)) {
+        start += chunkLength;
+        chunkLength = length - start < 256 ? length - start : 256;
+    }
+    TEST_ASSERT_SUCCESS(status);
+    TEST_ASSERT(start < length);
+    TEST_ASSERT(!ucsdet_appendText(csd.getAlias(), utf8.data() + start, chunkLength, &status));
+
+    const UCharsetMatch *match = ucsdet_detect(csd.getAlias(), &status);
+    TEST_ASSERT_SUCCESS(status);
+    TEST_ASSERT(strcmp(ucsdet_getName(match, &status), "UTF-8") == 0);
+    TEST_ASSERT(ucsdet_getConfidence(match, &status) == 100);
+
+    // setText() discards the stream; the next appendText() starts a new one.
+    ucsdet_setText(csd.getAlias(), "", 0, &status);
+    TEST_ASSERT(ucsdet_appendText(csd.getAlias(), "abc", -1, &status));
+    match = ucsdet_detect(csd.getAlias(), &status);
+    TEST_ASSERT_SUCCESS(status);
+    TEST_ASSERT(strcmp(ucsdet_getName(match, &status), "UTF-8") != 0 ||
+                ucsdet_getConfidence(match, &status) < 100);
+#endif
+}
@@ -33,10 +33,13 @@ class CharsetDetectionTest: public IntlTest {
     virtual void IBM420Test();
     virtual void Ticket6394Test();
     virtual void Ticket6954Test();
+    virtual void StreamingTest();
 
 private:
     void checkEncoding(const UnicodeString &testString,
                        const UnicodeString &encoding, const UnicodeString &id);
+    void checkStreaming(const char *bytes, int32_t byteLength, UBool stripTags,
+                        int32_t chunkLength, const UnicodeString &id);
 
     virtual const char *getPath(char buffer[2048], const char *filename);
 
@@ -28,6 +28,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <string>
 
 #include "unicode/localpointer.h"
 #include "unicode/regex.h"
@@ -40,6 +41,7 @@
 #include "unicode/ustring.h"
 #include "unicode/utext.h"
 #include "unicode/utf16.h"
+#include "unicode/utf8.h"
 #include "cstr.h"
 #include "regextst.h"
 #include "regexcmp.h"
@@ -107,6 +109,7 @@ void RegexTest::runIndexedTest( int32_t index, UBool exec, const char* &name, ch
     TESTCASE_AUTO(TestBug13632);
     TESTCASE_AUTO(TestBug20359);
     TESTCASE_AUTO(TestBug20863);
+    TESTCASE_AUTO(TestRequiredString);
     TESTCASE_AUTO_END;
 }
 
@@ -6014,4 +6017,127 @@ void RegexTest::TestBug20863() {
 }
 
 
+// List the matches of find() as "[start,end]...", followed by the hitEnd() flag.
+static UnicodeString findAll(RegexMatcher &matcher, UErrorCode &status) {
+    UnicodeString result;
+    while (matcher.find(status)) {
+        result.append(u'[').append(Int64ToUnicodeString(matcher.start64(status)));
+        result.append(u',').append(Int64ToUnicodeString(matcher.end64(status))).append(u']');
+    }
+    result.append(matcher.hitEnd() ? u" hitEnd" : u" !hitEnd");
+    return result;
+}
+
+void RegexTest::TestRequiredString() {
+    // A pattern with a literal string that is part of every match is
+    // prefiltered in find() by searching the input for that string.
+    // Check that it finds the same matches as the same pattern wrapped
+    // in an alternation, which has no required string,
+    // for UTF-16 and UTF-8 input, and with and without a region.
+    static const char16_t *patterns[] = {
+        u"abc",
+        u"\\d{2}abc",
+        u"(?:abcd|e)xyz",
+        u"x*abc",
+        u"[a-c]+xyz",
+        u"(\\w)\\1xyz",
+        u"(?:ab|cd)(?:xyz|xy)",
+        u"(?:xyz)?abc",
+        u"(?:xyz)*abc",
+        u"(?:abc){2,3}",
+        u"(?:abc){0,2}xyz",
+        u"a(?=xyz)xy",
+        u"(?<=q)xyz",
+        u"(?<!q)xyz",
+        u"\\bxyz\\b",
+        u".{0,3}xyz.?",
+        u"(?m)^.*xyz",
+        u"(?s).*xyz",
+        u"(?i)xyz",
+        u"xyz|abc",
+        u"(?:ab)++xyz",
+        u"\\u00e9t\\u00e9",
+        u"\\U0001F600?xyz",
+        u"\\U0001F600{1,2}xyz",
+        u"[\\U0001F600-\\U0001F64F]xyz",
+        u"xyz\\U0001F600",
+    };
+    static const char16_t *texts[] = {
+        u"",
+        u"xyz",
+        u"12abc 34abc xxabc 5abc",
+        u"abcdxyz exyz xyz cdxy abxyz",
+        u"qxyz xyzxyz axyzb xyzabc abcabcabcabc",
+        u"aaxyz abxyz ccxyzc",
+        u"\U0001F600xyz\U0001F601\U0001F600\U0001F600xyz\U0001F600 xyz\U0001F600",
+        u"\u00e9t\u00e9 et ete \u00e9t\u00e9",
+        u"line\nfoo xyz\nbar\nxyz",
+    };
+
+    // Also a long text, with matches spanning the chunk boundaries of a UTF-8 UText.
+    UnicodeString longText;
+    for (int32_t i = 0; i < 60; ++i) {
+        for (int32_t j = 0; j < i; ++j) {
+            longText.append(j % 7 == 0 ? u'\u00e9' : u'x');
+        }
+        longText.append(i % 3 == 0 ? u"12abcxyz" : u"q\U0001F600xyz");
+    }
+
+    for (const char16_t *pattern : patterns) {
+        UErrorCode status = U_ZERO_ERROR;
+        UnicodeString patternString(pattern);
+        UnicodeString refPatternString = UnicodeString(u"(?:").append(patternString).append(u"|(?!))");
+        LocalPointer<RegexMatcher> matcher(new RegexMatcher(patternString, 0, status), status);
+        LocalPointer<RegexMatcher> refMatcher(new RegexMatcher(refPatternString, 0, status), status);
+        if (!assertSuccess(WHERE, status)) {
+            return;
+        }
+
+        for (int32_t textIdx = 0; textIdx <= UPRV_LENGTHOF(texts); ++textIdx) {
+            UnicodeString text = textIdx < UPRV_LENGTHOF(texts) ? UnicodeString(texts[textIdx]) : longText;
+            std::string text8;
+            text.toUTF8String(text8);
+            UnicodeString message = UnicodeString(u"/").append(patternString).append(u"/ text ");
+            message.append(Int64ToUnicodeString(textIdx));
+
+            for (int32_t withRegion = 0; withRegion <= 1; ++withRegion) {
+                // UTF-16
+                matcher->reset(text);
+                refMatcher->reset(text);
+                if (withRegion && text.length() > 0) {
+                    int32_t regionStart = text.moveIndex32(0, 1);
+                    int32_t regionLimit = text.moveIndex32(text.length(), -1);
+                    if (regionStart <= regionLimit) {
+                        matcher->region(regionStart, regionLimit, status);
+                        refMatcher->region(regionStart, regionLimit, status);
+                    }
+                }
+                UnicodeString expected = findAll(*refMatcher, status);
+                assertEquals(UnicodeString(message).append(u" UTF-16"), expected, findAll(*matcher, status));
+
+                // UTF-8
+                LocalUTextPointer ut(utext_openUTF8(nullptr, text8.data(), (int64_t)text8.length(), &status));
+                matcher->reset(ut.getAlias());
+                refMatcher->reset(ut.getAlias());
+                if (withRegion && text8.length() > 0) {
+                    int32_t regionStart = 0;
+                    int32_t regionLimit = (int32_t)text8.length();
+                    U8_FWD_1((const uint8_t *)text8.data(), regionStart, regionLimit);
+                    U8_BACK_1((const uint8_t *)text8.data(), 0, regionLimit);
+                    if (regionStart <= regionLimit) {
+                        matcher->region(regionStart, regionLimit, status);
+                        refMatcher->region(regionStart, regionLimit, status);
+                    }
+                }
+                expected = findAll(*refMatcher, status);
+                assertEquals(UnicodeString(message).append(u" UTF-8"), expected, findAll(*matcher, status));
+                if (!assertSuccess(WHERE, status)) {
+                    return;
+                }
+            }
+        }
+    }
+}
+
+
 #endif  /* !UCONFIG_NO_REGULAR_EXPRESSIONS  */
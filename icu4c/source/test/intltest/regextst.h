@@ -61,6 +61,7 @@ class RegexTest: public IntlTest {
     virtual void TestBug13632();
     virtual void TestBug20359();
     virtual void TestBug20863();
+    virtual void TestRequiredString();
 
     // The following functions are internal to the regexp tests.
     virtual void assertUText(const char *expected, UText *actual, const char *file, int line);
@@ -10,6 +10,7 @@
 #include "simplethread.h"
 
 #include <thread>
+#include <vector>
 #include "unicode/utypes.h"
 #include "intltest.h"
 
@@ -34,6 +35,20 @@ void SimpleThread::join() {
 
 
 
+U_CDECL_BEGIN
+void U_CALLCONV
+runTasksOnThreads(const void * /*runnerContext*/, UTask task, void *taskContext, int32_t count) {
+    std::vector<std::thread> threads;
+    for (int32_t i = 0; i < count; ++i) {
+        threads.emplace_back(task, taskContext, i);
+    }
+    for (std::thread &t : threads) {
+        t.join();
+    }
+}
+U_CDECL_END
+
+
 class ThreadPoolThread: public SimpleThread {
   public:
     ThreadPoolThread(ThreadPoolBase *pool, int32_t threadNum) : fPool(pool), fNum(threadNum) {}
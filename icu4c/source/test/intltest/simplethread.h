@@ -11,6 +11,7 @@
 
 #include <thread>
 #include "unicode/utypes.h"
+#include "unicode/utask.h"
 
 /*
  * Simple class for creating threads in ICU tests.
@@ -35,6 +36,15 @@ class SimpleThread
 };
 
 
+U_CDECL_BEGIN
+/**
+ * UTaskRunner for tests of ICU functions that take one: Runs each task on its own thread.
+ */
+void U_CALLCONV runTasksOnThreads(const void *runnerContext, UTask task, void *taskContext,
+                                  int32_t count);
+U_CDECL_END
+
+
 class IntlTest;
 
 // ThreadPool - utililty class to simplify the spawning a group of threads by
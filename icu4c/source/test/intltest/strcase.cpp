@@ -70,6 +70,7 @@ class StringCaseTest: public IntlTest {
     void TestInPlaceTitle();
     void TestCaseMapEditsIteratorDocs();
     void TestCaseMapGreekExtended();
+    void TestUTF8FoldInPlace();
 
 private:
     void assertGreekUpper(const char16_t *s, const char16_t *expected);
@@ -117,6 +118,7 @@ StringCaseTest::runIndexedTest(int32_t index, UBool exec, const char *&name, cha
 #endif
     TESTCASE_AUTO(TestCaseMapEditsIteratorDocs);
     TESTCASE_AUTO(TestCaseMapGreekExtended);
+    TESTCASE_AUTO(TestUTF8FoldInPlace);
     TESTCASE_AUTO_END;
 }
 
@@ -1725,4 +1727,72 @@ void StringCaseTest::TestCaseMapGreekExtended() {
 #endif
 }
 
+void StringCaseTest::TestUTF8FoldInPlace() {
+    IcuTestErrorCode errorCode(*this, "TestUTF8FoldInPlace");
+    // Already folded, shrinking (Kelvin sign), growing (sharp s),
+    // and both, so that unchanged text moves left and right.
+    static const char *const strings[] = {
+        "",
+        "already folded",
+        "AbC",
+        "xx\xc3\x9f",
+        "\xe2\x84\xaa" "ab\xc3\x9f" "cd\xe2\x84\xaa" "ef\xc3\x9f" "gh",
+        "\xc3\x9f" "abc\xc3\x9f\xc3\x9f" "def\xe2\x84\xaa\xe2\x84\xaa" "ghi\xe2\x84\xaa",
+        "I\xc4\xb0stanBul \xef\xac\x83 \xce\xa3\xcf\x82 \xf0\x90\x90\x80 ill\xc0\x80" "formed"
+    };
+    static const uint32_t options[] = { U_FOLD_CASE_DEFAULT, U_FOLD_CASE_EXCLUDE_SPECIAL_I };
+    for (int32_t i = 0; i < UPRV_LENGTHOF(strings); ++i) {
+        for (int32_t j = 0; j < UPRV_LENGTHOF(options); ++j) {
+            int32_t length = (int32_t)strlen(strings[i]);
+            std::string expected;
+            StringByteSink<std::string> sink(&expected);
+            CaseMap::utf8Fold(options[j], StringPiece(strings[i], length), sink, nullptr, errorCode);
+            int32_t expectedLength = (int32_t)expected.length();
+            int32_t expectedFirstChange = 0;
+            while (expectedFirstChange < length && expectedFirstChange < expectedLength &&
+                    strings[i][expectedFirstChange] == expected[expectedFirstChange]) {
+                ++expectedFirstChange;
+            }
+            UnicodeString message = UnicodeString("utf8FoldInPlace #") + i + " options " + j;
+
+            // With just enough room for the original: Overflow if the result is longer.
+            char buffer[100];
+            uprv_memcpy(buffer, strings[i], length);
+            int32_t firstChange = -1;
+            int32_t resultLength = CaseMap::utf8FoldInPlace(
+                options[j], buffer, length, length, &firstChange, errorCode);
+            assertEquals(message + " length", expectedLength, resultLength);
+            if (expectedFirstChange == length && expectedLength == length) {
+                assertEquals(message + " no change", length, firstChange);
+            } else {
+                assertTrue(message + " first change", firstChange <= expectedFirstChange);
+            }
+            assertEquals(message + " text before first change", 0,
+                         memcmp(buffer, expected.data(), firstChange));
+            if (expectedLength > length) {
+                assertEquals(message + " overflow", U_BUFFER_OVERFLOW_ERROR, errorCode.reset());
+                assertEquals(message + " unchanged on overflow", 0, memcmp(buffer, strings[i], length));
+            } else {
+                errorCode.reset();  // U_STRING_NOT_TERMINATED_WARNING if the length is the same
+                assertTrue(message, std::string(buffer, resultLength) == expected);
+            }
+
+            // With room to grow.
+            uprv_memcpy(buffer, strings[i], length);
+            resultLength = CaseMap::utf8FoldInPlace(
+                options[j], buffer, length, UPRV_LENGTHOF(buffer), nullptr, errorCode);
+            if (errorCode.errIfFailureAndReset("utf8FoldInPlace #%d options %d", (int)i, (int)j)) {
+                continue;
+            }
+            assertTrue(message + " with room", std::string(buffer, resultLength) == expected);
+            assertEquals(message + " NUL-terminated", 0, buffer[resultLength]);
+        }
+    }
+    char s[20] = "aBc";
+    CaseMap::utf8FoldInPlace(0, s, 3, 2, nullptr, errorCode);
+    assertEquals("capacity < length", U_ILLEGAL_ARGUMENT_ERROR, errorCode.reset());
+    assertEquals("NUL-terminated input", 3, CaseMap::utf8FoldInPlace(0, s, -1, 20, nullptr, errorCode));
+    assertEquals("NUL-terminated input folded", "abc", s);
+}
+
 //#endif
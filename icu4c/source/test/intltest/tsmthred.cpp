@@ -23,6 +23,7 @@
 #include "putilimp.h"
 #include "intltest.h"
 #include "tsmthred.h"
+#include "unicode/ucnv.h"
 #include "unicode/ushape.h"
 #include "unicode/translit.h"
 #include "sharedobject.h"
@@ -79,6 +80,9 @@ void MultithreadTest::runIndexedTest( int32_t index, UBool exec,
     TESTCASE_AUTO(Test20104);
 #endif /* #if !UCONFIG_NO_FORMATTING */
 #endif /* #if !UCONFIG_NO_TRANSLITERATION */
+#if !UCONFIG_NO_LEGACY_CONVERSION
+    TESTCASE_AUTO(TestConverterPool);
+#endif
     TESTCASE_AUTO_END;
 }
 
@@ -1366,3 +1370,73 @@ void MultithreadTest::Test20104() {
 #endif /* !UCONFIG_NO_FORMATTING */
 
 #endif /* !UCONFIG_NO_TRANSLITERATION */
+
+#if !UCONFIG_NO_LEGACY_CONVERSION
+//-------------------------------------------------------------------------------------------
+//
+//  TestConverterPool. Threads open converters from the pool, convert, and return them,
+//                     while one thread also flushes the pool via ucnv_flushCache().
+//
+//-------------------------------------------------------------------------------------------
+
+static const char *gPoolConverterNames[] = { "Shift_JIS", "UTF-8", "windows-1252", "ibm-1047" };
+
+class ConverterPoolThread : public SimpleThread {
+  public:
+    ConverterPoolThread(int32_t id) : fId(id), fErrors(0) {}
+    virtual void run();
+    int32_t fId;
+    int32_t fErrors;
+};
+
+void ConverterPoolThread::run() {
+    static const UChar text[] = { 0x41, 0x62, 0x63, 0x20, 0x31, 0x32, 0x33 };
+    for (int32_t i = 0; i < 2000; ++i) {
+        const char *name = gPoolConverterNames[(fId + i) % UPRV_LENGTHOF(gPoolConverterNames)];
+        UErrorCode status = U_ZERO_ERROR;
+        UConverter *cnv = ucnv_openPooled(name, &status);
+        char bytes[32];
+        UChar uchars[32];
+        int32_t length = ucnv_fromUChars(cnv, bytes, UPRV_LENGTHOF(bytes),
+                                         text, UPRV_LENGTHOF(text), &status);
+        length = ucnv_toUChars(cnv, uchars, UPRV_LENGTHOF(uchars), bytes, length, &status);
+        if (U_FAILURE(status) || length != UPRV_LENGTHOF(text) ||
+                u_memcmp(uchars, text, length) != 0) {
+            ++fErrors;
+        }
+        ucnv_returnToPool(cnv);
+        if (fId == 0 && (i % 500) == 499) {
+            ucnv_flushCache();
+        }
+    }
+}
+
+void MultithreadTest::TestConverterPool() {
+    UErrorCode status = U_ZERO_ERROR;
+    ucnv_close(ucnv_open("Shift_JIS", &status));
+    if (U_FAILURE(status)) {
+        dataerrln("ucnv_open(Shift_JIS) failed - %s", u_errorName(status));
+        return;
+    }
+    int64_t hits0, misses0, hits, misses;
+    ucnv_getPoolStatistics(&hits0, &misses0);
+
+    static constexpr int NUM_THREADS = 8;
+    ConverterPoolThread *threads[NUM_THREADS];
+    for (int32_t i = 0; i < NUM_THREADS; ++i) {
+        threads[i] = new ConverterPoolThread(i);
+        threads[i]->start();
+    }
+    int32_t errors = 0;
+    for (int32_t i = 0; i < NUM_THREADS; ++i) {
+        threads[i]->join();
+        errors += threads[i]->fErrors;
+        delete threads[i];
+    }
+    assertEquals(WHERE, 0, errors);
+
+    ucnv_getPoolStatistics(&hits, &misses);
+    assertEquals(WHERE, (int64_t)NUM_THREADS * 2000, (hits - hits0) + (misses - misses0));
+    assertTrue(WHERE, hits - hits0 > misses - misses0);
+}
+#endif /* !UCONFIG_NO_LEGACY_CONVERSION */
@@ -12,7 +12,9 @@
 
 #include "unicode/uchar.h"
 #include "unicode/errorcode.h"
+#include "unicode/keynorm.h"
 #include "unicode/normlzr.h"
+#include "unicode/normstream.h"
 #include "unicode/stringoptions.h"
 #include "unicode/stringpiece.h"
 #include "unicode/uniset.h"
@@ -22,6 +24,7 @@
 #include "cmemory.h"
 #include "cstring.h"
 #include "normalizer2impl.h"
+#include "simplethread.h"
 #include "testutil.h"
 #include "tstnorm.h"
 
@@ -62,6 +65,11 @@ void BasicNormalizerTest::runIndexedTest(int32_t index, UBool exec,
     TESTCASE_AUTO(TestNormalizeIllFormedText);
     TESTCASE_AUTO(TestComposeJamoTBase);
     TESTCASE_AUTO(TestComposeBoundaryAfter);
+    TESTCASE_AUTO(TestLowTextRuns);
+    TESTCASE_AUTO(TestStreamingNormalizer);
+    TESTCASE_AUTO(TestParallelNormalizer);
+    TESTCASE_AUTO(TestNormalizeUTF8InPlace);
+    TESTCASE_AUTO(TestSearchKeyNormalizer);
     TESTCASE_AUTO_END;
 }
 
@@ -1873,4 +1881,395 @@ BasicNormalizerTest::TestComposeBoundaryAfter() {
     assertFalse("U+FB2C boundary-after", nfkc->hasBoundaryAfter(0xFB2C));
 }
 
+void
+BasicNormalizerTest::TestLowTextRuns() {
+    // The fast paths skip runs of low code units in blocks.
+    // Put a combining mark at every position relative to block boundaries
+    // and check that it is still found, in UTF-16 and in UTF-8.
+    IcuTestErrorCode errorCode(*this, "TestLowTextRuns");
+    const Normalizer2 *nfc = Normalizer2::getNFCInstance(errorCode);
+    const Normalizer2 *nfd = Normalizer2::getNFDInstance(errorCode);
+    if(errorCode.errDataIfFailureAndReset("Normalizer2::getNFCInstance() call failed")) {
+        return;
+    }
+    for(int32_t i = 0; i < 70; ++i) {
+        // For NFC, mix ASCII with Latin-1 letters, all below the threshold U+0300.
+        // For NFD, use only ASCII because U+00E9 decomposes.
+        UnicodeString prefix, ascii;
+        for(int32_t j = 0; j < i; ++j) {
+            prefix.append((UChar)((j % 5) == 4 ? 0xe9 : 0x61 + j % 26));
+            ascii.append((UChar)(0x61 + j % 26));
+        }
+        UnicodeString s = prefix + u"e\u0301" + prefix;
+        UnicodeString composed = prefix + u"\u00e9" + prefix;
+        UnicodeString asciiComposed = ascii + u"\u00e9" + ascii;
+        UnicodeString asciiDecomposed = ascii + u"e\u0301" + ascii;
+        std::string s8, composed8, asciiComposed8, asciiDecomposed8;
+        s.toUTF8String(s8);
+        composed.toUTF8String(composed8);
+        asciiComposed.toUTF8String(asciiComposed8);
+        asciiDecomposed.toUTF8String(asciiDecomposed8);
+
+        assertEquals(UnicodeString("nfc ") + i, composed, nfc->normalize(s, errorCode));
+        assertFalse(UnicodeString("nfc.isNormalized ") + i, nfc->isNormalized(s, errorCode));
+        // The quick check yes span ends before the e which combines with the accent.
+        assertEquals(UnicodeString("nfc.spanQuickCheckYes ") + i,
+                     i, nfc->spanQuickCheckYes(s, errorCode));
+        assertTrue(UnicodeString("nfc.isNormalized(composed) ") + i,
+                   nfc->isNormalized(composed, errorCode));
+        assertEquals(UnicodeString("nfd ") + i, asciiDecomposed, nfd->normalize(asciiComposed, errorCode));
+        assertEquals(UnicodeString("nfd.spanQuickCheckYes ") + i,
+                     i, nfd->spanQuickCheckYes(asciiComposed, errorCode));
+
+        std::string result8;
+        StringByteSink<std::string> sink(&result8);
+        nfc->normalizeUTF8(0, s8, sink, nullptr, errorCode);
+        assertTrue(UnicodeString("nfc.normalizeUTF8 ") + i, result8 == composed8);
+        assertFalse(UnicodeString("nfc.isNormalizedUTF8 ") + i, nfc->isNormalizedUTF8(s8, errorCode));
+        assertTrue(UnicodeString("nfc.isNormalizedUTF8(composed) ") + i,
+                   nfc->isNormalizedUTF8(composed8, errorCode));
+        result8.clear();
+        nfd->normalizeUTF8(0, asciiComposed8, sink, nullptr, errorCode);
+        assertTrue(UnicodeString("nfd.normalizeUTF8 ") + i, result8 == asciiDecomposed8);
+        assertFalse(UnicodeString("nfd.isNormalizedUTF8 ") + i,
+                    nfd->isNormalizedUTF8(asciiComposed8, errorCode));
+    }
+}
+
+namespace {
+
+UBool sameCoarseEdits(const Edits &expected, const Edits &actual, UErrorCode &errorCode) {
+    Edits::Iterator ei1 = expected.getCoarseIterator();
+    Edits::Iterator ei2 = actual.getCoarseIterator();
+    for(;;) {
+        UBool more1 = ei1.next(errorCode), more2 = ei2.next(errorCode);
+        if(more1 != more2 || (more1 &&
+                (ei1.hasChange() != ei2.hasChange() ||
+                 ei1.oldLength() != ei2.oldLength() ||
+                 ei1.newLength() != ei2.newLength()))) {
+            return FALSE;
+        }
+        if(!more1) { return TRUE; }
+    }
+}
+
+}  // namespace
+
+void
+BasicNormalizerTest::TestStreamingNormalizer() {
+    IcuTestErrorCode errorCode(*this, "TestStreamingNormalizer");
+    const Normalizer2 *nfc = Normalizer2::getNFCInstance(errorCode);
+    const Normalizer2 *nfd = Normalizer2::getNFDInstance(errorCode);
+    const Normalizer2 *nfkc = Normalizer2::getNFKCInstance(errorCode);
+    const Normalizer2 *nfkc_cf = Normalizer2::getNFKCCasefoldInstance(errorCode);
+    if(errorCode.errDataIfFailureAndReset("Normalizer2::getNFCInstance() call failed")) {
+        return;
+    }
+    UnicodeSet filter(u"[^\u00e4\u1100-\u11ff]", errorCode);
+    filter.freeze();
+    FilteredNormalizer2 fn2(*nfc, filter);
+    const Normalizer2 *normalizers[] = { nfc, nfd, nfkc, nfkc_cf, &fn2 };
+    const char *names[] = { "nfc", "nfd", "nfkc", "nfkc_cf", "filtered nfc" };
+
+    // Combining sequences, Hangul Jamo, decomposing supplementary characters,
+    // a long run of combining marks, and unpaired surrogates.
+    UnicodeString text(
+        u"Ab\u0301\u0323c A\u0308\u00ad\u0323\u00c4\u0323, \ufb01x \u1100\u1161\uac00\u11a8"
+        u"\U0001D15E\U0001D157\U0001D165 q\u0308\u0301\u0323\u0327\u0328\u0308\u0301"
+        u"\u0323\u0327\u0328\u0308\u0301\u0323\u0327\u0328 ");
+    text.append((UChar)0xd800).append(u'x').append((UChar)0xdc00).append(u" \u0344 \u0f73 z");
+    std::string text8;
+    text.toUTF8String(text8);
+    // Ill-formed UTF-8 between well-formed parts.
+    text8.append("\xe1\x86 a\xcc\x81\xc0\x80\xcc\x81\xf0\x9d\x85 x\xcc");
+
+    for(int32_t n = 0; n < UPRV_LENGTHOF(normalizers); ++n) {
+        const Normalizer2 &norm2 = *normalizers[n];
+        UnicodeString expected = norm2.normalize(text, errorCode);
+        std::string expected8;
+        StringByteSink<std::string> expectedSink(&expected8);
+        Edits expectedEdits;
+        Edits *pExpectedEdits = n < 4 ? &expectedEdits : nullptr;  // not supported when filtered
+        norm2.normalizeUTF8(0, text8, expectedSink, pExpectedEdits, errorCode);
+        if(errorCode.errIfFailureAndReset("%s.normalize()", names[n])) {
+            continue;
+        }
+
+        StreamingNormalizer2 stream(norm2);
+        for(int32_t chunkLength = 1; chunkLength <= 9; ++chunkLength) {
+            UnicodeString result;
+            UnicodeStringAppendable appendable(result);
+            int32_t maxPending = 0;
+            for(int32_t i = 0; i < text.length(); i += chunkLength) {
+                int32_t length = i + chunkLength <= text.length() ? chunkLength : text.length() - i;
+                stream.append(text.getBuffer() + i, length, appendable, errorCode);
+                if(maxPending < stream.getPendingLength()) {
+                    maxPending = stream.getPendingLength();
+                }
+            }
+            stream.finish(appendable, errorCode);
+            assertEquals(UnicodeString(names[n]) + " chunks of " + chunkLength, expected, result);
+            assertEquals("pending after finish()", 0, stream.getPendingLength());
+            // The longest unstable sequence is the q with 15 combining marks.
+            assertTrue(UnicodeString(names[n]) + " bounded pending length", maxPending <= 24);
+
+            std::string result8;
+            StringByteSink<std::string> sink(&result8);
+            Edits edits;
+            Edits *pEdits = pExpectedEdits != nullptr ? &edits : nullptr;
+            int32_t length8 = (int32_t)text8.length();
+            for(int32_t i = 0; i < length8; i += chunkLength) {
+                int32_t length = i + chunkLength <= length8 ? chunkLength : length8 - i;
+                stream.appendUTF8(0, StringPiece(text8.data() + i, length), sink, pEdits, errorCode);
+            }
+            stream.finishUTF8(0, sink, pEdits, errorCode);
+            assertTrue(UnicodeString(names[n]) + " UTF-8 chunks of " + chunkLength,
+                       result8 == expected8);
+            if(pEdits != nullptr) {
+                assertTrue(UnicodeString(names[n]) + " UTF-8 edits for chunks of " + chunkLength,
+                           sameCoarseEdits(expectedEdits, edits, errorCode));
+            }
+            errorCode.errIfFailureAndReset("%s streaming chunks of %d", names[n], (int)chunkLength);
+        }
+    }
+}
+
+void
+BasicNormalizerTest::TestParallelNormalizer() {
+    IcuTestErrorCode errorCode(*this, "TestParallelNormalizer");
+    const Normalizer2 *nfc = Normalizer2::getNFCInstance(errorCode);
+    const Normalizer2 *nfd = Normalizer2::getNFDInstance(errorCode);
+    const Normalizer2 *nfkc_cf = Normalizer2::getNFKCCasefoldInstance(errorCode);
+    if(errorCode.errDataIfFailureAndReset("Normalizer2::getNFCInstance() call failed")) {
+        return;
+    }
+    UnicodeSet filter(u"[^\u00e4\u1100-\u11ff]", errorCode);
+    filter.freeze();
+    FilteredNormalizer2 fn2(*nfc, filter);
+    const Normalizer2 *normalizers[] = { nfc, nfd, nfkc_cf, &fn2 };
+    const char *names[] = { "nfc", "nfd", "nfkc_cf", "filtered nfc" };
+
+    UnicodeString piece(
+        u"Ab\u0301\u0323c A\u0308\u00ad\u0323\u00c4\u0323, \ufb01x \u1100\u1161\uac00\u11a8"
+        u"\U0001D15E\U0001D157\U0001D165 q\u0308\u0301\u0323\u0327\u0328\u0308\u0301 ");
+    piece.append((UChar)0xd800).append(u'x').append((UChar)0xdc00).append(u" \u0344 \u0f73 z");
+    UnicodeString text;
+    for(int32_t i = 0; i < 20; ++i) {
+        text.append(piece);
+    }
+    std::string text8;
+    text.toUTF8String(text8);
+    text8.append("\xe1\x86 a\xcc\x81\xc0\x80\xcc\x81\xf0\x9d\x85 x\xcc");
+
+    for(int32_t n = 0; n < UPRV_LENGTHOF(normalizers); ++n) {
+        const Normalizer2 &norm2 = *normalizers[n];
+        UnicodeString expected = norm2.normalize(text, errorCode);
+        std::string expected8;
+        StringByteSink<std::string> expectedSink(&expected8);
+        Edits expectedEdits;
+        Edits *pExpectedEdits = n < 3 ? &expectedEdits : nullptr;  // not supported when filtered
+        norm2.normalizeUTF8(0, text8, expectedSink, pExpectedEdits, errorCode);
+        if(errorCode.errIfFailureAndReset("%s.normalize()", names[n])) {
+            continue;
+        }
+        // Segment count 0: No runner, all of the text is normalized on this thread.
+        static const int32_t segmentCounts[] = { 0, 1, 2, 3, 5 };
+        static const int32_t minSegmentLengths[] = { 1, 7, 100, 100000 };
+        for(int32_t t = 0; t < UPRV_LENGTHOF(segmentCounts); ++t) {
+            int32_t maxSegments = segmentCounts[t];
+            ParallelNormalizer2 parallel(norm2, maxSegments,
+                                         maxSegments > 0 ? runTasksOnThreads : nullptr, nullptr);
+            assertEquals("getMaxSegments()", maxSegments > 0 ? maxSegments : 1,
+                         parallel.getMaxSegments());
+            for(int32_t m = 0; m < UPRV_LENGTHOF(minSegmentLengths); ++m) {
+                parallel.setMinSegmentLength(minSegmentLengths[m]);
+                UnicodeString message = UnicodeString(names[n]) + " segments=" + maxSegments +
+                    " min=" + minSegmentLengths[m];
+                UnicodeString result;
+                parallel.normalize(text, result, errorCode);
+                assertEquals(message, expected, result);
+
+                std::string result8;
+                StringByteSink<std::string> sink(&result8);
+                Edits edits;
+                Edits *pEdits = pExpectedEdits != nullptr ? &edits : nullptr;
+                parallel.normalizeUTF8(0, text8, sink, pEdits, errorCode);
+                assertTrue(message + " UTF-8", result8 == expected8);
+                if(pEdits != nullptr) {
+                    assertTrue(message + " UTF-8 edits", sameCoarseEdits(expectedEdits, edits, errorCode));
+                }
+                errorCode.errIfFailureAndReset("%s parallel", names[n]);
+            }
+        }
+    }
+
+    // The source and destination strings must differ.
+    ParallelNormalizer2 parallel(*nfc, 2, runTasksOnThreads, nullptr);
+    parallel.setMinSegmentLength(1);
+    UnicodeString same(u"abc");
+    parallel.normalize(same, same, errorCode);
+    assertEquals("normalize(s, s)", U_ILLEGAL_ARGUMENT_ERROR, errorCode.reset());
+    ParallelNormalizer2 tooMany(*nfc, 1000, runTasksOnThreads, nullptr);
+    assertEquals("at most 64 segments", 64, tooMany.getMaxSegments());
+}
+
+void
+BasicNormalizerTest::TestNormalizeUTF8InPlace() {
+    IcuTestErrorCode errorCode(*this, "TestNormalizeUTF8InPlace");
+    const Normalizer2 *nfc = Normalizer2::getNFCInstance(errorCode);
+    const Normalizer2 *nfd = Normalizer2::getNFDInstance(errorCode);
+    const Normalizer2 *nfkc_cf = Normalizer2::getNFKCCasefoldInstance(errorCode);
+    const Normalizer2 *fcd = Normalizer2::getInstance(nullptr, "nfc", UNORM2_FCD, errorCode);
+    if(errorCode.errDataIfFailureAndReset("Normalizer2::getNFCInstance() call failed")) {
+        return;
+    }
+    UnicodeSet filter(u"[^\u00e4\u1100-\u11ff]", errorCode);
+    filter.freeze();
+    FilteredNormalizer2 fn2(*nfc, filter);
+    // FCD and the filtered normalizer do not record edits and take another code path.
+    const Normalizer2 *normalizers[] = { nfc, nfd, nfkc_cf, fcd, &fn2 };
+    const char *names[] = { "nfc", "nfd", "nfkc_cf", "fcd", "filtered nfc" };
+    // Already normalized, shrinking, growing, and both.
+    static const char16_t *const strings[] = {
+        u"",
+        u"plain text",
+        u"A\u0308bc",
+        u"xy\u00e4",
+        u"\ufb01 \u1100\u1161 \u212b ab \u00c5 cd \ufb01x \u0344 A\u030a",
+        u"\u0f73\u0f73 q\u0323\u0308 \uac00\u11a8 \U0001D15E \u2126\u2126\u2126 \u00e4\u00e4"
+    };
+    for(int32_t n = 0; n < UPRV_LENGTHOF(normalizers); ++n) {
+        const Normalizer2 &norm2 = *normalizers[n];
+        for(int32_t i = 0; i < UPRV_LENGTHOF(strings); ++i) {
+            std::string s8;
+            UnicodeString(strings[i]).toUTF8String(s8);
+            int32_t length = (int32_t)s8.length();
+            std::string expected;
+            StringByteSink<std::string> sink(&expected);
+            norm2.normalizeUTF8(0, s8, sink, nullptr, errorCode);
+            int32_t expectedLength = (int32_t)expected.length();
+            UnicodeString message = UnicodeString(names[n]) + " #" + i;
+
+            char buffer[100];
+            uprv_memcpy(buffer, s8.data(), length);
+            int32_t firstChange = -1;
+            int32_t resultLength =
+                norm2.normalizeUTF8InPlace(buffer, length, length, &firstChange, errorCode);
+            assertEquals(message + " length", expectedLength, resultLength);
+            if(expected == s8) {
+                assertEquals(message + " no change", length, firstChange);
+            } else {
+                assertTrue(message + " first change", 0 <= firstChange && firstChange < length &&
+                           firstChange <= expectedLength &&
+                           memcmp(s8.data(), expected.data(), firstChange) == 0);
+            }
+            if(expectedLength > length) {
+                assertEquals(message + " overflow", U_BUFFER_OVERFLOW_ERROR, errorCode.reset());
+                assertTrue(message + " unchanged on overflow", std::string(buffer, length) == s8);
+            } else {
+                errorCode.reset();  // U_STRING_NOT_TERMINATED_WARNING if the length is the same
+                assertTrue(message, std::string(buffer, resultLength) == expected);
+            }
+
+            uprv_memcpy(buffer, s8.data(), length);
+            resultLength = norm2.normalizeUTF8InPlace(
+                buffer, length, UPRV_LENGTHOF(buffer), nullptr, errorCode);
+            if(errorCode.errIfFailureAndReset("%s #%d", names[n], (int)i)) {
+                continue;
+            }
+            assertTrue(message + " with room", std::string(buffer, resultLength) == expected);
+            assertEquals(message + " NUL-terminated", 0, buffer[resultLength]);
+        }
+    }
+    char s[20] = "a";
+    nfc->normalizeUTF8InPlace(s, 1, 0, nullptr, errorCode);
+    assertEquals("capacity < length", U_ILLEGAL_ARGUMENT_ERROR, errorCode.reset());
+    nfc->normalizeUTF8InPlace(nullptr, 0, 0, nullptr, errorCode);
+    assertSuccess("empty", errorCode);
+}
+
+void
+BasicNormalizerTest::TestSearchKeyNormalizer() {
+    IcuTestErrorCode errorCode(*this, "TestSearchKeyNormalizer");
+    const Normalizer2 *nfkc_cf = Normalizer2::getNFKCCasefoldInstance(errorCode);
+    if(errorCode.errDataIfFailureAndReset("Normalizer2::getNFKCCasefoldInstance() call failed")) {
+        return;
+    }
+    UnicodeSet excluded(u"[\u00df\u2160-\u217f A-C]", errorCode);
+    UnicodeSet removed(u"[[:P:][:Zs:]]", errorCode);
+    UnicodeSet filter(excluded);
+    filter.complement().freeze();
+    FilteredNormalizer2 filtered(*nfkc_cf, filter);
+    SearchKeyNormalizer plain(errorCode);
+    SearchKeyNormalizer withExcluded(&excluded, nullptr, errorCode);
+    SearchKeyNormalizer withRemoved(nullptr, &removed, errorCode);
+    SearchKeyNormalizer withBoth(&excluded, &removed, errorCode);
+    if(errorCode.errIfFailureAndReset("SearchKeyNormalizer constructors")) {
+        return;
+    }
+    const SearchKeyNormalizer *keyNormalizers[] = { &plain, &withExcluded, &withRemoved, &withBoth };
+    const Normalizer2 *normalizers[] = { nfkc_cf, &filtered, nfkc_cf, &filtered };
+    const UnicodeSet *removedSets[] = { nullptr, nullptr, &removed, &removed };
+
+    // ASCII before combining marks, default ignorables, compatibility characters,
+    // case folding that changes the length, and ill-formed UTF-8.
+    static const char16_t *const strings[] = {
+        u"",
+        u"Hello, World!",
+        u"Stra\u00dfe STRASSE e\u0301 A\u030a <\u0338 a\u00adb\u200dc",
+        u"\ufb01 \u2163 \u2167 \u00c5\u212b \uff21\uff22 \u1e9e\u00df \u03a3\u03c2 \U0001D400",
+        u"\u0130stanbul \u0f73 \uac00\u11a8 \u3000x\u3000 \ufe0f\u180b END."
+    };
+    for(int32_t i = 0; i < UPRV_LENGTHOF(strings); ++i) {
+        UnicodeString s(strings[i]);
+        std::string s8;
+        s.toUTF8String(s8);
+        if(i == UPRV_LENGTHOF(strings) - 1) {
+            s8.append("Q\xcc\x87\xc0\x80z\xe2\x84");
+        }
+        for(int32_t k = 0; k < UPRV_LENGTHOF(keyNormalizers); ++k) {
+            UnicodeString expected = normalizers[k]->normalize(s, errorCode);
+            std::string expected8;
+            StringByteSink<std::string> expectedSink(&expected8);
+            normalizers[k]->normalizeUTF8(0, s8, expectedSink, nullptr, errorCode);
+            if(removedSets[k] != nullptr) {
+                UnicodeString kept;
+                for(int32_t j = 0; j < expected.length();) {
+                    UChar32 c = expected.char32At(j);
+                    if(!removedSets[k]->contains(c)) { kept.append(c); }
+                    j += U16_LENGTH(c);
+                }
+                expected = kept;
+                std::string kept8;
+                for(int32_t j = 0; j < (int32_t)expected8.length();) {
+                    int32_t span = removedSets[k]->spanUTF8(expected8.data() + j,
+                        (int32_t)expected8.length() - j, USET_SPAN_NOT_CONTAINED);
+                    kept8.append(expected8, j, span);
+                    j += span;
+                    j += removedSets[k]->spanUTF8(expected8.data() + j,
+                        (int32_t)expected8.length() - j, USET_SPAN_CONTAINED);
+                }
+                expected8 = kept8;
+            }
+            UnicodeString message = UnicodeString("key #") + i + " normalizer " + k;
+            UnicodeString result;
+            keyNormalizers[k]->normalize(s, result, errorCode);
+            assertEquals(message, expected, result);
+            std::string result8;
+            StringByteSink<std::string> sink(&result8);
+            keyNormalizers[k]->normalizeUTF8(s8, sink, errorCode);
+            assertTrue(message + " UTF-8", result8 == expected8);
+            errorCode.errIfFailureAndReset("key #%d normalizer %d", (int)i, (int)k);
+        }
+    }
+    // Spot checks.
+    std::string source8, result8;
+    UnicodeString(u"Hello, Stra\u00dfe! \u2163 Cafe\u0301").toUTF8String(source8);
+    StringByteSink<std::string> sink(&result8);
+    withBoth.normalizeUTF8(source8, sink, errorCode);
+    assertEquals("withBoth", u"hellostra\u00dfe\u2163Caf\u00e9", UnicodeString::fromUTF8(result8));
+    UnicodeString result;
+    assertEquals("plain", u"strasse\u00e9ab", plain.normalize(u"STRA\u00dfE\u00c9a\u00adB", result, errorCode));
+}
+
 #endif /* #if !UCONFIG_NO_NORMALIZATION */
@@ -54,6 +54,11 @@ class BasicNormalizerTest : public IntlTest {
     void TestNormalizeIllFormedText();
     void TestComposeJamoTBase();
     void TestComposeBoundaryAfter();
+    void TestLowTextRuns();
+    void TestStreamingNormalizer();
+    void TestParallelNormalizer();
+    void TestNormalizeUTF8InPlace();
+    void TestSearchKeyNormalizer();
 
 private:
     UnicodeString canonTests[24][3];
@@ -174,6 +174,27 @@ class CmdIter : public UPerfFunction {
             while (ucol_next(iter, status) != UCOL_NULLORDER) exec_count++;
         }
 
+        // Fetches native 64-bit CEs in batches rather than 32-bit orders one at a time.
+        void icu_forward_bulk_null(UErrorCode* status, int32_t i){
+            int64_t ces[64];
+            int32_t n;
+            ucol_setText(iter, data->dataOf(i), -1, status);
+            do {
+                n = ucol_nextCEs(iter, ces, NULL, UPRV_LENGTHOF(ces), status);
+                exec_count += n;
+            } while (n == UPRV_LENGTHOF(ces));
+        }
+
+        void icu_forward_bulk_len(UErrorCode* status, int32_t i){
+            int64_t ces[64];
+            int32_t n;
+            ucol_setText(iter, data->dataOf(i), data->lengthOf(i) , status);
+            do {
+                n = ucol_nextCEs(iter, ces, NULL, UPRV_LENGTHOF(ces), status);
+                exec_count += n;
+            } while (n == UPRV_LENGTHOF(ces));
+        }
+
         void icu_backward_null(UErrorCode* status, int32_t i){
             ucol_setText(iter, data->dataOf(i), -1, status);
             while (ucol_previous(iter, status) != UCOL_NULLORDER) exec_count++;
@@ -701,6 +722,8 @@ class CollPerfTest : public UPerfTest {
     TEST(testname, CmdIter, col, count, icu_data, &CmdIter::func,0,0)
         TEST_ITER(TestIcu_ForwardIter_null, icu_forward_null);
         TEST_ITER(TestIcu_ForwardIter_len, icu_forward_len);
+        TEST_ITER(TestIcu_ForwardIterBulk_null, icu_forward_bulk_null);
+        TEST_ITER(TestIcu_ForwardIterBulk_len, icu_forward_bulk_len);
         TEST_ITER(TestIcu_BackwardIter_null, icu_backward_null);
         TEST_ITER(TestIcu_BackwardIter_len, icu_backward_len);
 
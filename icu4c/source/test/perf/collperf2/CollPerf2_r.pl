@@ -141,6 +141,17 @@
         "TestRandomWordsUDHR_el.txt"
     ],
 
+    # Normalization mode on: FCD checking in the collation iterators.
+    "el-u-kk",
+    [
+        "TestRandomWordsUDHR_el.txt"
+    ],
+
+    "fr-u-kk",
+    [
+        "TestRandomWordsUDHR_fr.txt"
+    ],
+
     "ru",
     [
         "TestNames_Russian.txt"
@@ -10,6 +10,8 @@
 */
 
 #include <string.h>
+#include <thread>
+#include <vector>
 #include "unicode/localpointer.h"
 #include "unicode/uperf.h"
 #include "unicode/ucol.h"
@@ -17,6 +19,7 @@
 #include "unicode/uiter.h"
 #include "unicode/ustring.h"
 #include "unicode/sortkey.h"
+#include "unicode/usortkeystore.h"
 #include "uarrsort.h"
 #include "uoptions.h"
 #include "ustr_imp.h"
@@ -328,6 +331,66 @@ long GetSortKey::getOperationsPerIteration()
     return source->count;
 }
 
+//
+// Test case taking a single test data array in UTF-8, calling ucol_getSortKeyUTF8 for each,
+// or else converting each string to UTF-16 and calling ucol_getSortKey
+//
+class GetSortKeyUTF8 : public UPerfFunction
+{
+public:
+    GetSortKeyUTF8(const UCollator* coll, const CA_char* source, UBool convert);
+    ~GetSortKeyUTF8();
+    virtual void call(UErrorCode* status);
+    virtual long getOperationsPerIteration();
+
+private:
+    const UCollator *coll;
+    const CA_char *source;
+    UBool convert;
+};
+
+GetSortKeyUTF8::GetSortKeyUTF8(const UCollator* coll, const CA_char* source, UBool convert)
+    :   coll(coll),
+        source(source),
+        convert(convert)
+{
+}
+
+GetSortKeyUTF8::~GetSortKeyUTF8()
+{
+}
+
+void GetSortKeyUTF8::call(UErrorCode* status)
+{
+    if (U_FAILURE(*status)) return;
+
+    uint8_t key[KEY_BUF_SIZE];
+    int32_t len;
+
+    if (convert) {
+        UChar s16[1024];
+        int32_t length16;
+        for (int32_t i = 0; i < source->count && U_SUCCESS(*status); i++) {
+            u_strFromUTF8WithSub(s16, (int32_t)(sizeof(s16) / sizeof(s16[0])), &length16,
+                                 source->dataOf(i), source->lengthOf(i), 0xfffd, NULL, status);
+            len = ucol_getSortKey(coll, s16, length16, key, KEY_BUF_SIZE);
+        }
+    } else {
+        for (int32_t i = 0; i < source->count && U_SUCCESS(*status); i++) {
+            len = ucol_getSortKeyUTF8(coll, source->dataOf(i), source->lengthOf(i),
+                                      key, KEY_BUF_SIZE, status);
+            if (*status == U_BUFFER_OVERFLOW_ERROR) {
+                *status = U_ZERO_ERROR;
+            }
+        }
+    }
+}
+
+long GetSortKeyUTF8::getOperationsPerIteration()
+{
+    return source->count;
+}
+
 //
 // Test case taking a single test data array in UTF-16, calling ucol_nextSortKeyPart for each for the
 // given buffer size
@@ -462,6 +525,407 @@ long NextSortKeyPartUTF8::getEventsPerIteration()
     return events;
 }
 
+//
+// Test case taking a single test data array in UTF-16, calling ucol_getSortKeys
+// to write all of the sort keys into one arena, growing it as needed
+//
+class GetSortKeys : public UPerfFunction
+{
+public:
+    GetSortKeys(const UCollator* coll, const CA_uchar* source);
+    ~GetSortKeys();
+    virtual void call(UErrorCode* status);
+    virtual long getOperationsPerIteration();
+
+private:
+    const UCollator *coll;
+    const CA_uchar *source;
+    const UChar **strings;
+    int32_t *lengths;
+    int32_t *offsets;
+    uint8_t *arena;
+    int32_t capacity;
+};
+
+GetSortKeys::GetSortKeys(const UCollator* coll, const CA_uchar* source)
+    :   coll(coll),
+        source(source),
+        capacity(4096)
+{
+    strings = (const UChar **)malloc(sizeof(const UChar *) * source->count);
+    lengths = (int32_t *)malloc(sizeof(int32_t) * source->count);
+    offsets = (int32_t *)malloc(sizeof(int32_t) * (source->count + 1));
+    arena = (uint8_t *)malloc(capacity);
+    for (int32_t i = 0; i < source->count; i++) {
+        strings[i] = source->dataOf(i);
+        lengths[i] = source->lengthOf(i);
+    }
+}
+
+GetSortKeys::~GetSortKeys()
+{
+    free(strings);
+    free(lengths);
+    free(offsets);
+    free(arena);
+}
+
+void GetSortKeys::call(UErrorCode* status)
+{
+    if (U_FAILURE(*status)) return;
+
+    int32_t n = 0, total = 0;
+    while (n < source->count && U_SUCCESS(*status)) {
+        int32_t written = ucol_getSortKeys(coll, strings + n, lengths + n, source->count - n,
+                                           arena + total, capacity - total, offsets + n,
+                                           NULL, status);
+        n += written;
+        total += offsets[n];
+        if (*status == U_BUFFER_OVERFLOW_ERROR) {
+            *status = U_ZERO_ERROR;
+            capacity *= 2;
+            arena = (uint8_t *)realloc(arena, capacity);
+        }
+    }
+}
+
+long GetSortKeys::getOperationsPerIteration()
+{
+    return source->count;
+}
+
+//
+// Test case taking a single test data array in UTF-8, calling ucol_getSortKeysUTF8
+// to write all of the sort keys into one arena, growing it as needed
+//
+class GetSortKeysUTF8 : public UPerfFunction
+{
+public:
+    GetSortKeysUTF8(const UCollator* coll, const CA_char* source);
+    ~GetSortKeysUTF8();
+    virtual void call(UErrorCode* status);
+    virtual long getOperationsPerIteration();
+
+private:
+    const UCollator *coll;
+    const CA_char *source;
+    const char **strings;
+    int32_t *lengths;
+    int32_t *offsets;
+    uint8_t *arena;
+    int32_t capacity;
+};
+
+GetSortKeysUTF8::GetSortKeysUTF8(const UCollator* coll, const CA_char* source)
+    :   coll(coll),
+        source(source),
+        capacity(4096)
+{
+    strings = (const char **)malloc(sizeof(const char *) * source->count);
+    lengths = (int32_t *)malloc(sizeof(int32_t) * source->count);
+    offsets = (int32_t *)malloc(sizeof(int32_t) * (source->count + 1));
+    arena = (uint8_t *)malloc(capacity);
+    for (int32_t i = 0; i < source->count; i++) {
+        strings[i] = source->dataOf(i);
+        lengths[i] = source->lengthOf(i);
+    }
+}
+
+GetSortKeysUTF8::~GetSortKeysUTF8()
+{
+    free(strings);
+    free(lengths);
+    free(offsets);
+    free(arena);
+}
+
+void GetSortKeysUTF8::call(UErrorCode* status)
+{
+    if (U_FAILURE(*status)) return;
+
+    int32_t n = 0, total = 0;
+    while (n < source->count && U_SUCCESS(*status)) {
+        int32_t written = ucol_getSortKeysUTF8(coll, strings + n, lengths + n, source->count - n,
+                                               arena + total, capacity - total, offsets + n,
+                                               NULL, status);
+        n += written;
+        total += offsets[n];
+        if (*status == U_BUFFER_OVERFLOW_ERROR) {
+            *status = U_ZERO_ERROR;
+            capacity *= 2;
+            arena = (uint8_t *)realloc(arena, capacity);
+        }
+    }
+}
+
+long GetSortKeysUTF8::getOperationsPerIteration()
+{
+    return source->count;
+}
+
+//
+// Test case taking a single test data array in UTF-16 or UTF-8,
+// calling ucol_sortStrings/ucol_sortStringsUTF8 to get the sorted order of the strings,
+// or else sorting their indexes with uprv_sortArray and ucol_strcoll/ucol_strcollUTF8
+//
+struct SortContext {
+    const UCollator *coll;
+    const CA_uchar *source16;
+    const CA_char *source8;
+};
+
+static int32_t U_CALLCONV
+StrcollIndexComparator(const void *context, const void *left, const void *right) {
+    const SortContext &sc = *(const SortContext *)context;
+    int32_t i = *(const int32_t *)left;
+    int32_t j = *(const int32_t *)right;
+    return ucol_strcoll(sc.coll, sc.source16->dataOf(i), sc.source16->lengthOf(i),
+                        sc.source16->dataOf(j), sc.source16->lengthOf(j));
+}
+
+static int32_t U_CALLCONV
+StrcollUTF8IndexComparator(const void *context, const void *left, const void *right) {
+    const SortContext &sc = *(const SortContext *)context;
+    int32_t i = *(const int32_t *)left;
+    int32_t j = *(const int32_t *)right;
+    UErrorCode errorCode = U_ZERO_ERROR;
+    return ucol_strcollUTF8(sc.coll, sc.source8->dataOf(i), sc.source8->lengthOf(i),
+                            sc.source8->dataOf(j), sc.source8->lengthOf(j), &errorCode);
+}
+
+U_CDECL_BEGIN
+static void U_CALLCONV
+runTasksOnThreads(const void * /*runnerContext*/, UTask task, void *taskContext, int32_t count) {
+    std::vector<std::thread> threads;
+    for (int32_t i = 0; i < count; ++i) {
+        threads.emplace_back(task, taskContext, i);
+    }
+    for (std::thread &t : threads) {
+        t.join();
+    }
+}
+U_CDECL_END
+
+class SortStrings : public UPerfFunction
+{
+public:
+    SortStrings(const UCollator* coll, const CA_uchar* source16, const CA_char* source8,
+                UBool byStrcoll);
+    ~SortStrings();
+    virtual void call(UErrorCode* status);
+    virtual long getOperationsPerIteration();
+
+private:
+    SortContext context;
+    UBool byStrcoll;
+    int32_t count;
+    const UChar **strings16;
+    const char **strings8;
+    int32_t *lengths;
+    int32_t *permutation;
+    int32_t maxTasks;
+};
+
+SortStrings::SortStrings(const UCollator* coll, const CA_uchar* source16, const CA_char* source8,
+                         UBool byStrcoll)
+    :   byStrcoll(byStrcoll),
+        strings16(NULL),
+        strings8(NULL),
+        maxTasks(static_cast<int32_t>(std::thread::hardware_concurrency()))
+{
+    context.coll = coll;
+    context.source16 = source16;
+    context.source8 = source8;
+    count = source16 != NULL ? source16->count : source8->count;
+    lengths = (int32_t *)malloc(sizeof(int32_t) * count);
+    permutation = (int32_t *)malloc(sizeof(int32_t) * count);
+    if (source16 != NULL) {
+        strings16 = (const UChar **)malloc(sizeof(const UChar *) * count);
+        for (int32_t i = 0; i < count; i++) {
+            strings16[i] = source16->dataOf(i);
+            lengths[i] = source16->lengthOf(i);
+        }
+    } else {
+        strings8 = (const char **)malloc(sizeof(const char *) * count);
+        for (int32_t i = 0; i < count; i++) {
+            strings8[i] = source8->dataOf(i);
+            lengths[i] = source8->lengthOf(i);
+        }
+    }
+}
+
+SortStrings::~SortStrings()
+{
+    free(strings16);
+    free(strings8);
+    free(lengths);
+    free(permutation);
+}
+
+void SortStrings::call(UErrorCode* status)
+{
+    if (U_FAILURE(*status)) return;
+
+    if (byStrcoll) {
+        for (int32_t i = 0; i < count; i++) {
+            permutation[i] = i;
+        }
+        uprv_sortArray(permutation, count, (int32_t)sizeof(int32_t),
+                       strings16 != NULL ? StrcollIndexComparator : StrcollUTF8IndexComparator,
+                       &context, FALSE, status);
+    } else if (strings16 != NULL) {
+        ucol_sortStrings(context.coll, strings16, lengths, count, permutation,
+                         maxTasks, runTasksOnThreads, NULL, status);
+    } else {
+        ucol_sortStringsUTF8(context.coll, strings8, lengths, count, permutation,
+                             maxTasks, runTasksOnThreads, NULL, status);
+    }
+}
+
+long SortStrings::getOperationsPerIteration()
+{
+    return count;
+}
+
+//
+// Test case taking sorted test data in UTF-16, with the sort keys of all strings,
+// and looking up the range of keys between the primary-level bounds of each key,
+// either in a USortKeyStore or with binary searches in the array of raw sort keys.
+//
+class SortKeyLookup : public UPerfFunction
+{
+public:
+    SortKeyLookup(const UCollator* coll, const CA_uchar* source, UBool inStore);
+    ~SortKeyLookup();
+    virtual void call(UErrorCode* status);
+    virtual long getOperationsPerIteration();
+
+private:
+    int32_t lowerBound(const uint8_t *bound) const;
+    int32_t upperBound(const uint8_t *bound) const;
+
+    UBool inStore;
+    int32_t count;
+    int32_t *offsets;
+    uint8_t *keys;
+    uint32_t *storeData;
+    USortKeyStore *store;
+};
+
+SortKeyLookup::SortKeyLookup(const UCollator* coll, const CA_uchar* source, UBool inStore)
+    :   inStore(inStore),
+        count(source->count),
+        storeData(NULL),
+        store(NULL)
+{
+    UErrorCode status = U_ZERO_ERROR;
+    const UChar **strings = (const UChar **)malloc(sizeof(const UChar *) * count);
+    int32_t *lengths = (int32_t *)malloc(sizeof(int32_t) * count);
+    for (int32_t i = 0; i < count; i++) {
+        strings[i] = source->dataOf(i);
+        lengths[i] = source->lengthOf(i);
+    }
+    offsets = (int32_t *)malloc(sizeof(int32_t) * (count + 1));
+    int32_t capacity = count * 64;
+    keys = (uint8_t *)malloc(capacity);
+    int32_t n = 0;
+    while (n < count && U_SUCCESS(status)) {
+        int32_t total = n == 0 ? 0 : offsets[n];
+        int32_t written = ucol_getSortKeys(coll, strings + n, lengths + n, count - n,
+                                           keys + total, capacity - total, offsets + n,
+                                           NULL, &status);
+        for (int32_t i = n; i <= n + written; ++i) {
+            offsets[i] += total;
+        }
+        n += written;
+        if (status == U_BUFFER_OVERFLOW_ERROR) {
+            status = U_ZERO_ERROR;
+            capacity *= 2;
+            keys = (uint8_t *)realloc(keys, capacity);
+        }
+    }
+    free(strings);
+    free(lengths);
+    if (inStore && U_SUCCESS(status)) {
+        int32_t length = usortkeystore_build(keys, offsets, count, 0, NULL, 0, &status);
+        status = U_ZERO_ERROR;
+        storeData = (uint32_t *)malloc(length);
+        usortkeystore_build(keys, offsets, count, 0, storeData, length, &status);
+        store = usortkeystore_openFromBinary(storeData, length, NULL, &status);
+        // Raw keys also need an offset or pointer per key.
+        fprintf(stderr, "%d sort keys: %.1f bytes per raw key + 4 for its offset, "
+                "%.1f bytes per key in the USortKeyStore\n",
+                (int)count, (double)offsets[count] / count, (double)length / count);
+    }
+    if (U_FAILURE(status)) {
+        fprintf(stderr, "SortKeyLookup setup failed - %s\n", u_errorName(status));
+    }
+}
+
+SortKeyLookup::~SortKeyLookup()
+{
+    usortkeystore_close(store);
+    free(storeData);
+    free(offsets);
+    free(keys);
+}
+
+int32_t SortKeyLookup::lowerBound(const uint8_t *bound) const
+{
+    int32_t start = 0, limit = count;
+    while (start < limit) {
+        int32_t mid = (start + limit) / 2;
+        if (strcmp((const char *)keys + offsets[mid], (const char *)bound) < 0) {
+            start = mid + 1;
+        } else {
+            limit = mid;
+        }
+    }
+    return start;
+}
+
+int32_t SortKeyLookup::upperBound(const uint8_t *bound) const
+{
+    int32_t start = 0, limit = count;
+    while (start < limit) {
+        int32_t mid = (start + limit) / 2;
+        if (strcmp((const char *)keys + offsets[mid], (const char *)bound) <= 0) {
+            start = mid + 1;
+        } else {
+            limit = mid;
+        }
+    }
+    return start;
+}
+
+void SortKeyLookup::call(UErrorCode* status)
+{
+    if (U_FAILURE(*status)) return;
+
+    for (int32_t i = 0; i < count; i++) {
+        const uint8_t *key = keys + offsets[i];
+        int32_t start, limit;
+        if (inStore) {
+            start = usortkeystore_getBoundRange(store, key, -1, UCOL_BOUND_UPPER, 1, &limit, status);
+        } else {
+            uint8_t lower[2048], upper[2048];
+            ucol_getBound(key, -1, UCOL_BOUND_LOWER, 1, lower, (int32_t)sizeof(lower), status);
+            ucol_getBound(key, -1, UCOL_BOUND_UPPER, 1, upper, (int32_t)sizeof(upper), status);
+            start = lowerBound(lower);
+            limit = upperBound(upper);
+        }
+        if (start > i || i >= limit) {
+            *status = U_INTERNAL_PROGRAM_ERROR;  // The key must be in its own range.
+            return;
+        }
+    }
+}
+
+long SortKeyLookup::getOperationsPerIteration()
+{
+    return count;
+}
+
 // CPP API test cases
 
 //
@@ -1093,6 +1557,10 @@ class CollPerf2Test : public UPerfTest
 
     UPerfFunction* TestGetSortKey();
     UPerfFunction* TestGetSortKeyNull();
+    UPerfFunction* TestGetSortKeyUTF8();
+    UPerfFunction* TestGetSortKeyFromUTF8();
+    UPerfFunction* TestGetSortKeys();
+    UPerfFunction* TestGetSortKeysUTF8();
 
     UPerfFunction* TestNextSortKeyPart_4All();
     UPerfFunction* TestNextSortKeyPart_4x2();
@@ -1122,6 +1590,12 @@ class CollPerf2Test : public UPerfTest
     UPerfFunction* TestUniStrSort();
     UPerfFunction* TestStringPieceSortCpp();
     UPerfFunction* TestStringPieceSortC();
+    UPerfFunction* TestSortStrings();
+    UPerfFunction* TestSortStringsUTF8();
+    UPerfFunction* TestSortStringsByStrcoll();
+    UPerfFunction* TestSortStringsByStrcollUTF8();
+    UPerfFunction* TestSortKeyStoreLookup();
+    UPerfFunction* TestSortKeyBinSearch();
 
     UPerfFunction* TestUniStrBinSearch();
     UPerfFunction* TestStringPieceBinSearchCpp();
@@ -1402,6 +1876,10 @@ CollPerf2Test::runIndexedTest(int32_t index, UBool exec, const char *&name, char
 
     TESTCASE_AUTO(TestGetSortKey);
     TESTCASE_AUTO(TestGetSortKeyNull);
+    TESTCASE_AUTO(TestGetSortKeyUTF8);
+    TESTCASE_AUTO(TestGetSortKeyFromUTF8);
+    TESTCASE_AUTO(TestGetSortKeys);
+    TESTCASE_AUTO(TestGetSortKeysUTF8);
 
     TESTCASE_AUTO(TestNextSortKeyPart_4All);
     TESTCASE_AUTO(TestNextSortKeyPart_4x4);
@@ -1429,6 +1907,12 @@ CollPerf2Test::runIndexedTest(int32_t index, UBool exec, const char *&name, char
     TESTCASE_AUTO(TestUniStrSort);
     TESTCASE_AUTO(TestStringPieceSortCpp);
     TESTCASE_AUTO(TestStringPieceSortC);
+    TESTCASE_AUTO(TestSortStrings);
+    TESTCASE_AUTO(TestSortStringsUTF8);
+    TESTCASE_AUTO(TestSortStringsByStrcoll);
+    TESTCASE_AUTO(TestSortStringsByStrcollUTF8);
+    TESTCASE_AUTO(TestSortKeyStoreLookup);
+    TESTCASE_AUTO(TestSortKeyBinSearch);
 
     TESTCASE_AUTO(TestUniStrBinSearch);
     TESTCASE_AUTO(TestStringPieceBinSearchCpp);
@@ -1528,6 +2012,46 @@ UPerfFunction* CollPerf2Test::TestGetSortKeyNull()
     return testCase;
 }
 
+UPerfFunction* CollPerf2Test::TestGetSortKeyUTF8()
+{
+    UErrorCode status = U_ZERO_ERROR;
+    const CA_char *data = getData8(status);
+    if (U_FAILURE(status)) {
+        return NULL;
+    }
+    return new GetSortKeyUTF8(coll, data, FALSE /* convert */);
+}
+
+UPerfFunction* CollPerf2Test::TestGetSortKeyFromUTF8()
+{
+    UErrorCode status = U_ZERO_ERROR;
+    const CA_char *data = getData8(status);
+    if (U_FAILURE(status)) {
+        return NULL;
+    }
+    return new GetSortKeyUTF8(coll, data, TRUE /* convert */);
+}
+
+UPerfFunction* CollPerf2Test::TestGetSortKeys()
+{
+    UErrorCode status = U_ZERO_ERROR;
+    const CA_uchar *data = getData16(status);
+    if (U_FAILURE(status)) {
+        return NULL;
+    }
+    return new GetSortKeys(coll, data);
+}
+
+UPerfFunction* CollPerf2Test::TestGetSortKeysUTF8()
+{
+    UErrorCode status = U_ZERO_ERROR;
+    const CA_char *data = getData8(status);
+    if (U_FAILURE(status)) {
+        return NULL;
+    }
+    return new GetSortKeysUTF8(coll, data);
+}
+
 UPerfFunction* CollPerf2Test::TestNextSortKeyPart_4All()
 {
     UErrorCode status = U_ZERO_ERROR;
@@ -1756,6 +2280,60 @@ UPerfFunction* CollPerf2Test::TestStringPieceSortC() {
     return testCase;
 }
 
+UPerfFunction* CollPerf2Test::TestSortStrings() {
+    UErrorCode status = U_ZERO_ERROR;
+    const CA_uchar *data = getRandomData16(status);
+    if (U_FAILURE(status)) {
+        return NULL;
+    }
+    return new SortStrings(coll, data, NULL, FALSE /* byStrcoll */);
+}
+
+UPerfFunction* CollPerf2Test::TestSortStringsUTF8() {
+    UErrorCode status = U_ZERO_ERROR;
+    const CA_char *data = getRandomData8(status);
+    if (U_FAILURE(status)) {
+        return NULL;
+    }
+    return new SortStrings(coll, NULL, data, FALSE /* byStrcoll */);
+}
+
+UPerfFunction* CollPerf2Test::TestSortStringsByStrcoll() {
+    UErrorCode status = U_ZERO_ERROR;
+    const CA_uchar *data = getRandomData16(status);
+    if (U_FAILURE(status)) {
+        return NULL;
+    }
+    return new SortStrings(coll, data, NULL, TRUE /* byStrcoll */);
+}
+
+UPerfFunction* CollPerf2Test::TestSortStringsByStrcollUTF8() {
+    UErrorCode status = U_ZERO_ERROR;
+    const CA_char *data = getRandomData8(status);
+    if (U_FAILURE(status)) {
+        return NULL;
+    }
+    return new SortStrings(coll, NULL, data, TRUE /* byStrcoll */);
+}
+
+UPerfFunction* CollPerf2Test::TestSortKeyStoreLookup() {
+    UErrorCode status = U_ZERO_ERROR;
+    const CA_uchar *data = getSortedData16(status);
+    if (U_FAILURE(status)) {
+        return NULL;
+    }
+    return new SortKeyLookup(coll, data, TRUE /* inStore */);
+}
+
+UPerfFunction* CollPerf2Test::TestSortKeyBinSearch() {
+    UErrorCode status = U_ZERO_ERROR;
+    const CA_uchar *data = getSortedData16(status);
+    if (U_FAILURE(status)) {
+        return NULL;
+    }
+    return new SortKeyLookup(coll, data, FALSE /* inStore */);
+}
+
 UPerfFunction* CollPerf2Test::TestUniStrBinSearch() {
     UErrorCode status = U_ZERO_ERROR;
     UPerfFunction *testCase = new UniStrBinSearch(*collObj, coll, getSortedData16(status));
@@ -0,0 +1,357 @@
+// © 2016 and later: Unicode, Inc. and others.
+// License & terms of use: http://www.unicode.org/copyright.html
+//
+// convertperf.cpp
+//
+// Performance test for converting text from one charset to another.
+// The input file is read as usual (-f, -e) and converted into the --source
+// charset once; each test then converts those bytes into the --target charset.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <thread>
+#include <vector>
+#include "unicode/uperf.h"
+#include "unicode/ucnv.h"
+#include "cmemory.h" // for UPRV_LENGTHOF
+#include "uoptions.h"
+
+// Command-line options specific to convertperf.
+// Options do not have abbreviations: Force readable command lines.
+// (Using U+0001 for abbreviation characters.)
+enum {
+    SOURCE_CHARSET,
+    TARGET_CHARSET,
+    CONVERTPERF_OPTIONS_COUNT
+};
+
+static UOption options[CONVERTPERF_OPTIONS_COUNT]={
+    UOPTION_DEF("source", '\x01', UOPT_REQUIRES_ARG),
+    UOPTION_DEF("target", '\x01', UOPT_REQUIRES_ARG)
+};
+
+static const char *const convertperf_usage =
+    "\t--source    Charset of the text to be converted. Default: Shift_JIS\n"
+    "\t--target    Charset to convert the text into. Default: UTF-8\n"
+    "\tEach test counts one operation per source byte.\n"
+    "\tConvert calls ucnv_convertEx(), which may use a direct conversion path;\n"
+    "\tConvertPivot converts to UTF-16 and from there with separate calls.\n"
+    "\tFor example, --source windows-1252 or --source ibm-37 with the default\n"
+    "\t--target UTF-8 compares direct conversion to UTF-8 with pivoting.\n"
+    "\tThe ParallelN tests call ucnv_convertParallel() with up to N threads\n"
+    "\ton the input repeated to at least 4 MB.\n"
+    "\tThe OpenCloseN tests open and close --source converters on N threads,\n"
+    "\twith the converter data staying loaded; they ignore the input text.\n";
+
+// Test object.
+class ConvertPerformanceTest : public UPerfTest {
+public:
+    ConvertPerformanceTest(int32_t argc, const char *argv[], UErrorCode &status)
+            : UPerfTest(argc, argv, options, UPRV_LENGTHOF(options), convertperf_usage, status),
+              source(NULL), sourceLength(0) {
+        if (U_FAILURE(status)) {
+            return;
+        }
+        sourceCharset = options[SOURCE_CHARSET].value;
+        targetCharset = options[TARGET_CHARSET].value;
+
+        int32_t length;
+        const UChar *text = getBuffer(length, status);
+        UConverter *cnv = ucnv_open(sourceCharset, &status);
+        if (U_FAILURE(status)) {
+            fprintf(stderr, "error opening converter for \"%s\" - %s\n",
+                    sourceCharset, u_errorName(status));
+            return;
+        }
+        int32_t capacity = UCNV_GET_MAX_BYTES_FOR_STRING(length, ucnv_getMaxCharSize(cnv));
+        source = (char *)malloc(capacity);
+        if (source == NULL) {
+            status = U_MEMORY_ALLOCATION_ERROR;
+        } else {
+            sourceLength = ucnv_fromUChars(cnv, source, capacity, text, length, &status);
+        }
+        ucnv_close(cnv);
+    }
+
+    virtual ~ConvertPerformanceTest() {
+        free(source);
+    }
+
+    virtual UPerfFunction* runIndexedTest(int32_t index, UBool exec, const char* &name, char* par = NULL);
+
+    UPerfFunction *Convert();
+    UPerfFunction *ConvertPivot();
+    UPerfFunction *newConvertParallel(int32_t threads);
+
+    UPerfFunction *Parallel1() { return newConvertParallel(1); }
+    UPerfFunction *Parallel2() { return newConvertParallel(2); }
+    UPerfFunction *Parallel4() { return newConvertParallel(4); }
+    UPerfFunction *Parallel8() { return newConvertParallel(8); }
+
+    UPerfFunction *newOpenCloseThreads(int32_t threads);
+
+    UPerfFunction *OpenClose1() { return newOpenCloseThreads(1); }
+    UPerfFunction *OpenClose4() { return newOpenCloseThreads(4); }
+    UPerfFunction *OpenClose16() { return newOpenCloseThreads(16); }
+    UPerfFunction *OpenClose64() { return newOpenCloseThreads(64); }
+
+    const char *sourceCharset;
+    const char *targetCharset;
+    char *source;
+    int32_t sourceLength;
+};
+
+U_CDECL_BEGIN
+static void U_CALLCONV
+runTasksOnThreads(const void * /*runnerContext*/, UTask task, void *taskContext, int32_t count) {
+    std::vector<std::thread> threads;
+    for (int32_t i = 0; i < count; ++i) {
+        threads.emplace_back(task, taskContext, i);
+    }
+    for (std::thread &t : threads) {
+        t.join();
+    }
+}
+U_CDECL_END
+
+// Base class with the source and target converters.
+class Command : public UPerfFunction {
+protected:
+    Command(const ConvertPerformanceTest &testcase, UErrorCode &status)
+            : sourceCnv(NULL), targetCnv(NULL),
+              src(testcase.source), srcLength(testcase.sourceLength) {
+        sourceCnv = ucnv_open(testcase.sourceCharset, &status);
+        targetCnv = ucnv_open(testcase.targetCharset, &status);
+        if (U_FAILURE(status)) {
+            fprintf(stderr, "error opening converters for \"%s\" and \"%s\" - %s\n",
+                    testcase.sourceCharset, testcase.targetCharset, u_errorName(status));
+        }
+    }
+public:
+    virtual ~Command() {
+        ucnv_close(sourceCnv);
+        ucnv_close(targetCnv);
+    }
+    virtual long getOperationsPerIteration() {
+        return srcLength;
+    }
+protected:
+    UConverter *sourceCnv;
+    UConverter *targetCnv;
+    const char *src;
+    int32_t srcLength;
+};
+
+// ucnv_convertEx() with the default pivot buffer.
+class Convert : public Command {
+public:
+    Convert(const ConvertPerformanceTest &testcase, UErrorCode &status)
+            : Command(testcase, status), target(NULL), targetCapacity(0) {
+        if (U_FAILURE(status)) {
+            return;
+        }
+        targetCapacity = UCNV_GET_MAX_BYTES_FOR_STRING(srcLength, ucnv_getMaxCharSize(targetCnv));
+        target = (char *)malloc(targetCapacity);
+        if (target == NULL) {
+            status = U_MEMORY_ALLOCATION_ERROR;
+        }
+    }
+    virtual ~Convert() {
+        free(target);
+    }
+    virtual void call(UErrorCode *pErrorCode) {
+        const char *s = src;
+        char *t = target;
+        ucnv_convertEx(targetCnv, sourceCnv, &t, target + targetCapacity,
+                       &s, src + srcLength, NULL, NULL, NULL, NULL, TRUE, TRUE, pErrorCode);
+    }
+private:
+    char *target;
+    int32_t targetCapacity;
+};
+
+// Explicit conversion via a full UTF-16 buffer, for comparison with Convert.
+class ConvertPivot : public Command {
+public:
+    ConvertPivot(const ConvertPerformanceTest &testcase, UErrorCode &status)
+            : Command(testcase, status), buffer(NULL), bufferCapacity(0), target(NULL), targetCapacity(0) {
+        if (U_FAILURE(status)) {
+            return;
+        }
+        // At most one UTF-16 code unit per source byte, except for SBCS supplementary mappings.
+        bufferCapacity = 2 * srcLength;
+        targetCapacity = UCNV_GET_MAX_BYTES_FOR_STRING(bufferCapacity, ucnv_getMaxCharSize(targetCnv));
+        buffer = (UChar *)malloc(bufferCapacity * U_SIZEOF_UCHAR);
+        target = (char *)malloc(targetCapacity);
+        if (buffer == NULL || target == NULL) {
+            status = U_MEMORY_ALLOCATION_ERROR;
+        }
+    }
+    virtual ~ConvertPivot() {
+        free(target);
+        free(buffer);
+    }
+    virtual void call(UErrorCode *pErrorCode) {
+        int32_t length = ucnv_toUChars(sourceCnv, buffer, bufferCapacity, src, srcLength, pErrorCode);
+        ucnv_fromUChars(targetCnv, target, targetCapacity, buffer, length, pErrorCode);
+    }
+private:
+    UChar *buffer;
+    int32_t bufferCapacity;
+    char *target;
+    int32_t targetCapacity;
+};
+
+// ucnv_convertParallel() with a given maximum number of threads.
+class ConvertParallel : public Command {
+public:
+    ConvertParallel(const ConvertPerformanceTest &testcase, int32_t threads, UErrorCode &status)
+            : Command(testcase, status), numThreads(threads), repeated(NULL), target(NULL) {
+        if (U_FAILURE(status) || srcLength <= 0) {
+            return;
+        }
+        int32_t repeat = (0x400000 + srcLength - 1) / srcLength;
+        repeated = (char *)malloc((size_t)srcLength * repeat);
+        if (repeated == NULL) {
+            status = U_MEMORY_ALLOCATION_ERROR;
+            return;
+        }
+        for (int32_t i = 0; i < repeat; ++i) {
+            uprv_memcpy(repeated + i * srcLength, src, srcLength);
+        }
+        src = repeated;
+        srcLength *= repeat;
+        targetCapacity = ucnv_convertParallel(targetCnv, sourceCnv, NULL, 0, src, srcLength,
+                                              1, NULL, NULL, &status);
+        if (status == U_BUFFER_OVERFLOW_ERROR) {
+            status = U_ZERO_ERROR;
+        }
+        target = (char *)malloc(targetCapacity + 1);
+        if (target == NULL) {
+            status = U_MEMORY_ALLOCATION_ERROR;
+        }
+    }
+    virtual ~ConvertParallel() {
+        free(target);
+        free(repeated);
+    }
+    virtual void call(UErrorCode *pErrorCode) {
+        ucnv_convertParallel(targetCnv, sourceCnv, target, targetCapacity + 1, src, srcLength,
+                             numThreads, runTasksOnThreads, NULL, pErrorCode);
+    }
+private:
+    int32_t numThreads;
+    char *repeated;
+    char *target;
+    int32_t targetCapacity;
+};
+
+U_CDECL_BEGIN
+static void U_CALLCONV
+openCloseConverters(const char *name, int32_t count, UErrorCode *pErrorCode) {
+    for (int32_t i = 0; i < count && U_SUCCESS(*pErrorCode); ++i) {
+        ucnv_close(ucnv_open(name, pErrorCode));
+    }
+}
+U_CDECL_END
+
+// Stress test for the converter cache: Several threads repeatedly open and close
+// converters for the same charset. The base class keeps the data loaded.
+class OpenCloseThreads : public Command {
+public:
+    OpenCloseThreads(const ConvertPerformanceTest &testcase, int32_t threads, UErrorCode &status)
+            : Command(testcase, status), name(testcase.sourceCharset),
+              numThreads(threads), opensPerThread(100000 / threads) {}
+    virtual void call(UErrorCode *pErrorCode) {
+        std::vector<std::thread> threads;
+        std::vector<UErrorCode> errorCodes(numThreads, U_ZERO_ERROR);
+        for (int32_t i = 0; i < numThreads; ++i) {
+            threads.emplace_back(openCloseConverters, name, opensPerThread, &errorCodes[i]);
+        }
+        for (int32_t i = 0; i < numThreads; ++i) {
+            threads[i].join();
+            if (U_FAILURE(errorCodes[i])) {
+                *pErrorCode = errorCodes[i];
+            }
+        }
+    }
+    virtual long getOperationsPerIteration() {
+        return numThreads * opensPerThread;
+    }
+private:
+    const char *name;
+    int32_t numThreads;
+    int32_t opensPerThread;
+};
+
+// Returns func, or NULL and deletes func if it failed to initialize.
+static UPerfFunction *checkCommand(UPerfFunction *func, UErrorCode status) {
+    if (U_FAILURE(status)) {
+        fprintf(stderr, "FAILED to set up the test. Error: %s\n", u_errorName(status));
+        delete func;
+        return NULL;
+    }
+    return func;
+}
+
+UPerfFunction *ConvertPerformanceTest::Convert() {
+    UErrorCode status = U_ZERO_ERROR;
+    return checkCommand(new ::Convert(*this, status), status);
+}
+
+UPerfFunction *ConvertPerformanceTest::ConvertPivot() {
+    UErrorCode status = U_ZERO_ERROR;
+    return checkCommand(new ::ConvertPivot(*this, status), status);
+}
+
+UPerfFunction *ConvertPerformanceTest::newConvertParallel(int32_t threads) {
+    UErrorCode status = U_ZERO_ERROR;
+    return checkCommand(new ConvertParallel(*this, threads, status), status);
+}
+
+UPerfFunction *ConvertPerformanceTest::newOpenCloseThreads(int32_t threads) {
+    UErrorCode status = U_ZERO_ERROR;
+    return checkCommand(new OpenCloseThreads(*this, threads, status), status);
+}
+
+UPerfFunction* ConvertPerformanceTest::runIndexedTest(int32_t index, UBool exec, const char* &name, char* /*par*/) {
+    switch (index) {
+        TESTCASE(0, Convert);
+        TESTCASE(1, ConvertPivot);
+        TESTCASE(2, Parallel1);
+        TESTCASE(3, Parallel2);
+        TESTCASE(4, Parallel4);
+        TESTCASE(5, Parallel8);
+        TESTCASE(6, OpenClose1);
+        TESTCASE(7, OpenClose4);
+        TESTCASE(8, OpenClose16);
+        TESTCASE(9, OpenClose64);
+        default:
+            name = "";
+            return NULL;
+    }
+    return NULL;
+}
+
+int main(int argc, const char *argv[])
+{
+    // Default values for command-line options.
+    options[SOURCE_CHARSET].value = "Shift_JIS";
+    options[TARGET_CHARSET].value = "UTF-8";
+
+    UErrorCode status = U_ZERO_ERROR;
+    ConvertPerformanceTest test(argc, argv, status);
+
+    if (U_FAILURE(status)){
+        printf("The error is %s\n", u_errorName(status));
+        test.usage();
+        return status;
+    }
+
+    if (test.run() == FALSE){
+        fprintf(stderr, "FAILED: Tests could not be run please check the "
+                        "arguments.\n");
+        return -1;
+    }
+    return 0;
+}
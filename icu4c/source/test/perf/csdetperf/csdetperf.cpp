@@ -0,0 +1,189 @@
+// © 2016 and later: Unicode, Inc. and others.
+// License & terms of use: http://www.unicode.org/copyright.html
+/*
+ *************************************************************************
+ *   file name:  csdetperf.cpp
+ *   encoding:   UTF-8
+ *   tab size:   8 (not used)
+ *   indentation:4
+ *
+ *   Performance test program for charset detection,
+ *   comparing detection over one buffer with detection over streamed chunks.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "unicode/uperf.h"
+#include "unicode/ucnv.h"
+#include "unicode/ucsdet.h"
+#include "cmemory.h" // for UPRV_LENGTHOF
+#include "uoptions.h"
+
+// Command-line options specific to csdetperf.
+// Options do not have abbreviations: Force readable command lines.
+// (Using U+0001 for abbreviation characters.)
+enum {
+    CHARSET,
+    CHUNK_LENGTH,
+    STOP_CONFIDENCE,
+    CSDETPERF_OPTIONS_COUNT
+};
+
+static UOption options[CSDETPERF_OPTIONS_COUNT]={
+    UOPTION_DEF("charset",  '\x01', UOPT_REQUIRES_ARG),
+    UOPTION_DEF("chunk",    '\x01', UOPT_REQUIRES_ARG),
+    UOPTION_DEF("stop",     '\x01', UOPT_REQUIRES_ARG)
+};
+
+static const char *const csdetperf_usage =
+    "\t--charset   Charset in which the input file is encoded for detection,\n"
+    "\t            e.g. Shift_JIS. Default: UTF-8\n"
+    "\t--chunk     Length (in bytes) of the chunks passed to ucsdet_appendText(). [4096]\n"
+    "\t--stop      Stop confidence for the DetectStreamStop test. [100]\n"
+    "\tAll tests count one event per input byte.\n"
+    "\tDetectWhole detects the whole input with ucsdet_setText();\n"
+    "\tDetectStream appends it in chunks with ucsdet_appendText().\n";
+
+// Test object.
+class CharsetDetectionPerformanceTest : public UPerfTest {
+public:
+    CharsetDetectionPerformanceTest(int32_t argc, const char *argv[], UErrorCode &status)
+            : UPerfTest(argc, argv, options, UPRV_LENGTHOF(options), csdetperf_usage, status),
+              bytes(NULL), bytesLength(0) {
+        if (U_SUCCESS(status)) {
+            chunkLength = atoi(options[CHUNK_LENGTH].value);
+            if (chunkLength < 1) {
+                fprintf(stderr, "error: chunk length must be at least 1\n");
+                status = U_ILLEGAL_ARGUMENT_ERROR;
+            }
+
+            stopConfidence = atoi(options[STOP_CONFIDENCE].value);
+            if (stopConfidence < 1 || 100 < stopConfidence) {
+                fprintf(stderr, "error: stop confidence must be 1..100\n");
+                status = U_ILLEGAL_ARGUMENT_ERROR;
+            }
+
+            int32_t inputLength;
+            const UChar *input = UPerfTest::getBuffer(inputLength, status);
+            UConverter *cnv = ucnv_open(options[CHARSET].value, &status);
+            if (U_SUCCESS(status)) {
+                int32_t capacity = UCNV_GET_MAX_BYTES_FOR_STRING(inputLength, ucnv_getMaxCharSize(cnv));
+                bytes = (char *)uprv_malloc(capacity);
+                if (bytes == NULL) {
+                    status = U_MEMORY_ALLOCATION_ERROR;
+                } else {
+                    bytesLength = ucnv_fromUChars(cnv, bytes, capacity, input, inputLength, &status);
+                }
+            }
+            ucnv_close(cnv);
+        }
+    }
+
+    ~CharsetDetectionPerformanceTest() {
+        uprv_free(bytes);
+    }
+
+    virtual UPerfFunction* runIndexedTest(int32_t index, UBool exec, const char* &name, char* par = NULL);
+
+    char *bytes;
+    int32_t bytesLength;
+    int32_t chunkLength;
+    int32_t stopConfidence;
+};
+
+// Base class with common setup.
+class Command : public UPerfFunction {
+protected:
+    Command(const CharsetDetectionPerformanceTest &testcase)
+            : testcase(testcase), errorCode(U_ZERO_ERROR) {
+        csd = ucsdet_open(&errorCode);
+        if (U_FAILURE(errorCode)) {
+            fprintf(stderr, "error opening charset detector - %s\n", u_errorName(errorCode));
+        }
+    }
+public:
+    virtual ~Command() {
+        ucsdet_close(csd);
+    }
+    virtual long getOperationsPerIteration() {
+        return testcase.bytesLength;
+    }
+    virtual long getEventsPerIteration() {
+        return testcase.bytesLength;
+    }
+
+    const CharsetDetectionPerformanceTest &testcase;
+    UErrorCode errorCode;
+    UCharsetDetector *csd;
+};
+
+// Detect the whole input, passed as one buffer.
+class DetectWhole : public Command {
+public:
+    DetectWhole(const CharsetDetectionPerformanceTest &testcase) : Command(testcase) {}
+    virtual void call(UErrorCode* pErrorCode) {
+        ucsdet_setText(csd, testcase.bytes, testcase.bytesLength, pErrorCode);
+        ucsdet_detect(csd, pErrorCode);
+    }
+};
+
+// Detect the input passed in chunks, optionally stopping once the stop confidence is reached.
+class DetectStream : public Command {
+public:
+    DetectStream(const CharsetDetectionPerformanceTest &testcase, int32_t stopConfidence)
+            : Command(testcase) {
+        ucsdet_setStopConfidence(csd, stopConfidence, &errorCode);
+    }
+    virtual void call(UErrorCode* pErrorCode) {
+        const char *p = testcase.bytes;
+        const char *limit = testcase.bytes + testcase.bytesLength;
+
+        ucsdet_setText(csd, "", 0, pErrorCode);
+        while (p < limit) {
+            int32_t length = (int32_t)(limit - p);
+            if (length > testcase.chunkLength) {
+                length = testcase.chunkLength;
+            }
+            if (!ucsdet_appendText(csd, p, length, pErrorCode)) {
+                break;
+            }
+            p += length;
+        }
+        ucsdet_detect(csd, pErrorCode);
+    }
+};
+
+UPerfFunction* CharsetDetectionPerformanceTest::runIndexedTest(int32_t index, UBool exec, const char* &name, char* /*par*/) {
+    switch (index) {
+        case 0: name = "DetectWhole";       if (exec) return new DetectWhole(*this); break;
+        case 1: name = "DetectStream";      if (exec) return new DetectStream(*this, 0); break;
+        case 2: name = "DetectStreamStop";  if (exec) return new DetectStream(*this, stopConfidence); break;
+        default: name = ""; break;
+    }
+    return NULL;
+}
+
+int main(int argc, const char *argv[])
+{
+    // Default values for command-line options.
+    options[CHARSET].value = "UTF-8";
+    options[CHUNK_LENGTH].value = "4096";
+    options[STOP_CONFIDENCE].value = "100";
+
+    UErrorCode status = U_ZERO_ERROR;
+    CharsetDetectionPerformanceTest test(argc, argv, status);
+
+    if (U_FAILURE(status)){
+        printf("The error is %s\n", u_errorName(status));
+        test.usage();
+        return status;
+    }
+
+    if (test.run() == FALSE){
+        fprintf(stderr, "FAILED: Tests could not be run please check the "
+                        "arguments.\n");
+        return -1;
+    }
+
+    return 0;
+}
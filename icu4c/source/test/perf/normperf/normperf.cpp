@@ -19,6 +19,8 @@
 #include "uoptions.h"
 #include "cmemory.h" // for UPRV_LENGTHOF
 #include <stdio.h>
+#include <thread>
+#include <vector>
 
 UPerfFunction* NormalizerPerformanceTest::runIndexedTest(int32_t index, UBool exec,const char* &name, char* par) {
     switch (index) {
@@ -66,6 +68,19 @@ UPerfFunction* NormalizerPerformanceTest::runIndexedTest(int32_t index, UBool ex
         TESTCASE(31,TestIsNormalized_FCD_NFC_Text);
         TESTCASE(32,TestIsNormalized_FCD_Orig_Text);
 
+        TESTCASE(33,TestICU_NFC_UTF8_NFC_Text);
+        TESTCASE(34,TestICU_NFD_UTF8_NFD_Text);
+        TESTCASE(35,TestIsNormalized_NFC_UTF8_NFC_Text);
+        TESTCASE(36,TestIsNormalized_NFD_UTF8_NFD_Text);
+
+        TESTCASE(37,TestParallel1_NFC_UTF8_NFD_Text);
+        TESTCASE(38,TestParallel2_NFC_UTF8_NFD_Text);
+        TESTCASE(39,TestParallel4_NFC_UTF8_NFD_Text);
+        TESTCASE(40,TestParallel8_NFC_UTF8_NFD_Text);
+
+        TESTCASE(41,TestKeyChain_UTF8_NFC_Text);
+        TESTCASE(42,TestKeyFused_UTF8_NFC_Text);
+
         default: 
             name = ""; 
             return NULL;
@@ -112,6 +127,27 @@ UChar* NormalizerPerformanceTest::normalizeInput(int32_t& len, const UChar* src
     return dest;
 }
 
+// Converts the text to UTF-8, concatenating lines.
+char* NormalizerPerformanceTest::toUTF8(int32_t& len, const ULine* srcLines, int32_t srcNumLines){
+    UErrorCode status = U_ZERO_ERROR;
+    int32_t capacity = 1;
+    for(int32_t i = 0; i < srcNumLines; i++){
+        capacity += srcLines[i].len * 3;
+    }
+    char* dest = new char[capacity];
+    len = 0;
+    for(int32_t i = 0; i < srcNumLines && U_SUCCESS(status); i++){
+        int32_t length;
+        u_strToUTF8(dest + len, capacity - len, &length, srcLines[i].name, srcLines[i].len, &status);
+        len += length;
+    }
+    if(U_FAILURE(status)){
+        printf("Could not convert input to UTF-8. Error: %s", u_errorName(status));
+        len = 0;
+    }
+    return dest;
+}
+
 static UOption cmdLineOptions[]={
     UOPTION_DEF("options", 'o', UOPT_OPTIONAL_ARG)
 };
@@ -124,6 +160,10 @@ NormalizerPerformanceTest::NormalizerPerformanceTest(int32_t argc, const char* a
     NFCBufferLen = 0;
     NFDFileLines = NULL;
     NFCFileLines = NULL;
+    NFDUTF8Buffer = NULL;
+    NFCUTF8Buffer = NULL;
+    NFDUTF8BufferLen = 0;
+    NFCUTF8BufferLen = 0;
 
     if(status== U_ILLEGAL_ARGUMENT_ERROR){
        fprintf(stderr,gUsageString, "normperf");
@@ -154,6 +194,8 @@ NormalizerPerformanceTest::NormalizerPerformanceTest(int32_t argc, const char* a
             normalizeInput(&NFCFileLines[i],filelines[i].name,filelines[i].len,UNORM_NFC, options);
 
         }
+        NFDUTF8Buffer = toUTF8(NFDUTF8BufferLen, NFDFileLines, numLines);
+        NFCUTF8Buffer = toUTF8(NFCUTF8BufferLen, NFCFileLines, numLines);
     }else if(bulk_mode){
         int32_t srcLen = 0;
         const UChar* src = getBuffer(srcLen,status);
@@ -167,6 +209,11 @@ NormalizerPerformanceTest::NormalizerPerformanceTest(int32_t argc, const char* a
          
         NFDBuffer = normalizeInput(NFDBufferLen,src,srcLen,UNORM_NFD, options);
         NFCBuffer = normalizeInput(NFCBufferLen,src,srcLen,UNORM_NFC, options);
+
+        ULine NFDLine = { NFDBuffer, NFDBufferLen };
+        ULine NFCLine = { NFCBuffer, NFCBufferLen };
+        NFDUTF8Buffer = toUTF8(NFDUTF8BufferLen, &NFDLine, 1);
+        NFCUTF8Buffer = toUTF8(NFCUTF8BufferLen, &NFCLine, 1);
     }
     
 }
@@ -176,6 +223,8 @@ NormalizerPerformanceTest::~NormalizerPerformanceTest(){
     delete[] NFCFileLines;
     delete[] NFDBuffer;
     delete[] NFCBuffer;
+    delete[] NFDUTF8Buffer;
+    delete[] NFCUTF8Buffer;
 }
 
 // Test NFC Performance
@@ -494,6 +543,84 @@ UPerfFunction* NormalizerPerformanceTest::TestIsNormalized_FCD_Orig_Text(){
     }
 }
 
+// Test UTF-8 Performance
+UPerfFunction* NormalizerPerformanceTest::newUTF8Function(UNormalizationMode mode, const char* src, int32_t srcLen, UBool checkOnly){
+    UErrorCode status = U_ZERO_ERROR;
+    const icu::Normalizer2* norm2 = mode == UNORM_NFC ?
+        icu::Normalizer2::getNFCInstance(status) : icu::Normalizer2::getNFDInstance(status);
+    if(U_FAILURE(status)){
+        fprintf(stderr, "FAILED to get the Normalizer2 instance. Error: %s\n", u_errorName(status));
+        return NULL;
+    }
+    return new UTF8NormPerfFunction(norm2, src, srcLen, checkOnly);
+}
+UPerfFunction* NormalizerPerformanceTest::TestICU_NFC_UTF8_NFC_Text(){
+    return newUTF8Function(UNORM_NFC, NFCUTF8Buffer, NFCUTF8BufferLen, FALSE);
+}
+UPerfFunction* NormalizerPerformanceTest::TestICU_NFD_UTF8_NFD_Text(){
+    return newUTF8Function(UNORM_NFD, NFDUTF8Buffer, NFDUTF8BufferLen, FALSE);
+}
+UPerfFunction* NormalizerPerformanceTest::TestIsNormalized_NFC_UTF8_NFC_Text(){
+    return newUTF8Function(UNORM_NFC, NFCUTF8Buffer, NFCUTF8BufferLen, TRUE);
+}
+UPerfFunction* NormalizerPerformanceTest::TestIsNormalized_NFD_UTF8_NFD_Text(){
+    return newUTF8Function(UNORM_NFD, NFDUTF8Buffer, NFDUTF8BufferLen, TRUE);
+}
+
+U_CDECL_BEGIN
+void U_CALLCONV
+runTasksOnThreads(const void * /*runnerContext*/, UTask task, void *taskContext, int32_t count) {
+    std::vector<std::thread> threads;
+    for (int32_t i = 0; i < count; ++i) {
+        threads.emplace_back(task, taskContext, i);
+    }
+    for (std::thread &t : threads) {
+        t.join();
+    }
+}
+U_CDECL_END
+
+// Test scaling of parallel normalization
+UPerfFunction* NormalizerPerformanceTest::newParallelFunction(int32_t threadCount){
+    UErrorCode status = U_ZERO_ERROR;
+    const icu::Normalizer2* norm2 = icu::Normalizer2::getNFCInstance(status);
+    if(U_FAILURE(status)){
+        fprintf(stderr, "FAILED to get the Normalizer2 instance. Error: %s\n", u_errorName(status));
+        return NULL;
+    }
+    return new ParallelNormPerfFunction(norm2, threadCount, NFDUTF8Buffer, NFDUTF8BufferLen);
+}
+UPerfFunction* NormalizerPerformanceTest::TestParallel1_NFC_UTF8_NFD_Text(){
+    return newParallelFunction(1);
+}
+UPerfFunction* NormalizerPerformanceTest::TestParallel2_NFC_UTF8_NFD_Text(){
+    return newParallelFunction(2);
+}
+UPerfFunction* NormalizerPerformanceTest::TestParallel4_NFC_UTF8_NFD_Text(){
+    return newParallelFunction(4);
+}
+UPerfFunction* NormalizerPerformanceTest::TestParallel8_NFC_UTF8_NFD_Text(){
+    return newParallelFunction(8);
+}
+
+// Test search-key generation
+UPerfFunction* NormalizerPerformanceTest::newKeyFunction(UBool fused){
+    UErrorCode status = U_ZERO_ERROR;
+    KeyNormPerfFunction* func = new KeyNormPerfFunction(fused, NFCUTF8Buffer, NFCUTF8BufferLen, status);
+    if(U_FAILURE(status)){
+        fprintf(stderr, "FAILED to set up search-key generation. Error: %s\n", u_errorName(status));
+        delete func;
+        return NULL;
+    }
+    return func;
+}
+UPerfFunction* NormalizerPerformanceTest::TestKeyChain_UTF8_NFC_Text(){
+    return newKeyFunction(FALSE);
+}
+UPerfFunction* NormalizerPerformanceTest::TestKeyFused_UTF8_NFC_Text(){
+    return newKeyFunction(TRUE);
+}
+
 int main(int argc, const char* argv[]){
     UErrorCode status = U_ZERO_ERROR;
     NormalizerPerformanceTest test(argc, argv, status);
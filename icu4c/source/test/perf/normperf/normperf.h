@@ -14,9 +14,17 @@
 
 #include "unicode/unorm.h"
 #include "unicode/ustring.h"
+#include "unicode/bytestream.h"
+#include "unicode/normalizer2.h"
+#include "unicode/normstream.h"
+#include "unicode/keynorm.h"
+#include "unicode/ucasemap.h"
+#include "unicode/uniset.h"
+#include "unicode/stringpiece.h"
 
 #include "unicode/uperf.h"
 #include <stdlib.h>
+#include <string.h>
 
 //  Stubs for Windows API functions when building on UNIXes.
 //
@@ -178,6 +186,138 @@ class NormPerfFunction : public UPerfFunction{
 
 
 
+// Normalizes or checks UTF-8 text with a Normalizer2.
+// Operates on the whole text, also in line mode.
+class UTF8NormPerfFunction : public UPerfFunction{
+private:
+    const icu::Normalizer2* norm2;
+    const char* src;
+    int32_t srcLen;
+    UBool checkOnly;
+    char* dest;
+    int32_t destCapacity;
+    UBool retVal;
+
+public:
+    virtual void call(UErrorCode* status){
+        if(checkOnly){
+            retVal = norm2->isNormalizedUTF8(icu::StringPiece(src, srcLen), *status);
+        }else{
+            icu::CheckedArrayByteSink sink(dest, destCapacity);
+            norm2->normalizeUTF8(0, icu::StringPiece(src, srcLen), sink, NULL, *status);
+        }
+    }
+    virtual long getOperationsPerIteration(){
+        return srcLen;
+    }
+    UTF8NormPerfFunction(const icu::Normalizer2* n2, const char* source, int32_t sourceLen, UBool _checkOnly)
+            : norm2(n2), src(source), srcLen(sourceLen), checkOnly(_checkOnly), retVal(FALSE) {
+        destCapacity = checkOnly ? 0 : sourceLen*3;
+        dest = checkOnly ? NULL : (char*) malloc(destCapacity);
+    }
+    ~UTF8NormPerfFunction(){
+        free(dest);
+    }
+};
+
+// Runs each task on its own thread, for the ParallelNormalizer2.
+U_CDECL_BEGIN
+void U_CALLCONV
+runTasksOnThreads(const void *runnerContext, UTask task, void *taskContext, int32_t count);
+U_CDECL_END
+
+// Normalizes UTF-8 text with a ParallelNormalizer2, to measure scaling with the thread count.
+// Operates on the whole text, also in line mode.
+class ParallelNormPerfFunction : public UPerfFunction{
+private:
+    icu::ParallelNormalizer2 parallel;
+    const char* src;
+    int32_t srcLen;
+    char* dest;
+    int32_t destCapacity;
+
+public:
+    virtual void call(UErrorCode* status){
+        icu::CheckedArrayByteSink sink(dest, destCapacity);
+        parallel.normalizeUTF8(0, icu::StringPiece(src, srcLen), sink, NULL, *status);
+    }
+    virtual long getOperationsPerIteration(){
+        return srcLen;
+    }
+    ParallelNormPerfFunction(const icu::Normalizer2* n2, int32_t threadCount, const char* source, int32_t sourceLen)
+            : parallel(*n2, threadCount, runTasksOnThreads, NULL), src(source), srcLen(sourceLen) {
+        // Split even short test files so that the threads are actually used.
+        parallel.setMinSegmentLength(4096);
+        destCapacity = sourceLen*3;
+        dest = (char*) malloc(destCapacity);
+    }
+    ~ParallelNormPerfFunction(){
+        free(dest);
+    }
+};
+
+// Maps UTF-8 text to search keys: either in three steps
+// (case folding, NFKC, removing default ignorables), or with the fused SearchKeyNormalizer.
+class KeyNormPerfFunction : public UPerfFunction{
+private:
+    icu::SearchKeyNormalizer* keyNorm;
+    const icu::Normalizer2* nfkc;
+    UCaseMap* csm;
+    icu::UnicodeSet* ignorables;
+    const char* src;
+    int32_t srcLen;
+    char* folded;
+    char* normalized;
+    char* dest;
+    int32_t destCapacity;
+
+public:
+    virtual void call(UErrorCode* status){
+        if(keyNorm != NULL){
+            icu::CheckedArrayByteSink sink(dest, destCapacity);
+            keyNorm->normalizeUTF8(icu::StringPiece(src, srcLen), sink, *status);
+            return;
+        }
+        int32_t foldedLen = ucasemap_utf8FoldCase(csm, folded, destCapacity, src, srcLen, status);
+        icu::CheckedArrayByteSink sink(normalized, destCapacity);
+        nfkc->normalizeUTF8(0, icu::StringPiece(folded, foldedLen), sink, NULL, *status);
+        int32_t normalizedLen = sink.NumberOfBytesWritten();
+        int32_t destLen = 0;
+        for(int32_t i = 0; i < normalizedLen;){
+            int32_t keep = ignorables->spanUTF8(normalized + i, normalizedLen - i, USET_SPAN_NOT_CONTAINED);
+            memcpy(dest + destLen, normalized + i, keep);
+            destLen += keep;
+            i += keep;
+            i += ignorables->spanUTF8(normalized + i, normalizedLen - i, USET_SPAN_CONTAINED);
+        }
+    }
+    virtual long getOperationsPerIteration(){
+        return srcLen;
+    }
+    KeyNormPerfFunction(UBool fused, const char* source, int32_t sourceLen, UErrorCode& status)
+            : keyNorm(NULL), nfkc(NULL), csm(NULL), ignorables(NULL), src(source), srcLen(sourceLen) {
+        if(fused){
+            keyNorm = new icu::SearchKeyNormalizer(status);
+        }else{
+            nfkc = icu::Normalizer2::getNFKCInstance(status);
+            csm = ucasemap_open("", U_FOLD_CASE_DEFAULT, &status);
+            ignorables = new icu::UnicodeSet(UNICODE_STRING_SIMPLE("[:DI:]"), status);
+        }
+        destCapacity = sourceLen*3;
+        folded = (char*) malloc(destCapacity);
+        normalized = (char*) malloc(destCapacity);
+        dest = (char*) malloc(destCapacity);
+    }
+    ~KeyNormPerfFunction(){
+        delete keyNorm;
+        ucasemap_close(csm);
+        delete ignorables;
+        free(folded);
+        free(normalized);
+        free(dest);
+    }
+};
+
 class  NormalizerPerformanceTest : public UPerfTest{
 private:
     ULine* NFDFileLines;
@@ -188,10 +328,18 @@ class  NormalizerPerformanceTest : public UPerfTest{
     int32_t origBufferLen;
     int32_t NFDBufferLen;
     int32_t NFCBufferLen;
+    char* NFDUTF8Buffer;
+    char* NFCUTF8Buffer;
+    int32_t NFDUTF8BufferLen;
+    int32_t NFCUTF8BufferLen;
     int32_t options;
 
     void normalizeInput(ULine* dest,const UChar* src ,int32_t srcLen,UNormalizationMode mode, int32_t options);
     UChar* normalizeInput(int32_t& len, const UChar* src ,int32_t srcLen,UNormalizationMode mode, int32_t options);
+    char* toUTF8(int32_t& len, const ULine* srcLines, int32_t srcNumLines);
+    UPerfFunction* newUTF8Function(UNormalizationMode mode, const char* src, int32_t srcLen, UBool checkOnly);
+    UPerfFunction* newParallelFunction(int32_t threadCount);
+    UPerfFunction* newKeyFunction(UBool fused);
 
 public:
 
@@ -249,6 +397,22 @@ class  NormalizerPerformanceTest : public UPerfTest{
     UPerfFunction* TestIsNormalized_FCD_NFC_Text();
     UPerfFunction* TestIsNormalized_FCD_Orig_Text();
 
+    /* UTF-8 performance, on the whole text */
+    UPerfFunction* TestICU_NFC_UTF8_NFC_Text();
+    UPerfFunction* TestICU_NFD_UTF8_NFD_Text();
+    UPerfFunction* TestIsNormalized_NFC_UTF8_NFC_Text();
+    UPerfFunction* TestIsNormalized_NFD_UTF8_NFD_Text();
+
+    /* Parallel UTF-8 NFC normalization of the NFD text, with 1..8 threads */
+    UPerfFunction* TestParallel1_NFC_UTF8_NFD_Text();
+    UPerfFunction* TestParallel2_NFC_UTF8_NFD_Text();
+    UPerfFunction* TestParallel4_NFC_UTF8_NFD_Text();
+    UPerfFunction* TestParallel8_NFC_UTF8_NFD_Text();
+
+    /* Search keys from UTF-8: fold+NFKC+remove ignorables chain vs. SearchKeyNormalizer */
+    UPerfFunction* TestKeyChain_UTF8_NFC_Text();
+    UPerfFunction* TestKeyFused_UTF8_NFC_Text();
+
 };
 
 //---------------------------------------------------------------------------------------
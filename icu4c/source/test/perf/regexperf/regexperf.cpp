@@ -0,0 +1,175 @@
+// © 2016 and later: Unicode, Inc. and others.
+// License & terms of use: http://www.unicode.org/copyright.html
+//
+// regexperf.cpp
+//
+// Performance test for RegexMatcher::find(), on UTF-16 input
+// and on UTF-8 input in a UText.
+//
+// The NoPrefilter tests wrap the pattern in an alternation with a branch
+// that never matches, "(?:pattern|(?!))". That finds the same matches,
+// but hides any literal string that is part of every match, so that find()
+// can not skip ahead by searching for it.
+// Comparing the two shows the effect of that prefilter for a given pattern.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include "unicode/uperf.h"
+#include "unicode/regex.h"
+#include "unicode/unistr.h"
+#include "unicode/utext.h"
+#include "cmemory.h" // for UPRV_LENGTHOF
+#include "uoptions.h"
+
+#if !UCONFIG_NO_REGULAR_EXPRESSIONS
+
+using icu::RegexMatcher;
+using icu::UnicodeString;
+
+// Command-line options specific to regexperf.
+// Options do not have abbreviations: Force readable command lines.
+// (Using U+0001 for abbreviation characters.)
+enum {
+    PATTERN,
+    REGEXPERF_OPTIONS_COUNT
+};
+
+static UOption options[REGEXPERF_OPTIONS_COUNT]={
+    UOPTION_DEF("pattern", '\x01', UOPT_REQUIRES_ARG)
+};
+
+static const char *const regexperf_usage =
+    "\t--pattern   The regular expression to find in the input file.\n"
+    "\t            Default: \\b\\w{1,12}ing the\\b\n"
+    "\tEach test finds all of the matches in the file, and counts one event per match.\n"
+    "\tThe NoPrefilter tests find the same matches with a pattern that has no\n"
+    "\trequired literal string.\n";
+
+// Finds all of the matches of a pattern in the input text.
+class FindAll : public UPerfFunction {
+public:
+    FindAll(const UnicodeString &pattern, const UnicodeString &text, UText *text8, UErrorCode &status)
+            : matcher(pattern, 0, status), input(text), input8(text8), numMatches(0) {}
+
+    virtual void call(UErrorCode *pErrorCode) {
+        if (input8 != NULL) {
+            matcher.reset(input8);
+        } else {
+            matcher.reset(input);
+        }
+        numMatches = 0;
+        while (matcher.find(*pErrorCode)) {
+            ++numMatches;
+        }
+    }
+
+    virtual long getOperationsPerIteration() {
+        return input.length();
+    }
+
+    virtual long getEventsPerIteration() {
+        return numMatches;
+    }
+
+private:
+    RegexMatcher matcher;
+    const UnicodeString &input;
+    UText *input8;
+    long numMatches;
+};
+
+// Test object.
+class RegexPerformanceTest : public UPerfTest {
+public:
+    RegexPerformanceTest(int32_t argc, const char *argv[], UErrorCode &status)
+            : UPerfTest(argc, argv, options, UPRV_LENGTHOF(options), regexperf_usage, status),
+              text8(NULL) {
+        if (U_SUCCESS(status)) {
+            pattern = UnicodeString::fromUTF8(options[PATTERN].value);
+            noPrefilterPattern = UnicodeString(u"(?:").append(pattern).append(u"|(?!))");
+
+            int32_t length;
+            const UChar *buffer = getBuffer(length, status);
+            if (U_FAILURE(status)) {
+                return;
+            }
+            text.setTo(buffer, length);
+            text.toUTF8String(utf8);
+            text8 = utext_openUTF8(NULL, utf8.data(), (int64_t)utf8.length(), &status);
+        }
+    }
+
+    virtual ~RegexPerformanceTest() {
+        utext_close(text8);
+    }
+
+    virtual UPerfFunction* runIndexedTest(int32_t index, UBool exec, const char* &name, char* par = NULL);
+
+    UPerfFunction *newFindAll(const UnicodeString &pat, UText *input8) {
+        UErrorCode status = U_ZERO_ERROR;
+        FindAll *func = new FindAll(pat, text, input8, status);
+        if (U_FAILURE(status)) {
+            fprintf(stderr, "FAILED to compile the pattern. Error: %s\n", u_errorName(status));
+            delete func;
+            return NULL;
+        }
+        return func;
+    }
+
+    UPerfFunction *Find_UTF16() { return newFindAll(pattern, NULL); }
+    UPerfFunction *Find_UTF8() { return newFindAll(pattern, text8); }
+    UPerfFunction *Find_NoPrefilter_UTF16() { return newFindAll(noPrefilterPattern, NULL); }
+    UPerfFunction *Find_NoPrefilter_UTF8() { return newFindAll(noPrefilterPattern, text8); }
+
+private:
+    UnicodeString pattern;
+    UnicodeString noPrefilterPattern;
+    UnicodeString text;
+    std::string utf8;
+    UText *text8;
+};
+
+UPerfFunction* RegexPerformanceTest::runIndexedTest(int32_t index, UBool exec, const char* &name, char* /*par*/) {
+    switch (index) {
+        TESTCASE(0, Find_UTF16);
+        TESTCASE(1, Find_UTF8);
+        TESTCASE(2, Find_NoPrefilter_UTF16);
+        TESTCASE(3, Find_NoPrefilter_UTF8);
+        default:
+            name = "";
+            return NULL;
+    }
+    return NULL;
+}
+
+int main(int argc, const char *argv[])
+{
+    // Default values for command-line options.
+    options[PATTERN].value = "\\b\\w{1,12}ing the\\b";
+
+    UErrorCode status = U_ZERO_ERROR;
+    RegexPerformanceTest test(argc, argv, status);
+
+    if (U_FAILURE(status)){
+        printf("The error is %s\n", u_errorName(status));
+        test.usage();
+        return status;
+    }
+
+    if (test.run() == FALSE){
+        fprintf(stderr, "FAILED: Tests could not be run please check the "
+                        "arguments.\n");
+        return -1;
+    }
+    return 0;
+}
+
+#else
+
+int main(int /* argc */, const char * /* argv */ []) {
+    fprintf(stderr, "regexperf: Regular expressions are not supported by this ICU build.\n");
+    return 0;
+}
+
+#endif  // !UCONFIG_NO_REGULAR_EXPRESSIONS
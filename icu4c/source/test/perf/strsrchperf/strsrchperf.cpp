@@ -20,7 +20,11 @@ StringSearchPerformanceTest::StringSearchPerformanceTest(int32_t argc, const cha
 :UPerfTest(argc,argv,status){
     int32_t start, end;
     srch = NULL;
+    srchPrimary = NULL;
+    srchSecondary = NULL;
     pttrn = NULL;
+    keywordCount = 0;
+    keywordMSrch = NULL;
     if(status== U_ILLEGAL_ARGUMENT_ERROR || line_mode){
        fprintf(stderr,gUsageString, "strsrchperf");
        return;
@@ -71,7 +75,53 @@ StringSearchPerformanceTest::StringSearchPerformanceTest(int32_t argc, const cha
         fprintf(stderr, "FAILED to create UPerfTest object. Error: %s\n", u_errorName(status));
         return;
     }
-    
+
+    /* The same search with the collator set to lower strengths. */
+    srchPrimary = usearch_open(pttrn, pttrnLen, src, srcLen, locale, NULL, &status);
+    srchSecondary = usearch_open(pttrn, pttrnLen, src, srcLen, locale, NULL, &status);
+    if(U_FAILURE(status)){
+        fprintf(stderr, "FAILED to create UPerfTest object. Error: %s\n", u_errorName(status));
+        return;
+    }
+    ucol_setStrength(usearch_getCollator(srchPrimary), UCOL_PRIMARY);
+    usearch_reset(srchPrimary);
+    ucol_setStrength(usearch_getCollator(srchSecondary), UCOL_SECONDARY);
+    usearch_reset(srchSecondary);
+
+    /*
+     * Keywords for searching many patterns at once:
+     * The words at evenly spaced positions in the text.
+     */
+    UBreakIterator* brk = ubrk_open(UBRK_WORD, locale, src, srcLen, &status);
+    if(U_FAILURE(status)){
+        fprintf(stderr, "FAILED to create UPerfTest object. Error: %s\n", u_errorName(status));
+        return;
+    }
+    for (int32_t i = 0; i < MAX_KEYWORDS; ++i) {
+        start = ubrk_following(brk, (int32_t)((int64_t)srcLen * i / MAX_KEYWORDS));
+        if (start == UBRK_DONE) {
+            break;
+        }
+        while ((end = ubrk_next(brk)) != UBRK_DONE && ubrk_getRuleStatus(brk) < UBRK_WORD_LETTER) {
+            start = end;
+        }
+        if (end == UBRK_DONE) {
+            break;
+        }
+        keywordLengths[keywordCount] = end - start;
+        keywords[keywordCount] = (UChar*)malloc(sizeof(UChar)*(end - start));
+        u_memcpy(keywords[keywordCount], src + start, end - start);
+        keywordSrchs[keywordCount] = usearch_open(keywords[keywordCount], end - start, src, srcLen, locale, NULL, &status);
+        usearch_setAttribute(keywordSrchs[keywordCount], USEARCH_OVERLAP, USEARCH_ON, &status);
+        ++keywordCount;
+    }
+    ubrk_close(brk);
+    keywordMSrch = umsearch_open(keywords, keywordLengths, keywordCount, src, srcLen,
+                                 usearch_getCollator(srch), NULL, &status);
+    if(U_FAILURE(status)){
+        fprintf(stderr, "FAILED to create UPerfTest object. Error: %s\n", u_errorName(status));
+        return;
+    }
 }
 
 StringSearchPerformanceTest::~StringSearchPerformanceTest() {
@@ -81,12 +131,29 @@ StringSearchPerformanceTest::~StringSearchPerformanceTest() {
     if (srch != NULL) {
         usearch_close(srch);
     }
+    if (srchPrimary != NULL) {
+        usearch_close(srchPrimary);
+    }
+    if (srchSecondary != NULL) {
+        usearch_close(srchSecondary);
+    }
+    for (int32_t i = 0; i < keywordCount; ++i) {
+        usearch_close(keywordSrchs[i]);
+        free(keywords[i]);
+    }
+    umsearch_close(keywordMSrch);
 }
 
 UPerfFunction* StringSearchPerformanceTest::runIndexedTest(int32_t index, UBool exec, const char *&name, char *par) {
     switch (index) {
         TESTCASE(0,Test_ICU_Forward_Search);
         TESTCASE(1,Test_ICU_Backward_Search);
+        TESTCASE(2,Test_ICU_Forward_Search_Primary);
+        TESTCASE(3,Test_ICU_Backward_Search_Primary);
+        TESTCASE(4,Test_ICU_Forward_Search_Secondary);
+        TESTCASE(5,Test_ICU_Backward_Search_Secondary);
+        TESTCASE(6,Test_ICU_Keywords_Search_Each);
+        TESTCASE(7,Test_ICU_Keywords_Search_Multi);
 
         default: 
             name = ""; 
@@ -105,6 +172,36 @@ UPerfFunction* StringSearchPerformanceTest::Test_ICU_Backward_Search(){
     return func;
 }
 
+UPerfFunction* StringSearchPerformanceTest::Test_ICU_Forward_Search_Primary(){
+    StringSearchPerfFunction* func = new StringSearchPerfFunction(ICUForwardSearch, srchPrimary, src, srcLen, pttrn, pttrnLen);
+    return func;
+}
+
+UPerfFunction* StringSearchPerformanceTest::Test_ICU_Backward_Search_Primary(){
+    StringSearchPerfFunction* func = new StringSearchPerfFunction(ICUBackwardSearch, srchPrimary, src, srcLen, pttrn, pttrnLen);
+    return func;
+}
+
+UPerfFunction* StringSearchPerformanceTest::Test_ICU_Forward_Search_Secondary(){
+    StringSearchPerfFunction* func = new StringSearchPerfFunction(ICUForwardSearch, srchSecondary, src, srcLen, pttrn, pttrnLen);
+    return func;
+}
+
+UPerfFunction* StringSearchPerformanceTest::Test_ICU_Backward_Search_Secondary(){
+    StringSearchPerfFunction* func = new StringSearchPerfFunction(ICUBackwardSearch, srchSecondary, src, srcLen, pttrn, pttrnLen);
+    return func;
+}
+
+UPerfFunction* StringSearchPerformanceTest::Test_ICU_Keywords_Search_Each(){
+    MultiStringSearchPerfFunction* func = new MultiStringSearchPerfFunction(NULL, keywordSrchs, keywordCount, src, srcLen);
+    return func;
+}
+
+UPerfFunction* StringSearchPerformanceTest::Test_ICU_Keywords_Search_Multi(){
+    MultiStringSearchPerfFunction* func = new MultiStringSearchPerfFunction(keywordMSrch, keywordSrchs, keywordCount, src, srcLen);
+    return func;
+}
+
 int main (int argc, const char* argv[]) {
     UErrorCode status = U_ZERO_ERROR;
     StringSearchPerformanceTest test(argc, argv, status);
@@ -12,6 +12,7 @@
 #define _STRSRCHPERF_H
 
 #include "unicode/usearch.h"
+#include "unicode/umsearch.h"
 #include "unicode/uperf.h"
 #include <stdlib.h>
 #include <stdio.h>
@@ -46,6 +47,44 @@ class StringSearchPerfFunction : public UPerfFunction {
     }
 };
 
+class MultiStringSearchPerfFunction : public UPerfFunction {
+private:
+    UMultiStringSearch* msrch;
+    UStringSearch** srchs;
+    int32_t srchCount;
+    const UChar* src;
+    int32_t srcLen;
+
+public:
+    virtual void call(UErrorCode* status) {
+        if (msrch != NULL) {
+            /* One pass for all of the keywords. */
+            umsearch_setText(msrch, src, srcLen, status);
+            while (umsearch_next(msrch, NULL, NULL, NULL, status)) {}
+        } else {
+            /* One pass per keyword. */
+            for (int32_t i = 0; i < srchCount; ++i) {
+                int32_t match = usearch_first(srchs[i], status);
+                while (match != USEARCH_DONE) {
+                    match = usearch_next(srchs[i], status);
+                }
+            }
+        }
+    }
+
+    virtual long getOperationsPerIteration() {
+        return (long) srcLen;
+    }
+
+    MultiStringSearchPerfFunction(UMultiStringSearch* multiSearch, UStringSearch** searches, int32_t searchCount, const UChar* source, int32_t sourceLen) {
+        msrch = multiSearch;
+        srchs = searches;
+        srchCount = searchCount;
+        src = source;
+        srcLen = sourceLen;
+    }
+};
+
 class StringSearchPerformanceTest : public UPerfTest {
 private:
     const UChar* src;
@@ -53,6 +92,14 @@ class StringSearchPerformanceTest : public UPerfTest {
     UChar* pttrn;
     int32_t pttrnLen;
     UStringSearch* srch;
+    UStringSearch* srchPrimary;
+    UStringSearch* srchSecondary;
+    enum { MAX_KEYWORDS = 100 };
+    UChar* keywords[MAX_KEYWORDS];
+    int32_t keywordLengths[MAX_KEYWORDS];
+    int32_t keywordCount;
+    UStringSearch* keywordSrchs[MAX_KEYWORDS];
+    UMultiStringSearch* keywordMSrch;
     
 public:
     StringSearchPerformanceTest(int32_t argc, const char *argv[], UErrorCode &status);
@@ -60,6 +107,12 @@ class StringSearchPerformanceTest : public UPerfTest {
     virtual UPerfFunction* runIndexedTest(int32_t index, UBool exec, const char *&name, char *par = NULL);
     UPerfFunction* Test_ICU_Forward_Search();
     UPerfFunction* Test_ICU_Backward_Search();
+    UPerfFunction* Test_ICU_Forward_Search_Primary();
+    UPerfFunction* Test_ICU_Backward_Search_Primary();
+    UPerfFunction* Test_ICU_Forward_Search_Secondary();
+    UPerfFunction* Test_ICU_Backward_Search_Secondary();
+    UPerfFunction* Test_ICU_Keywords_Search_Each();
+    UPerfFunction* Test_ICU_Keywords_Search_Multi();
 };
 
 
@@ -64,7 +64,10 @@ static const char *const utfperf_usage =
     "\t            Default: UTF-8\n"
     "\t--chunk     Length (in bytes) of charset output chunks. [4096]\n"
     "\t--pivot     Length (in UChars) of the UTF-16 pivot buffer, if applicable.\n"
-    "\t            [1024]\n";
+    "\t            [1024]\n"
+    "\tStrFromUTF8 and StrToUTF8 test u_strFromUTF8WithSub() and u_strToUTF8WithSub()\n"
+    "\tand count one event per UTF-8 byte: 1/(time per event in ns) is the throughput\n"
+    "\tin GB/s. Run them on ASCII, mostly-Latin, CJK and emoji input files.\n";
 
 // Test object.
 class  UtfPerformanceTest : public UPerfTest{
@@ -328,11 +331,49 @@ class FromUTF8 : public Command {
     int32_t input8Length;
 };
 
+// Test u_strFromUTF8WithSub(), UTF-8->UTF-16 without a converter.
+class StrFromUTF8 : public UPerfFunction {
+public:
+    StrFromUTF8() {}
+    virtual void call(UErrorCode* pErrorCode){
+        u_strFromUTF8WithSub(output, OUTPUT_CAPACITY, &outputLength,
+                             utf8, utf8Length, 0xfffd, NULL, pErrorCode);
+    }
+    virtual long getOperationsPerIteration(){
+        return countInputCodePoints;
+    }
+    virtual long getEventsPerIteration(){
+        return utf8Length;
+    }
+};
+
+// Test u_strToUTF8WithSub(), UTF-16->UTF-8 without a converter.
+class StrToUTF8 : public UPerfFunction {
+public:
+    StrToUTF8(const UtfPerformanceTest &testcase)
+            : input(testcase.getBuffer()), inputLength(testcase.getBufferLen()) {}
+    virtual void call(UErrorCode* pErrorCode){
+        u_strToUTF8WithSub(intermediate, OUTPUT_CAPACITY, &encodedLength,
+                           input, inputLength, 0xfffd, NULL, pErrorCode);
+    }
+    virtual long getOperationsPerIteration(){
+        return countInputCodePoints;
+    }
+    virtual long getEventsPerIteration(){
+        return utf8Length;
+    }
+private:
+    const UChar *input;
+    int32_t inputLength;
+};
+
 UPerfFunction* UtfPerformanceTest::runIndexedTest(int32_t index, UBool exec, const char* &name, char* par) {
     switch (index) {
         case 0: name = "Roundtrip";     if (exec) return Roundtrip::get(*this); break;
         case 1: name = "FromUnicode";   if (exec) return FromUnicode::get(*this); break;
         case 2: name = "FromUTF8";      if (exec) return FromUTF8::get(*this); break;
+        case 3: name = "StrFromUTF8";   if (exec) return new StrFromUTF8(); break;
+        case 4: name = "StrToUTF8";     if (exec) return new StrToUTF8(*this); break;
         default: name = ""; break;
     }
     return NULL;